@@ -0,0 +1,115 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/batch_analysis.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_SECTIONS = 16U;
+    constexpr auto ANGULAR_FREQUENCY = 1e4;
+
+    struct Ladder
+    {
+        Network network;
+        uint32_t ground;
+        std::vector<uint32_t> resistors;
+    };
+
+    /**
+     * \brief Source driven RC ladder, the resistor of section i has resistance base * (i + 1)
+     */
+    void build_ladder(Ladder& ladder, const double base)
+    {
+        auto& network = ladder.network;
+        ladder.ground = network.create_node();
+        auto previous = network.create_node();
+
+        const auto source = network.create_branch(std::make_unique<Voltage_Source>(1.0));
+        network.create_connection_between(previous, source);
+        network.create_connection_between(ladder.ground, source);
+
+        for(auto section = 0U; section < NUMBER_OF_SECTIONS; ++section)
+        {
+            const auto next = network.create_node();
+            const auto resistor = network.create_branch(
+                std::make_unique<Resistor>(base * (section + 1U)));
+            const auto capacitor = network.create_branch(std::make_unique<Capacitor>(10.0_nF));
+
+            network.create_connection_between(previous, resistor);
+            network.create_connection_between(next, resistor);
+            network.create_connection_between(next, capacitor);
+            network.create_connection_between(ladder.ground, capacitor);
+
+            ladder.resistors.emplace_back(resistor);
+            previous = next;
+        }
+    }
+
+    double base_for(const std::size_t instance)
+    {
+        return 1.0_kohm + static_cast<double>(instance);
+    }
+}
+
+/**********************************************************************************************//**
+ * Baseline, one scalar analysis per instance over prebuilt networks
+ *************************************************************************************************/
+static void BM_ScalarLoop(benchmark::State& state)
+{
+    const auto number_of_instances = static_cast<std::size_t>(state.range(0));
+
+    std::vector<Ladder> ladders(number_of_instances);
+    for(std::size_t instance = 0U; instance < number_of_instances; ++instance)
+    {
+        build_ladder(ladders[instance], base_for(instance));
+    }
+
+    for(auto _ : state)
+    {
+        for(const auto& ladder : ladders)
+        {
+            benchmark::DoNotOptimize(Nodal_Analysis(ladder.network, ladder.ground)
+                                     .solve(ANGULAR_FREQUENCY));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScalarLoop)->Arg(64)->Arg(1024);
+
+/**********************************************************************************************//**
+ * Every instance packed into SIMD lanes through a Batch_Table
+ *************************************************************************************************/
+static void BM_BatchAnalysis(benchmark::State& state)
+{
+    const auto number_of_instances = static_cast<std::size_t>(state.range(0));
+
+    Ladder nominal;
+    build_ladder(nominal, base_for(0U));
+
+    Batch_Table table;
+    table.number_of_instances = number_of_instances;
+    for(std::size_t section = 0U; section < NUMBER_OF_SECTIONS; ++section)
+    {
+        auto& column = table.columns[nominal.resistors[section]];
+        for(std::size_t instance = 0U; instance < number_of_instances; ++instance)
+        {
+            column.emplace_back(base_for(instance) * (section + 1U));
+        }
+    }
+
+    const Batch_Analysis analysis(nominal.network, nominal.ground);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(analysis.solve(table, ANGULAR_FREQUENCY));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BatchAnalysis)->Arg(64)->Arg(1024);
@@ -0,0 +1,76 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/branch_quantities.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+
+#include <random>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto SEED = 7U;
+
+    /**
+     * \brief Arbitrary unknowns for an RLC tree. Post-processing doesn't care whether they solve
+     *        the system, and a dense solve would dwarf what is being measured.
+     */
+    std::vector<std::complex<double>> make_unknowns(const Nodal_Analysis& analysis)
+    {
+        std::mt19937_64 generator(SEED);
+        std::vector<std::complex<double>> unknowns(analysis.get_system_size());
+        for(auto& unknown : unknowns)
+        {
+            unknown = { static_cast<double>(generator() % 1000U), static_cast<double>(generator() % 1000U) };
+        }
+
+        return unknowns;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Branch voltages, currents and powers through per UID lookups on the network and solution
+ *************************************************************************************************/
+static void BM_BranchQuantitiesLookup(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)), 4U, SEED);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+    const auto solution = analysis.interpret(make_unknowns(analysis), ANGULAR_FREQUENCY);
+    const auto branch_uids = network.get_branch_uids();
+
+    std::vector<std::complex<double>> powers(branch_uids.size());
+    for(auto _ : state)
+    {
+        for(std::size_t index = 0U; index < branch_uids.size(); ++index)
+        {
+            const auto& nodes = network.get_branch(branch_uids[index]).nodes;
+            const auto voltage = solution.node_voltages.at(nodes[0]) - solution.node_voltages.at(nodes[1]);
+            powers[index] = voltage * std::conj(solution.branch_currents.at(branch_uids[index]));
+        }
+        benchmark::DoNotOptimize(powers.data());
+    }
+}
+BENCHMARK(BM_BranchQuantitiesLookup)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief The same quantities in one pass over flat arrays, from the unknowns
+ *************************************************************************************************/
+static void BM_BranchQuantities(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)), 4U, SEED);
+    const auto compiled = network.compile();
+    const Nodal_Analysis analysis(*compiled, circuit.ground_uid);
+    const auto unknowns = make_unknowns(analysis);
+
+    Branch_Quantities quantities(*compiled, analysis);
+    for(auto _ : state)
+    {
+        quantities.evaluate(unknowns, ANGULAR_FREQUENCY);
+        benchmark::DoNotOptimize(quantities.get_powers().data());
+    }
+}
+BENCHMARK(BM_BranchQuantities)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,87 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/dc_sweep.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/matrix.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr std::size_t NUMBER_OF_SECTIONS = 200U;
+    constexpr std::size_t NUMBER_OF_POINTS = 4096U;
+
+    // One swept source, so one value per point
+    std::vector<double> make_points()
+    {
+        std::vector<double> points;
+        for(std::size_t index = 0U; index < NUMBER_OF_POINTS; ++index)
+        {
+            points.push_back(-1.0 + (2.0 * static_cast<double>(index) / NUMBER_OF_POINTS));
+        }
+
+        return points;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief One factorization, then one substitution per point
+ *************************************************************************************************/
+static void BM_DCSweepPerPoint(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_ladder(network, NUMBER_OF_SECTIONS);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+    const auto points = make_points();
+
+    std::size_t row = 0U;
+    for(const auto& element : analysis.get_elements())
+    {
+        if(element.uid == circuit.source_uid)
+        {
+            row = element.current_index;
+        }
+    }
+
+    const LU_Factorization<std::complex<double>> factorization(analysis.assemble_matrix(0.0));
+    auto excitation = analysis.assemble_excitation();
+    std::vector<std::complex<double>> unknowns;
+
+    for(auto _ : state)
+    {
+        for(const auto point : points)
+        {
+            excitation[row] = point;
+            factorization.solve(excitation, unknowns);
+            benchmark::DoNotOptimize(unknowns.data());
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * NUMBER_OF_POINTS));
+}
+BENCHMARK(BM_DCSweepPerPoint)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief The same points through DC_Sweep, range(0) points per block
+ *************************************************************************************************/
+static void BM_DCSweepBlocked(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_ladder(network, NUMBER_OF_SECTIONS);
+    const DC_Sweep sweep(network, circuit.ground_uid, { circuit.source_uid }, network.get_node_uids());
+    const auto points = make_points();
+
+    for(auto _ : state)
+    {
+        double total = 0.0;
+        sweep.run(points, [&](std::size_t, const std::span<const double> voltages) { total += voltages[1]; },
+                  static_cast<std::size_t>(state.range(0)));
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * NUMBER_OF_POINTS));
+}
+BENCHMARK(BM_DCSweepBlocked)->Arg(1)->Arg(8)->Arg(32)->Arg(128)->Unit(benchmark::kMillisecond);
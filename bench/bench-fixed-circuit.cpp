@@ -0,0 +1,110 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/fixed_circuit.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+
+#include <array>
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 2.0 * 3.14159265358979 * 50.0;
+
+    // Two section RC ladder with an inductive load, small enough for the fixed solver
+    using Ladder = Fixed_Circuit<5U,
+                                 Fixed_Voltage_Source<1U, 0U>,
+                                 Fixed_Resistor<1U, 2U>,
+                                 Fixed_Capacitor<2U, 0U>,
+                                 Fixed_Resistor<2U, 3U>,
+                                 Fixed_Capacitor<3U, 0U>,
+                                 Fixed_Inductor<3U, 4U>,
+                                 Fixed_Resistor<4U, 0U>>;
+
+    const Ladder::Values NOMINAL_VALUES = { 1.0, 1.0_kohm, 1.0_muF, 2.2_kohm, 470.0_nF,
+                                            10.0_mH, 100.0_ohm };
+
+    /**
+     * \brief Builds the same ladder as a Network, returning the ground UID
+     */
+    uint32_t build_ladder(Network& network, const Ladder::Values& values)
+    {
+        std::array<uint32_t, 5U> nodes{};
+        for(auto& node : nodes)
+        {
+            node = network.create_node();
+        }
+
+        const auto connect = [&](std::unique_ptr<Component> component, uint32_t a, uint32_t b)
+        {
+            const auto uid = network.create_branch(std::move(component));
+            network.create_connection_between(nodes[a], uid);
+            network.create_connection_between(nodes[b], uid);
+        };
+
+        connect(std::make_unique<Voltage_Source>(values[0]), 1U, 0U);
+        connect(std::make_unique<Resistor>(values[1].real()), 1U, 2U);
+        connect(std::make_unique<Capacitor>(values[2].real()), 2U, 0U);
+        connect(std::make_unique<Resistor>(values[3].real()), 2U, 3U);
+        connect(std::make_unique<Capacitor>(values[4].real()), 3U, 0U);
+        connect(std::make_unique<Inductor>(values[5].real()), 3U, 4U);
+        connect(std::make_unique<Resistor>(values[6].real()), 4U, 0U);
+
+        return nodes[0];
+    }
+}
+
+/**********************************************************************************************//**
+ * Fixed topology solve with the resistor values perturbed every iteration
+ *************************************************************************************************/
+static void BM_FixedCircuitSolve(benchmark::State& state)
+{
+    auto values = NOMINAL_VALUES;
+    auto step = 0.0;
+
+    for(auto _ : state)
+    {
+        values[1] = NOMINAL_VALUES[1] + step;
+        step += 1e-3;
+
+        benchmark::DoNotOptimize(Ladder::solve(values, ANGULAR_FREQUENCY));
+    }
+}
+BENCHMARK(BM_FixedCircuitSolve);
+
+/**********************************************************************************************//**
+ * Dynamic path for the same circuit, the network is prebuilt and only analysed per iteration
+ *************************************************************************************************/
+static void BM_NodalAnalysisSolve(benchmark::State& state)
+{
+    Network network;
+    const auto ground = build_ladder(network, NOMINAL_VALUES);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(Nodal_Analysis(network, ground).solve(ANGULAR_FREQUENCY));
+    }
+}
+BENCHMARK(BM_NodalAnalysisSolve);
+
+/**********************************************************************************************//**
+ * Dynamic path when new values require the network to be rebuilt every iteration
+ *************************************************************************************************/
+static void BM_NetworkRebuildAndSolve(benchmark::State& state)
+{
+    auto values = NOMINAL_VALUES;
+    auto step = 0.0;
+
+    for(auto _ : state)
+    {
+        values[1] = NOMINAL_VALUES[1] + step;
+        step += 1e-3;
+
+        Network network;
+        const auto ground = build_ladder(network, values);
+        benchmark::DoNotOptimize(Nodal_Analysis(network, ground).solve(ANGULAR_FREQUENCY));
+    }
+}
+BENCHMARK(BM_NetworkRebuildAndSolve);
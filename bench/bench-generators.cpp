@@ -0,0 +1,124 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/compiled_network.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+
+#include <cmath>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 1234U;
+
+    // Runs go from a thousand to a million elements. Production sized networks are checked by
+    // the Generators.ProductionScale test with CIRCLYZER_SCALE_ELEMENTS set
+    constexpr auto MINIMUM_ELEMENTS = 1 << 10;
+    constexpr auto MAXIMUM_ELEMENTS = 1 << 20;
+    constexpr auto RANGE_MULTIPLIER = 16;
+
+    void report(benchmark::State& state, const Generated_Circuit& circuit)
+    {
+        state.counters["elements"] = static_cast<double>(circuit.number_of_nodes +
+                                                         circuit.number_of_branches);
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(circuit.number_of_nodes +
+                                                     circuit.number_of_branches));
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Network construction time of a resistor ladder, three elements per section
+ *************************************************************************************************/
+static void BM_GenerateLadder(benchmark::State& state)
+{
+    Generated_Circuit circuit{};
+    for(auto _ : state)
+    {
+        Network network;
+        circuit = generate_ladder(network, static_cast<std::size_t>(state.range(0)) / 3U, SEED);
+        benchmark::DoNotOptimize(network);
+    }
+
+    report(state, circuit);
+}
+BENCHMARK(BM_GenerateLadder)->RangeMultiplier(RANGE_MULTIPLIER)->Range(MINIMUM_ELEMENTS, MAXIMUM_ELEMENTS)
+                            ->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Network construction time of a square 2D grid, roughly three elements per node
+ *************************************************************************************************/
+static void BM_GenerateGrid(benchmark::State& state)
+{
+    const auto side = static_cast<std::size_t>(std::sqrt(static_cast<double>(state.range(0)) / 3.0));
+
+    Generated_Circuit circuit{};
+    for(auto _ : state)
+    {
+        Network network;
+        circuit = generate_grid(network, side, side, 1U, SEED);
+        benchmark::DoNotOptimize(network);
+    }
+
+    report(state, circuit);
+}
+BENCHMARK(BM_GenerateGrid)->RangeMultiplier(RANGE_MULTIPLIER)->Range(MINIMUM_ELEMENTS, MAXIMUM_ELEMENTS)
+                          ->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Network construction time of a random graph with an average degree of four
+ *************************************************************************************************/
+static void BM_GenerateRandomSparse(benchmark::State& state)
+{
+    Generated_Circuit circuit{};
+    for(auto _ : state)
+    {
+        Network network;
+        circuit = generate_random_sparse(network, static_cast<std::size_t>(state.range(0)) / 3U,
+                                         4.0, SEED);
+        benchmark::DoNotOptimize(network);
+    }
+
+    report(state, circuit);
+}
+BENCHMARK(BM_GenerateRandomSparse)->RangeMultiplier(RANGE_MULTIPLIER)
+                                  ->Range(MINIMUM_ELEMENTS, MAXIMUM_ELEMENTS)
+                                  ->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Network construction time of an RLC tree
+ *************************************************************************************************/
+static void BM_GenerateRlcTree(benchmark::State& state)
+{
+    Generated_Circuit circuit{};
+    for(auto _ : state)
+    {
+        Network network;
+        circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)) / 3U, 4U, SEED);
+        benchmark::DoNotOptimize(network);
+    }
+
+    report(state, circuit);
+}
+BENCHMARK(BM_GenerateRlcTree)->RangeMultiplier(RANGE_MULTIPLIER)->Range(MINIMUM_ELEMENTS, MAXIMUM_ELEMENTS)
+                             ->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Compiling a large random graph into the CSR view
+ *************************************************************************************************/
+static void BM_CompileRandomSparse(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_random_sparse(network, static_cast<std::size_t>(state.range(0)) / 3U,
+                                                4.0, SEED);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(network.compile());
+    }
+
+    report(state, circuit);
+}
+BENCHMARK(BM_CompileRandomSparse)->RangeMultiplier(RANGE_MULTIPLIER)
+                                 ->Range(MINIMUM_ELEMENTS, MAXIMUM_ELEMENTS)
+                                 ->Unit(benchmark::kMillisecond);
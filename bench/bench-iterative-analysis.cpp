@@ -0,0 +1,116 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/iterative_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 1234U;
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+}
+
+/**********************************************************************************************//**
+ * \brief Dense LU solve of a resistive grid, the baseline the iterative solvers replace
+ *************************************************************************************************/
+static void BM_DirectGrid(benchmark::State& state)
+{
+    const auto side = static_cast<std::size_t>(state.range(0));
+
+    Network network;
+    const auto circuit = generate_grid(network, side, side, 1U, SEED);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(analysis.solve());
+    }
+
+    state.counters["nodes"] = static_cast<double>(circuit.number_of_nodes);
+}
+BENCHMARK(BM_DirectGrid)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Conjugate gradient on the same grid at DC, per preconditioner
+ *************************************************************************************************/
+static void BM_ConjugateGradientGrid(benchmark::State& state)
+{
+    const auto side = static_cast<std::size_t>(state.range(0));
+
+    Network network;
+    const auto circuit = generate_grid(network, side, side, 1U, SEED);
+
+    Iterative_Options options;
+    options.preconditioner = static_cast<Preconditioner_Type>(state.range(1));
+    options.krylov.tolerance = 1e-8;
+    const Iterative_Analysis analysis(network, circuit.ground_uid, options);
+
+    uint32_t iterations = 0U;
+    for(auto _ : state)
+    {
+        const auto result = analysis.solve();
+        iterations = result.iterations;
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["nodes"] = static_cast<double>(circuit.number_of_nodes);
+    state.counters["iterations"] = iterations;
+}
+BENCHMARK(BM_ConjugateGradientGrid)
+    ->ArgsProduct({ { 32, 128, 512 }, { 1, 2 } })
+    ->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief BiCGSTAB on an RLC tree in the AC steady state
+ *************************************************************************************************/
+static void BM_BiCGSTABTree(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)), 4U, SEED);
+
+    Iterative_Options options;
+    options.krylov.tolerance = 1e-8;
+    const Iterative_Analysis analysis(network, circuit.ground_uid, options);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(analysis.solve(ANGULAR_FREQUENCY));
+    }
+
+    state.counters["nodes"] = static_cast<double>(circuit.number_of_nodes);
+}
+BENCHMARK(BM_BiCGSTABTree)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief The sparse matrix-vector product alone, serial against split across the shared pool
+ *************************************************************************************************/
+static void BM_SparseProduct(benchmark::State& state)
+{
+    const auto side = static_cast<std::size_t>(state.range(0));
+
+    Network network;
+    const auto circuit = generate_grid(network, side, side, 1U, SEED);
+    const auto matrix = Iterative_Analysis(network, circuit.ground_uid).assemble_reduced_matrix(0.0);
+
+    std::vector<std::complex<double>> vector(matrix.get_number_of_rows(), 1.0);
+    std::vector<std::complex<double>> result;
+
+    for(auto _ : state)
+    {
+        if(state.range(1) != 0)
+        {
+            matrix.multiply(vector, result, Executor::get_shared());
+        }
+        else
+        {
+            matrix.multiply(vector, result);
+        }
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * matrix.get_number_of_nonzeros()));
+}
+BENCHMARK(BM_SparseProduct)->ArgsProduct({ { 1024 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,77 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/model_reduction.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 1234U;
+    constexpr auto NUMBER_OF_FREQUENCIES = 64U;
+    constexpr auto REDUCED_BLOCKS = 10U;
+
+    std::vector<double> make_frequencies()
+    {
+        std::vector<double> frequencies;
+        for(auto index = 0U; index < NUMBER_OF_FREQUENCIES; ++index)
+        {
+            frequencies.emplace_back(1.0e3 * (1.0 + index));
+        }
+
+        return frequencies;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Sweeping an RLC tree with a full nodal solve per frequency
+ *************************************************************************************************/
+static void BM_FullSweep(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)), 4U, SEED);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+    const auto frequencies = make_frequencies();
+
+    for(auto _ : state)
+    {
+        for(const auto frequency : frequencies)
+        {
+            benchmark::DoNotOptimize(analysis.solve(frequency));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * frequencies.size()));
+}
+BENCHMARK(BM_FullSweep)->Arg(100)->Arg(400)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Building a one port reduced model of the same tree, then sweeping it
+ *************************************************************************************************/
+static void BM_ReducedSweep(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)), 4U, SEED);
+    network.delete_connection_between(network.get_node_uids()[1], circuit.source_uid);
+    network.delete_connection_between(circuit.ground_uid, circuit.source_uid);
+    network.destroy_entity(circuit.source_uid);
+
+    const auto frequencies = make_frequencies();
+    const auto compiled = network.compile();
+
+    Model_Reduction_Options options;
+    options.expansion_point = 1.0e4;
+    options.maximum_blocks = REDUCED_BLOCKS;
+
+    for(auto _ : state)
+    {
+        const Reduced_Model model(*compiled, circuit.ground_uid, { network.get_node_uids()[1] }, options);
+        benchmark::DoNotOptimize(model.sweep(frequencies));
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * frequencies.size()));
+}
+BENCHMARK(BM_ReducedSweep)->Arg(100)->Arg(400)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,115 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/network.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_NODES = 65536U;
+
+    /**
+     * \brief A chain of resistors, churned by destroying every other branch and node and
+     *        recreating half as many, leaving gaps scattered through the UIDs
+     */
+    Network make_churned_network()
+    {
+        Network network;
+        std::vector<uint32_t> nodes;
+        for(uint32_t index = 0U; index < NUMBER_OF_NODES; ++index)
+        {
+            nodes.emplace_back(network.create_node());
+            if(index > 0U)
+            {
+                const auto branch = network.create_branch(std::make_unique<Resistor>(1.0));
+                network.create_connection_between(nodes[index - 1U], branch);
+                network.create_connection_between(nodes[index], branch);
+            }
+        }
+
+        for(const auto uid : network.get_branch_uids())
+        {
+            if((uid % 4U) == 1U)
+            {
+                network.destroy_entity(uid);
+            }
+        }
+
+        for(uint32_t index = 0U; index < NUMBER_OF_NODES / 4U; ++index)
+        {
+            network.create_node();
+        }
+
+        return network;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Resolves every node by UID
+ *************************************************************************************************/
+static void BM_AccessByUid(benchmark::State& state)
+{
+    const auto network = make_churned_network();
+    const auto uids = network.get_node_uids();
+
+    for(auto _ : state)
+    {
+        std::size_t degree = 0U;
+        for(const auto uid : uids)
+        {
+            degree += network.get_node(uid).branches.size();
+        }
+
+        benchmark::DoNotOptimize(degree);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * uids.size()));
+}
+BENCHMARK(BM_AccessByUid);
+
+/**********************************************************************************************//**
+ * \brief Resolves every node through a generational handle
+ *************************************************************************************************/
+static void BM_AccessByHandle(benchmark::State& state)
+{
+    const auto network = make_churned_network();
+    std::vector<Node_Handle> handles;
+    for(const auto uid : network.get_node_uids())
+    {
+        handles.emplace_back(network.get_node_handle(uid));
+    }
+
+    for(auto _ : state)
+    {
+        std::size_t degree = 0U;
+        for(const auto handle : handles)
+        {
+            degree += network.get_node(handle).branches.size();
+        }
+
+        benchmark::DoNotOptimize(degree);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * handles.size()));
+}
+BENCHMARK(BM_AccessByHandle);
+
+/**********************************************************************************************//**
+ * \brief Compacts a churned network, rebuilding it every iteration outside the timing
+ *************************************************************************************************/
+static void BM_Compact(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto network = make_churned_network();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(network.compact());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * NUMBER_OF_NODES * 2);
+}
+BENCHMARK(BM_Compact)->Unit(benchmark::kMillisecond);
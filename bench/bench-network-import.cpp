@@ -0,0 +1,191 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/network.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_RECORDS = 4096U;
+    constexpr auto PERCENT = 100U;
+    constexpr auto ALIAS_LENGTH_LIMIT = 25U;
+
+    /**
+     * \brief One row of an imported netlist: a node alias and a resistor alias to connect to it.
+     *        Dirty rows reuse an alias already taken, or one that is too long.
+     */
+    struct Record
+    {
+        std::string node_alias;
+        std::string branch_alias;
+        double resistance;
+    };
+
+    std::vector<Record> make_records(const std::size_t failure_percent)
+    {
+        std::vector<Record> records;
+        records.reserve(NUMBER_OF_RECORDS);
+
+        for(std::size_t index = 0U; index < NUMBER_OF_RECORDS; ++index)
+        {
+            Record record{ "N" + std::to_string(index), "R" + std::to_string(index), 1.0 + index };
+
+            // Spread the dirty rows evenly through the import
+            if(((index * failure_percent) % PERCENT) < failure_percent)
+            {
+                record.node_alias = (index % 2U == 0U) ? std::string("N0") :
+                                                         std::string(ALIAS_LENGTH_LIMIT, 'x');
+                record.branch_alias = "R0";
+            }
+
+            records.emplace_back(std::move(record));
+        }
+
+        return records;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Imports with the throwing API, catching each rejected row
+ *************************************************************************************************/
+static void BM_ImportThrowing(benchmark::State& state)
+{
+    const auto records = make_records(static_cast<std::size_t>(state.range(0)));
+
+    std::size_t rejected = 0U;
+    for(auto _ : state)
+    {
+        Network network;
+        rejected = 0U;
+
+        for(const auto& record : records)
+        {
+            try
+            {
+                const auto node = network.create_node(record.node_alias);
+                const auto branch = network.create_branch(
+                    std::make_unique<Resistor>(record.resistance), record.branch_alias);
+                network.create_connection_between(node, branch);
+            }
+            catch(const std::exception&)
+            {
+                ++rejected;
+            }
+        }
+
+        benchmark::DoNotOptimize(network);
+    }
+
+    state.counters["rejected"] = static_cast<double>(rejected);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * NUMBER_OF_RECORDS);
+}
+BENCHMARK(BM_ImportThrowing)->Arg(0)->Arg(10)->Arg(50)->Arg(90);
+
+/**********************************************************************************************//**
+ * \brief Imports the same rows with the Result returning API
+ *************************************************************************************************/
+static void BM_ImportResult(benchmark::State& state)
+{
+    const auto records = make_records(static_cast<std::size_t>(state.range(0)));
+
+    std::size_t rejected = 0U;
+    for(auto _ : state)
+    {
+        Network network;
+        rejected = 0U;
+
+        for(const auto& record : records)
+        {
+            const auto node = network.try_create_node(record.node_alias);
+            if(!node)
+            {
+                ++rejected;
+                continue;
+            }
+
+            const auto branch = network.try_create_branch(
+                std::make_unique<Resistor>(record.resistance), record.branch_alias);
+            if(!branch)
+            {
+                ++rejected;
+                continue;
+            }
+
+            network.create_connection_between(*node, *branch);
+        }
+
+        benchmark::DoNotOptimize(network);
+    }
+
+    state.counters["rejected"] = static_cast<double>(rejected);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * NUMBER_OF_RECORDS);
+}
+BENCHMARK(BM_ImportResult)->Arg(0)->Arg(10)->Arg(50)->Arg(90);
+
+/**********************************************************************************************//**
+ * \brief Lookups of mostly missing or mistyped UIDs, as when validating a dirty reference list
+ *************************************************************************************************/
+static void BM_LookupThrowing(benchmark::State& state)
+{
+    Network network;
+    std::vector<uint32_t> uids;
+    for(std::size_t index = 0U; index < NUMBER_OF_RECORDS; ++index)
+    {
+        uids.emplace_back(network.create_node());
+        uids.emplace_back(index * 2U + NUMBER_OF_RECORDS * 4U);
+    }
+
+    for(auto _ : state)
+    {
+        std::size_t found = 0U;
+        for(const auto uid : uids)
+        {
+            try
+            {
+                benchmark::DoNotOptimize(&network.get_component(uid));
+                ++found;
+            }
+            catch(const std::exception&)
+            {
+
+            }
+        }
+
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * uids.size()));
+}
+BENCHMARK(BM_LookupThrowing);
+
+/**********************************************************************************************//**
+ * \brief The same lookups through try_get_component
+ *************************************************************************************************/
+static void BM_LookupResult(benchmark::State& state)
+{
+    Network network;
+    std::vector<uint32_t> uids;
+    for(std::size_t index = 0U; index < NUMBER_OF_RECORDS; ++index)
+    {
+        uids.emplace_back(network.create_node());
+        uids.emplace_back(index * 2U + NUMBER_OF_RECORDS * 4U);
+    }
+
+    for(auto _ : state)
+    {
+        std::size_t found = 0U;
+        for(const auto uid : uids)
+        {
+            found += network.try_get_component(uid).has_value() ? 1U : 0U;
+        }
+
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * uids.size()));
+}
+BENCHMARK(BM_LookupResult);
@@ -0,0 +1,105 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr std::size_t GRID_SIZE = 200U;
+    constexpr std::size_t REGION_SIZE = 2000U;
+
+    /**
+     * \brief A run of nodes from the middle of the grid, with every branch touching them
+     */
+    std::vector<uint32_t> select_region(const Network& network, const bool with_branches)
+    {
+        const auto node_uids = network.get_node_uids();
+        const auto first = node_uids.begin() + static_cast<std::ptrdiff_t>((node_uids.size() - REGION_SIZE) / 2U);
+        std::vector<uint32_t> region(first, first + REGION_SIZE);
+
+        if(with_branches)
+        {
+            for(std::size_t index = 0U; index < REGION_SIZE; ++index)
+            {
+                const auto& branches = network.get_node(region[index]).branches;
+                region.insert(region.end(), branches.begin(), branches.end());
+            }
+        }
+
+        return region;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Destroys a region one entity at a time
+ *************************************************************************************************/
+static void BM_DestroyOneByOne(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto network = std::make_unique<Network>();
+        generate_grid(*network, GRID_SIZE, GRID_SIZE);
+        const auto region = select_region(*network, true);
+        state.ResumeTiming();
+
+        for(const auto uid : region)
+        {
+            network->destroy_entity(uid);
+        }
+
+        benchmark::DoNotOptimize(network->get_number_of_entities());
+
+        // Tearing the rest of the grid down isn't part of the work
+        state.PauseTiming();
+        network.reset();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_DestroyOneByOne)->Unit(benchmark::kMicrosecond);
+
+/**********************************************************************************************//**
+ * \brief Destroys the same region in one call
+ *************************************************************************************************/
+static void BM_DestroyEntities(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto network = std::make_unique<Network>();
+        generate_grid(*network, GRID_SIZE, GRID_SIZE);
+        const auto region = select_region(*network, true);
+        state.ResumeTiming();
+
+        network->destroy_entities(region);
+        benchmark::DoNotOptimize(network->get_number_of_entities());
+
+        state.PauseTiming();
+        network.reset();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_DestroyEntities)->Unit(benchmark::kMicrosecond);
+
+/**********************************************************************************************//**
+ * \brief Copies out the subnetwork induced by the region's nodes
+ *************************************************************************************************/
+static void BM_ExtractSubnetwork(benchmark::State& state)
+{
+    Network network;
+    generate_grid(network, GRID_SIZE, GRID_SIZE);
+    const auto region = select_region(network, false);
+
+    for(auto _ : state)
+    {
+        const auto extracted = network.extract_subnetwork(region);
+        benchmark::DoNotOptimize(extracted.original_uids.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * REGION_SIZE));
+}
+BENCHMARK(BM_ExtractSubnetwork)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,93 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/network.h"
+#include "circlyzer/network_shard.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_SECTIONS = 65536U;
+
+    /**
+     * \brief One section of an aliased RC ladder, as an importer would create it
+     */
+    template<typename Builder>
+    void add_section(Builder& builder, const uint32_t index)
+    {
+        const auto node = "N" + std::to_string(index);
+        builder.create_node(node);
+
+        if(index > 0U)
+        {
+            const auto resistor = builder.create_branch(std::make_unique<Resistor>(1.0 + index),
+                                                        "R" + std::to_string(index));
+            builder.create_connection_between("N" + std::to_string(index - 1U), "R" + std::to_string(index));
+            builder.create_connection_between(node, "R" + std::to_string(index));
+
+            const auto capacitor = builder.create_branch(std::make_unique<Capacitor>(1.0e-9));
+            benchmark::DoNotOptimize(resistor);
+            benchmark::DoNotOptimize(capacitor);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Builds the ladder through one Network
+ *************************************************************************************************/
+static void BM_SerialConstruction(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        Network network;
+        for(uint32_t index = 0U; index < NUMBER_OF_SECTIONS; ++index)
+        {
+            add_section(network, index);
+        }
+
+        benchmark::DoNotOptimize(network.get_number_of_entities());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * NUMBER_OF_SECTIONS);
+}
+BENCHMARK(BM_SerialConstruction)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Builds the same ladder in shards, one thread each, and merges them
+ *************************************************************************************************/
+static void BM_ShardedConstruction(benchmark::State& state)
+{
+    const auto number_of_shards = static_cast<uint32_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<Network_Shard> shards(number_of_shards);
+        std::vector<std::thread> builders;
+        for(uint32_t shard = 0U; shard < number_of_shards; ++shard)
+        {
+            builders.emplace_back([&shards, shard, number_of_shards]()
+            {
+                const auto sections = NUMBER_OF_SECTIONS / number_of_shards;
+                for(auto index = shard * sections; index < (shard + 1U) * sections; ++index)
+                {
+                    add_section(shards[shard], index);
+                }
+            });
+        }
+
+        for(auto& builder : builders)
+        {
+            builder.join();
+        }
+
+        const Network network(std::move(shards));
+        benchmark::DoNotOptimize(network.get_number_of_entities());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * NUMBER_OF_SECTIONS);
+}
+BENCHMARK(BM_ShardedConstruction)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
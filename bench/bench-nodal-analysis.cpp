@@ -0,0 +1,72 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+
+#include <complex>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr std::size_t BRANCHING_FACTOR = 4U;
+    constexpr auto SEED = 11U;
+
+    /**
+     * \brief Sums every contribution, so only the stamping itself is timed
+     */
+    std::complex<double> stamp_all(const Nodal_Analysis& analysis, const double frequency)
+    {
+        std::complex<double> sum = 0.0;
+        analysis.for_each_stamp(frequency, [&](const std::size_t, const std::size_t,
+                                               const std::complex<double>& value)
+        {
+            sum += value;
+        });
+
+        return sum;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Stamps a new frequency every time, so every impedance is evaluated
+ *************************************************************************************************/
+static void BM_StampNewFrequency(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)),
+                                           BRANCHING_FACTOR, SEED);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+
+    auto frequency = ANGULAR_FREQUENCY;
+    for(auto _ : state)
+    {
+        frequency += 1.0;
+        benchmark::DoNotOptimize(stamp_all(analysis, frequency));
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_StampNewFrequency)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+/**********************************************************************************************//**
+ * \brief Stamps the same few operating frequencies over and over, served from the table
+ *************************************************************************************************/
+static void BM_StampRepeatedFrequency(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)),
+                                           BRANCHING_FACTOR, SEED);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+
+    std::size_t harmonic = 0U;
+    for(auto _ : state)
+    {
+        harmonic = (harmonic % 3U) + 1U;
+        benchmark::DoNotOptimize(stamp_all(analysis, static_cast<double>(harmonic) * ANGULAR_FREQUENCY));
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_StampRepeatedFrequency)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,66 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/component.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nonlinear_analysis.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    void connect(Network& network, const uint32_t first, const uint32_t second,
+                 std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+    }
+
+    /**
+     * \brief A resistive ladder with a diode from every rung to the ground
+     */
+    uint32_t build_diode_ladder(Network& network, const std::size_t number_of_sections)
+    {
+        const auto ground = network.create_node();
+        auto previous = network.create_node();
+        connect(network, previous, ground, std::make_unique<Voltage_Source>(10.0));
+
+        for(std::size_t section = 0U; section < number_of_sections; ++section)
+        {
+            const auto rung = network.create_node();
+            connect(network, previous, rung, std::make_unique<Resistor>(100.0_ohm));
+            connect(network, rung, ground, std::make_unique<Diode>());
+            connect(network, rung, ground, std::make_unique<Resistor>(10.0_kohm));
+            previous = rung;
+        }
+
+        return ground;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Operating point of a diode ladder, reusing factorizations (1) or with full Newton (0)
+ *************************************************************************************************/
+static void BM_DiodeLadder(benchmark::State& state)
+{
+    Network network;
+    const auto ground = build_diode_ladder(network, static_cast<std::size_t>(state.range(0)));
+
+    Nonlinear_Options options;
+    options.reuse_jacobian = (state.range(1) != 0);
+    const Nonlinear_Analysis analysis(network, ground, options);
+
+    Nonlinear_Result result{};
+    for(auto _ : state)
+    {
+        result = analysis.solve();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["iterations"] = result.iterations;
+    state.counters["factorizations"] = result.factorizations;
+}
+BENCHMARK(BM_DiodeLadder)->Args({ 50, 0 })->Args({ 50, 1 })->Args({ 200, 0 })->Args({ 200, 1 })
+                         ->Unit(benchmark::kMillisecond);
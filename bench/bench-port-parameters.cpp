@@ -0,0 +1,70 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/matrix.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/port_parameters.h"
+
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 1234U;
+    constexpr auto NUMBER_OF_NODES = 400U;
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+
+    std::vector<Port> make_ports(const Network& network, const uint32_t ground, const std::size_t count)
+    {
+        const auto& nodes = network.get_node_uids();
+
+        std::vector<Port> ports;
+        for(std::size_t index = 0U; index < count; ++index)
+        {
+            ports.push_back({ nodes[1U + ((index * 37U) % (nodes.size() - 1U))], ground });
+        }
+
+        return ports;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Z parameters with one factorization and one block solve for every port
+ *************************************************************************************************/
+static void BM_ImpedanceBlock(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, NUMBER_OF_NODES, 4U, SEED);
+    const Port_Analysis analysis(network, circuit.ground_uid,
+                                 make_ports(network, circuit.ground_uid, static_cast<std::size_t>(state.range(0))));
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(analysis.get_impedance_matrix(ANGULAR_FREQUENCY));
+    }
+}
+BENCHMARK(BM_ImpedanceBlock)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief The same columns solved one right hand side at a time, as separate nodal solves would
+ *************************************************************************************************/
+static void BM_ImpedanceColumns(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, NUMBER_OF_NODES, 4U, SEED);
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+    const auto number_of_ports = static_cast<std::size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        const LU_Factorization<std::complex<double>> factorization(analysis.assemble_matrix(ANGULAR_FREQUENCY));
+        for(std::size_t port = 0U; port < number_of_ports; ++port)
+        {
+            std::vector<std::complex<double>> excitation(analysis.get_system_size(), 0.0);
+            excitation[(port * 37U) % analysis.get_node_uids().size()] = 1.0;
+            benchmark::DoNotOptimize(factorization.solve(excitation));
+        }
+    }
+}
+BENCHMARK(BM_ImpedanceColumns)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
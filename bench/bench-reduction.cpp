@@ -0,0 +1,34 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/reduction.h"
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 1234U;
+}
+
+/**********************************************************************************************//**
+ * \brief Reducing a square resistor grid between opposite corners, which takes a delta-wye or
+ *        wye-delta step for most nodes
+ *************************************************************************************************/
+static void BM_ReduceGrid(benchmark::State& state)
+{
+    const auto side = static_cast<std::size_t>(state.range(0));
+
+    Network network;
+    const auto circuit = generate_grid(network, side, side, 1U, SEED);
+    const auto nodes = network.get_node_uids();
+    network.destroy_entity(circuit.source_uid);
+    const auto compiled = network.compile();
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(reduce_impedance(*compiled, nodes[1], nodes.back()));
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * circuit.number_of_nodes));
+}
+BENCHMARK(BM_ReduceGrid)->Arg(10)->Arg(20)->Arg(40)->Arg(80)->Unit(benchmark::kMillisecond);
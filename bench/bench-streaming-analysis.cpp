@@ -0,0 +1,47 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/streaming_analysis.h"
+
+#include <chrono>
+#include <cmath>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto TIME_STEP = 1.0e-7;
+    constexpr auto SEED = 13U;
+}
+
+/**********************************************************************************************//**
+ * \brief One time step of an RLC tree driven by a sine, with the per step latency percentiles
+ *        reported as counters, in nanoseconds
+ *************************************************************************************************/
+static void BM_StreamingStep(benchmark::State& state)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, static_cast<std::size_t>(state.range(0)), 4U, SEED);
+    Streaming_Analysis analysis(network, circuit.ground_uid, TIME_STEP, { circuit.source_uid },
+                                { network.get_node_uids().back() });
+
+    std::vector<double> sample(1U);
+    std::vector<double> output(1U);
+    auto& histogram = analysis.get_latency_histogram();
+    for(auto _ : state)
+    {
+        sample[0] = std::sin(analysis.get_time() * 1.0e5);
+
+        const auto start = std::chrono::steady_clock::now();
+        analysis.step(sample, output);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.counters["p50_ns"] = static_cast<double>(histogram.get_percentile(0.5));
+    state.counters["p99_ns"] = static_cast<double>(histogram.get_percentile(0.99));
+    state.counters["max_ns"] = static_cast<double>(histogram.get_maximum());
+}
+BENCHMARK(BM_StreamingStep)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
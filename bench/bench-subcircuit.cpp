@@ -0,0 +1,113 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/component.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/subcircuit.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr std::size_t RUNGS_PER_BLOCK = 16U;
+
+    void connect(Network& network, const uint32_t first, const uint32_t second,
+                 std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+    }
+
+    /**
+     * \brief An RC ladder of RUNGS_PER_BLOCK sections from input to output, shunted to reference
+     */
+    void add_block(Network& network, const uint32_t reference, const uint32_t input, const uint32_t output)
+    {
+        auto previous = input;
+        for(std::size_t rung = 0U; rung < RUNGS_PER_BLOCK; ++rung)
+        {
+            const auto next = (rung + 1U == RUNGS_PER_BLOCK) ? output : network.create_node();
+            connect(network, previous, next, std::make_unique<Resistor>(100.0_ohm));
+            connect(network, next, reference, std::make_unique<Capacitor>(100.0_nF));
+            previous = next;
+        }
+    }
+
+    /**
+     * \brief A source driving a chain of blocks, instanced when a definition is provided and
+     *        flattened otherwise
+     */
+    uint32_t build_chain(Network& network, const std::size_t number_of_blocks,
+                         const std::shared_ptr<const Subcircuit_Definition>& definition,
+                         std::vector<Subcircuit_Instance>& instances)
+    {
+        const auto ground = network.create_node();
+        auto previous = network.create_node();
+        connect(network, previous, ground, std::make_unique<Voltage_Source>(1.0));
+
+        for(std::size_t block = 0U; block < number_of_blocks; ++block)
+        {
+            const auto next = network.create_node();
+            if(definition)
+            {
+                instances.push_back({ definition, { ground, previous, next } });
+            }
+            else
+            {
+                add_block(network, ground, previous, next);
+            }
+            previous = next;
+        }
+
+        connect(network, previous, ground, std::make_unique<Resistor>(1.0_kohm));
+        return ground;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief A chain of repeated blocks solved flattened, as one dense MNA system
+ *************************************************************************************************/
+static void BM_FlattenedBlocks(benchmark::State& state)
+{
+    Network network;
+    std::vector<Subcircuit_Instance> instances;
+    const auto ground = build_chain(network, static_cast<std::size_t>(state.range(0)), nullptr, instances);
+    const Nodal_Analysis analysis(network, ground);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(analysis.solve(ANGULAR_FREQUENCY));
+    }
+}
+BENCHMARK(BM_FlattenedBlocks)->Arg(8)->Arg(32)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief The same chain with every block instanced, each solve rebuilding the definition so the
+ *        elimination is counted
+ *************************************************************************************************/
+static void BM_HierarchicalBlocks(benchmark::State& state)
+{
+    Network body;
+    const auto reference = body.create_node();
+    const auto input = body.create_node();
+    const auto output = body.create_node();
+    add_block(body, reference, input, output);
+
+    for(auto _ : state)
+    {
+        const auto definition = std::make_shared<const Subcircuit_Definition>(
+            body, std::vector<uint32_t>{ reference, input, output });
+
+        Network network;
+        std::vector<Subcircuit_Instance> instances;
+        const auto ground = build_chain(network, static_cast<std::size_t>(state.range(0)), definition, instances);
+
+        const Hierarchical_Analysis analysis(network, ground, instances);
+        benchmark::DoNotOptimize(analysis.solve(ANGULAR_FREQUENCY));
+    }
+}
+BENCHMARK(BM_HierarchicalBlocks)->Arg(8)->Arg(32)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+#include "benchmark/benchmark.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/matrix.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/superposition.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr std::size_t NUMBER_OF_NODES = 200U;
+    constexpr std::size_t NUMBER_OF_SOURCES = 8U;
+    constexpr auto SEED = 17U;
+
+    /**
+     * \brief An RLC tree with extra sources hung off it through resistors, each driven at every
+     *        one of the first range(0) harmonics
+     */
+    std::vector<Source_Excitation> build_harmonic_network(Network& network, uint32_t& ground,
+                                                          const std::size_t number_of_harmonics)
+    {
+        const auto circuit = generate_rlc_tree(network, NUMBER_OF_NODES, 4U, SEED);
+        ground = circuit.ground_uid;
+
+        std::vector<uint32_t> sources = { circuit.source_uid };
+        const auto node_uids = network.get_node_uids();
+        for(std::size_t source = 1U; source < NUMBER_OF_SOURCES; ++source)
+        {
+            const auto terminal = network.create_node();
+            const auto branch = network.create_branch(std::make_unique<Voltage_Source>(0.0));
+            network.create_connection_between(terminal, branch);
+            network.create_connection_between(ground, branch);
+
+            const auto feed = network.create_branch(std::make_unique<Resistor>(100.0_ohm));
+            network.create_connection_between(terminal, feed);
+            network.create_connection_between(node_uids[(source * 37U) % node_uids.size()], feed);
+            sources.emplace_back(branch);
+        }
+
+        std::vector<Source_Excitation> excitations;
+        for(std::size_t harmonic = 1U; harmonic <= number_of_harmonics; ++harmonic)
+        {
+            for(const auto source : sources)
+            {
+                excitations.push_back({ source, 1.0 / static_cast<double>(harmonic),
+                                        static_cast<double>(harmonic) * ANGULAR_FREQUENCY });
+            }
+        }
+
+        return excitations;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief One assembly, factorization and solve per excitation
+ *************************************************************************************************/
+static void BM_SuperpositionPerSource(benchmark::State& state)
+{
+    Network network;
+    uint32_t ground = 0U;
+    const auto excitations = build_harmonic_network(network, ground, static_cast<std::size_t>(state.range(0)));
+    const Superposition_Analysis superposition(network, ground);
+    const auto& analysis = superposition.get_nodal_analysis();
+
+    for(auto _ : state)
+    {
+        for(const auto& excitation : excitations)
+        {
+            const auto single = superposition.solve({ excitation });
+            benchmark::DoNotOptimize(single);
+        }
+    }
+    state.counters["unknowns"] = static_cast<double>(analysis.get_system_size());
+}
+BENCHMARK(BM_SuperpositionPerSource)->Arg(1)->Arg(5)->Unit(benchmark::kMillisecond);
+
+/**********************************************************************************************//**
+ * \brief Every excitation at once, one factorization per harmonic
+ *************************************************************************************************/
+static void BM_SuperpositionGrouped(benchmark::State& state)
+{
+    Network network;
+    uint32_t ground = 0U;
+    const auto excitations = build_harmonic_network(network, ground, static_cast<std::size_t>(state.range(0)));
+    const Superposition_Analysis superposition(network, ground);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(superposition.solve(excitations, state.range(1) != 0));
+    }
+}
+BENCHMARK(BM_SuperpositionGrouped)->Args({ 1, 0 })->Args({ 5, 0 })->Args({ 5, 1 })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,122 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "matrix.h"
+#include "nodal_analysis.h"
+#include "reduction.h"
+#include "structural_hash.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Remembers analysis results by the Structural_Hash of the network they came from, so a
+ *        network that is submitted again, however it is numbered, is answered without any
+ *        numeric work.
+ *
+ *        Results are stored against the colours of the Structural_Hash's stable colouring
+ *        rather than UIDs and are mapped back onto the UIDs of whichever network asks. Refined
+ *        until stable, repeated structure such as the links of a chain still gets colours of
+ *        its own. A solution in which two nodes (or branches) share a label but not a value
+ *        can't be mapped back like that, so it is returned but not kept.
+ *
+ *        The hash only finds a candidate. Each entry also keeps a fingerprint of the network it
+ *        came from, and a candidate whose fingerprint differs is a miss. For solutions and
+ *        reductions the fingerprint is the Structural_Hash's stable colouring with the ground
+ *        or ports in roles, which the hash refines once per change to the network, and is
+ *        compared exactly rather than by hash. For factorizations the fingerprint is the
+ *        analysis's element list, which fixes the matrix exactly.
+ *
+ *        The least recently used entry is evicted once capacity is reached. Given a directory,
+ *        solutions and reductions are also written there, one file per entry, and a request
+ *        that misses in memory looks there before computing. The disk is best effort: a file
+ *        that can't be written is skipped and one that can't be read is a miss. Factorizations
+ *        depend on the unknown ordering as well as the structure and are only kept in memory.
+ *
+ *        Lookups and insertions are serialised by a mutex, the analyses themselves run outside
+ *        it. A Structural_Hash is not itself thread safe, so each thread needs its own.
+ *************************************************************************************************/
+class Analysis_Cache
+{
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 256U;
+
+    explicit Analysis_Cache(std::size_t capacity = DEFAULT_CAPACITY, const std::string& directory = "");
+    virtual ~Analysis_Cache() = default;
+
+    Nodal_Solution solve(Structural_Hash& structure, uint32_t ground_uid, double frequency = 0.0);
+
+    Reduction_Result reduce(Structural_Hash& structure, uint32_t first_port_uid,
+                            uint32_t second_port_uid, double frequency = 0.0,
+                            const Reduction_Options& options = {});
+
+    // The factorization of analysis's MNA matrix, which must describe structure's network
+    std::shared_ptr<const LU_Factorization<std::complex<double>>> factorize(Structural_Hash& structure,
+                                                                           const Nodal_Analysis& analysis,
+                                                                           double frequency);
+
+    void clear();
+
+    std::size_t get_size() const;
+    std::size_t get_capacity() const;
+    std::size_t get_number_of_hits() const;
+    std::size_t get_number_of_disk_hits() const;
+    std::size_t get_number_of_misses() const;
+
+private:
+    using Labelled_Values = std::vector<std::pair<uint64_t, std::complex<double>>>;
+    using Fingerprint = std::vector<uint64_t>;
+
+    struct Canonical_Solution
+    {
+        Labelled_Values node_voltages;
+        Labelled_Values branch_currents;
+    };
+
+    using Factorization = std::shared_ptr<const LU_Factorization<std::complex<double>>>;
+    using Entry = std::variant<Canonical_Solution, Reduction_Result, Factorization>;
+
+    struct Slot
+    {
+        Entry entry;
+        Fingerprint fingerprint;
+        std::list<uint64_t>::iterator position;
+    };
+
+    bool find(uint64_t key, const Fingerprint& fingerprint, Entry& entry);
+    void insert(uint64_t key, const Fingerprint& fingerprint, const Entry& entry);
+    void remember(uint64_t key, const Fingerprint& fingerprint, const Entry& entry);
+
+    bool load(uint64_t key, const Fingerprint& fingerprint, Entry& entry) const;
+    void store(uint64_t key, const Fingerprint& fingerprint, const Entry& entry) const;
+    std::string path_of(uint64_t key) const;
+
+    std::size_t capacity;
+    std::string directory;
+
+    // Most recently used at the front
+    std::list<uint64_t> order;
+    std::unordered_map<uint64_t, Slot> entries;
+
+    std::size_t number_of_hits;
+    std::size_t number_of_disk_hits;
+    std::size_t number_of_misses;
+
+    mutable std::mutex mutex;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef ASYNC_ANALYSIS_H
+#define ASYNC_ANALYSIS_H
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stop_token>
+#include <vector>
+
+#include "compiled_network.h"
+#include "executor.h"
+#include "nodal_analysis.h"
+#include "reduction.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Submit-style front ends for the analyses. Each takes shared ownership of the compiled
+ *        view so the caller can drop the Network while work is in flight, and returns a future.
+ *        A stopped token turns any work that hasn't started yet into a future holding a
+ *        Cancelled_Operation_Exception.
+ *************************************************************************************************/
+std::future<Nodal_Solution> solve_async(std::shared_ptr<const Compiled_Network> network,
+                                        uint32_t ground_uid,
+                                        double frequency = 0.0,
+                                        std::stop_token token = {},
+                                        Executor& executor = Executor::get_shared());
+
+/**********************************************************************************************//**
+ * \brief Solves every frequency of a sweep as its own task. Results are in the order of the
+ *        frequencies given.
+ *************************************************************************************************/
+std::future<std::vector<Nodal_Solution>> sweep_async(std::shared_ptr<const Compiled_Network> network,
+                                                     uint32_t ground_uid,
+                                                     std::vector<double> frequencies,
+                                                     std::stop_token token = {},
+                                                     Executor& executor = Executor::get_shared());
+
+/**********************************************************************************************//**
+ * \brief Reduces the impedance between two ports, see reduce_impedance
+ *************************************************************************************************/
+std::future<Reduction_Result> reduce_async(std::shared_ptr<const Compiled_Network> network,
+                                           uint32_t first_port_uid,
+                                           uint32_t second_port_uid,
+                                           double frequency = 0.0,
+                                           Reduction_Options options = {},
+                                           std::stop_token token = {},
+                                           Executor& executor = Executor::get_shared());
+
+} // namespace Circlyzer
+
+#endif
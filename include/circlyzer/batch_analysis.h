@@ -0,0 +1,63 @@
+#ifndef BATCH_ANALYSIS_H
+#define BATCH_ANALYSIS_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "network.h"
+#include "nodal_analysis.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Structure of arrays table of component values. Each column is keyed by branch UID and
+ *        holds that branch's value (resistance, capacitance, inductance or source voltage) for
+ *        every instance. Branches without a column keep their value from the Network.
+ *************************************************************************************************/
+struct Batch_Table
+{
+    std::size_t number_of_instances = 0U;
+    std::map<uint32_t, std::vector<std::complex<double>>> columns;
+};
+
+/**********************************************************************************************//**
+ * \brief Node voltages for every instance, one column per node UID
+ *************************************************************************************************/
+struct Batch_Solution
+{
+    std::size_t number_of_instances = 0U;
+    std::map<uint32_t, std::vector<std::complex<double>>> node_voltages;
+};
+
+/**********************************************************************************************//**
+ * \brief Solves many instances of one topology at once. Instances are packed LANES at a time,
+ *        one per SIMD lane, with the real and imaginary planes of every matrix entry stored
+ *        contiguously across lanes so the elimination loops vectorize.
+ *
+ *        The pivot order is taken from a partial pivoting factorization of the nominal Network
+ *        values and shared by every lane, so index arithmetic is done once per block rather than
+ *        once per instance. Instances whose values make a statically chosen pivot vanish are
+ *        reported through Singular_Matrix_Exception.
+ *************************************************************************************************/
+class Batch_Analysis
+{
+public:
+    static constexpr std::size_t LANES = 8U;
+
+    Batch_Analysis(const Compiled_Network& network, uint32_t ground_uid);
+    Batch_Analysis(const Network& network, uint32_t ground_uid);
+    virtual ~Batch_Analysis() = default;
+
+    Batch_Solution solve(const Batch_Table& table, double frequency = 0.0) const;
+
+private:
+    Nodal_Analysis analysis;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef BRANCH_QUANTITIES_H
+#define BRANCH_QUANTITIES_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "compiled_network.h"
+#include "nodal_analysis.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Every branch's voltage drop, current and complex power after a solve, in one pass.
+ *
+ *        The branches are laid out once, on construction, in flat arrays indexed like the
+ *        Compiled_Network: terminal slots, the unknown carrying the branch current for voltage
+ *        sources and inductors, and the conductance and capacitance of each branch, zero where
+ *        the branch has none. evaluate() then gathers the terminal voltages and runs the
+ *        arithmetic over contiguous doubles, with no lookups, branches or virtual calls, which
+ *        leaves it to the compiler to vectorize.
+ *
+ *        Voltages are the first terminal's less the second's, currents flow from the first
+ *        terminal to the second, as in Nodal_Solution, and the power V I* is the power absorbed.
+ *        Diodes, which are open circuits to the linear system, and branches without two
+ *        terminals report zero current. The spans remain valid until the next evaluate().
+ *
+ * \note  The Nodal_Analysis must have been built from the same Compiled_Network.
+ *************************************************************************************************/
+class Branch_Quantities
+{
+public:
+    Branch_Quantities(const Compiled_Network& network, const Nodal_Analysis& analysis);
+    virtual ~Branch_Quantities() = default;
+
+    // From the unknowns of the analysis' system, as solved from assemble_matrix
+    void evaluate(const std::vector<std::complex<double>>& unknowns, double frequency);
+    void evaluate(const Nodal_Solution& solution, double frequency);
+
+    std::span<const std::complex<double>> get_voltages() const;
+    std::span<const std::complex<double>> get_currents() const;
+    std::span<const std::complex<double>> get_powers() const;
+
+    std::span<const uint32_t> get_branch_uids() const;
+    std::size_t get_number_of_branches() const;
+
+private:
+    static constexpr auto NO_UNKNOWN = std::numeric_limits<uint32_t>::max();
+
+    void compute(double frequency);
+
+    std::vector<uint32_t> node_uids;
+    std::vector<uint32_t> branch_uids;
+
+    // Unknown index of each node, NO_UNKNOWN for the ground
+    std::vector<uint32_t> node_unknowns;
+
+    // Per branch, indexed like the Compiled_Network. Terminal slots index potentials, whose
+    // trailing entry is a permanent zero for the ground and unconnected terminals.
+    std::vector<uint32_t> first;
+    std::vector<uint32_t> second;
+    std::vector<uint32_t> current_unknowns;
+    std::vector<double> conductances;
+    std::vector<double> capacitances;
+
+    std::vector<std::complex<double>> potentials;
+    std::vector<std::complex<double>> voltages;
+    std::vector<std::complex<double>> currents;
+    std::vector<std::complex<double>> powers;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef COMPILED_NETWORK_H
+#define COMPILED_NETWORK_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "component.h"
+
+namespace Circlyzer
+{
+class Network;
+
+/**********************************************************************************************//**
+ * \brief Read-only snapshot of a Network laid out for analysis passes.
+ *
+ *        Nodes and branches are renumbered densely, in UID order, starting from 0. Each branch has
+ *        two terminal slots holding node indices (NO_NODE where a terminal is unconnected), and
+ *        the node to branch incidence is stored in compressed sparse row form. Component types
+ *        and values live in flat arrays indexed by branch: the resistance, capacitance,
+ *        inductance or source voltage.
+ *
+ *        Nothing is mutable after construction, so one compiled view can be shared between
+ *        threads without locking. Build one through Network::compile().
+ *************************************************************************************************/
+class Compiled_Network
+{
+public:
+    static constexpr auto NO_NODE = std::numeric_limits<uint32_t>::max();
+    static constexpr std::size_t TERMINALS_PER_BRANCH = 2U;
+
+    explicit Compiled_Network(const Network& network);
+    virtual ~Compiled_Network() = default;
+
+    std::size_t get_number_of_nodes() const;
+    std::size_t get_number_of_branches() const;
+
+    // Dense index <-> UID translation
+    uint32_t get_node_uid(uint32_t node_index) const;
+    uint32_t get_branch_uid(uint32_t branch_index) const;
+    uint32_t get_node_index(uint32_t uid) const;
+    uint32_t get_branch_index(uint32_t uid) const;
+
+    // Incidence
+    std::span<const uint32_t> get_terminals(uint32_t branch_index) const;
+    std::span<const uint32_t> get_incident_branches(uint32_t node_index) const;
+    bool is_connected(uint32_t branch_index) const;
+
+    const std::string& get_node_alias(uint32_t node_index) const;
+    const std::string& get_branch_alias(uint32_t branch_index) const;
+
+    // Flat component data
+    std::span<const Component_Type> get_types() const;
+    std::span<const std::complex<double>> get_values() const;
+
+    const std::vector<uint32_t>& get_node_uids() const;
+    const std::vector<uint32_t>& get_branch_uids() const;
+    const std::vector<uint32_t>& get_node_offsets() const;
+    const std::vector<uint32_t>& get_node_branches() const;
+
+    // Journal sequence of the Network at the time of compilation
+    uint64_t get_sequence() const;
+
+private:
+    std::vector<uint32_t> node_uids;
+    std::vector<uint32_t> branch_uids;
+    std::vector<std::string> node_aliases;
+    std::vector<std::string> branch_aliases;
+
+    std::vector<uint32_t> branch_terminals;
+    std::vector<uint32_t> node_offsets;
+    std::vector<uint32_t> node_branches;
+
+    std::vector<Component_Type> types;
+    std::vector<std::complex<double>> values;
+
+    uint64_t sequence;
+};
+
+/**********************************************************************************************//**
+ * \brief The value that defines a component: resistance, capacitance, inductance or voltage. A
+ *        diode carries its saturation current in the real part and n Vt in the imaginary part.
+ *************************************************************************************************/
+std::complex<double> get_component_value(const Component& component);
+
+} // namespace Circlyzer
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef COMPONENT_H
 #define COMPONENT_H
 
+#include <cmath>
 #include <complex>
+#include <cstdint>
 
 namespace Circlyzer
 {
@@ -11,7 +13,8 @@ enum class Component_Type : uint32_t
     Resistor,
     Capacitor,
     Inductor,
-    Voltage_Source
+    Voltage_Source,
+    Diode
 };
 
 struct Component
@@ -48,6 +51,15 @@ struct Resistor : Component
 
 struct Capacitor : Component
 {
+    Capacitor(const double capacitance) :
+        Component(Component_Type::Capacitor),
+        capacitance(capacitance)
+    {
+
+    }
+
+    virtual ~Capacitor() = default;
+
     double capacitance;
 
     std::complex<double> get_impedence(const double frequency) const
@@ -59,6 +71,15 @@ struct Capacitor : Component
 
 struct Inductor : Component
 {
+    Inductor(const double inductance) :
+        Component(Component_Type::Inductor),
+        inductance(inductance)
+    {
+
+    }
+
+    virtual ~Inductor() = default;
+
     double inductance;
 
     std::complex<double> get_impedence(const double frequency) const
@@ -70,9 +91,53 @@ struct Inductor : Component
 
 struct Voltage_Source : Component
 {
+    Voltage_Source(const std::complex<double> voltage) :
+        Component(Component_Type::Voltage_Source),
+        voltage(voltage)
+    {
+
+    }
+
+    virtual ~Voltage_Source() = default;
+
     std::complex<double> voltage;
 };
 
+/**********************************************************************************************//**
+ * \brief Shockley junction diode, conducting from its first terminal (the anode) to its second
+ *        (the cathode). The default thermal voltage is kT/q at 300 K. Being nonlinear, it is
+ *        only solved by Nonlinear_Analysis, the linear analyses treat it as an open circuit.
+ *************************************************************************************************/
+struct Diode : Component
+{
+    Diode(const double saturation_current = 1.0e-14, const double emission_coefficient = 1.0,
+          const double thermal_voltage = 25.852e-3) :
+        Component(Component_Type::Diode),
+        saturation_current(saturation_current),
+        emission_coefficient(emission_coefficient),
+        thermal_voltage(thermal_voltage)
+    {
+
+    }
+
+    virtual ~Diode() = default;
+
+    double saturation_current;
+    double emission_coefficient;
+    double thermal_voltage;
+
+    double get_current(const double voltage) const
+    {
+        return saturation_current * std::expm1(voltage / (emission_coefficient * thermal_voltage));
+    }
+
+    double get_conductance(const double voltage) const
+    {
+        const auto scale = emission_coefficient * thermal_voltage;
+        return (saturation_current / scale) * std::exp(voltage / scale);
+    }
+};
+
 } // namespace Circlyzer
 
 #endif
\ No newline at end of file
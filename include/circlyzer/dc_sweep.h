@@ -0,0 +1,79 @@
+#ifndef DC_SWEEP_H
+#define DC_SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "compiled_network.h"
+#include "executor.h"
+#include "matrix.h"
+#include "network.h"
+
+namespace Circlyzer
+{
+
+// Writes the next sweep point, one value per swept source, or returns false once there are no more
+using Point_Source = std::function<bool(std::span<double> point)>;
+
+// Receives one sweep point: its index and the voltage of each probe, valid only during the call
+using Sweep_Sink = std::function<void(std::size_t point, std::span<const double> probe_voltages)>;
+
+/**********************************************************************************************//**
+ * \brief DC sweep of voltage source values.
+ *
+ *        Only the excitation changes from one point to the next, so the DC system is assembled
+ *        and factorized once, on construction. The points are solved in blocks of columns, each
+ *        block a single multi right hand side substitution through the factors, and the blocks
+ *        run in parallel on the executor. Blocks are taken a wave at a time, one per worker,
+ *        and every wave is handed to the sink before the next is solved. The points are pulled
+ *        from the Point_Source a wave at a time too, on the calling thread, so memory stays
+ *        bounded by the wave however many points the sweep has. They can also be given as one
+ *        flat span, point after point.
+ *
+ *        Each point gives one value per swept source, in the order of source_uids. Voltage
+ *        sources that aren't swept hold their value. The sink is called on the calling thread,
+ *        once per point, in point order, with the voltage of each probed node in the order of
+ *        probe_uids.
+ *
+ * \note  Throws Invalid_Sweep_Exception for a swept UID that isn't a connected voltage source or
+ *        flat points that aren't a whole number of points, the latter before anything is solved,
+ *        Non_Existant_UID_Exception for a probe that isn't a node, and Singular_Matrix_Exception
+ *        for a circuit without a DC solution.
+ *************************************************************************************************/
+class DC_Sweep
+{
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 32U;
+
+    DC_Sweep(const Compiled_Network& network, uint32_t ground_uid,
+             const std::vector<uint32_t>& source_uids, const std::vector<uint32_t>& probe_uids);
+    DC_Sweep(const Network& network, uint32_t ground_uid,
+             const std::vector<uint32_t>& source_uids, const std::vector<uint32_t>& probe_uids);
+    virtual ~DC_Sweep() = default;
+
+    void run(const Point_Source& points, const Sweep_Sink& sink,
+             std::size_t block_size = DEFAULT_BLOCK_SIZE,
+             Executor& executor = Executor::get_shared()) const;
+    void run(std::span<const double> points, const Sweep_Sink& sink,
+             std::size_t block_size = DEFAULT_BLOCK_SIZE,
+             Executor& executor = Executor::get_shared()) const;
+
+    std::size_t get_number_of_sources() const;
+    std::size_t get_number_of_probes() const;
+    std::size_t get_system_size() const;
+
+private:
+    LU_Factorization<double> factorization;
+
+    // Right hand side with the sources that aren't swept
+    std::vector<double> base_excitation;
+    std::vector<std::size_t> source_rows;
+    std::vector<std::size_t> probe_indices;
+};
+
+} // namespace Circlyzer
+
+#endif
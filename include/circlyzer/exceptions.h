@@ -55,6 +55,152 @@ class Null_Component_Exception : public std::exception
     }
 };
 
+class Singular_Matrix_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "The network could not be solved, check for floating nodes or source loops";
+    }
+};
+
+class Invalid_Batch_Table_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide one value per instance in every batch table column";
+    }
+};
+
+class Compacted_Journal_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please rebuild, the requested changes have been compacted out of the journal";
+    }
+};
+
+class Cancelled_Operation_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "The operation was cancelled before it completed";
+    }
+};
+
+class Executor_Already_Running_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please configure the shared executor before it is first used";
+    }
+};
+
+class Export_Failed_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "The export destination could not be written to";
+    }
+};
+
+class Invalid_Generator_Size_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please request a generated network with at least one driven node";
+    }
+};
+
+class Invalid_Transform_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide branches of one passive type forming a triangle or star";
+    }
+};
+
+class Degenerate_Transform_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "The transform would divide by zero, as for a triangle that resonates";
+    }
+};
+
+class Irreducible_Network_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "The network can't be reduced with the enabled transforms";
+    }
+};
+
+class Invalid_Port_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide distinct ports that are not the ground node";
+    }
+};
+
+class Invalid_Port_Pair_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide ports with two distinct nodes and a positive reference impedance";
+    }
+};
+
+class Invalid_Parameter_Stream_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide a stream of port parameters in the binary format";
+    }
+};
+
+class Invalid_Subcircuit_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide at least two distinct ports per subcircuit, no voltage source between two ports "
+               "and one node per port per instance";
+    }
+};
+
+class Invalid_Streaming_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide a positive time step, at least one streamed source, only voltage sources as streamed "
+               "sources and ring buffers that hold a whole frame";
+    }
+};
+
+class Invalid_Excitation_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide connected voltage sources and finite frequencies as excitations";
+    }
+};
+
+class Stale_Handle_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide a handle to an entity that hasn't been destroyed or compacted since";
+    }
+};
+
+class Invalid_Sweep_Exception : public std::exception
+{
+    const char * what() const throw()
+    {
+        return "Please provide only voltage sources as swept sources and one value per swept source at every point";
+    }
+};
+
 } // Namespace Circlyzer
 
 #endif
@@ -0,0 +1,167 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Work-stealing thread pool shared by the whole library.
+ *
+ *        Each worker owns a deque. Work submitted from a worker goes to the back of its own deque
+ *        and is popped from the back (newest first, which keeps caches warm for nested work),
+ *        while idle workers steal from the front of the others. Work submitted from outside the
+ *        pool is spread round-robin.
+ *
+ *        Every parallel algorithm in the library runs on get_shared() unless given another
+ *        executor, so the library never runs more threads than configure_shared() allowed.
+ *************************************************************************************************/
+class Executor
+{
+public:
+    explicit Executor(std::size_t number_of_workers = 0U);
+    virtual ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    static Executor& get_shared();
+    static void configure_shared(std::size_t number_of_workers);
+
+    std::size_t get_number_of_workers() const;
+
+    /**
+     * \brief Runs function on the pool. If the token is stopped before the task starts, the
+     *        future holds a Cancelled_Operation_Exception instead.
+     */
+    template<typename Function>
+    auto submit(std::stop_token token, Function&& function)
+        -> std::future<std::invoke_result_t<std::decay_t<Function>&>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Function>&>;
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            [token = std::move(token), function = std::forward<Function>(function)]() mutable
+            {
+                if(token.stop_requested())
+                {
+                    throw Cancelled_Operation_Exception();
+                }
+
+                return function();
+            });
+
+        auto future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    template<typename Function>
+    auto submit(Function&& function)
+    {
+        return submit(std::stop_token{}, std::forward<Function>(function));
+    }
+
+    /**
+     * \brief Calls function(first, last) over chunks of [begin, end) and blocks until every chunk
+     *        is done. The calling thread runs queued work while it waits, so this is safe to use
+     *        from inside a task without deadlocking the pool. Once there is nothing left to run
+     *        it sleeps until the last chunk finishes or more work is queued.
+     */
+    template<typename Function>
+    void parallel_for(const std::size_t begin, const std::size_t end, Function&& function)
+    {
+        if(begin >= end)
+        {
+            return;
+        }
+
+        const auto count = end - begin;
+        const auto number_of_chunks = std::min(count, get_number_of_workers() * CHUNKS_PER_WORKER);
+        const auto chunk_size = (count + number_of_chunks - 1U) / number_of_chunks;
+
+        std::atomic<std::size_t> remaining{ 0U };
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+
+        for(auto first = begin; first < end; first += chunk_size)
+        {
+            const auto last = std::min(end, first + chunk_size);
+            remaining.fetch_add(1U);
+
+            enqueue([&, first, last]()
+            {
+                try
+                {
+                    function(first, last);
+                }
+                catch(...)
+                {
+                    const std::lock_guard<std::mutex> lock(failure_mutex);
+                    failure = std::current_exception();
+                }
+
+                if(remaining.fetch_sub(1U) == 1U)
+                {
+                    wake_waiters();
+                }
+            });
+        }
+
+        help_while([&]() { return remaining.load() > 0U; });
+
+        if(failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker_Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static constexpr std::size_t CHUNKS_PER_WORKER = 4U;
+
+    void enqueue(Task task);
+    bool try_pop(std::size_t index, Task& task);
+    bool try_steal(std::size_t thief, Task& task);
+    bool try_run_one();
+    void help_while(const std::function<bool()>& predicate);
+    void wake_waiters();
+    void run(std::size_t index);
+
+    std::vector<std::unique_ptr<Worker_Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_condition;
+    std::size_t pending;
+    bool stopping;
+
+    std::atomic<std::size_t> next_queue;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef FIXED_CIRCUIT_H
+#define FIXED_CIRCUIT_H
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "component.h"
+#include "exceptions.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Compile time description of a single two terminal element. Node 0 is always ground.
+ *************************************************************************************************/
+template<Component_Type TYPE, uint32_t FIRST, uint32_t SECOND>
+struct Fixed_Element
+{
+    static_assert(FIRST != SECOND, "An element can't be connected to the same node twice");
+
+    static constexpr Component_Type type = TYPE;
+    static constexpr uint32_t first = FIRST;
+    static constexpr uint32_t second = SECOND;
+};
+
+template<uint32_t FIRST, uint32_t SECOND>
+using Fixed_Resistor = Fixed_Element<Component_Type::Resistor, FIRST, SECOND>;
+
+template<uint32_t FIRST, uint32_t SECOND>
+using Fixed_Capacitor = Fixed_Element<Component_Type::Capacitor, FIRST, SECOND>;
+
+template<uint32_t FIRST, uint32_t SECOND>
+using Fixed_Inductor = Fixed_Element<Component_Type::Inductor, FIRST, SECOND>;
+
+template<uint32_t FIRST, uint32_t SECOND>
+using Fixed_Voltage_Source = Fixed_Element<Component_Type::Voltage_Source, FIRST, SECOND>;
+
+/**********************************************************************************************//**
+ * \brief Modified nodal analysis of a circuit whose topology is fixed at compile time.
+ *
+ *        The same stamping rules as Nodal_Analysis are used, but every index is a constant, every
+ *        loop is unrolled through index sequences and all storage lives in std::arrays. A solve
+ *        never allocates, which makes this suitable for evaluating one small circuit millions of
+ *        times with different component values.
+ *
+ *        Values are given per element, in declaration order: the resistance, capacitance,
+ *        inductance or source voltage. Frequencies are angular (rad/s).
+ *************************************************************************************************/
+template<uint32_t NUMBER_OF_NODES, typename... Elements>
+class Fixed_Circuit
+{
+    static_assert(NUMBER_OF_NODES >= 2U, "A circuit needs a ground node and at least one other");
+    static_assert(NUMBER_OF_NODES <= 16U, "Use Nodal_Analysis for circuits with more nodes");
+    static_assert(((Elements::first < NUMBER_OF_NODES) && ...), "Element node out of range");
+    static_assert(((Elements::second < NUMBER_OF_NODES) && ...), "Element node out of range");
+
+public:
+    static constexpr std::size_t number_of_elements = sizeof...(Elements);
+    static constexpr std::size_t number_of_currents =
+        (0U + ... + (((Elements::type == Component_Type::Voltage_Source) ||
+                      (Elements::type == Component_Type::Inductor)) ? 1U : 0U));
+    static constexpr std::size_t system_size = (NUMBER_OF_NODES - 1U) + number_of_currents;
+
+    using Values = std::array<std::complex<double>, number_of_elements>;
+    using Voltages = std::array<std::complex<double>, NUMBER_OF_NODES>;
+
+    /**
+     * \brief Solves the circuit, returning the voltage of every node relative to node 0
+     */
+    static constexpr Voltages solve(const Values& values, const double frequency = 0.0)
+    {
+        Matrix matrix{};
+        Vector vector{};
+
+        stamp(matrix, vector, values, frequency);
+        eliminate(matrix, vector);
+
+        Voltages voltages{};
+        unroll<1U, NUMBER_OF_NODES>([&](auto node)
+        {
+            voltages[node] = vector[decltype(node)::value - 1U];
+        });
+
+        return voltages;
+    }
+
+private:
+    using Vector = std::array<std::complex<double>, system_size>;
+    using Matrix = std::array<Vector, system_size>;
+
+    static constexpr std::array<Component_Type, number_of_elements> types = { Elements::type... };
+    static constexpr std::array<uint32_t, number_of_elements> firsts = { Elements::first... };
+    static constexpr std::array<uint32_t, number_of_elements> seconds = { Elements::second... };
+
+    /**
+     * \brief Row of each element's current unknown, or 0 for admittance stamped elements
+     */
+    static constexpr std::array<std::size_t, number_of_elements> current_rows = []()
+    {
+        std::array<std::size_t, number_of_elements> rows{};
+        auto next_row = NUMBER_OF_NODES - 1U;
+
+        for(std::size_t index = 0U; index < number_of_elements; ++index)
+        {
+            if((types[index] == Component_Type::Voltage_Source) ||
+               (types[index] == Component_Type::Inductor))
+            {
+                rows[index] = next_row++;
+            }
+        }
+
+        return rows;
+    }();
+
+    template<std::size_t BEGIN, std::size_t... OFFSETS, typename Function>
+    static constexpr void unroll(std::index_sequence<OFFSETS...>, Function&& function)
+    {
+        (function(std::integral_constant<std::size_t, BEGIN + OFFSETS>{}), ...);
+    }
+
+    template<std::size_t BEGIN, std::size_t END, typename Function>
+    static constexpr void unroll(Function&& function)
+    {
+        if constexpr(BEGIN < END)
+        {
+            unroll<BEGIN>(std::make_index_sequence<END - BEGIN>{}, function);
+        }
+    }
+
+    static constexpr double magnitude(const std::complex<double>& value)
+    {
+        const auto real = value.real();
+        const auto imaginary = value.imag();
+        return ((real < 0.0) ? -real : real) + ((imaginary < 0.0) ? -imaginary : imaginary);
+    }
+
+    static constexpr void stamp(Matrix& matrix, Vector& vector, const Values& values,
+                                const double frequency)
+    {
+        unroll<0U, number_of_elements>([&](auto index)
+        {
+            constexpr auto element = decltype(index)::value;
+            constexpr auto type = types[element];
+            constexpr auto first = firsts[element];
+            constexpr auto second = seconds[element];
+
+            if constexpr((type == Component_Type::Resistor) || (type == Component_Type::Capacitor))
+            {
+                const auto admittance = (type == Component_Type::Resistor) ?
+                    (1.0 / values[element]) :
+                    (std::complex<double>{ 0.0, frequency } * values[element]);
+
+                if constexpr(first != 0U)
+                {
+                    matrix[first - 1U][first - 1U] += admittance;
+                }
+
+                if constexpr(second != 0U)
+                {
+                    matrix[second - 1U][second - 1U] += admittance;
+                }
+
+                if constexpr((first != 0U) && (second != 0U))
+                {
+                    matrix[first - 1U][second - 1U] -= admittance;
+                    matrix[second - 1U][first - 1U] -= admittance;
+                }
+            }
+            else
+            {
+                constexpr auto row = current_rows[element];
+
+                if constexpr(first != 0U)
+                {
+                    matrix[first - 1U][row] += 1.0;
+                    matrix[row][first - 1U] += 1.0;
+                }
+
+                if constexpr(second != 0U)
+                {
+                    matrix[second - 1U][row] -= 1.0;
+                    matrix[row][second - 1U] -= 1.0;
+                }
+
+                if constexpr(type == Component_Type::Inductor)
+                {
+                    matrix[row][row] -= std::complex<double>{ 0.0, frequency } * values[element];
+                }
+                else
+                {
+                    vector[row] = values[element];
+                }
+            }
+        });
+    }
+
+    /**
+     * \brief Gaussian elimination with partial pivoting followed by back substitution, leaving
+     *        the solution in vector
+     */
+    static constexpr void eliminate(Matrix& matrix, Vector& vector)
+    {
+        unroll<0U, system_size>([&](auto pivot_index)
+        {
+            constexpr auto pivot = decltype(pivot_index)::value;
+
+            auto best_row = pivot;
+            auto best_magnitude = magnitude(matrix[pivot][pivot]);
+            unroll<pivot + 1U, system_size>([&](auto row)
+            {
+                const auto candidate = magnitude(matrix[row][pivot]);
+                if(candidate > best_magnitude)
+                {
+                    best_row = row;
+                    best_magnitude = candidate;
+                }
+            });
+
+            if(!(best_magnitude > 0.0))
+            {
+                throw Singular_Matrix_Exception();
+            }
+
+            if(best_row != pivot)
+            {
+                std::swap(matrix[pivot], matrix[best_row]);
+                std::swap(vector[pivot], vector[best_row]);
+            }
+
+            const auto inverse_pivot = 1.0 / matrix[pivot][pivot];
+            unroll<pivot + 1U, system_size>([&](auto row)
+            {
+                const auto multiplier = matrix[row][pivot] * inverse_pivot;
+                unroll<pivot + 1U, system_size>([&](auto column)
+                {
+                    matrix[row][column] -= multiplier * matrix[pivot][column];
+                });
+
+                vector[row] -= multiplier * vector[pivot];
+            });
+        });
+
+        unroll<0U, system_size>([&](auto reversed)
+        {
+            constexpr auto row = system_size - 1U - decltype(reversed)::value;
+            unroll<row + 1U, system_size>([&](auto column)
+            {
+                vector[row] -= matrix[row][column] * vector[column];
+            });
+
+            vector[row] /= matrix[row][row];
+        });
+    }
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "network.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief What a generator added to the network. The source is a 1 V voltage source from the
+ *        ground node to the first driven node, so every generated circuit can be solved as is.
+ *************************************************************************************************/
+struct Generated_Circuit
+{
+    uint32_t ground_uid;
+    uint32_t source_uid;
+    std::size_t number_of_nodes;
+    std::size_t number_of_branches;
+};
+
+/**********************************************************************************************//**
+ * \brief Seeded synthetic networks for scale and regression testing.
+ *
+ *        Each generator adds its circuit to the provided Network, which may already hold other
+ *        entities. The same seed always produces the same topology and component values on
+ *        every platform, as the random values are derived from std::mt19937_64 directly rather
+ *        than through the implementation defined standard distributions.
+ *
+ *        Sizes are limited only by memory; a few tens of millions of elements are practical.
+ *************************************************************************************************/
+
+// Series resistor followed by a shunt resistor to ground, repeated once per section
+Generated_Circuit generate_ladder(Network& network, std::size_t number_of_sections,
+                                  uint64_t seed = 0U);
+
+// Resistor mesh of width x height x depth nodes, driven at one corner and loaded to ground at
+// the opposite corner. A depth of one gives a 2D grid.
+Generated_Circuit generate_grid(Network& network, std::size_t width, std::size_t height,
+                                std::size_t depth = 1U, uint64_t seed = 0U);
+
+// Connected random resistor graph. A random spanning tree is laid first, then extra resistors
+// are added between random node pairs until the average degree is reached.
+Generated_Circuit generate_random_sparse(Network& network, std::size_t number_of_nodes,
+                                         double average_degree = 4.0, uint64_t seed = 0U);
+
+// Random tree whose edges are resistors or inductors, with a shunt capacitor to ground at
+// every node. Inductors keep the tree solvable at DC, capacitors make it frequency dependent.
+Generated_Circuit generate_rlc_tree(Network& network, std::size_t number_of_nodes,
+                                    std::size_t maximum_children = 4U, uint64_t seed = 0U);
+
+} // namespace Circlyzer
+
+#endif
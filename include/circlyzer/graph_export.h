@@ -0,0 +1,102 @@
+#ifndef GRAPH_EXPORT_H
+#define GRAPH_EXPORT_H
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "compiled_network.h"
+#include "network.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Fixed size write buffer in front of some destination. Exporters write through this so
+ *        memory use stays at BUFFER_SIZE no matter how large the network is.
+ *************************************************************************************************/
+class Output_Sink
+{
+public:
+    static constexpr std::size_t BUFFER_SIZE = 64U * 1024U;
+
+    Output_Sink();
+    virtual ~Output_Sink() = default;
+
+    void write(std::string_view text);
+    void write(char character);
+    void flush();
+
+protected:
+    virtual void write_through(const char* data, std::size_t size) = 0;
+
+private:
+    std::vector<char> buffer;
+    std::size_t used;
+};
+
+/**********************************************************************************************//**
+ * \brief Writes to an already open POSIX file descriptor, which is left open afterwards
+ *************************************************************************************************/
+class File_Descriptor_Sink : public Output_Sink
+{
+public:
+    explicit File_Descriptor_Sink(int file_descriptor);
+    virtual ~File_Descriptor_Sink();
+
+protected:
+    void write_through(const char* data, std::size_t size) override;
+
+private:
+    int file_descriptor;
+};
+
+/**********************************************************************************************//**
+ * \brief Writes to a std::ostream
+ *************************************************************************************************/
+class Stream_Sink : public Output_Sink
+{
+public:
+    explicit Stream_Sink(std::ostream& stream);
+    virtual ~Stream_Sink();
+
+protected:
+    void write_through(const char* data, std::size_t size) override;
+
+private:
+    std::ostream& stream;
+};
+
+enum class Graph_Format
+{
+    Dot,
+    GraphML
+};
+
+struct Export_Options
+{
+    Graph_Format format = Graph_Format::Dot;
+
+    // Replace chains of passive branches through unaliased two-branch nodes, and passive
+    // branches sharing both end nodes, with one edge labelled by the equivalent impedance
+    bool collapse_series_parallel = false;
+
+    // Angular frequency used for the equivalent impedances of collapsed groups
+    double frequency = 0.0;
+};
+
+/**********************************************************************************************//**
+ * \brief Streams nodes, branches, aliases and component values as a Graphviz DOT or GraphML
+ *        document. Nodes become vertices and connected branches become edges. Branches missing
+ *        a terminal are drawn as box vertices attached to whatever they are connected to.
+ *************************************************************************************************/
+void export_network(const Compiled_Network& network, Output_Sink& sink,
+                    const Export_Options& options = {});
+
+void export_network(const Network& network, Output_Sink& sink,
+                    const Export_Options& options = {});
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef IMPEDANCE_TABLE_H
+#define IMPEDANCE_TABLE_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "compiled_network.h"
+#include "component.h"
+#include "network.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Every branch impedance and admittance at one frequency, indexed like the table's
+ *        get_branch_uids()
+ *************************************************************************************************/
+struct Branch_Impedances
+{
+    std::vector<std::complex<double>> impedances;
+    std::vector<std::complex<double>> admittances;
+};
+
+/**********************************************************************************************//**
+ * \brief Per-network table of branch impedances, cached by angular frequency.
+ *
+ *        Component values are copied into flat arrays grouped by type, so a new frequency is
+ *        evaluated in one pass per type with no map lookups or virtual calls. Each frequency's
+ *        result is kept until it is evicted as the least recently used.
+ *
+ *        Before answering, the table catches up with the network's Journal. It follows the
+ *        network through Network::get_reference, so moving the network is harmless. Once the
+ *        network is destroyed the table keeps the values it last read, like a table built from a
+ *        Compiled_Network. A component swapped
+ *        through Network::update_component refreshes that one value, and only that entry is
+ *        recomputed the next time a cached frequency is requested. Creating or destroying
+ *        branches rebuilds the table.
+ *
+ *        A table built from a Compiled_Network copies its values once and never changes, which is
+ *        how Nodal_Analysis uses it to stamp repeated frequencies without re-evaluating them.
+ *
+ *        Entries follow the order of get_branch_uids(). Voltage sources are ideal and report an
+ *        impedance of zero, while diodes are open circuits to a linear analysis and report an
+ *        infinite one. Admittances are the reciprocals, computed in closed form, so an inductor
+ *        reports an infinite admittance at DC. References returned by get_impedances and
+ *        get_admittances remain valid until the next call that evaluates a new frequency or
+ *        invalidates the whole table. get_values instead shares the frequency's entry, which
+ *        stays valid and unchanged for as long as it is held: later evictions and updates work
+ *        on a copy rather than on an entry still in use.
+ *************************************************************************************************/
+class Impedance_Table
+{
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 16U;
+
+    explicit Impedance_Table(const Network& network, std::size_t capacity = DEFAULT_CAPACITY);
+    explicit Impedance_Table(const Compiled_Network& network, std::size_t capacity = DEFAULT_CAPACITY);
+    virtual ~Impedance_Table() = default;
+
+    const std::vector<std::complex<double>>& get_impedances(double frequency);
+    const std::vector<std::complex<double>>& get_admittances(double frequency);
+    std::shared_ptr<const Branch_Impedances> get_values(double frequency);
+    std::complex<double> get_impedance(uint32_t branch_uid, double frequency);
+
+    void synchronize();
+    void invalidate(uint32_t branch_uid);
+    void invalidate_all();
+
+    const std::vector<uint32_t>& get_branch_uids() const;
+    std::size_t get_number_of_cached_frequencies() const;
+    std::size_t get_number_of_evaluations() const;
+
+private:
+    struct Cached_Frequency
+    {
+        std::shared_ptr<Branch_Impedances> values;
+        std::vector<std::size_t> dirty;
+        uint64_t last_used;
+    };
+
+    Cached_Frequency& look_up(double frequency);
+    void snapshot(const Compiled_Network& compiled);
+    void evaluate(double frequency, Branch_Impedances& entry);
+    void evaluate_entry(std::size_t index, double frequency, Branch_Impedances& entry);
+
+    const Network* get_network() const;
+
+    // Null when the table was built from a Compiled_Network, which has nothing to follow
+    std::shared_ptr<const Network* const> network;
+    std::size_t capacity;
+
+    // Flat copy of the network's branches, indexed like branch_uids
+    std::vector<uint32_t> branch_uids;
+    std::unordered_map<uint32_t, std::size_t> branch_indices;
+    std::vector<Component_Type> types;
+    std::vector<double> values;
+
+    // 1 / value, so that every closed form is a product
+    std::vector<double> reciprocals;
+
+    // Entry indices of each component type for the per type passes
+    std::vector<std::size_t> resistors;
+    std::vector<std::size_t> capacitors;
+    std::vector<std::size_t> inductors;
+    std::vector<std::size_t> sources;
+    std::vector<std::size_t> diodes;
+
+    std::map<double, Cached_Frequency> cache;
+    uint64_t synchronized_sequence;
+    uint64_t clock;
+    std::size_t number_of_evaluations;
+};
+
+} // namespace Circlyzer
+
+#endif
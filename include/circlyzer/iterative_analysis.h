@@ -0,0 +1,111 @@
+#ifndef ITERATIVE_ANALYSIS_H
+#define ITERATIVE_ANALYSIS_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "compiled_network.h"
+#include "executor.h"
+#include "krylov.h"
+#include "network.h"
+#include "nodal_analysis.h"
+#include "sparse_matrix.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Automatic picks Conjugate_Gradient at DC, where the reduced system is the symmetric
+ *        positive definite conductance matrix, and BiCGSTAB otherwise.
+ *************************************************************************************************/
+enum class Iterative_Method
+{
+    Automatic,
+    Conjugate_Gradient,
+    BiCGSTAB,
+    GMRES
+};
+
+/**********************************************************************************************//**
+ * \brief Incomplete_Factorization is ILU(0), which is the zero fill incomplete Cholesky
+ *        factorization whenever the system is Hermitian.
+ *************************************************************************************************/
+enum class Preconditioner_Type
+{
+    None,
+    Jacobi,
+    Incomplete_Factorization
+};
+
+/**********************************************************************************************//**
+ * \brief executor defaults to Executor::get_shared(). Systems with fewer unknowns than
+ *        parallel_threshold multiply on the calling thread, where the pool would cost more than
+ *        it saves.
+ *************************************************************************************************/
+struct Iterative_Options
+{
+    Iterative_Method method = Iterative_Method::Automatic;
+    Preconditioner_Type preconditioner = Preconditioner_Type::Incomplete_Factorization;
+    Krylov_Options krylov;
+    Executor* executor = nullptr;
+    std::size_t parallel_threshold = 16384U;
+};
+
+/**********************************************************************************************//**
+ * \brief solution is filled in even when the solver did not converge, check converged.
+ *************************************************************************************************/
+struct Iterative_Result
+{
+    Nodal_Solution solution;
+    Iterative_Method method;
+    uint32_t iterations;
+    double relative_residual;
+    bool converged;
+};
+
+/**********************************************************************************************//**
+ * \brief Solves the network with a preconditioned Krylov method, for networks too large to
+ *        factorize densely.
+ *
+ *        The MNA current unknowns make the system indefinite, which stalls the incomplete
+ *        factorizations, so they are eliminated before the solve. Every voltage source (and every
+ *        inductor at DC, as a short) ties the voltages at its terminals together, so each group
+ *        of tied nodes is one supernode with a single unknown and a known offset per node. KCL is
+ *        summed over each supernode, leaving only the nodal admittance matrix. At DC that is the
+ *        conductance matrix, which is symmetric positive definite and suits conjugate gradient.
+ *        At other frequencies it is complex symmetric and needs BiCGSTAB or GMRES.
+ *
+ *        The source and inductor currents are recovered afterwards from KCL, working in from the
+ *        leaves of the tree the sources form within each supernode.
+ *
+ * \note  Throws Singular_Matrix_Exception if the voltage sources (or DC inductors) form a loop.
+ *************************************************************************************************/
+class Iterative_Analysis
+{
+public:
+    Iterative_Analysis(const Compiled_Network& network, uint32_t ground_uid,
+                       const Iterative_Options& options = {});
+    Iterative_Analysis(const Network& network, uint32_t ground_uid,
+                       const Iterative_Options& options = {});
+    virtual ~Iterative_Analysis() = default;
+
+    Iterative_Result solve(double frequency = 0.0) const;
+
+    // Building blocks of solve(), with one unknown per supernode not tied to the ground
+    Sparse_Matrix<std::complex<double>> assemble_reduced_matrix(double frequency) const;
+    std::vector<std::complex<double>> assemble_reduced_excitation(double frequency) const;
+    std::size_t get_reduced_size(double frequency) const;
+
+    const Nodal_Analysis& get_nodal_analysis() const;
+    const Iterative_Options& get_options() const;
+
+private:
+    Nodal_Analysis analysis;
+    Iterative_Options options;
+};
+
+} // namespace Circlyzer
+
+#endif
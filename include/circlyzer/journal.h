@@ -0,0 +1,91 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+
+namespace Circlyzer
+{
+
+enum class Change_Type : uint8_t
+{
+    Node_Created,
+    Node_Destroyed,
+    Branch_Created,
+    Branch_Destroyed,
+    Connection_Created,
+    Connection_Deleted,
+    Alias_Updated,
+    Component_Updated
+};
+
+/**********************************************************************************************//**
+ * \brief One successful mutation of a Network. uid is the entity that changed. Connection changes
+ *        carry the node in uid and the branch in other_uid.
+ *************************************************************************************************/
+struct Change
+{
+    static constexpr auto NO_UID = std::numeric_limits<uint32_t>::max();
+
+    Change_Type type;
+    uint32_t uid;
+    uint32_t other_uid;
+};
+
+/**********************************************************************************************//**
+ * \brief Entities touched by a range of changes. Topology changes are anything that can alter
+ *        the node/branch incidence, as opposed to value changes that only alter a component.
+ *************************************************************************************************/
+struct Dirty_Region
+{
+    std::set<uint32_t> nodes;
+    std::set<uint32_t> branches;
+    bool topology_changed = false;
+    bool values_changed = false;
+    bool aliases_changed = false;
+
+    bool is_clean() const
+    {
+        return !topology_changed && !values_changed && !aliases_changed;
+    }
+};
+
+/**********************************************************************************************//**
+ * \brief Append-only record of Network mutations.
+ *
+ *        Every change gets a sequence number, starting from 0. Derived structures remember the
+ *        sequence they were last built at (get_sequence()) and later ask for what happened since,
+ *        updating only the dirty region. compact() drops changes that every consumer has already
+ *        seen, keeping memory bounded through long editing sessions. A consumer that falls behind
+ *        a compaction is told so by is_available() and has to rebuild from scratch.
+ *************************************************************************************************/
+class Journal
+{
+public:
+    Journal();
+    virtual ~Journal() = default;
+
+    void record(Change_Type type, uint32_t uid, uint32_t other_uid = Change::NO_UID);
+
+    uint64_t get_sequence() const;
+    uint64_t get_oldest_sequence() const;
+    std::size_t get_number_of_retained_changes() const;
+
+    bool is_available(uint64_t since) const;
+    std::vector<Change> get_changes_since(uint64_t since) const;
+    Dirty_Region get_dirty_region(uint64_t since) const;
+
+    void compact(uint64_t up_to);
+    void restart();
+
+private:
+    std::vector<Change> changes;
+    uint64_t oldest_sequence;
+};
+
+} // namespace Circlyzer
+
+#endif
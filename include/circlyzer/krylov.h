@@ -0,0 +1,595 @@
+#ifndef KRYLOV_H
+#define KRYLOV_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "exceptions.h"
+#include "sparse_matrix.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Approximate inverse applied to the residual on every Krylov iteration, z = M^-1 r
+ *************************************************************************************************/
+template<typename T>
+class Preconditioner
+{
+public:
+    virtual ~Preconditioner() = default;
+
+    virtual void apply(const std::vector<T>& residual, std::vector<T>& result) const = 0;
+};
+
+/**********************************************************************************************//**
+ * \brief No preconditioning, the solvers see the raw system
+ *************************************************************************************************/
+template<typename T>
+class Identity_Preconditioner : public Preconditioner<T>
+{
+public:
+    void apply(const std::vector<T>& residual, std::vector<T>& result) const override
+    {
+        result = residual;
+    }
+};
+
+/**********************************************************************************************//**
+ * \brief Scales by the inverse diagonal. Rows with a zero diagonal, such as the current row of a
+ *        floating voltage source, are passed through unscaled.
+ *************************************************************************************************/
+template<typename T>
+class Jacobi_Preconditioner : public Preconditioner<T>
+{
+public:
+    explicit Jacobi_Preconditioner(const Sparse_Matrix<T>& matrix) :
+        inverse_diagonal(matrix.get_number_of_rows(), T{ 1 })
+    {
+        const auto positions = matrix.get_diagonal_positions();
+        const auto& values = matrix.get_values();
+
+        for(std::size_t row = 0U; row < positions.size(); ++row)
+        {
+            if((positions[row] < values.size()) && (std::abs(values[positions[row]]) > 0.0))
+            {
+                inverse_diagonal[row] = T{ 1 } / values[positions[row]];
+            }
+        }
+    }
+
+    void apply(const std::vector<T>& residual, std::vector<T>& result) const override
+    {
+        result.resize(residual.size());
+        for(std::size_t row = 0U; row < residual.size(); ++row)
+        {
+            result[row] = inverse_diagonal[row] * residual[row];
+        }
+    }
+
+private:
+    std::vector<T> inverse_diagonal;
+};
+
+/**********************************************************************************************//**
+ * \brief ILU(0): an LU factorization that keeps only the sparsity pattern of the matrix. On a
+ *        Hermitian matrix U is D L^H, so this is also the zero fill incomplete Cholesky
+ *        factorization and keeps the preconditioner symmetric for conjugate gradient.
+ *
+ *        A pivot that vanishes, for example on the current row of a voltage source, is replaced
+ *        by a small multiple of the largest entry in its row rather than failing the solve.
+ *
+ * \note  Throws Singular_Matrix_Exception if a row has no diagonal entry in its pattern.
+ *************************************************************************************************/
+template<typename T>
+class Incomplete_LU_Preconditioner : public Preconditioner<T>
+{
+public:
+    explicit Incomplete_LU_Preconditioner(const Sparse_Matrix<T>& matrix) :
+        row_offsets(matrix.get_row_offsets()),
+        column_indices(matrix.get_column_indices()),
+        factors(matrix.get_values()),
+        diagonal_positions(matrix.get_diagonal_positions())
+    {
+        constexpr auto NOT_IN_ROW = std::numeric_limits<std::size_t>::max();
+        constexpr auto PIVOT_SHIFT = 1e-8;
+
+        const auto rows = matrix.get_number_of_rows();
+        std::vector<std::size_t> position_of(rows, NOT_IN_ROW);
+
+        for(std::size_t row = 0U; row < rows; ++row)
+        {
+            if(diagonal_positions[row] == factors.size())
+            {
+                throw Singular_Matrix_Exception();
+            }
+
+            for(auto index = row_offsets[row]; index < row_offsets[row + 1U]; ++index)
+            {
+                position_of[column_indices[index]] = index;
+            }
+
+            // Eliminate with every earlier row this one references, dropping any fill-in
+            for(auto index = row_offsets[row]; index < diagonal_positions[row]; ++index)
+            {
+                const auto pivot_row = column_indices[index];
+                const auto multiplier = factors[index] / factors[diagonal_positions[pivot_row]];
+                factors[index] = multiplier;
+
+                for(auto upper = diagonal_positions[pivot_row] + 1U;
+                    upper < row_offsets[pivot_row + 1U]; ++upper)
+                {
+                    const auto target = position_of[column_indices[upper]];
+                    if(target != NOT_IN_ROW)
+                    {
+                        factors[target] -= multiplier * factors[upper];
+                    }
+                }
+            }
+
+            auto& pivot = factors[diagonal_positions[row]];
+            if(!(std::abs(pivot) > 0.0))
+            {
+                double largest = 0.0;
+                for(auto index = row_offsets[row]; index < row_offsets[row + 1U]; ++index)
+                {
+                    largest = std::max(largest, std::abs(factors[index]));
+                }
+
+                pivot = T{ (largest > 0.0) ? (largest * PIVOT_SHIFT) : 1.0 };
+            }
+
+            for(auto index = row_offsets[row]; index < row_offsets[row + 1U]; ++index)
+            {
+                position_of[column_indices[index]] = NOT_IN_ROW;
+            }
+        }
+    }
+
+    void apply(const std::vector<T>& residual, std::vector<T>& result) const override
+    {
+        const auto rows = diagonal_positions.size();
+        result.resize(rows);
+
+        // Forward substitution through the unit lower factor
+        for(std::size_t row = 0U; row < rows; ++row)
+        {
+            auto accumulator = residual[row];
+            for(auto index = row_offsets[row]; index < diagonal_positions[row]; ++index)
+            {
+                accumulator -= factors[index] * result[column_indices[index]];
+            }
+
+            result[row] = accumulator;
+        }
+
+        // Backward substitution through the upper factor
+        for(std::size_t row = rows; row-- > 0U;)
+        {
+            auto accumulator = result[row];
+            for(auto index = diagonal_positions[row] + 1U; index < row_offsets[row + 1U]; ++index)
+            {
+                accumulator -= factors[index] * result[column_indices[index]];
+            }
+
+            result[row] = accumulator / factors[diagonal_positions[row]];
+        }
+    }
+
+private:
+    std::vector<std::size_t> row_offsets;
+    std::vector<std::size_t> column_indices;
+    std::vector<T> factors;
+    std::vector<std::size_t> diagonal_positions;
+};
+
+/**********************************************************************************************//**
+ * \brief Stopping rules shared by the Krylov solvers. The solve has converged once
+ *        ||b - A x|| <= tolerance * ||b||. restart only applies to GMRES.
+ *************************************************************************************************/
+struct Krylov_Options
+{
+    double tolerance = 1e-10;
+    uint32_t maximum_iterations = 10000U;
+    uint32_t restart = 50U;
+};
+
+struct Krylov_Result
+{
+    uint32_t iterations = 0U;
+    double relative_residual = 0.0;
+    bool converged = false;
+};
+
+namespace Krylov_Detail
+{
+
+template<typename T>
+T conjugate(const T& value)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return value;
+    }
+    else
+    {
+        return std::conj(value);
+    }
+}
+
+template<typename T>
+T dot(const std::vector<T>& one, const std::vector<T>& two)
+{
+    auto accumulator = T{};
+    for(std::size_t index = 0U; index < one.size(); ++index)
+    {
+        accumulator += conjugate(one[index]) * two[index];
+    }
+
+    return accumulator;
+}
+
+template<typename T>
+double norm(const std::vector<T>& vector)
+{
+    return std::sqrt(std::abs(dot(vector, vector)));
+}
+
+/**
+ * \brief Shared start of every solver: r = b - A x0, returns ||b||
+ */
+template<typename T, typename Multiply>
+double initial_residual(const Multiply& multiply, const std::vector<T>& rhs,
+                        const std::vector<T>& solution, std::vector<T>& residual)
+{
+    multiply(solution, residual);
+    for(std::size_t index = 0U; index < rhs.size(); ++index)
+    {
+        residual[index] = rhs[index] - residual[index];
+    }
+
+    return norm(rhs);
+}
+
+} // namespace Krylov_Detail
+
+/**********************************************************************************************//**
+ * \brief Preconditioned conjugate gradient. The matrix and preconditioner must be Hermitian
+ *        positive definite, which holds for the conductance matrix of a grounded resistive
+ *        network. solution holds the initial guess on entry and the answer on return.
+ *
+ *        multiply(x, y) must compute y = A x, which lets the caller choose how the product runs.
+ *************************************************************************************************/
+template<typename T, typename Multiply>
+Krylov_Result conjugate_gradient(const Multiply& multiply, const std::vector<T>& rhs,
+                                 std::vector<T>& solution, const Preconditioner<T>& preconditioner,
+                                 const Krylov_Options& options = {})
+{
+    using namespace Krylov_Detail;
+
+    const auto size = rhs.size();
+    solution.resize(size, T{});
+
+    std::vector<T> residual(size);
+    const auto rhs_norm = initial_residual(multiply, rhs, solution, residual);
+    if(!(rhs_norm > 0.0))
+    {
+        std::fill(solution.begin(), solution.end(), T{});
+        return { 0U, 0.0, true };
+    }
+
+    std::vector<T> preconditioned(size);
+    std::vector<T> product(size);
+    preconditioner.apply(residual, preconditioned);
+    auto direction = preconditioned;
+    auto rho = dot(residual, preconditioned);
+
+    Krylov_Result result;
+    result.relative_residual = norm(residual) / rhs_norm;
+
+    while((result.relative_residual > options.tolerance) &&
+          (result.iterations < options.maximum_iterations))
+    {
+        multiply(direction, product);
+        const auto curvature = dot(direction, product);
+        if(!(std::abs(curvature) > 0.0))
+        {
+            break;
+        }
+
+        const auto alpha = rho / curvature;
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            solution[index] += alpha * direction[index];
+            residual[index] -= alpha * product[index];
+        }
+
+        ++result.iterations;
+        result.relative_residual = norm(residual) / rhs_norm;
+
+        preconditioner.apply(residual, preconditioned);
+        const auto next_rho = dot(residual, preconditioned);
+        const auto beta = next_rho / rho;
+        rho = next_rho;
+
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            direction[index] = preconditioned[index] + beta * direction[index];
+        }
+    }
+
+    result.converged = (result.relative_residual <= options.tolerance);
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Right preconditioned BiCGSTAB for general (non-Hermitian, complex) systems such as an
+ *        MNA matrix at a non-zero frequency. Uses a fixed amount of memory per iteration but its
+ *        convergence is not monotonic, see gmres for the alternative.
+ *************************************************************************************************/
+template<typename T, typename Multiply>
+Krylov_Result bicgstab(const Multiply& multiply, const std::vector<T>& rhs,
+                       std::vector<T>& solution, const Preconditioner<T>& preconditioner,
+                       const Krylov_Options& options = {})
+{
+    using namespace Krylov_Detail;
+
+    const auto size = rhs.size();
+    solution.resize(size, T{});
+
+    std::vector<T> residual(size);
+    const auto rhs_norm = initial_residual(multiply, rhs, solution, residual);
+    if(!(rhs_norm > 0.0))
+    {
+        std::fill(solution.begin(), solution.end(), T{});
+        return { 0U, 0.0, true };
+    }
+
+    const auto shadow = residual;
+    std::vector<T> direction(size, T{});
+    std::vector<T> product(size, T{});
+    std::vector<T> preconditioned_direction(size);
+    std::vector<T> intermediate(size);
+    std::vector<T> preconditioned_intermediate(size);
+    std::vector<T> intermediate_product(size);
+
+    T rho{ 1 };
+    T alpha{ 1 };
+    T omega{ 1 };
+
+    Krylov_Result result;
+    result.relative_residual = norm(residual) / rhs_norm;
+
+    while((result.relative_residual > options.tolerance) &&
+          (result.iterations < options.maximum_iterations))
+    {
+        const auto next_rho = dot(shadow, residual);
+        if(!(std::abs(next_rho) > 0.0))
+        {
+            break;
+        }
+
+        const auto beta = (next_rho / rho) * (alpha / omega);
+        rho = next_rho;
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            direction[index] = residual[index] + beta * (direction[index] - omega * product[index]);
+        }
+
+        preconditioner.apply(direction, preconditioned_direction);
+        multiply(preconditioned_direction, product);
+
+        const auto projection = dot(shadow, product);
+        if(!(std::abs(projection) > 0.0))
+        {
+            break;
+        }
+
+        alpha = rho / projection;
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            intermediate[index] = residual[index] - alpha * product[index];
+        }
+
+        ++result.iterations;
+        const auto intermediate_norm = norm(intermediate) / rhs_norm;
+        if(intermediate_norm <= options.tolerance)
+        {
+            for(std::size_t index = 0U; index < size; ++index)
+            {
+                solution[index] += alpha * preconditioned_direction[index];
+            }
+
+            result.relative_residual = intermediate_norm;
+            break;
+        }
+
+        preconditioner.apply(intermediate, preconditioned_intermediate);
+        multiply(preconditioned_intermediate, intermediate_product);
+
+        const auto energy = dot(intermediate_product, intermediate_product);
+        if(!(std::abs(energy) > 0.0))
+        {
+            break;
+        }
+
+        omega = dot(intermediate_product, intermediate) / energy;
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            solution[index] += (alpha * preconditioned_direction[index]) +
+                               (omega * preconditioned_intermediate[index]);
+            residual[index] = intermediate[index] - omega * intermediate_product[index];
+        }
+
+        result.relative_residual = norm(residual) / rhs_norm;
+        if(!(std::abs(omega) > 0.0))
+        {
+            break;
+        }
+    }
+
+    result.converged = (result.relative_residual <= options.tolerance);
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Restarted, right preconditioned GMRES. The residual never grows, at the cost of keeping
+ *        options.restart basis vectors. The least squares problem is kept triangular with Givens
+ *        rotations, so the residual is known on every iteration without forming the solution.
+ *************************************************************************************************/
+template<typename T, typename Multiply>
+Krylov_Result gmres(const Multiply& multiply, const std::vector<T>& rhs,
+                    std::vector<T>& solution, const Preconditioner<T>& preconditioner,
+                    const Krylov_Options& options = {})
+{
+    using namespace Krylov_Detail;
+
+    const auto size = rhs.size();
+    const auto restart = std::max<std::size_t>(1U, options.restart);
+    solution.resize(size, T{});
+
+    std::vector<T> residual(size);
+    const auto rhs_norm = initial_residual(multiply, rhs, solution, residual);
+    if(!(rhs_norm > 0.0))
+    {
+        std::fill(solution.begin(), solution.end(), T{});
+        return { 0U, 0.0, true };
+    }
+
+    std::vector<std::vector<T>> basis(restart + 1U, std::vector<T>(size));
+    std::vector<std::vector<T>> hessenberg(restart + 1U, std::vector<T>(restart, T{}));
+    std::vector<T> cosines(restart);
+    std::vector<T> sines(restart);
+    std::vector<T> residual_projection(restart + 1U);
+    std::vector<T> preconditioned(size);
+    std::vector<T> coefficients(restart);
+
+    Krylov_Result result;
+    result.relative_residual = norm(residual) / rhs_norm;
+
+    while((result.relative_residual > options.tolerance) &&
+          (result.iterations < options.maximum_iterations))
+    {
+        const auto beta = norm(residual);
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            basis[0][index] = residual[index] / beta;
+        }
+
+        std::fill(residual_projection.begin(), residual_projection.end(), T{});
+        residual_projection[0] = beta;
+
+        std::size_t steps = 0U;
+        while((steps < restart) && (result.iterations < options.maximum_iterations))
+        {
+            const auto column = steps;
+            preconditioner.apply(basis[column], preconditioned);
+            multiply(preconditioned, basis[column + 1U]);
+
+            // Modified Gram-Schmidt against the existing basis
+            auto& next = basis[column + 1U];
+            for(std::size_t row = 0U; row <= column; ++row)
+            {
+                hessenberg[row][column] = dot(basis[row], next);
+                for(std::size_t index = 0U; index < size; ++index)
+                {
+                    next[index] -= hessenberg[row][column] * basis[row][index];
+                }
+            }
+
+            const auto next_norm = norm(next);
+            hessenberg[column + 1U][column] = next_norm;
+            if(next_norm > 0.0)
+            {
+                for(auto& value : next)
+                {
+                    value /= next_norm;
+                }
+            }
+
+            // Apply the earlier rotations to the new column, then eliminate its subdiagonal
+            for(std::size_t row = 0U; row < column; ++row)
+            {
+                const auto upper = hessenberg[row][column];
+                const auto lower = hessenberg[row + 1U][column];
+                hessenberg[row][column] = (conjugate(cosines[row]) * upper) +
+                                          (conjugate(sines[row]) * lower);
+                hessenberg[row + 1U][column] = (-sines[row] * upper) + (cosines[row] * lower);
+            }
+
+            const auto upper = hessenberg[column][column];
+            const auto lower = hessenberg[column + 1U][column];
+            const auto radius = std::sqrt(std::norm(upper) + std::norm(lower));
+            if(radius > 0.0)
+            {
+                cosines[column] = upper / radius;
+                sines[column] = lower / radius;
+            }
+            else
+            {
+                cosines[column] = T{ 1 };
+                sines[column] = T{};
+            }
+
+            hessenberg[column][column] = (conjugate(cosines[column]) * upper) +
+                                         (conjugate(sines[column]) * lower);
+            hessenberg[column + 1U][column] = T{};
+
+            residual_projection[column + 1U] = -sines[column] * residual_projection[column];
+            residual_projection[column] = conjugate(cosines[column]) * residual_projection[column];
+
+            ++steps;
+            ++result.iterations;
+            result.relative_residual = std::abs(residual_projection[steps]) / rhs_norm;
+
+            if((result.relative_residual <= options.tolerance) || !(next_norm > 0.0))
+            {
+                break;
+            }
+        }
+
+        // Back substitute for the basis coefficients and fold the correction into the solution
+        for(std::size_t row = steps; row-- > 0U;)
+        {
+            auto accumulator = residual_projection[row];
+            for(auto column = row + 1U; column < steps; ++column)
+            {
+                accumulator -= hessenberg[row][column] * coefficients[column];
+            }
+
+            coefficients[row] = accumulator / hessenberg[row][row];
+        }
+
+        std::fill(residual.begin(), residual.end(), T{});
+        for(std::size_t column = 0U; column < steps; ++column)
+        {
+            for(std::size_t index = 0U; index < size; ++index)
+            {
+                residual[index] += coefficients[column] * basis[column][index];
+            }
+        }
+
+        preconditioner.apply(residual, preconditioned);
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            solution[index] += preconditioned[index];
+        }
+
+        // The true residual guards against drift in the rotated estimate across restarts
+        initial_residual(multiply, rhs, solution, residual);
+        result.relative_residual = norm(residual) / rhs_norm;
+    }
+
+    result.converged = (result.relative_residual <= options.tolerance);
+    return result;
+}
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,359 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Row major dense matrix. Only the handful of operations that the analysis code needs are
+ *        provided, this is not meant to be a general purpose linear algebra type.
+ *************************************************************************************************/
+template<typename T>
+class Dense_Matrix
+{
+public:
+    Dense_Matrix() :
+        rows{ 0U },
+        columns{ 0U },
+        elements()
+    {
+
+    }
+
+    Dense_Matrix(const std::size_t rows, const std::size_t columns) :
+        rows{ rows },
+        columns{ columns },
+        elements(rows * columns, T{})
+    {
+
+    }
+
+    T& operator()(const std::size_t row, const std::size_t column)
+    {
+        return elements[(row * columns) + column];
+    }
+
+    const T& operator()(const std::size_t row, const std::size_t column) const
+    {
+        return elements[(row * columns) + column];
+    }
+
+    std::size_t get_number_of_rows() const
+    {
+        return rows;
+    }
+
+    std::size_t get_number_of_columns() const
+    {
+        return columns;
+    }
+
+    T* data()
+    {
+        return elements.data();
+    }
+
+    const T* data() const
+    {
+        return elements.data();
+    }
+
+    void fill(const T& value)
+    {
+        std::fill(elements.begin(), elements.end(), value);
+    }
+
+    /**
+     * \brief Element-wise conversion, used to move a system between precisions
+     */
+    template<typename U>
+    Dense_Matrix<U> cast() const
+    {
+        Dense_Matrix<U> result(rows, columns);
+        for(std::size_t index = 0U; index < elements.size(); ++index)
+        {
+            result.data()[index] = static_cast<U>(elements[index]);
+        }
+
+        return result;
+    }
+
+    std::vector<T> multiply(const std::vector<T>& vector) const
+    {
+        std::vector<T> result(rows, T{});
+
+        for(std::size_t row = 0U; row < rows; ++row)
+        {
+            auto accumulator = T{};
+            for(std::size_t column = 0U; column < columns; ++column)
+            {
+                accumulator += (*this)(row, column) * vector[column];
+            }
+
+            result[row] = accumulator;
+        }
+
+        return result;
+    }
+
+private:
+    std::size_t rows;
+    std::size_t columns;
+    std::vector<T> elements;
+};
+
+/**********************************************************************************************//**
+ * \brief LU factorization with partial (row) pivoting. The factors are stored in place, L below
+ *        the diagonal with an implied unit diagonal and U on and above it.
+ *
+ * \note  Throws Singular_Matrix_Exception if no usable pivot can be found for a column.
+ *************************************************************************************************/
+template<typename T>
+class LU_Factorization
+{
+public:
+    LU_Factorization() = default;
+
+    explicit LU_Factorization(Dense_Matrix<T> matrix) :
+        factors(std::move(matrix)),
+        permutation()
+    {
+        const auto size = factors.get_number_of_rows();
+        permutation.resize(size);
+
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            permutation[index] = index;
+        }
+
+        for(std::size_t pivot = 0U; pivot < size; ++pivot)
+        {
+            // Select the largest magnitude entry in the column to keep the elimination stable
+            auto best_row = pivot;
+            auto best_magnitude = std::abs(factors(pivot, pivot));
+            for(std::size_t row = pivot + 1U; row < size; ++row)
+            {
+                const auto magnitude = std::abs(factors(row, pivot));
+                if(magnitude > best_magnitude)
+                {
+                    best_row = row;
+                    best_magnitude = magnitude;
+                }
+            }
+
+            if(!(best_magnitude > 0) || !std::isfinite(best_magnitude))
+            {
+                throw Singular_Matrix_Exception();
+            }
+
+            if(best_row != pivot)
+            {
+                for(std::size_t column = 0U; column < size; ++column)
+                {
+                    std::swap(factors(pivot, column), factors(best_row, column));
+                }
+
+                std::swap(permutation[pivot], permutation[best_row]);
+            }
+
+            const auto inverse_pivot = T{ 1 } / factors(pivot, pivot);
+            for(std::size_t row = pivot + 1U; row < size; ++row)
+            {
+                const auto multiplier = factors(row, pivot) * inverse_pivot;
+                factors(row, pivot) = multiplier;
+
+                if(multiplier == T{})
+                {
+                    continue;
+                }
+
+                for(std::size_t column = pivot + 1U; column < size; ++column)
+                {
+                    factors(row, column) -= multiplier * factors(pivot, column);
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Solves A x = b for x using the stored factors
+     */
+    std::vector<T> solve(const std::vector<T>& rhs) const
+    {
+        std::vector<T> solution;
+        solve(rhs, solution);
+        return solution;
+    }
+
+    /**
+     * \brief Solves A x = b into the provided solution, which doesn't allocate once it is sized.
+     *        The solution must not be the right hand side itself.
+     */
+    void solve(const std::vector<T>& rhs, std::vector<T>& solution) const
+    {
+        const auto size = factors.get_number_of_rows();
+        solution.resize(size);
+
+        // Forward substitution against the permuted right hand side
+        for(std::size_t row = 0U; row < size; ++row)
+        {
+            auto accumulator = rhs[permutation[row]];
+            for(std::size_t column = 0U; column < row; ++column)
+            {
+                accumulator -= factors(row, column) * solution[column];
+            }
+
+            solution[row] = accumulator;
+        }
+
+        // Backward substitution
+        for(std::size_t row = size; row-- > 0U;)
+        {
+            auto accumulator = solution[row];
+            for(std::size_t column = row + 1U; column < size; ++column)
+            {
+                accumulator -= factors(row, column) * solution[column];
+            }
+
+            solution[row] = accumulator / factors(row, row);
+        }
+    }
+
+    /**
+     * \brief Solves A X = B for every column of B in one pass. Each row of the substitution is
+     *        applied across all right hand sides at once, so the factors are read once rather
+     *        than once per column and the inner loop runs over contiguous memory.
+     */
+    Dense_Matrix<T> solve(const Dense_Matrix<T>& rhs) const
+    {
+        const auto size = factors.get_number_of_rows();
+        const auto width = rhs.get_number_of_columns();
+        Dense_Matrix<T> solution(size, width);
+
+        // Forward substitution against the permuted right hand sides
+        for(std::size_t row = 0U; row < size; ++row)
+        {
+            auto* target = solution.data() + (row * width);
+            const auto* source = rhs.data() + (permutation[row] * width);
+            std::copy(source, source + width, target);
+
+            for(std::size_t column = 0U; column < row; ++column)
+            {
+                const auto factor = factors(row, column);
+                if(factor == T{})
+                {
+                    continue;
+                }
+
+                const auto* known = solution.data() + (column * width);
+                for(std::size_t index = 0U; index < width; ++index)
+                {
+                    target[index] -= factor * known[index];
+                }
+            }
+        }
+
+        // Backward substitution
+        for(std::size_t row = size; row-- > 0U;)
+        {
+            auto* target = solution.data() + (row * width);
+            for(std::size_t column = row + 1U; column < size; ++column)
+            {
+                const auto factor = factors(row, column);
+                if(factor == T{})
+                {
+                    continue;
+                }
+
+                const auto* known = solution.data() + (column * width);
+                for(std::size_t index = 0U; index < width; ++index)
+                {
+                    target[index] -= factor * known[index];
+                }
+            }
+
+            const auto inverse_pivot = T{ 1 } / factors(row, row);
+            for(std::size_t index = 0U; index < width; ++index)
+            {
+                target[index] *= inverse_pivot;
+            }
+        }
+
+        return solution;
+    }
+
+    /**
+     * \brief Solves A^T x = b for x with the same factors. With P A = L U this is
+     *        U^T L^T P x = b: a forward pass through U^T, a backward pass through L^T, then
+     *        undoing the row permutation. The transpose is not conjugated.
+     */
+    std::vector<T> solve_transposed(const std::vector<T>& rhs) const
+    {
+        const auto size = factors.get_number_of_rows();
+        std::vector<T> intermediate(rhs);
+
+        // Forward substitution through U^T, which is lower triangular
+        for(std::size_t row = 0U; row < size; ++row)
+        {
+            auto accumulator = intermediate[row];
+            for(std::size_t column = 0U; column < row; ++column)
+            {
+                accumulator -= factors(column, row) * intermediate[column];
+            }
+
+            intermediate[row] = accumulator / factors(row, row);
+        }
+
+        // Backward substitution through L^T, which has a unit diagonal
+        for(std::size_t row = size; row-- > 0U;)
+        {
+            auto accumulator = intermediate[row];
+            for(std::size_t column = row + 1U; column < size; ++column)
+            {
+                accumulator -= factors(column, row) * intermediate[column];
+            }
+
+            intermediate[row] = accumulator;
+        }
+
+        std::vector<T> solution(size, T{});
+        for(std::size_t row = 0U; row < size; ++row)
+        {
+            solution[permutation[row]] = intermediate[row];
+        }
+
+        return solution;
+    }
+
+    std::size_t get_size() const
+    {
+        return factors.get_number_of_rows();
+    }
+
+    const Dense_Matrix<T>& get_factors() const
+    {
+        return factors;
+    }
+
+    const std::vector<std::size_t>& get_permutation() const
+    {
+        return permutation;
+    }
+
+private:
+    Dense_Matrix<T> factors;
+    std::vector<std::size_t> permutation;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef MIXED_PRECISION_H
+#define MIXED_PRECISION_H
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "matrix.h"
+
+namespace Circlyzer
+{
+
+struct Refinement_Options
+{
+    // Upper bound on correction steps before giving up on the float factors
+    uint32_t maximum_iterations = 10U;
+
+    // Normwise backward error at which the solution is considered converged
+    double tolerance = 1e-14;
+
+    // Each step must shrink the residual by at least this factor, otherwise it has stalled
+    double stall_ratio = 0.5;
+};
+
+struct Refinement_Result
+{
+    std::vector<std::complex<double>> solution;
+    uint32_t iterations = 0U;
+    double backward_error = 0.0;
+    bool used_fallback = false;
+};
+
+/**********************************************************************************************//**
+ * \brief Solves A x = b by factorizing A in complex<float> and recovering double accuracy with
+ *        iterative refinement against a residual computed in complex<double>. Falls back to a
+ *        double factorization when the float factors are singular or refinement stalls, which
+ *        happens once the condition number approaches the reciprocal of float epsilon.
+ *************************************************************************************************/
+Refinement_Result solve_mixed_precision(const Dense_Matrix<std::complex<double>>& matrix,
+                                        const std::vector<std::complex<double>>& rhs,
+                                        const Refinement_Options& options = {});
+
+} // namespace Circlyzer
+
+#endif
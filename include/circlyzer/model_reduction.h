@@ -0,0 +1,92 @@
+#ifndef MODEL_REDUCTION_H
+#define MODEL_REDUCTION_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "compiled_network.h"
+#include "matrix.h"
+#include "network.h"
+
+namespace Circlyzer
+{
+
+struct Model_Reduction_Options
+{
+    // Real expansion point s0 in rad/s. Zero matches the low frequency behaviour best but needs
+    // a DC path to ground from every node; use a positive value for purely capacitive nodes.
+    double expansion_point = 0.0;
+
+    // Upper bound on Krylov blocks. Each block adds one state per port.
+    std::size_t maximum_blocks = 8U;
+
+    // When positive, blocks stop being added once the error estimate at every one of the
+    // check frequencies falls below this relative value
+    double tolerance = 0.0;
+    std::vector<double> check_frequencies;
+};
+
+/**********************************************************************************************//**
+ * \brief Compact model of a network as seen from its port nodes, produced by PRIMA.
+ *
+ *        The network is written as (G + sC) x = B u with the port currents u as inputs and the
+ *        port voltages y = B^T x as outputs, so its impedance matrix is Z(s) = B^T (G + sC)^-1 B.
+ *        An orthonormal basis X of the block Krylov space of (G + s0 C)^-1 C and
+ *        (G + s0 C)^-1 B is built with block Arnoldi, and the model keeps Gr = X^T G X,
+ *        Cr = X^T C X and Br = X^T B. The congruence preserves passivity, and the first
+ *        block count moments of Z around s0 are matched.
+ *
+ *        G and C are assembled sparse and (G + s0 C) is factorized once with a sparse LU, so the
+ *        cost follows the network's nonzeros and fill rather than the square of its size.
+ *
+ *        Voltage sources are zeroed (shorted), as in any impedance measurement. Gr, Cr and Br
+ *        describe the reduced system Cr x' = -Gr x + Br u, y = Br^T x for transient use.
+ *************************************************************************************************/
+class Reduced_Model
+{
+public:
+    Reduced_Model(const Compiled_Network& network, uint32_t ground_uid,
+                  const std::vector<uint32_t>& port_uids,
+                  const Model_Reduction_Options& options = {});
+    Reduced_Model(const Network& network, uint32_t ground_uid,
+                  const std::vector<uint32_t>& port_uids,
+                  const Model_Reduction_Options& options = {});
+    virtual ~Reduced_Model() = default;
+
+    // Port impedance matrix at an angular frequency, ports in the order given
+    Dense_Matrix<std::complex<double>> get_impedance(double frequency) const;
+    std::vector<Dense_Matrix<std::complex<double>>> sweep(const std::vector<double>& frequencies) const;
+
+    // Impedance looking into one port with every other port open
+    std::complex<double> get_thevenin_impedance(uint32_t port_uid, double frequency) const;
+
+    // Relative change of Z(jw) from dropping the last Krylov block. Infinite for a one block model.
+    double get_error_estimate(double frequency) const;
+
+    std::size_t get_order() const;
+    std::size_t get_original_size() const;
+    const std::vector<uint32_t>& get_port_uids() const;
+
+    const Dense_Matrix<double>& get_conductance() const;
+    const Dense_Matrix<double>& get_capacitance() const;
+    const Dense_Matrix<double>& get_input() const;
+
+private:
+    Dense_Matrix<std::complex<double>> evaluate(std::size_t order, double frequency) const;
+
+    std::vector<uint32_t> port_uids;
+    std::size_t original_size;
+
+    // Number of basis columns after each block, for the nested lower order models
+    std::vector<std::size_t> block_ends;
+
+    Dense_Matrix<double> conductance;
+    Dense_Matrix<double> capacitance;
+    Dense_Matrix<double> input;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -8,11 +8,17 @@
 #include <set>
 
 #include "component.h"
+#include "executor.h"
+#include "journal.h"
+#include "result.h"
 
 namespace Circlyzer
 {
 struct Branch;
 struct Node;
+struct Extracted_Network;
+class Compiled_Network;
+class Network_Shard;
 
 enum class Entity_Type
 {
@@ -44,11 +50,41 @@ struct Node : public Unique_Entity
     std::set<uint32_t> branches;
 };
 
+/**********************************************************************************************//**
+ * \brief Generational references to a node or a branch. index is the entity's UID and generation
+ *        counts how often that UID's slot has changed hands, so a handle kept past destroy_entity
+ *        or compact() stops resolving instead of silently naming whatever took the UID over.
+ *************************************************************************************************/
+struct Node_Handle
+{
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const Node_Handle&) const = default;
+};
+
+struct Branch_Handle
+{
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const Branch_Handle&) const = default;
+};
+
 class Network
 {
 public:
+    static constexpr uint32_t ALIAS_LENGTH_LIMIT = 25U;
+
     Network();
-    virtual ~Network() = default;
+    virtual ~Network();
+
+    // Moves carry the contents' reference along, see get_reference
+    Network(Network&& other);
+    Network& operator=(Network&& other);
+
+    // Merges shards filled on separate threads, see Network_Shard
+    explicit Network(std::vector<Network_Shard> shards, Executor& executor = Executor::get_shared());
 
     // Create Functions
     uint32_t create_node(const std::string& alias="");
@@ -58,6 +94,22 @@ public:
     const Component& get_component(uint32_t uid) const;
     const Component& get_component(const std::string& alias) const;
 
+    const Node& get_node(uint32_t uid) const;
+    const Branch& get_branch(uint32_t uid) const;
+
+    std::vector<uint32_t> get_node_uids() const;
+    std::vector<uint32_t> get_branch_uids() const;
+
+    // Handle Functions, O(1) and validated against the generation
+    Node_Handle get_node_handle(uint32_t uid) const;
+    Branch_Handle get_branch_handle(uint32_t uid) const;
+
+    const Node& get_node(Node_Handle handle) const;
+    const Branch& get_branch(Branch_Handle handle) const;
+
+    bool is_valid(Node_Handle handle) const;
+    bool is_valid(Branch_Handle handle) const;
+
     // Update Functions
     void create_connection_between(uint32_t node_uid, uint32_t branch_uid);
     void delete_connection_between(uint32_t node_uid, uint32_t branch_uid);
@@ -71,29 +123,102 @@ public:
     void update_alias(uint32_t uid, const std::string& new_alias);
     void update_alias(const std::string& alias, const std::string& new_alias);
 
-    // TODO: add logic to update components
+    void update_component(uint32_t uid, std::unique_ptr<Component> component);
+    void update_component(const std::string& alias, std::unique_ptr<Component> component);
 
     void destroy_entity(uint32_t uid);
     void destroy_entity(const std::string& alias);
 
+    // Bulk Functions, costing in proportion to the region rather than the network
+    void destroy_entities(const std::vector<uint32_t>& uids);
+    Extracted_Network extract_subnetwork(const std::vector<uint32_t>& node_uids) const;
+
+    // Non-throwing variants for bulk work. Validation is identical; failures come back as a
+    // Network_Error instead of an exception, and nothing is changed when one is reported.
+    Result<uint32_t> try_create_node(const std::string& alias="");
+    Result<uint32_t> try_create_branch(std::unique_ptr<Component> component,
+                                       const std::string& alias="");
+
+    Result<const Component*> try_get_component(uint32_t uid) const;
+    Result<const Component*> try_get_component(const std::string& alias) const;
+
+    Result<const Node*> try_get_node(uint32_t uid) const;
+    Result<const Branch*> try_get_branch(uint32_t uid) const;
+
+    Result<Node_Handle> try_get_node_handle(uint32_t uid) const;
+    Result<Branch_Handle> try_get_branch_handle(uint32_t uid) const;
+
+    Result<const Node*> try_get_node(Node_Handle handle) const;
+    Result<const Branch*> try_get_branch(Branch_Handle handle) const;
+
+    Result<void> try_update_alias(uint32_t uid, const std::string& new_alias);
+    Result<void> try_update_alias(const std::string& alias, const std::string& new_alias);
+
+    Result<void> try_update_component(uint32_t uid, std::unique_ptr<Component> component);
+    Result<void> try_update_component(const std::string& alias,
+                                      std::unique_ptr<Component> component);
+
     // External Utility Functions
     uint32_t get_number_of_entities() const;
     uint32_t get_number_of_aliases() const;
     uint32_t get_number_of_nodes() const;
     uint32_t get_number_of_branches() const;
 
+    const Journal& get_journal() const;
+    void compact_journal(uint64_t up_to);
+
+    // Follows this network's contents through moves, and reads null once they are destroyed
+    std::shared_ptr<const Network* const> get_reference() const;
+
+    // Renumbers the entities without gaps, returning each old UID's new UID
+    std::vector<uint32_t> compact();
+
+    // Freezes the current state into a read-only view for the analysis passes
+    std::shared_ptr<const Compiled_Network> compile() const;
+
 private:
     // Internal utility functions
-    uint32_t find_valid_uid() const;
+    uint32_t find_valid_uid();
     bool uid_does_not_exist(uint32_t uid) const;
     bool alias_does_not_exist(const std::string& alias) const;
-
-    std::map<uint32_t, std::shared_ptr<Unique_Entity>> entity_table;
+    Result<void> validate_new_alias(const std::string& alias) const;
+    Result<uint32_t> find_uid(const std::string& alias) const;
+    Result<Unique_Entity*> find_entity(uint32_t uid) const;
+    Result<Unique_Entity*> find_entity(uint32_t index, uint32_t generation, Entity_Type type) const;
+    void store_entity(std::shared_ptr<Unique_Entity> entity);
+    static bool attach(Node& node, Branch& branch);
+
+    // Slot map indexed by UID, with an empty slot for every released UID
+    std::vector<std::shared_ptr<Unique_Entity>> entity_table;
     std::map<std::string, uint32_t> alias_to_id_table;
 
+    // Bumped whenever a slot's occupant changes. Kept for slots past the end of entity_table too,
+    // so a UID dropped by compact() and handed out again still gets a new generation.
+    std::vector<uint32_t> generations;
+
+    // Every UID below next_uid is either in use or waiting in released_uids, and next_uid is
+    // always the size of entity_table
+    std::set<uint32_t> released_uids;
+    uint32_t next_uid;
+
     uint32_t number_of_nodes;
     uint32_t number_of_branches;
 
+    Journal journal;
+
+    // Where the contents live now, shared with everything that follows them
+    std::shared_ptr<const Network*> self;
+
+};
+
+/**********************************************************************************************//**
+ * \brief A subnetwork copied out of a Network by extract_subnetwork. original_uids holds, for
+ *        each UID of the copy, the UID it had in the source.
+ *************************************************************************************************/
+struct Extracted_Network
+{
+    Network network;
+    std::vector<uint32_t> original_uids;
 };
 
 } // Namespace Circlyzer
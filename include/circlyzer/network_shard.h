@@ -0,0 +1,86 @@
+#ifndef NETWORK_SHARD_H
+#define NETWORK_SHARD_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "component.h"
+#include "network.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Part of a Network under construction, filled by a single thread.
+ *
+ *        A shard has no shared state, so any number of threads can each fill their own without
+ *        locking, and Network's sharded constructor then merges them. Entities get local IDs,
+ *        0 upwards in creation order, that only mean something within their shard. On merge
+ *        every shard's entities keep that order and the shards follow each other, so the UIDs
+ *        only depend on what was put in which shard, not on how the threads were scheduled.
+ *
+ *        The alias rules are those of Network. Duplicates within a shard are refused as they
+ *        are created, duplicates across shards when merging. Connections between local IDs
+ *        follow create_connection_between, including silently ignoring invalid ones. Connections
+ *        naming a node by alias can reach an entity in any shard and are resolved when merging.
+ *        Either kind is applied in creation order, shard after shard, so a branch's terminals
+ *        come out in the order a serial build would give them.
+ *************************************************************************************************/
+class Network_Shard
+{
+public:
+    Network_Shard();
+    virtual ~Network_Shard() = default;
+
+    Network_Shard(Network_Shard&&) = default;
+    Network_Shard& operator=(Network_Shard&&) = default;
+
+    uint32_t create_node(const std::string& alias="");
+    uint32_t create_branch(std::unique_ptr<Component> component, const std::string& alias="");
+
+    void create_connection_between(uint32_t node_id, uint32_t branch_id);
+    void create_connection_between(const std::string& node_alias, uint32_t branch_id);
+    void create_connection_between(const std::string& node_alias, const std::string& branch_alias);
+
+    uint32_t get_number_of_entities() const;
+    uint32_t get_number_of_aliases() const;
+    uint32_t get_number_of_nodes() const;
+    uint32_t get_number_of_branches() const;
+
+private:
+    friend class Network;
+
+    static constexpr auto NO_ID = std::numeric_limits<uint32_t>::max();
+
+    struct Deferred_Connection
+    {
+        std::string node_alias;
+        std::string branch_alias;
+        uint32_t branch_id;
+    };
+
+    void validate_new_alias(const std::string& alias) const;
+
+    // One entry per local ID. Nodes hold no component.
+    std::vector<Entity_Type> types;
+    std::vector<std::string> aliases;
+    std::vector<std::unique_ptr<Component>> components;
+
+    std::unordered_map<std::string, uint32_t> alias_to_id_table;
+
+    // In creation order. One by alias is (NO_ID, its index in deferred_connections).
+    std::vector<std::pair<uint32_t, uint32_t>> connections;
+    std::vector<Deferred_Connection> deferred_connections;
+
+    uint32_t number_of_nodes;
+    uint32_t number_of_branches;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef NODAL_ANALYSIS_H
+#define NODAL_ANALYSIS_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "compiled_network.h"
+#include "component.h"
+#include "impedance_table.h"
+#include "matrix.h"
+#include "network.h"
+#include "sparse_matrix.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Result of a nodal solve. Voltages are relative to the ground node, which is reported
+ *        with a voltage of zero. Branch currents flow from the branch's first node to its second.
+ *************************************************************************************************/
+struct Nodal_Solution
+{
+    std::map<uint32_t, std::complex<double>> node_voltages;
+    std::map<uint32_t, std::complex<double>> branch_currents;
+};
+
+/**********************************************************************************************//**
+ * \brief One connected branch as seen by the MNA system. first and second are unknown indices,
+ *        or Nodal_Analysis::GROUND_INDEX for the ground node. current_index is the unknown
+ *        carrying the branch current for voltage sources and inductors, GROUND_INDEX otherwise.
+ *        branch_index is the branch's position in the Compiled_Network the analysis was built on.
+ *************************************************************************************************/
+struct Nodal_Element
+{
+    uint32_t uid;
+    uint32_t branch_index;
+    Component_Type type;
+    std::size_t first;
+    std::size_t second;
+    std::size_t current_index;
+    std::complex<double> value;
+};
+
+/**********************************************************************************************//**
+ * \brief Mixed factorizes in complex<float> and refines against a complex<double> residual, see
+ *        solve_mixed_precision. It falls back to Double on its own when refinement stalls.
+ *************************************************************************************************/
+enum class Solve_Precision
+{
+    Double,
+    Mixed
+};
+
+/**********************************************************************************************//**
+ * \brief Modified nodal analysis of a Network.
+ *
+ *        Every node other than the ground node contributes one unknown voltage. Resistors and
+ *        capacitors are stamped as admittances. Voltage sources and inductors each add one unknown
+ *        branch current, which keeps inductors well defined as shorts when solving at DC.
+ *        Diodes are kept apart in the nonlinear elements, and are open circuits to the linear
+ *        system and its solution. Nonlinear_Analysis solves them.
+ *
+ *        The analysis runs on a Compiled_Network. Topology and component values are captured on
+ *        construction, so later edits to the Network are not seen by an existing analysis.
+ *        Frequencies are angular (rad/s), matching the get_impedence functions in component.h.
+ *
+ *        Element impedances come from an Impedance_Table over the captured values, so stamping a
+ *        frequency that was recently stamped evaluates nothing. Copies of an analysis share the
+ *        table. Concurrent solves only take turns to fetch a frequency's values, and then stamp
+ *        from their own reference to them, so neither the stamp function passed to
+ *        for_each_stamp nor a frequency evicted by another solve holds anyone up. solve()
+ *        interprets its unknowns with the very values it stamped.
+ *************************************************************************************************/
+class Nodal_Analysis
+{
+public:
+    Nodal_Analysis(const Compiled_Network& network, uint32_t ground_uid);
+    Nodal_Analysis(const Network& network, uint32_t ground_uid);
+    virtual ~Nodal_Analysis() = default;
+
+    Nodal_Solution solve(double frequency = 0.0,
+                         Solve_Precision precision = Solve_Precision::Double) const;
+
+    using Stamp_Function = std::function<void(std::size_t row, std::size_t column,
+                                              const std::complex<double>& value)>;
+
+    // Building blocks of solve(), exposed for the specialised solvers
+    Dense_Matrix<std::complex<double>> assemble_matrix(double frequency) const;
+    Sparse_Matrix<std::complex<double>> assemble_sparse_matrix(double frequency) const;
+    void for_each_stamp(double frequency, const Stamp_Function& stamp) const;
+    std::vector<std::complex<double>> assemble_excitation() const;
+    Nodal_Solution interpret(const std::vector<std::complex<double>>& unknowns,
+                             double frequency) const;
+
+    std::size_t get_system_size() const;
+    uint32_t get_ground_uid() const;
+    const std::vector<uint32_t>& get_node_uids() const;
+    const std::vector<Nodal_Element>& get_elements() const;
+    const std::vector<Nodal_Element>& get_nonlinear_elements() const;
+
+    static constexpr auto GROUND_INDEX = std::numeric_limits<std::size_t>::max();
+
+private:
+    static constexpr std::size_t STAMP_CACHE_CAPACITY = 4U;
+
+    struct Stamp_Cache
+    {
+        explicit Stamp_Cache(const Compiled_Network& network);
+
+        std::mutex mutex;
+        Impedance_Table table;
+    };
+
+    std::shared_ptr<const Branch_Impedances> get_branch_impedances(double frequency) const;
+    void stamp_elements(const Branch_Impedances& values, const Stamp_Function& stamp) const;
+    Nodal_Solution interpret(const std::vector<std::complex<double>>& unknowns,
+                             const Branch_Impedances& values) const;
+
+    uint32_t ground_uid;
+    std::vector<uint32_t> node_uids;
+    std::vector<Nodal_Element> elements;
+    std::vector<Nodal_Element> nonlinear_elements;
+    std::size_t system_size;
+    std::shared_ptr<Stamp_Cache> stamp_cache;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef NONLINEAR_ANALYSIS_H
+#define NONLINEAR_ANALYSIS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "compiled_network.h"
+#include "matrix.h"
+#include "network.h"
+#include "nodal_analysis.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief An iteration has converged when every unknown moved by less than relative_tolerance of
+ *        its magnitude plus voltage_tolerance (node voltages) or current_tolerance (branch
+ *        currents), and every diode's linearised current agrees with its true current to the
+ *        same relative tolerance plus current_tolerance.
+ *
+ *        minimum_conductance is placed across every diode so that a reverse biased junction never
+ *        leaves a node floating. With reuse_jacobian, a factorization is kept for as long as
+ *        each update shrinks to at most contraction times the previous one.
+ *************************************************************************************************/
+struct Nonlinear_Options
+{
+    double relative_tolerance = 1e-9;
+    double voltage_tolerance = 1e-9;
+    double current_tolerance = 1e-15;
+    uint32_t maximum_iterations = 100U;
+    double minimum_conductance = 1e-12;
+    bool reuse_jacobian = true;
+    double contraction = 0.5;
+};
+
+/**********************************************************************************************//**
+ * \brief unknowns is in Nodal_Analysis order and can seed the next solve. solution is filled in
+ *        even when the solver did not converge, check converged.
+ *************************************************************************************************/
+struct Nonlinear_Result
+{
+    Nodal_Solution solution;
+    std::vector<double> unknowns;
+    uint32_t iterations;
+    uint32_t factorizations;
+    bool converged;
+};
+
+/**********************************************************************************************//**
+ * \brief DC operating point of a network with diodes, found with Newton-Raphson.
+ *
+ *        Each iteration replaces every diode with its companion model, the conductance g at the
+ *        junction voltage in parallel with the current source I(v) - g v, and solves the
+ *        resulting linear MNA system. The linear part of the matrix is assembled once, and the
+ *        entries every diode stamps are located once, so each new Jacobian is a copy of the
+ *        linear matrix plus four additions per diode.
+ *
+ *        A factorization is reused (a chord step) while the updates keep contracting, so near the
+ *        solution iterations cost a solve rather than a factorization. A step that stalls, or
+ *        one where a junction had to be limited, refactors at the new junction voltages.
+ *        Junction voltages are limited the way SPICE does: a forward step beyond the critical
+ *        voltage moves the diode current rather than the voltage linearly, which keeps the
+ *        exponential from overflowing on the first iterations.
+ *
+ *        Capacitors are open and inductors short at DC. Voltage sources act with the real part
+ *        of their voltage.
+ *
+ * \note  Throws Singular_Matrix_Exception where the linearised system has no solution, for
+ *        example a loop of voltage sources.
+ *************************************************************************************************/
+class Nonlinear_Analysis
+{
+public:
+    Nonlinear_Analysis(const Compiled_Network& network, uint32_t ground_uid,
+                       const Nonlinear_Options& options = {});
+    Nonlinear_Analysis(const Network& network, uint32_t ground_uid,
+                       const Nonlinear_Options& options = {});
+    virtual ~Nonlinear_Analysis() = default;
+
+    Nonlinear_Result solve() const;
+    Nonlinear_Result solve(const std::vector<double>& initial_unknowns) const;
+
+    const Nodal_Analysis& get_nodal_analysis() const;
+    const Nonlinear_Options& get_options() const;
+
+private:
+    struct Junction
+    {
+        uint32_t uid;
+        std::size_t anode;
+        std::size_t cathode;
+        double saturation_current;
+        double scale;
+        double critical_voltage;
+
+        // Offsets into the matrix of the four entries the junction stamps, GROUND_INDEX if absent
+        std::size_t slots[4];
+    };
+
+    Nodal_Analysis analysis;
+    Nonlinear_Options options;
+    Dense_Matrix<double> linear_matrix;
+    std::vector<double> excitation;
+    std::vector<Junction> junctions;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -1,9 +1,28 @@
+#ifndef PHASORS_H
+#define PHASORS_H
+
 #include <vector>
 #include <complex>
 
 namespace Circlyzer
 {
 
+// Impedances between each pair of terminals of a triangle
+struct Delta_Impedances
+{
+    std::complex<double> ab;
+    std::complex<double> bc;
+    std::complex<double> ca;
+};
+
+// Impedances from each terminal to the star point
+struct Wye_Impedances
+{
+    std::complex<double> a;
+    std::complex<double> b;
+    std::complex<double> c;
+};
+
 // Parallel Phasor API
 std::complex<double> simplify_series(const std::vector<std::complex<double>>& elements);
 std::complex<double> simplify_parallel(const std::vector<std::complex<double>>& elements);
@@ -14,4 +33,13 @@ std::complex<float> simplify_series(const std::vector<std::complex<float>>& elem
 std::complex<float> simplify_parallel(const std::vector<std::complex<float>>& elements);
 std::complex<float> simplify_parallel(const std::complex<float>& one, const std::complex<float>& two);
 
-} // namespace Circlyzer
\ No newline at end of file
+// Delta-Wye Phasor API, throwing Degenerate_Transform_Exception instead of dividing by zero
+Wye_Impedances delta_to_wye(const Delta_Impedances& delta);
+Delta_Impedances wye_to_delta(const Wye_Impedances& wye);
+
+// Whether a sum cancelled to zero, to within rounding of the magnitude of its terms
+bool is_cancelled(const std::complex<double>& sum, double magnitude);
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef PORT_PARAMETERS_H
+#define PORT_PARAMETERS_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+#include "compiled_network.h"
+#include "executor.h"
+#include "graph_export.h"
+#include "matrix.h"
+#include "network.h"
+#include "nodal_analysis.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief One port of a multi-port network: the current enters at the positive node and leaves at
+ *        the negative one, and the port voltage is v(positive) - v(negative). Either terminal may
+ *        be the ground node. reference_impedance (ohms, real) only affects S parameters.
+ *************************************************************************************************/
+struct Port
+{
+    uint32_t positive_uid;
+    uint32_t negative_uid;
+    double reference_impedance = 50.0;
+};
+
+enum class Parameter_Type : uint8_t
+{
+    Z,
+    Y,
+    S
+};
+
+/**********************************************************************************************//**
+ * \brief One port-by-port matrix per frequency, in the order of frequencies. Frequencies are
+ *        angular, like everywhere else in the library.
+ *************************************************************************************************/
+struct Port_Parameters
+{
+    Parameter_Type type = Parameter_Type::Z;
+    std::vector<double> reference_impedances;
+    std::vector<double> frequencies;
+    std::vector<Dense_Matrix<std::complex<double>>> matrices;
+};
+
+/**********************************************************************************************//**
+ * \brief Characterises a network as an N-port.
+ *
+ *        Every port is driven with a unit current in turn while the others are left open, and
+ *        the voltages across all ports give one column of Z. Independent voltage sources in the
+ *        network are shorted, as the parameters describe the linear network alone. All N
+ *        excitations share one factorization of the MNA matrix and are solved together as an
+ *        N column block. Y and S follow from Z:
+ *
+ *            Y = Z^-1
+ *            S = R^-1/2 (Z - R) (Z + R)^-1 R^1/2, with R the diagonal of reference impedances
+ *
+ * \note  Throws Singular_Matrix_Exception where Z (or Z + R) does not exist, for example when a
+ *        port is shorted.
+ *************************************************************************************************/
+class Port_Analysis
+{
+public:
+    Port_Analysis(const Compiled_Network& network, uint32_t ground_uid, const std::vector<Port>& ports);
+    Port_Analysis(const Network& network, uint32_t ground_uid, const std::vector<Port>& ports);
+    virtual ~Port_Analysis() = default;
+
+    Dense_Matrix<std::complex<double>> get_impedance_matrix(double frequency) const;
+    Dense_Matrix<std::complex<double>> get_admittance_matrix(double frequency) const;
+    Dense_Matrix<std::complex<double>> get_scattering_matrix(double frequency) const;
+    Dense_Matrix<std::complex<double>> get_parameters(Parameter_Type type, double frequency) const;
+
+    // Every frequency is solved as its own task on the executor
+    Port_Parameters extract(Parameter_Type type, const std::vector<double>& frequencies,
+                            Executor& executor = Executor::get_shared()) const;
+
+    const std::vector<Port>& get_ports() const;
+
+private:
+    Nodal_Analysis analysis;
+    std::vector<Port> ports;
+    std::vector<std::size_t> positive_indices;
+    std::vector<std::size_t> negative_indices;
+};
+
+/**********************************************************************************************//**
+ * \brief Writes Touchstone data in real/imaginary form with frequencies in Hz.
+ *
+ *        When every port shares one reference impedance the version 1 format is used, which is
+ *        the most widely read: the option line carries the reference impedance, Z and Y are
+ *        normalised to it, and two-port data is in the 11 21 12 22 order the format requires.
+ *        Mixed reference impedances need the version 2.0 [Reference] keyword instead.
+ *************************************************************************************************/
+void write_touchstone(const Port_Parameters& parameters, Output_Sink& sink);
+
+/**********************************************************************************************//**
+ * \brief Compact binary form, in host byte order:
+ *
+ *            "CZNP", uint32 version, uint8 type, uint32 ports, uint32 frequencies,
+ *            double reference impedance per port,
+ *            then per frequency: double angular frequency, ports x ports (real, imaginary)
+ *            doubles in row major order
+ *************************************************************************************************/
+void write_binary_parameters(const Port_Parameters& parameters, Output_Sink& sink);
+
+/**********************************************************************************************//**
+ * \brief Reads what write_binary_parameters wrote. The header is checked against a limit of
+ *        4096 ports and, on a seekable stream, against the bytes actually left, before anything
+ *        is allocated.
+ *
+ * \note  Throws Invalid_Parameter_Stream_Exception on a stream in any other format.
+ *************************************************************************************************/
+Port_Parameters read_binary_parameters(std::istream& stream);
+
+} // namespace Circlyzer
+
+#endif
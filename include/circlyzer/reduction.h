@@ -0,0 +1,77 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+#include "compiled_network.h"
+#include "network.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Replaces a triangle of three branches with a star around a new node.
+ *
+ *        The branches must connect three distinct nodes pairwise and hold the same kind of
+ *        passive component, so the star can be built from the same kind: resistors and inductors
+ *        transform like impedances, capacitors like their inverse. The triangle's branches are
+ *        destroyed along with their aliases.
+ *
+ * \return UID of the new star node
+ *************************************************************************************************/
+uint32_t delta_to_wye(Network& network, const std::array<uint32_t, 3U>& branch_uids);
+
+/**********************************************************************************************//**
+ * \brief Replaces a node with exactly three branches of the same passive kind by a triangle
+ *        between its neighbours. The node and its branches are destroyed.
+ *
+ * \return UIDs of the new branches, between the neighbours in the order the star's branches
+ *         were listed: first-second, second-third, third-first
+ *************************************************************************************************/
+std::array<uint32_t, 3U> wye_to_delta(Network& network, uint32_t star_node_uid);
+
+struct Reduction_Options
+{
+    // Eliminate any remaining node with a generalised star-mesh transform when no series,
+    // parallel, delta-wye or wye-delta step applies. Without it such networks are refused.
+    bool allow_star_mesh = true;
+};
+
+struct Reduction_Result
+{
+    std::complex<double> impedance;
+
+    // How often each step was applied
+    std::size_t series;
+    std::size_t parallel;
+    std::size_t delta_to_wye;
+    std::size_t wye_to_delta;
+    std::size_t star_mesh;
+};
+
+/**********************************************************************************************//**
+ * \brief Equivalent impedance between two nodes, found by reducing the network rather than
+ *        solving it.
+ *
+ *        Branches are evaluated at the angular frequency. Voltage sources and zero impedances are
+ *        shorts, open circuits drop out. The reducer applies series, parallel and dangling
+ *        branch removal until none are left, then picks the delta-wye or wye-delta transform
+ *        that lets the most series/parallel steps follow, and repeats. Ports not connected to
+ *        each other give an infinite impedance.
+ *
+ *        Throws Irreducible_Network_Exception if the reduction stalls with star-mesh disabled.
+ *************************************************************************************************/
+Reduction_Result reduce_impedance(const Compiled_Network& network, uint32_t first_port_uid,
+                                  uint32_t second_port_uid, double frequency = 0.0,
+                                  const Reduction_Options& options = {});
+
+Reduction_Result reduce_impedance(const Network& network, uint32_t first_port_uid,
+                                  uint32_t second_port_uid, double frequency = 0.0,
+                                  const Reduction_Options& options = {});
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef RESULT_H
+#define RESULT_H
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <variant>
+
+#include "exceptions.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief The routine failures of the Network API, one for each exception in exceptions.h that
+ *        the throwing functions can raise
+ *************************************************************************************************/
+enum class Network_Error : uint32_t
+{
+    Non_Existant_UID,
+    Non_Existant_Alias,
+    Invalid_Alias,
+    Duplicate_Alias,
+    Wrong_Entity_Type,
+    Null_Component,
+    Stale_Handle
+};
+
+/**********************************************************************************************//**
+ * \brief Raises the exception the throwing API uses for an error
+ * \param error
+ *************************************************************************************************/
+[[noreturn]] inline void throw_network_error(const Network_Error error)
+{
+    switch(error)
+    {
+        case Network_Error::Non_Existant_UID:   throw Non_Existant_UID_Exception();
+        case Network_Error::Non_Existant_Alias: throw Non_Existant_Alias_Exception();
+        case Network_Error::Invalid_Alias:      throw Invalid_Alias_Exception();
+        case Network_Error::Duplicate_Alias:    throw Duplicate_Alias_Exception();
+        case Network_Error::Wrong_Entity_Type:  throw Wrong_Entity_Type_Exception();
+        case Network_Error::Null_Component:     throw Null_Component_Exception();
+        case Network_Error::Stale_Handle:       throw Stale_Handle_Exception();
+    }
+
+    throw Non_Existant_UID_Exception();
+}
+
+/**********************************************************************************************//**
+ * \brief Either a value or the Network_Error that prevented it, in the style of std::expected.
+ *
+ *        Checking has_value() and reading error() never throws. value() on a failed result
+ *        throws the exception the throwing API would have raised, so a Result can always be
+ *        unwrapped into the old behaviour.
+ *
+ * \pre   error() requires has_value() to be false, and operator* and operator-> require it to be
+ *        true. Both are asserted, as neither is checked in release builds.
+ *************************************************************************************************/
+template<typename T>
+class Result
+{
+public:
+    Result(const T& value) :
+        storage(std::in_place_index<0U>, value)
+    {
+
+    }
+
+    Result(T&& value) :
+        storage(std::in_place_index<0U>, std::move(value))
+    {
+
+    }
+
+    Result(const Network_Error error) :
+        storage(std::in_place_index<1U>, error)
+    {
+
+    }
+
+    bool has_value() const
+    {
+        return storage.index() == 0U;
+    }
+
+    explicit operator bool() const
+    {
+        return has_value();
+    }
+
+    const T& value() const
+    {
+        if(!has_value())
+        {
+            throw_network_error(error());
+        }
+
+        return *std::get_if<0U>(&storage);
+    }
+
+    T& value()
+    {
+        if(!has_value())
+        {
+            throw_network_error(error());
+        }
+
+        return *std::get_if<0U>(&storage);
+    }
+
+    T value_or(T fallback) const
+    {
+        return has_value() ? *std::get_if<0U>(&storage) : std::move(fallback);
+    }
+
+    Network_Error error() const
+    {
+        assert(!has_value() && "error() read from a Result holding a value");
+        return *std::get_if<1U>(&storage);
+    }
+
+    const T& operator*() const
+    {
+        assert(has_value() && "Dereferenced a Result holding an error");
+        return *std::get_if<0U>(&storage);
+    }
+
+    const T* operator->() const
+    {
+        assert(has_value() && "Dereferenced a Result holding an error");
+        return std::get_if<0U>(&storage);
+    }
+
+private:
+    std::variant<T, Network_Error> storage;
+};
+
+/**********************************************************************************************//**
+ * \brief Result of an operation that produces nothing but can still fail. error() has the same
+ *        precondition as for Result<T>.
+ *************************************************************************************************/
+template<>
+class Result<void>
+{
+public:
+    Result() :
+        failed{ false },
+        failure{ Network_Error::Non_Existant_UID }
+    {
+
+    }
+
+    Result(const Network_Error error) :
+        failed{ true },
+        failure{ error }
+    {
+
+    }
+
+    bool has_value() const
+    {
+        return !failed;
+    }
+
+    explicit operator bool() const
+    {
+        return has_value();
+    }
+
+    void value() const
+    {
+        if(failed)
+        {
+            throw_network_error(failure);
+        }
+    }
+
+    Network_Error error() const
+    {
+        assert(failed && "error() read from a successful Result");
+        return failure;
+    }
+
+private:
+    bool failed;
+    Network_Error failure;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Lock-free ring buffer for one producer thread and one consumer thread.
+ *
+ *        The capacity is rounded up to a power of two and allocated once, on construction, so
+ *        neither side ever allocates or blocks. Values can be moved one at a time or as whole
+ *        frames: a frame is pushed or popped entirely or not at all, which keeps multi-channel
+ *        samples aligned without any framing of their own.
+ *
+ *        Each side keeps a private copy of the other side's position and only reloads it when
+ *        the copy says the buffer is full or empty, so the shared positions, each on its own
+ *        cache line, are touched rarely.
+ *************************************************************************************************/
+template<typename T>
+class Ring_Buffer
+{
+public:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64U;
+
+    explicit Ring_Buffer(const std::size_t capacity) :
+        slots(std::bit_ceil(std::max<std::size_t>(capacity, 1U))),
+        mask{ slots.size() - 1U },
+        head{ 0U },
+        cached_tail{ 0U },
+        tail{ 0U },
+        cached_head{ 0U }
+    {
+
+    }
+
+    virtual ~Ring_Buffer() = default;
+
+    Ring_Buffer(const Ring_Buffer&) = delete;
+    Ring_Buffer& operator=(const Ring_Buffer&) = delete;
+
+    /**
+     * \brief Producer side. Returns false, pushing nothing, if the frame doesn't fit.
+     */
+    bool try_push(std::span<const T> values)
+    {
+        const auto position = tail.load(std::memory_order_relaxed);
+        if((slots.size() - (position - cached_head)) < values.size())
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if((slots.size() - (position - cached_head)) < values.size())
+            {
+                return false;
+            }
+        }
+
+        for(std::size_t index = 0U; index < values.size(); ++index)
+        {
+            slots[(position + index) & mask] = values[index];
+        }
+
+        tail.store(position + values.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value)
+    {
+        return try_push(std::span<const T>(&value, 1U));
+    }
+
+    /**
+     * \brief Consumer side. Returns false, popping nothing, unless a whole frame is available.
+     */
+    bool try_pop(std::span<T> values)
+    {
+        const auto position = head.load(std::memory_order_relaxed);
+        if((cached_tail - position) < values.size())
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if((cached_tail - position) < values.size())
+            {
+                return false;
+            }
+        }
+
+        for(std::size_t index = 0U; index < values.size(); ++index)
+        {
+            values[index] = slots[(position + index) & mask];
+        }
+
+        head.store(position + values.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value)
+    {
+        return try_pop(std::span<T>(&value, 1U));
+    }
+
+    // Only a snapshot while the other side is running
+    std::size_t get_size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    std::size_t get_capacity() const
+    {
+        return slots.size();
+    }
+
+private:
+    std::vector<T> slots;
+    std::size_t mask;
+
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head;
+    std::size_t cached_tail;
+
+    // Producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail;
+    std::size_t cached_head;
+};
+
+} // namespace Circlyzer
+
+#endif
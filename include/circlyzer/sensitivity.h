@@ -0,0 +1,56 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "nodal_analysis.h"
+#include "sparse_matrix.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Derivative of one output voltage with respect to every passive component value.
+ *        Entries follow branch_uids: d(output)/dR in volts per ohm, d(output)/dC in volts per
+ *        farad and d(output)/dL in volts per henry. Voltage sources are not included.
+ *************************************************************************************************/
+struct Sensitivity_Result
+{
+    uint32_t output_node_uid;
+    std::complex<double> output_voltage;
+    std::vector<uint32_t> branch_uids;
+    std::vector<std::complex<double>> sensitivities;
+};
+
+/**********************************************************************************************//**
+ * \brief Adjoint sensitivity analysis.
+ *
+ *        The MNA system A x = b is assembled sparse, factorized and solved once on construction.
+ *        For an output v = e^T x, one transposed solve A^T l = e with the same factors gives
+ *        dv/dp = -l^T (dA/dp) x for every component at once, since the excitation does not
+ *        depend on any R, L or C value. Each further output node costs one more transposed
+ *        solve, against the factorization already held.
+ *************************************************************************************************/
+class Sensitivity_Analysis
+{
+public:
+    Sensitivity_Analysis(const Nodal_Analysis& analysis, double frequency = 0.0);
+    virtual ~Sensitivity_Analysis() = default;
+
+    Sensitivity_Result get_sensitivities(uint32_t output_node_uid) const;
+
+    const std::vector<std::complex<double>>& get_unknowns() const;
+    double get_frequency() const;
+
+private:
+    Nodal_Analysis analysis;
+    double frequency;
+    Sparse_LU_Factorization<std::complex<double>> factorization;
+    std::vector<std::complex<double>> unknowns;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,609 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "exceptions.h"
+#include "executor.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Compressed sparse row matrix. Like Dense_Matrix this only carries what the analysis code
+ *        needs: assembly from unordered entries, lookups and the matrix-vector product.
+ *
+ *        Each row's column indices are sorted and unique, entries given more than once on
+ *        construction are summed the same way stamps accumulate into an MNA matrix.
+ *************************************************************************************************/
+template<typename T>
+class Sparse_Matrix
+{
+public:
+    struct Entry
+    {
+        std::size_t row;
+        std::size_t column;
+        T value;
+    };
+
+    Sparse_Matrix() :
+        rows{ 0U },
+        columns{ 0U },
+        row_offsets(1U, 0U),
+        column_indices(),
+        values()
+    {
+
+    }
+
+    Sparse_Matrix(const std::size_t rows, const std::size_t columns, std::vector<Entry> entries) :
+        rows{ rows },
+        columns{ columns },
+        row_offsets(rows + 1U, 0U),
+        column_indices(),
+        values()
+    {
+        // Counting sort by row keeps assembly linear, only the short rows are sorted by column
+        for(const auto& entry : entries)
+        {
+            ++row_offsets[entry.row + 1U];
+        }
+
+        for(std::size_t row = 0U; row < rows; ++row)
+        {
+            row_offsets[row + 1U] += row_offsets[row];
+        }
+
+        std::vector<std::pair<std::size_t, T>> ordered(entries.size());
+        std::vector<std::size_t> cursor(row_offsets.begin(), row_offsets.end() - 1);
+        for(auto& entry : entries)
+        {
+            ordered[cursor[entry.row]++] = { entry.column, std::move(entry.value) };
+        }
+
+        entries.clear();
+        entries.shrink_to_fit();
+
+        column_indices.reserve(ordered.size());
+        values.reserve(ordered.size());
+
+        std::size_t first = 0U;
+        for(std::size_t row = 0U; row < rows; ++row)
+        {
+            const auto last = row_offsets[row + 1U];
+            std::sort(ordered.begin() + first, ordered.begin() + last,
+                      [](const auto& one, const auto& two) { return one.first < two.first; });
+
+            row_offsets[row + 1U] = row_offsets[row];
+            for(auto index = first; index < last; ++index)
+            {
+                if((index > first) && (ordered[index].first == ordered[index - 1U].first))
+                {
+                    values.back() += ordered[index].second;
+                    continue;
+                }
+
+                column_indices.push_back(ordered[index].first);
+                values.push_back(ordered[index].second);
+                ++row_offsets[row + 1U];
+            }
+
+            first = last;
+        }
+    }
+
+    std::size_t get_number_of_rows() const
+    {
+        return rows;
+    }
+
+    std::size_t get_number_of_columns() const
+    {
+        return columns;
+    }
+
+    std::size_t get_number_of_nonzeros() const
+    {
+        return values.size();
+    }
+
+    const std::vector<std::size_t>& get_row_offsets() const
+    {
+        return row_offsets;
+    }
+
+    const std::vector<std::size_t>& get_column_indices() const
+    {
+        return column_indices;
+    }
+
+    const std::vector<T>& get_values() const
+    {
+        return values;
+    }
+
+    /**
+     * \brief Stored value at (row, column), or zero when the entry is not in the pattern
+     */
+    T get(const std::size_t row, const std::size_t column) const
+    {
+        const auto first = column_indices.begin() + row_offsets[row];
+        const auto last = column_indices.begin() + row_offsets[row + 1U];
+        const auto found = std::lower_bound(first, last, column);
+
+        if((found == last) || (*found != column))
+        {
+            return T{};
+        }
+
+        return values[static_cast<std::size_t>(found - column_indices.begin())];
+    }
+
+    /**
+     * \brief Index of the diagonal entry of each row, or get_number_of_nonzeros() where the row
+     *        has none
+     */
+    std::vector<std::size_t> get_diagonal_positions() const
+    {
+        std::vector<std::size_t> positions(rows, values.size());
+
+        for(std::size_t row = 0U; row < std::min(rows, columns); ++row)
+        {
+            const auto first = column_indices.begin() + row_offsets[row];
+            const auto last = column_indices.begin() + row_offsets[row + 1U];
+            const auto found = std::lower_bound(first, last, row);
+
+            if((found != last) && (*found == row))
+            {
+                positions[row] = static_cast<std::size_t>(found - column_indices.begin());
+            }
+        }
+
+        return positions;
+    }
+
+    /**
+     * \brief y = A x for the rows in [first_row, last_row)
+     */
+    void multiply(const std::vector<T>& vector, std::vector<T>& result,
+                  const std::size_t first_row, const std::size_t last_row) const
+    {
+        for(auto row = first_row; row < last_row; ++row)
+        {
+            auto accumulator = T{};
+            for(auto index = row_offsets[row]; index < row_offsets[row + 1U]; ++index)
+            {
+                accumulator += values[index] * vector[column_indices[index]];
+            }
+
+            result[row] = accumulator;
+        }
+    }
+
+    void multiply(const std::vector<T>& vector, std::vector<T>& result) const
+    {
+        result.resize(rows);
+        multiply(vector, result, 0U, rows);
+    }
+
+    /**
+     * \brief y = A x with the rows split across the executor. Every row is written by exactly one
+     *        chunk, so no synchronisation is needed beyond the join in parallel_for.
+     */
+    void multiply(const std::vector<T>& vector, std::vector<T>& result, Executor& executor) const
+    {
+        result.resize(rows);
+        executor.parallel_for(0U, rows, [&](const std::size_t first, const std::size_t last)
+        {
+            multiply(vector, result, first, last);
+        });
+    }
+
+    std::vector<T> multiply(const std::vector<T>& vector) const
+    {
+        std::vector<T> result(rows, T{});
+        multiply(vector, result, 0U, rows);
+        return result;
+    }
+
+private:
+    std::size_t rows;
+    std::size_t columns;
+    std::vector<std::size_t> row_offsets;
+    std::vector<std::size_t> column_indices;
+    std::vector<T> values;
+};
+
+/**********************************************************************************************//**
+ * \brief Sparse direct LU factorization, P A Q = L U, for systems too large for LU_Factorization.
+ *
+ *        Columns are ordered by minimum degree on the pattern of A + A^T, which keeps the fill of
+ *        tree and mesh shaped networks low. Each column is then factorized left-looking
+ *        (Gilbert-Peierls): a sparse triangular solve against the columns before it, visiting
+ *        only the rows it can reach, so the work is proportional to the arithmetic done. Rows
+ *        are chosen by threshold partial pivoting. The diagonal is kept while it is within
+ *        PIVOT_THRESHOLD of the largest candidate, so zero diagonals such as the current row of
+ *        a voltage source are pivoted around.
+ *
+ * \note  Throws Singular_Matrix_Exception if a column has no usable pivot.
+ *************************************************************************************************/
+template<typename T>
+class Sparse_LU_Factorization
+{
+public:
+    static constexpr double PIVOT_THRESHOLD = 0.1;
+
+    explicit Sparse_LU_Factorization(const Sparse_Matrix<T>& matrix) :
+        size{ matrix.get_number_of_rows() },
+        column_order(order_columns(matrix)),
+        pivot_rows(size),
+        lower_offsets(1U, 0U),
+        lower_rows(),
+        lower_values(),
+        upper_offsets(1U, 0U),
+        upper_steps(),
+        upper_values(),
+        diagonal()
+    {
+        constexpr auto NOT_PIVOTED = std::numeric_limits<std::size_t>::max();
+
+        // Column access to A, by transposing the row storage
+        const auto& row_offsets = matrix.get_row_offsets();
+        const auto& column_indices = matrix.get_column_indices();
+        const auto& values = matrix.get_values();
+
+        std::vector<std::size_t> column_offsets(size + 1U, 0U);
+        for(const auto column : column_indices)
+        {
+            ++column_offsets[column + 1U];
+        }
+
+        for(std::size_t column = 0U; column < size; ++column)
+        {
+            column_offsets[column + 1U] += column_offsets[column];
+        }
+
+        std::vector<std::size_t> column_rows(values.size());
+        std::vector<T> column_values(values.size());
+        std::vector<std::size_t> cursor(column_offsets.begin(), column_offsets.end() - 1);
+        for(std::size_t row = 0U; row < size; ++row)
+        {
+            for(auto index = row_offsets[row]; index < row_offsets[row + 1U]; ++index)
+            {
+                const auto position = cursor[column_indices[index]]++;
+                column_rows[position] = row;
+                column_values[position] = values[index];
+            }
+        }
+
+        std::vector<std::size_t> step_of_row(size, NOT_PIVOTED);
+        std::vector<T> work(size, T{});
+        std::vector<char> visited(size, 0);
+        std::vector<std::size_t> reach;
+        std::vector<std::pair<std::size_t, std::size_t>> stack;
+
+        for(std::size_t step = 0U; step < size; ++step)
+        {
+            const auto column = column_order[step];
+
+            // Rows reachable through the earlier L columns, in depth first postorder
+            reach.clear();
+            for(auto index = column_offsets[column]; index < column_offsets[column + 1U]; ++index)
+            {
+                const auto start = column_rows[index];
+                if(visited[start] != 0)
+                {
+                    continue;
+                }
+
+                visited[start] = 1;
+                stack.push_back({ start, 0U });
+                while(!stack.empty())
+                {
+                    const auto row = stack.back().first;
+                    const auto pivot_step = step_of_row[row];
+
+                    auto child = NOT_PIVOTED;
+                    if(pivot_step != NOT_PIVOTED)
+                    {
+                        auto& position = stack.back().second;
+                        const auto end = lower_offsets[pivot_step + 1U];
+                        for(auto next = lower_offsets[pivot_step] + position; next < end; ++next)
+                        {
+                            ++position;
+                            if(visited[lower_rows[next]] == 0)
+                            {
+                                child = lower_rows[next];
+                                break;
+                            }
+                        }
+                    }
+
+                    if(child != NOT_PIVOTED)
+                    {
+                        visited[child] = 1;
+                        stack.push_back({ child, 0U });
+                        continue;
+                    }
+
+                    reach.push_back(row);
+                    stack.pop_back();
+                }
+            }
+
+            for(auto index = column_offsets[column]; index < column_offsets[column + 1U]; ++index)
+            {
+                work[column_rows[index]] = column_values[index];
+            }
+
+            // Reverse postorder applies every earlier column before the rows it updates are read
+            for(auto index = reach.size(); index-- > 0U;)
+            {
+                const auto row = reach[index];
+                const auto pivot_step = step_of_row[row];
+                if((pivot_step == NOT_PIVOTED) || (work[row] == T{}))
+                {
+                    continue;
+                }
+
+                const auto value = work[row];
+                for(auto entry = lower_offsets[pivot_step]; entry < lower_offsets[pivot_step + 1U]; ++entry)
+                {
+                    work[lower_rows[entry]] -= lower_values[entry] * value;
+                }
+            }
+
+            auto pivot_row = NOT_PIVOTED;
+            double largest = 0.0;
+            for(const auto row : reach)
+            {
+                if((step_of_row[row] == NOT_PIVOTED) && (std::abs(work[row]) > largest))
+                {
+                    pivot_row = row;
+                    largest = std::abs(work[row]);
+                }
+            }
+
+            if(!(largest > 0.0) || !std::isfinite(largest))
+            {
+                throw Singular_Matrix_Exception();
+            }
+
+            if((step_of_row[column] == NOT_PIVOTED) && (std::abs(work[column]) >= (PIVOT_THRESHOLD * largest)))
+            {
+                pivot_row = column;
+            }
+
+            const auto pivot = work[pivot_row];
+            for(const auto row : reach)
+            {
+                if(work[row] == T{})
+                {
+                    continue;
+                }
+
+                if(step_of_row[row] != NOT_PIVOTED)
+                {
+                    upper_steps.push_back(step_of_row[row]);
+                    upper_values.push_back(work[row]);
+                }
+                else if(row != pivot_row)
+                {
+                    lower_rows.push_back(row);
+                    lower_values.push_back(work[row] / pivot);
+                }
+            }
+
+            diagonal.push_back(pivot);
+            lower_offsets.push_back(lower_rows.size());
+            upper_offsets.push_back(upper_steps.size());
+            step_of_row[pivot_row] = step;
+            pivot_rows[step] = pivot_row;
+
+            for(const auto row : reach)
+            {
+                work[row] = T{};
+                visited[row] = 0;
+            }
+        }
+    }
+
+    /**
+     * \brief Solves A x = b for x using the stored factors
+     */
+    std::vector<T> solve(const std::vector<T>& rhs) const
+    {
+        std::vector<T> solution;
+        solve(rhs, solution);
+        return solution;
+    }
+
+    /**
+     * \brief Solves A x = b into the provided solution. The solution must not be the right hand
+     *        side itself.
+     */
+    void solve(const std::vector<T>& rhs, std::vector<T>& solution) const
+    {
+        std::vector<T> remaining(rhs);
+        std::vector<T> steps(size);
+
+        // Forward substitution through the unit lower factor, in pivot order
+        for(std::size_t step = 0U; step < size; ++step)
+        {
+            const auto value = remaining[pivot_rows[step]];
+            steps[step] = value;
+
+            for(auto entry = lower_offsets[step]; entry < lower_offsets[step + 1U]; ++entry)
+            {
+                remaining[lower_rows[entry]] -= lower_values[entry] * value;
+            }
+        }
+
+        // Backward substitution, one column of the upper factor at a time
+        solution.resize(size);
+        for(auto step = size; step-- > 0U;)
+        {
+            const auto value = steps[step] / diagonal[step];
+            for(auto entry = upper_offsets[step]; entry < upper_offsets[step + 1U]; ++entry)
+            {
+                steps[upper_steps[entry]] -= upper_values[entry] * value;
+            }
+
+            solution[column_order[step]] = value;
+        }
+    }
+
+    /**
+     * \brief Solves A^T x = b for x with the same factors. With P A Q = L U this is
+     *        U^T L^T P x = Q^T b: a forward pass through U^T, whose rows are the stored columns
+     *        of U, then a backward pass through L^T. The transpose is not conjugated.
+     */
+    std::vector<T> solve_transposed(const std::vector<T>& rhs) const
+    {
+        std::vector<T> steps(size);
+
+        // Forward substitution through U^T, one dot product with a column of U per step
+        for(std::size_t step = 0U; step < size; ++step)
+        {
+            auto accumulator = rhs[column_order[step]];
+            for(auto entry = upper_offsets[step]; entry < upper_offsets[step + 1U]; ++entry)
+            {
+                accumulator -= upper_values[entry] * steps[upper_steps[entry]];
+            }
+
+            steps[step] = accumulator / diagonal[step];
+        }
+
+        // Backward substitution through L^T, whose rows below a step are already solved
+        std::vector<T> solution(size);
+        for(auto step = size; step-- > 0U;)
+        {
+            auto accumulator = steps[step];
+            for(auto entry = lower_offsets[step]; entry < lower_offsets[step + 1U]; ++entry)
+            {
+                accumulator -= lower_values[entry] * solution[lower_rows[entry]];
+            }
+
+            solution[pivot_rows[step]] = accumulator;
+        }
+
+        return solution;
+    }
+
+    /**
+     * \brief Entries stored in L and U together, including the diagonal
+     */
+    std::size_t get_number_of_nonzeros() const
+    {
+        return lower_values.size() + upper_values.size() + diagonal.size();
+    }
+
+private:
+    /**
+     * \brief Minimum degree ordering on the elimination graph of A + A^T. Eliminating a vertex
+     *        joins its neighbours into a clique, which is exactly the fill it would cause.
+     */
+    static std::vector<std::size_t> order_columns(const Sparse_Matrix<T>& matrix)
+    {
+        using Candidate = std::pair<std::size_t, std::size_t>;
+
+        const auto size = matrix.get_number_of_rows();
+        const auto& row_offsets = matrix.get_row_offsets();
+        const auto& column_indices = matrix.get_column_indices();
+
+        std::vector<std::vector<std::size_t>> neighbours(size);
+        for(std::size_t row = 0U; row < size; ++row)
+        {
+            for(auto index = row_offsets[row]; index < row_offsets[row + 1U]; ++index)
+            {
+                const auto column = column_indices[index];
+                if(column != row)
+                {
+                    neighbours[row].push_back(column);
+                    neighbours[column].push_back(row);
+                }
+            }
+        }
+
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+        for(std::size_t vertex = 0U; vertex < size; ++vertex)
+        {
+            auto& list = neighbours[vertex];
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+            candidates.push({ list.size(), vertex });
+        }
+
+        std::vector<std::size_t> order;
+        order.reserve(size);
+        std::vector<char> eliminated(size, 0);
+        std::vector<std::size_t> merged;
+
+        while(!candidates.empty())
+        {
+            const auto [degree, vertex] = candidates.top();
+            candidates.pop();
+
+            // Stale entries are left in the queue when a degree changes
+            if((eliminated[vertex] != 0) || (degree != neighbours[vertex].size()))
+            {
+                continue;
+            }
+
+            eliminated[vertex] = 1;
+            order.push_back(vertex);
+
+            const auto clique = std::move(neighbours[vertex]);
+            neighbours[vertex].clear();
+
+            for(const auto neighbour : clique)
+            {
+                auto& list = neighbours[neighbour];
+                merged.clear();
+                std::set_union(list.begin(), list.end(), clique.begin(), clique.end(),
+                               std::back_inserter(merged));
+                merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                            [&](const std::size_t other)
+                                            {
+                                                return (other == neighbour) || (other == vertex);
+                                            }),
+                             merged.end());
+
+                list.swap(merged);
+                candidates.push({ list.size(), neighbour });
+            }
+        }
+
+        return order;
+    }
+
+    std::size_t size;
+
+    // Step k factorizes column column_order[k] and pivots on row pivot_rows[k]
+    std::vector<std::size_t> column_order;
+    std::vector<std::size_t> pivot_rows;
+
+    // Columns of L below the unit diagonal, by step, holding original row indices
+    std::vector<std::size_t> lower_offsets;
+    std::vector<std::size_t> lower_rows;
+    std::vector<T> lower_values;
+
+    // Columns of U above the diagonal, by step, holding the steps of the rows they sit in
+    std::vector<std::size_t> upper_offsets;
+    std::vector<std::size_t> upper_steps;
+    std::vector<T> upper_values;
+    std::vector<T> diagonal;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef STREAMING_ANALYSIS_H
+#define STREAMING_ANALYSIS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include "compiled_network.h"
+#include "matrix.h"
+#include "network.h"
+#include "nodal_analysis.h"
+#include "ring_buffer.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Histogram of latencies in nanoseconds, with log-linear buckets.
+ *
+ *        Values below 32 ns have a bucket each. Above that every power of two is split into 16
+ *        buckets, so a reported percentile is within 6.25% of the true value, over the whole
+ *        64 bit range, in a fixed table of under a thousand counters. Recording never allocates
+ *        and the counters are relaxed atomics, so one thread can record while others read.
+ *************************************************************************************************/
+class Latency_Histogram
+{
+public:
+    static constexpr std::size_t SUB_BUCKET_BITS = 4U;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t{ 1U } << SUB_BUCKET_BITS;
+    static constexpr std::size_t NUMBER_OF_BUCKETS = (64U - SUB_BUCKET_BITS + 1U) * SUB_BUCKETS;
+
+    Latency_Histogram();
+    virtual ~Latency_Histogram() = default;
+
+    void record(uint64_t nanoseconds);
+    void reset();
+
+    uint64_t get_count() const;
+    uint64_t get_minimum() const;
+    uint64_t get_maximum() const;
+    double get_mean() const;
+
+    // Upper bound of the bucket holding the requested fraction of the samples, between 0 and 1
+    uint64_t get_percentile(double fraction) const;
+
+    uint64_t get_bucket_count(std::size_t bucket) const;
+    static std::size_t get_bucket(uint64_t nanoseconds);
+    static uint64_t get_bucket_lower_bound(std::size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, NUMBER_OF_BUCKETS> buckets;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> minimum;
+    std::atomic<uint64_t> maximum;
+};
+
+enum class Integration_Method
+{
+    Backward_Euler,
+    Trapezoidal
+};
+
+/**********************************************************************************************//**
+ * \brief Fixed time step transient analysis driven one sample at a time.
+ *
+ *        Capacitors and inductors are replaced by their companion models for the chosen
+ *        integration method. With a fixed step the MNA matrix doesn't change, so it is
+ *        factorized once, on construction. A step then only writes the new source samples and
+ *        the companion history into the right hand side, runs the triangular solves and updates
+ *        the history, all in storage sized up front: a step never allocates and always does the
+ *        same work.
+ *
+ *        The streamed sources are given by UID. Each step takes one sample per streamed source,
+ *        in that order, and produces the voltage of each probed node, in that order. Voltage
+ *        sources that aren't streamed hold their value. The circuit starts at rest, with every
+ *        capacitor discharged and no inductor current. Diodes are open circuits.
+ *
+ *        process() and run() connect the analysis to Ring_Buffers of frames, for a producer
+ *        reading files or generating waveforms on one thread and a consumer on another. Each
+ *        step is timed, from taking its input frame to handing over its output frame, into the
+ *        latency histogram.
+ *
+ * \note  Throws Invalid_Streaming_Exception for a time step that isn't positive, no streamed
+ *        sources, or a streamed UID that isn't a connected voltage source, and
+ *        Non_Existant_UID_Exception for a probe that isn't a node. process() and run() throw
+ *        Invalid_Streaming_Exception for a ring buffer too small to hold one frame, which would
+ *        otherwise never fill or never drain.
+ *************************************************************************************************/
+class Streaming_Analysis
+{
+public:
+    Streaming_Analysis(const Compiled_Network& network, uint32_t ground_uid, double time_step,
+                       const std::vector<uint32_t>& source_uids, const std::vector<uint32_t>& probe_uids,
+                       Integration_Method method = Integration_Method::Trapezoidal);
+    Streaming_Analysis(const Network& network, uint32_t ground_uid, double time_step,
+                       const std::vector<uint32_t>& source_uids, const std::vector<uint32_t>& probe_uids,
+                       Integration_Method method = Integration_Method::Trapezoidal);
+    virtual ~Streaming_Analysis() = default;
+
+    void step(std::span<const double> samples, std::span<double> outputs);
+
+    // Steps once per whole input frame available, up to maximum_steps, returning the steps taken
+    std::size_t process(Ring_Buffer<double>& input, Ring_Buffer<double>& output,
+                        std::size_t maximum_steps = SIZE_MAX);
+
+    // Processes until the token is stopped, yielding whenever the input runs dry
+    void run(Ring_Buffer<double>& input, Ring_Buffer<double>& output, std::stop_token token);
+
+    void reset();
+
+    double get_time() const;
+    double get_time_step() const;
+    uint64_t get_number_of_steps() const;
+    uint64_t get_number_of_dropped_outputs() const;
+    std::size_t get_number_of_sources() const;
+    std::size_t get_number_of_probes() const;
+
+    const Latency_Histogram& get_latency_histogram() const;
+    Latency_Histogram& get_latency_histogram();
+
+private:
+    struct Storage_Element
+    {
+        std::size_t first;
+        std::size_t second;
+        std::size_t current_index;
+        double coefficient;
+        double voltage;
+        double current;
+    };
+
+    double voltage_at(std::size_t index) const;
+
+    double time_step;
+    Integration_Method method;
+
+    LU_Factorization<double> factorization;
+
+    // Right hand side with the sources that aren't streamed, copied in at every step
+    std::vector<double> base_excitation;
+    std::vector<std::size_t> source_rows;
+    std::vector<std::size_t> probe_indices;
+
+    std::vector<Storage_Element> capacitors;
+    std::vector<Storage_Element> inductors;
+
+    std::vector<double> excitation;
+    std::vector<double> unknowns;
+    std::vector<double> input_frame;
+    std::vector<double> output_frame;
+
+    std::atomic<uint64_t> number_of_steps;
+    std::atomic<uint64_t> number_of_dropped_outputs;
+    Latency_Histogram latency;
+};
+
+} // namespace Circlyzer
+
+#endif
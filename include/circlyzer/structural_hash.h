@@ -0,0 +1,128 @@
+#ifndef STRUCTURAL_HASH_H
+#define STRUCTURAL_HASH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "network.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief Canonical hash of a Network's structure: its topology and component values, but not its
+ *        UID numbering or aliases. Two networks that differ only in how they were numbered or
+ *        named hash the same.
+ *
+ *        Nodes are labelled by colour refinement (Weisfeiler-Lehman). Every node starts with the
+ *        same colour, and each round a node's colour is mixed with the multiset of (component,
+ *        terminal, neighbour colour) over its incident branches. Terminals are told apart only
+ *        for voltage sources and diodes, whose orientation matters. After the final round each
+ *        branch is labelled by its component and its terminals' colours, and the hash combines
+ *        the multisets of node and branch labels.
+ *
+ *        The hash is kept up to date through the network's Journal. A change only alters colours
+ *        within rounds hops of the entities it touched, so only that neighbourhood is recoloured
+ *        and only the branches around it are relabelled. An edit next to a hub, such as a ground
+ *        node shared by every shunt element, still reaches most of the network. A journal
+ *        compaction the hash has not seen forces a full rebuild.
+ *
+ *        A stable colouring refines the same state further, until the partition stops
+ *        splitting, with some nodes such as a ground or ports given colours of their own. It is
+ *        computed on first use after a change and kept for that journal sequence.
+ *
+ * \note  Like any refinement hash this is not a proof of isomorphism. Networks that refinement
+ *        cannot tell apart, such as some regular graphs with identical components, share a hash,
+ *        and so do 64 bit collisions.
+ *************************************************************************************************/
+class Structural_Hash
+{
+public:
+    static constexpr uint32_t DEFAULT_ROUNDS = 3U;
+
+    /**
+     * \brief Colours numbered from the structure alone, so they compare exactly between
+     *        networks. The fingerprint is the number of nodes of each colour, each branch's
+     *        component and terminal colours in sorted order, then the colour of each role.
+     *        Networks that share it can't be told apart by refinement, nor by a linear solve:
+     *        every colour class gets the same voltages in both. A branch's label is its
+     *        component and its terminals' colours.
+     */
+    struct Stable_Colouring
+    {
+        std::vector<uint64_t> fingerprint;
+        std::unordered_map<uint32_t, uint64_t> node_colours;
+        std::unordered_map<uint32_t, uint64_t> branch_labels;
+    };
+
+    explicit Structural_Hash(const Network& network, uint32_t rounds = DEFAULT_ROUNDS);
+    virtual ~Structural_Hash() = default;
+
+    uint64_t get_hash();
+
+    // Labels that identify an entity by its place in the structure rather than by its UID
+    uint64_t get_node_label(uint32_t node_uid);
+    uint64_t get_branch_label(uint32_t branch_uid);
+
+    // Refinement until stable with the role nodes coloured apart, in the order given
+    const Stable_Colouring& get_stable_colouring(const std::vector<uint32_t>& role_uids);
+
+    void synchronize();
+
+    const Network& get_network() const;
+    std::size_t get_number_of_recoloured_nodes() const;
+
+private:
+    struct Node_State
+    {
+        std::vector<uint64_t> colours;
+        std::vector<uint32_t> branches;
+    };
+
+    struct Branch_State
+    {
+        // Component type and the bits of its value's real and imaginary parts
+        std::array<uint64_t, 3> value;
+        uint64_t component;
+        bool polarised;
+        std::vector<uint32_t> terminals;
+        uint64_t label;
+        bool counted;
+    };
+
+    void rebuild();
+    void update(std::set<uint32_t> touched_nodes, std::set<uint32_t> touched_branches);
+    uint64_t recolour(uint32_t node_uid, uint32_t round) const;
+    uint64_t relabel(const Branch_State& branch) const;
+    Stable_Colouring refine(const std::vector<uint32_t>& role_uids) const;
+
+    const Network& network;
+    uint32_t rounds;
+
+    std::unordered_map<uint32_t, Node_State> nodes;
+    std::unordered_map<uint32_t, Branch_State> branches;
+
+    // Order independent sums of every node's final colour and every branch label
+    uint64_t node_sum;
+    uint64_t branch_sum;
+
+    // Stable colourings by their roles, for synchronized_sequence only
+    std::map<std::vector<uint32_t>, Stable_Colouring> stable_colourings;
+
+    uint64_t synchronized_sequence;
+    std::size_t number_of_recoloured_nodes;
+};
+
+/**********************************************************************************************//**
+ * \brief Mixes value into seed, in the spirit of boost::hash_combine but with a 64 bit finaliser
+ *************************************************************************************************/
+uint64_t combine_hash(uint64_t seed, uint64_t value);
+
+} // namespace Circlyzer
+
+#endif
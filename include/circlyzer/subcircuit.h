@@ -0,0 +1,169 @@
+#ifndef SUBCIRCUIT_H
+#define SUBCIRCUIT_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "compiled_network.h"
+#include "matrix.h"
+#include "network.h"
+#include "nodal_analysis.h"
+
+namespace Circlyzer
+{
+
+class Subcircuit_Definition;
+
+/**********************************************************************************************//**
+ * \brief One use of a definition. nodes holds, for each of the definition's ports in order, the
+ *        node of the enclosing circuit it is wired to.
+ *************************************************************************************************/
+struct Subcircuit_Instance
+{
+    std::shared_ptr<const Subcircuit_Definition> definition;
+    std::vector<uint32_t> nodes;
+};
+
+/**********************************************************************************************//**
+ * \brief What a definition looks like from its ports at one frequency, the Norton equivalent
+ *
+ *            i = Y v - j
+ *
+ *        where v are the port voltages and i the currents flowing into the ports from outside.
+ *        Y is an indefinite admittance matrix, its rows and columns sum to zero, so only voltage
+ *        differences between ports matter.
+ *
+ *        The factorization of the internal block and the couplings to the ports are kept as well,
+ *        so the internal solution of any instance can be recovered from its port voltages.
+ *************************************************************************************************/
+struct Macromodel
+{
+    Dense_Matrix<std::complex<double>> admittance;
+    std::vector<std::complex<double>> current;
+
+    LU_Factorization<std::complex<double>> internal_factorization;
+    Dense_Matrix<std::complex<double>> internal_response;
+    std::vector<std::complex<double>> internal_offset;
+};
+
+/**********************************************************************************************//**
+ * \brief A reusable block, seen only through its ports.
+ *
+ *        The body is solved with its first port as the reference, so the block floats: a body
+ *        that should see the ground of the circuit it is placed in needs that ground as a port.
+ *        Bodies may instance other definitions in turn.
+ *
+ *        At each frequency every unknown of the body other than the port voltages is eliminated
+ *        once, leaving the Schur complement
+ *
+ *            Y' = A_pp - A_pi A_ii^-1 A_ip,    j' = b_p - A_pi A_ii^-1 b_i
+ *
+ *        over the ports after the first, which is widened to the indefinite Macromodel. The
+ *        result is kept and shared by every instance, from any thread, so a block used a
+ *        thousand times is eliminated once per frequency. Macromodels of the capacity most
+ *        recently used frequencies are kept. Like a Nodal_Analysis, the body is captured on
+ *        construction.
+ *
+ * \note  Throws Invalid_Subcircuit_Exception for fewer than two distinct ports, a port that is
+ *        not a node of the body, or a voltage source directly between two ports.
+ *        Singular_Matrix_Exception is thrown on elimination when the internal block is singular:
+ *        when an internal node has no path to a port, or when the ports are tied by a path of
+ *        zero impedance branches that the Norton form cannot describe. Examples are an inductor
+ *        between two ports at DC, and voltage sources in series between two ports. The flat
+ *        Nodal_Analysis solves such circuits. Inside a block, put a resistor in series with
+ *        the tie.
+ *************************************************************************************************/
+class Subcircuit_Definition
+{
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 16U;
+
+    Subcircuit_Definition(const Compiled_Network& body, const std::vector<uint32_t>& port_uids,
+                          const std::vector<Subcircuit_Instance>& instances = {},
+                          std::size_t capacity = DEFAULT_CAPACITY);
+    Subcircuit_Definition(const Network& body, const std::vector<uint32_t>& port_uids,
+                          const std::vector<Subcircuit_Instance>& instances = {},
+                          std::size_t capacity = DEFAULT_CAPACITY);
+    virtual ~Subcircuit_Definition() = default;
+
+    std::shared_ptr<const Macromodel> get_macromodel(double frequency) const;
+
+    // The body's own solution for an instance whose ports sit at the provided voltages
+    Nodal_Solution solve_internal(const std::vector<std::complex<double>>& port_voltages,
+                                  double frequency) const;
+
+    std::size_t get_number_of_ports() const;
+    const std::vector<uint32_t>& get_port_uids() const;
+    const std::vector<Subcircuit_Instance>& get_instances() const;
+    const Nodal_Analysis& get_nodal_analysis() const;
+    std::size_t get_number_of_eliminations() const;
+    std::size_t get_number_of_cached_frequencies() const;
+
+private:
+    struct Cached_Macromodel
+    {
+        std::shared_ptr<const Macromodel> macromodel;
+        uint64_t last_used;
+    };
+
+    Nodal_Analysis analysis;
+    std::vector<uint32_t> port_uids;
+    std::vector<Subcircuit_Instance> instances;
+
+    // Unknown index of each port after the first, the reference
+    std::vector<std::size_t> port_indices;
+    std::vector<std::size_t> internal_indices;
+    std::vector<std::vector<std::size_t>> instance_indices;
+
+    std::size_t capacity;
+    mutable std::map<double, Cached_Macromodel> macromodels;
+    mutable uint64_t clock;
+    mutable std::size_t number_of_eliminations;
+    mutable std::mutex mutex;
+};
+
+/**********************************************************************************************//**
+ * \brief Solves a top level network holding subcircuit instances.
+ *
+ *        The network's own elements are assembled as in Nodal_Analysis and each instance adds its
+ *        definition's Macromodel between the nodes it is wired to, so only the interconnect is
+ *        factorized. The solution covers the top level network, and solve_instance expands any
+ *        one instance on demand.
+ *
+ * \note  Throws Invalid_Subcircuit_Exception for an instance without one existing node per port.
+ *************************************************************************************************/
+class Hierarchical_Analysis
+{
+public:
+    Hierarchical_Analysis(const Compiled_Network& network, uint32_t ground_uid,
+                          const std::vector<Subcircuit_Instance>& instances);
+    Hierarchical_Analysis(const Network& network, uint32_t ground_uid,
+                          const std::vector<Subcircuit_Instance>& instances);
+    virtual ~Hierarchical_Analysis() = default;
+
+    Nodal_Solution solve(double frequency = 0.0) const;
+
+    // The internal solution of one instance, in its definition's UIDs, given a top level solution
+    Nodal_Solution solve_instance(const Nodal_Solution& solution, std::size_t instance,
+                                  double frequency = 0.0) const;
+
+    Dense_Matrix<std::complex<double>> assemble_matrix(double frequency,
+                                                       std::vector<std::complex<double>>& excitation) const;
+
+    const Nodal_Analysis& get_nodal_analysis() const;
+    const std::vector<Subcircuit_Instance>& get_instances() const;
+
+private:
+    Nodal_Analysis analysis;
+    std::vector<Subcircuit_Instance> instances;
+    std::vector<std::vector<std::size_t>> instance_indices;
+};
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef SUPERPOSITION_H
+#define SUPERPOSITION_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "compiled_network.h"
+#include "executor.h"
+#include "network.h"
+#include "nodal_analysis.h"
+
+namespace Circlyzer
+{
+
+/**********************************************************************************************//**
+ * \brief One voltage source driven at one angular frequency. A source carrying several harmonics
+ *        is listed once per harmonic.
+ *************************************************************************************************/
+struct Source_Excitation
+{
+    uint32_t source_uid;
+    std::complex<double> voltage;
+    double frequency = 0.0;
+};
+
+/**********************************************************************************************//**
+ * \brief The steady state under every excitation. solutions holds one Nodal_Solution per distinct
+ *        frequency, in ascending order of frequencies, with every source at that frequency acting
+ *        together. When kept, contributions holds each excitation's own solution, in the order
+ *        the excitations were given.
+ *************************************************************************************************/
+struct Superposition_Solution
+{
+    std::vector<double> frequencies;
+    std::vector<Nodal_Solution> solutions;
+    std::vector<Nodal_Solution> contributions;
+};
+
+/**********************************************************************************************//**
+ * \brief Steady state of a linear network driven by sources at several frequencies.
+ *
+ *        Excitations are grouped by frequency. Each group assembles and factorizes the MNA
+ *        matrix once, and the groups run in parallel on the executor. Within a group the
+ *        sources are linear in the right hand side, so by default they are summed into a single
+ *        right hand side. Keeping the contributions instead solves one column per excitation as
+ *        a block against the same factorization, and sums the columns for the group's total.
+ *
+ *        Only the excitations drive the network: every voltage source keeps its place as a short
+ *        at frequencies where it isn't excited, and the value it holds in the Network is not used.
+ *
+ * \note  Throws Invalid_Excitation_Exception for a UID that isn't a connected voltage source, or
+ *        a frequency that isn't finite.
+ *************************************************************************************************/
+class Superposition_Analysis
+{
+public:
+    Superposition_Analysis(const Compiled_Network& network, uint32_t ground_uid);
+    Superposition_Analysis(const Network& network, uint32_t ground_uid);
+    virtual ~Superposition_Analysis() = default;
+
+    Superposition_Solution solve(const std::vector<Source_Excitation>& excitations,
+                                 bool keep_contributions = false,
+                                 Executor& executor = Executor::get_shared()) const;
+
+    const Nodal_Analysis& get_nodal_analysis() const;
+
+private:
+    Nodal_Analysis analysis;
+
+    // Unknown carrying each voltage source's current, which is also its excitation row
+    std::unordered_map<uint32_t, std::size_t> source_rows;
+};
+
+/**********************************************************************************************//**
+ * \brief The instantaneous value at a time in seconds, summed over the frequencies as the real
+ *        parts of the phasors, Re(V e^jwt). Throws Non_Existant_UID_Exception for a UID the
+ *        solutions don't cover.
+ *************************************************************************************************/
+double evaluate_node_voltage(const Superposition_Solution& solution, uint32_t node_uid, double time);
+double evaluate_branch_current(const Superposition_Solution& solution, uint32_t branch_uid, double time);
+
+} // namespace Circlyzer
+
+#endif
@@ -0,0 +1,637 @@
+#include "circlyzer/analysis_cache.h"
+#include "circlyzer/compiled_network.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+using namespace Circlyzer;
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    constexpr char FILE_MAGIC[4] = { 'C', 'Z', 'A', 'C' };
+    constexpr uint32_t FILE_VERSION = 3U;
+    constexpr double AMBIGUITY_TOLERANCE = 1e-9;
+
+    // Mixed into every key so that different kinds of result never share one
+    enum class Entry_Kind : uint8_t
+    {
+        Solution,
+        Reduction,
+        Factorization
+    };
+
+    uint64_t hash_value(const double value)
+    {
+        return std::bit_cast<uint64_t>((value == 0.0) ? 0.0 : value);
+    }
+
+    uint64_t make_key(const Entry_Kind kind, Structural_Hash& structure, const double frequency)
+    {
+        return combine_hash(combine_hash(static_cast<uint64_t>(kind), structure.get_hash()),
+                            hash_value(frequency));
+    }
+
+    /**
+     * \brief An analysis's elements in order, which fix its matrix exactly
+     */
+    std::vector<uint64_t> describe_elements(const Nodal_Analysis& analysis)
+    {
+        std::vector<uint64_t> fingerprint{ analysis.get_node_uids().size(), analysis.get_elements().size() };
+        for(const auto& element : analysis.get_elements())
+        {
+            fingerprint.insert(fingerprint.end(), { static_cast<uint64_t>(element.type),
+                                                    hash_value(element.value.real()),
+                                                    hash_value(element.value.imag()), element.first,
+                                                    element.second, element.current_index });
+        }
+
+        return fingerprint;
+    }
+
+    bool same_value(const Complex& one, const Complex& two)
+    {
+        return std::abs(one - two) <= (AMBIGUITY_TOLERANCE * std::max({ 1.0, std::abs(one), std::abs(two) }));
+    }
+
+    /**
+     * \brief Sorts by label, failing if two entries share a label but not a value
+     */
+    template<typename Values>
+    bool sort_labelled(Values& values)
+    {
+        std::sort(values.begin(), values.end(), [](const auto& one, const auto& two)
+        {
+            return one.first < two.first;
+        });
+
+        for(std::size_t index = 1U; index < values.size(); ++index)
+        {
+            if((values[index].first == values[index - 1U].first) &&
+               !same_value(values[index].second, values[index - 1U].second))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<typename Values>
+    const Complex* find_labelled(const Values& values, const uint64_t label)
+    {
+        const auto found = std::lower_bound(values.begin(), values.end(), label,
+                                            [](const auto& entry, const uint64_t value)
+        {
+            return entry.first < value;
+        });
+
+        return ((found != values.end()) && (found->first == label)) ? &found->second : nullptr;
+    }
+
+    /**
+     * \brief +1 when a branch's current already flows in the canonical direction, from the lower
+     *        to the higher terminal colour, -1 when it is reversed and 0 when both terminals
+     *        share a colour. Polarised branches are always +1, their label fixes the direction.
+     */
+    double orientation(const Network& network, const Structural_Hash::Stable_Colouring& colouring,
+                       const uint32_t branch_uid)
+    {
+        const auto& branch = network.get_branch(branch_uid);
+        const auto type = branch.component->type;
+        if((type == Component_Type::Voltage_Source) || (type == Component_Type::Diode) ||
+           (branch.nodes.size() != 2U))
+        {
+            return 1.0;
+        }
+
+        const auto first = colouring.node_colours.at(branch.nodes[0]);
+        const auto second = colouring.node_colours.at(branch.nodes[1]);
+        return (first == second) ? 0.0 : ((first < second) ? 1.0 : -1.0);
+    }
+
+    template<typename Value>
+    void write_raw(std::ostream& stream, const Value& value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(Value));
+    }
+
+    template<typename Value>
+    bool read_raw(std::istream& stream, Value& value)
+    {
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(Value)));
+    }
+
+    void write_fingerprint(std::ostream& stream, const std::vector<uint64_t>& fingerprint)
+    {
+        write_raw<uint64_t>(stream, fingerprint.size());
+        for(const auto word : fingerprint)
+        {
+            write_raw(stream, word);
+        }
+    }
+
+    template<typename Values>
+    void write_labelled(std::ostream& stream, const Values& values)
+    {
+        write_raw<uint64_t>(stream, values.size());
+        for(const auto& [label, value] : values)
+        {
+            write_raw(stream, label);
+            write_raw(stream, value.real());
+            write_raw(stream, value.imag());
+        }
+    }
+
+    template<typename Values>
+    bool read_labelled(std::istream& stream, Values& values)
+    {
+        uint64_t size = 0U;
+        if(!read_raw(stream, size))
+        {
+            return false;
+        }
+
+        for(uint64_t index = 0U; index < size; ++index)
+        {
+            uint64_t label = 0U;
+            double real = 0.0;
+            double imaginary = 0.0;
+            if(!read_raw(stream, label) || !read_raw(stream, real) || !read_raw(stream, imaginary))
+            {
+                return false;
+            }
+
+            values.emplace_back(label, Complex{ real, imaginary });
+        }
+
+        return true;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief
+ * \param capacity Number of results kept in memory before the least recently used is evicted
+ * \param directory Where results are also kept on disk, or empty to keep them in memory only
+ *************************************************************************************************/
+Analysis_Cache::Analysis_Cache(const std::size_t capacity, const std::string& directory) :
+    capacity{ std::max<std::size_t>(capacity, 1U) },
+    directory(directory),
+    order(),
+    entries(),
+    number_of_hits{ 0U },
+    number_of_disk_hits{ 0U },
+    number_of_misses{ 0U },
+    mutex()
+{
+    if(!directory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Nodal_Analysis::solve, answered from the cache when this structure, ground and
+ *        frequency have been solved before
+ * \param structure
+ * \param ground_uid
+ * \param frequency
+ *************************************************************************************************/
+Nodal_Solution Analysis_Cache::solve(Structural_Hash& structure, const uint32_t ground_uid,
+                                     const double frequency)
+{
+    const auto& network = structure.get_network();
+    const auto key = combine_hash(make_key(Entry_Kind::Solution, structure, frequency),
+                                  structure.get_node_label(ground_uid));
+    const auto& colouring = structure.get_stable_colouring({ ground_uid });
+    const auto& fingerprint = colouring.fingerprint;
+
+    Entry entry;
+    if(find(key, fingerprint, entry))
+    {
+        const auto& canonical = std::get<Canonical_Solution>(entry);
+
+        Nodal_Solution solution;
+        for(const auto uid : network.get_node_uids())
+        {
+            const auto voltage = find_labelled(canonical.node_voltages, colouring.node_colours.at(uid));
+            if(voltage != nullptr)
+            {
+                solution.node_voltages.insert({ uid, *voltage });
+            }
+        }
+
+        for(const auto uid : network.get_branch_uids())
+        {
+            const auto current = find_labelled(canonical.branch_currents, colouring.branch_labels.at(uid));
+            if(current != nullptr)
+            {
+                const auto sign = orientation(network, colouring, uid);
+                solution.branch_currents.insert({ uid, (sign == 0.0) ? *current : (sign * *current) });
+            }
+        }
+
+        // Anything else is a hash collision, which is answered by solving after all
+        if((solution.node_voltages.size() == canonical.node_voltages.size()) &&
+           (solution.branch_currents.size() == canonical.branch_currents.size()))
+        {
+            return solution;
+        }
+    }
+
+    const auto solution = Nodal_Analysis(network, ground_uid).solve(frequency);
+
+    Canonical_Solution canonical;
+    for(const auto& [uid, voltage] : solution.node_voltages)
+    {
+        canonical.node_voltages.emplace_back(colouring.node_colours.at(uid), voltage);
+    }
+
+    auto cacheable = true;
+    for(const auto& [uid, current] : solution.branch_currents)
+    {
+        // A branch between two nodes of the same colour has no canonical direction
+        const auto sign = orientation(network, colouring, uid);
+        cacheable = cacheable && ((sign != 0.0) || same_value(current, 0.0));
+        canonical.branch_currents.emplace_back(colouring.branch_labels.at(uid),
+                                               (sign == 0.0) ? current : (sign * current));
+    }
+
+    if(cacheable && sort_labelled(canonical.node_voltages) && sort_labelled(canonical.branch_currents))
+    {
+        insert(key, fingerprint, canonical);
+    }
+
+    return solution;
+}
+
+/**********************************************************************************************//**
+ * \brief reduce_impedance, answered from the cache when this structure, pair of ports, frequency
+ *        and options have been reduced before
+ * \param structure
+ * \param first_port_uid
+ * \param second_port_uid
+ * \param frequency
+ * \param options
+ *************************************************************************************************/
+Reduction_Result Analysis_Cache::reduce(Structural_Hash& structure, const uint32_t first_port_uid,
+                                        const uint32_t second_port_uid, const double frequency,
+                                        const Reduction_Options& options)
+{
+    auto key = make_key(Entry_Kind::Reduction, structure, frequency);
+    key = combine_hash(key, structure.get_node_label(first_port_uid));
+    key = combine_hash(key, structure.get_node_label(second_port_uid));
+    key = combine_hash(key, options.allow_star_mesh ? 1U : 0U);
+    const auto& fingerprint = structure.get_stable_colouring({ first_port_uid, second_port_uid }).fingerprint;
+
+    Entry entry;
+    if(find(key, fingerprint, entry))
+    {
+        return std::get<Reduction_Result>(entry);
+    }
+
+    const auto result = reduce_impedance(structure.get_network(), first_port_uid, second_port_uid,
+                                         frequency, options);
+    insert(key, fingerprint, result);
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief The LU factorization of analysis's matrix at a frequency. A factorization can only be
+ *        shared between analyses that number their unknowns the same way, so the key also
+ *        covers the labels in unknown order.
+ * \param structure
+ * \param analysis
+ * \param frequency
+ *************************************************************************************************/
+std::shared_ptr<const LU_Factorization<std::complex<double>>>
+Analysis_Cache::factorize(Structural_Hash& structure, const Nodal_Analysis& analysis, const double frequency)
+{
+    auto key = combine_hash(make_key(Entry_Kind::Factorization, structure, frequency),
+                            structure.get_node_label(analysis.get_ground_uid()));
+
+    const auto& node_uids = analysis.get_node_uids();
+    const auto label_at = [&](const std::size_t index)
+    {
+        return (index == Nodal_Analysis::GROUND_INDEX) ? 0U : structure.get_node_label(node_uids[index]);
+    };
+
+    for(const auto uid : node_uids)
+    {
+        key = combine_hash(key, structure.get_node_label(uid));
+    }
+
+    for(const auto& element : analysis.get_elements())
+    {
+        key = combine_hash(key, structure.get_branch_label(element.uid));
+        key = combine_hash(key, label_at(element.first));
+        key = combine_hash(key, label_at(element.second));
+    }
+
+    const auto fingerprint = describe_elements(analysis);
+
+    Entry entry;
+    if(find(key, fingerprint, entry))
+    {
+        return std::get<Factorization>(entry);
+    }
+
+    auto factorization = std::make_shared<const LU_Factorization<std::complex<double>>>(
+        analysis.assemble_matrix(frequency));
+    insert(key, fingerprint, factorization);
+    return factorization;
+}
+
+/**********************************************************************************************//**
+ * \brief Forgets everything held in memory. Files on disk are left alone.
+ *************************************************************************************************/
+void Analysis_Cache::clear()
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    order.clear();
+    entries.clear();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of entries held in memory
+ *************************************************************************************************/
+std::size_t Analysis_Cache::get_size() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for capacity
+ *************************************************************************************************/
+std::size_t Analysis_Cache::get_capacity() const
+{
+    return capacity;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_hits, requests answered from memory
+ *************************************************************************************************/
+std::size_t Analysis_Cache::get_number_of_hits() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return number_of_hits;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_disk_hits, requests answered from the directory
+ *************************************************************************************************/
+std::size_t Analysis_Cache::get_number_of_disk_hits() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return number_of_disk_hits;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_misses, requests that had to be computed
+ *************************************************************************************************/
+std::size_t Analysis_Cache::get_number_of_misses() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return number_of_misses;
+}
+
+/**********************************************************************************************//**
+ * \brief Looks in memory, then on disk, promoting what it finds to most recently used. An entry
+ *        with another fingerprint shares only the key and is a miss.
+ * \param key
+ * \param fingerprint
+ * \param entry
+ *************************************************************************************************/
+bool Analysis_Cache::find(const uint64_t key, const Fingerprint& fingerprint, Entry& entry)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        const auto found = entries.find(key);
+        if((found != entries.end()) && (found->second.fingerprint != fingerprint))
+        {
+            ++number_of_misses;
+            return false;
+        }
+
+        if(found != entries.end())
+        {
+            order.splice(order.begin(), order, found->second.position);
+            entry = found->second.entry;
+            ++number_of_hits;
+            return true;
+        }
+    }
+
+    const auto loaded = !directory.empty() && load(key, fingerprint, entry);
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    if(!loaded)
+    {
+        ++number_of_misses;
+        return false;
+    }
+
+    ++number_of_disk_hits;
+    remember(key, fingerprint, entry);
+    return true;
+}
+
+/**********************************************************************************************//**
+ * \brief Adds an entry to memory, and writes it to disk when there is a directory
+ * \param key
+ * \param fingerprint
+ * \param entry
+ *************************************************************************************************/
+void Analysis_Cache::insert(const uint64_t key, const Fingerprint& fingerprint, const Entry& entry)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        remember(key, fingerprint, entry);
+    }
+
+    if(!directory.empty() && !std::holds_alternative<Factorization>(entry))
+    {
+        store(key, fingerprint, entry);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Makes an entry the most recently used, evicting the least recently used when full. The
+ *        caller holds the mutex.
+ * \param key
+ * \param fingerprint
+ * \param entry
+ *************************************************************************************************/
+void Analysis_Cache::remember(const uint64_t key, const Fingerprint& fingerprint, const Entry& entry)
+{
+    const auto found = entries.find(key);
+    if(found != entries.end())
+    {
+        found->second.entry = entry;
+        found->second.fingerprint = fingerprint;
+        order.splice(order.begin(), order, found->second.position);
+        return;
+    }
+
+    if(entries.size() >= capacity)
+    {
+        entries.erase(order.back());
+        order.pop_back();
+    }
+
+    order.push_front(key);
+    entries.insert({ key, { entry, fingerprint, order.begin() } });
+}
+
+/**********************************************************************************************//**
+ * \brief Reads an entry back from its file. Anything unexpected in the file, including another
+ *        fingerprint, makes it a miss.
+ * \param key
+ * \param fingerprint
+ * \param entry
+ *************************************************************************************************/
+bool Analysis_Cache::load(const uint64_t key, const Fingerprint& fingerprint, Entry& entry) const
+{
+    std::ifstream stream(path_of(key), std::ios::binary);
+    if(!stream)
+    {
+        return false;
+    }
+
+    char magic[sizeof(FILE_MAGIC)];
+    uint32_t version = 0U;
+    uint64_t stored_key = 0U;
+    uint8_t kind = 0U;
+    if(!stream.read(magic, sizeof(magic)) || (std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) ||
+       !read_raw(stream, version) || (version != FILE_VERSION) ||
+       !read_raw(stream, stored_key) || (stored_key != key) || !read_raw(stream, kind))
+    {
+        return false;
+    }
+
+    // Compared word by word, so a damaged count never allocates
+    uint64_t size = 0U;
+    if(!read_raw(stream, size) || (size != fingerprint.size()))
+    {
+        return false;
+    }
+
+    for(const auto word : fingerprint)
+    {
+        uint64_t stored = 0U;
+        if(!read_raw(stream, stored) || (stored != word))
+        {
+            return false;
+        }
+    }
+
+    if(kind == static_cast<uint8_t>(Entry_Kind::Solution))
+    {
+        Canonical_Solution solution;
+        if(!read_labelled(stream, solution.node_voltages) || !read_labelled(stream, solution.branch_currents))
+        {
+            return false;
+        }
+
+        entry = std::move(solution);
+        return true;
+    }
+
+    if(kind == static_cast<uint8_t>(Entry_Kind::Reduction))
+    {
+        double real = 0.0;
+        double imaginary = 0.0;
+        uint64_t counts[5] = {};
+        if(!read_raw(stream, real) || !read_raw(stream, imaginary) || !read_raw(stream, counts))
+        {
+            return false;
+        }
+
+        entry = Reduction_Result{ { real, imaginary }, counts[0], counts[1], counts[2], counts[3], counts[4] };
+        return true;
+    }
+
+    return false;
+}
+
+/**********************************************************************************************//**
+ * \brief Writes an entry to a temporary file and renames it into place, so a reader never sees
+ *        half a file:
+ *
+ *            "CZAC", uint32 version, uint64 key, uint8 kind, the fingerprint as a uint64 count
+ *            of uint64 words, then for a solution the node voltages and branch currents, each
+ *            a uint64 count of (uint64 label, double real, double imaginary), and for a
+ *            reduction the impedance as two doubles followed by the five step counts as uint64
+ * \param key
+ * \param fingerprint
+ * \param entry
+ *************************************************************************************************/
+void Analysis_Cache::store(const uint64_t key, const Fingerprint& fingerprint, const Entry& entry) const
+{
+    const auto path = path_of(key);
+    const auto temporary = path + "." +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if(!stream)
+        {
+            return;
+        }
+
+        stream.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+        write_raw(stream, FILE_VERSION);
+        write_raw(stream, key);
+
+        if(const auto* solution = std::get_if<Canonical_Solution>(&entry))
+        {
+            write_raw(stream, static_cast<uint8_t>(Entry_Kind::Solution));
+            write_fingerprint(stream, fingerprint);
+            write_labelled(stream, solution->node_voltages);
+            write_labelled(stream, solution->branch_currents);
+        }
+        else if(const auto* reduction = std::get_if<Reduction_Result>(&entry))
+        {
+            const uint64_t counts[5] = { reduction->series, reduction->parallel, reduction->delta_to_wye,
+                                         reduction->wye_to_delta, reduction->star_mesh };
+            write_raw(stream, static_cast<uint8_t>(Entry_Kind::Reduction));
+            write_fingerprint(stream, fingerprint);
+            write_raw(stream, reduction->impedance.real());
+            write_raw(stream, reduction->impedance.imag());
+            write_raw(stream, counts);
+        }
+
+        if(!stream.flush())
+        {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if(error)
+    {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief The file an entry lives in, named after its key in hexadecimal
+ * \param key
+ *************************************************************************************************/
+std::string Analysis_Cache::path_of(const uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.czac", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(directory) / name).string();
+}
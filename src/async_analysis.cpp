@@ -0,0 +1,135 @@
+#include "circlyzer/async_analysis.h"
+
+#include <atomic>
+#include <mutex>
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param network
+ * \param ground_uid
+ * \param frequency
+ * \param token
+ * \param executor
+ *************************************************************************************************/
+std::future<Nodal_Solution> Circlyzer::solve_async(std::shared_ptr<const Compiled_Network> network,
+                                                   const uint32_t ground_uid,
+                                                   const double frequency,
+                                                   std::stop_token token,
+                                                   Executor& executor)
+{
+    return executor.submit(std::move(token), [network = std::move(network), ground_uid, frequency]()
+    {
+        return Nodal_Analysis(*network, ground_uid).solve(frequency);
+    });
+}
+
+/**********************************************************************************************//**
+ * \brief The analysis is built once and shared by the per frequency tasks. The last task to
+ *        finish fulfils the promise, so no pool thread ever blocks waiting on the others.
+ * \param network
+ * \param ground_uid
+ * \param frequencies
+ * \param token
+ * \param executor
+ *************************************************************************************************/
+std::future<std::vector<Nodal_Solution>>
+Circlyzer::sweep_async(std::shared_ptr<const Compiled_Network> network,
+                       const uint32_t ground_uid,
+                       std::vector<double> frequencies,
+                       std::stop_token token,
+                       Executor& executor)
+{
+    struct Sweep_State
+    {
+        std::shared_ptr<const Nodal_Analysis> analysis;
+        std::vector<double> frequencies;
+        std::vector<Nodal_Solution> solutions;
+        std::atomic<std::size_t> remaining;
+        std::promise<std::vector<Nodal_Solution>> promise;
+        std::once_flag failed;
+    };
+
+    auto state = std::make_shared<Sweep_State>();
+    auto future = state->promise.get_future();
+
+    try
+    {
+        state->analysis = std::make_shared<const Nodal_Analysis>(*network, ground_uid);
+    }
+    catch(...)
+    {
+        state->promise.set_exception(std::current_exception());
+        return future;
+    }
+
+    state->frequencies = std::move(frequencies);
+    state->solutions.resize(state->frequencies.size());
+    state->remaining = state->frequencies.size();
+
+    if(state->frequencies.empty())
+    {
+        state->promise.set_value({});
+        return future;
+    }
+
+    for(std::size_t index = 0U; index < state->frequencies.size(); ++index)
+    {
+        // Failures, including cancellation, are reported once through the shared promise
+        executor.submit([state, index, token]()
+        {
+            try
+            {
+                if(token.stop_requested())
+                {
+                    throw Cancelled_Operation_Exception();
+                }
+
+                state->solutions[index] = state->analysis->solve(state->frequencies[index]);
+            }
+            catch(...)
+            {
+                std::call_once(state->failed, [&]()
+                {
+                    state->promise.set_exception(std::current_exception());
+                });
+            }
+
+            if(state->remaining.fetch_sub(1U) == 1U)
+            {
+                std::call_once(state->failed, [&]()
+                {
+                    state->promise.set_value(std::move(state->solutions));
+                });
+            }
+        });
+    }
+
+    return future;
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param network
+ * \param first_port_uid
+ * \param second_port_uid
+ * \param frequency
+ * \param options
+ * \param token
+ * \param executor
+ *************************************************************************************************/
+std::future<Reduction_Result> Circlyzer::reduce_async(std::shared_ptr<const Compiled_Network> network,
+                                                      const uint32_t first_port_uid,
+                                                      const uint32_t second_port_uid,
+                                                      const double frequency,
+                                                      Reduction_Options options,
+                                                      std::stop_token token,
+                                                      Executor& executor)
+{
+    return executor.submit(std::move(token), [network = std::move(network), first_port_uid,
+                                              second_port_uid, frequency, options]()
+    {
+        return reduce_impedance(*network, first_port_uid, second_port_uid, frequency, options);
+    });
+}
@@ -0,0 +1,404 @@
+#include "circlyzer/batch_analysis.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <array>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto LANES = Batch_Analysis::LANES;
+    constexpr auto GROUND_INDEX = Nodal_Analysis::GROUND_INDEX;
+
+    using Lane_Values = std::array<double, LANES>;
+
+    /**
+     * \brief Square system for one block of instances, split into real and imaginary planes.
+     *        Entry (row, column) of lane l lives at ((row * size) + column) * LANES + l.
+     */
+    struct Lane_System
+    {
+        explicit Lane_System(const std::size_t size) :
+            size{ size },
+            matrix_real(size * size * LANES, 0.0),
+            matrix_imaginary(size * size * LANES, 0.0),
+            rhs_real(size * LANES, 0.0),
+            rhs_imaginary(size * LANES, 0.0)
+        {
+
+        }
+
+        void clear()
+        {
+            std::fill(matrix_real.begin(), matrix_real.end(), 0.0);
+            std::fill(matrix_imaginary.begin(), matrix_imaginary.end(), 0.0);
+            std::fill(rhs_real.begin(), rhs_real.end(), 0.0);
+            std::fill(rhs_imaginary.begin(), rhs_imaginary.end(), 0.0);
+        }
+
+        std::size_t entry(const std::size_t row, const std::size_t column) const
+        {
+            return ((row * size) + column) * LANES;
+        }
+
+        std::size_t size;
+        std::vector<double> matrix_real;
+        std::vector<double> matrix_imaginary;
+        std::vector<double> rhs_real;
+        std::vector<double> rhs_imaginary;
+    };
+
+    void add(std::vector<double>& real, std::vector<double>& imaginary, const std::size_t offset,
+             const Lane_Values& value_real, const Lane_Values& value_imaginary, const double sign)
+    {
+        for(std::size_t lane = 0U; lane < LANES; ++lane)
+        {
+            real[offset + lane] += sign * value_real[lane];
+            imaginary[offset + lane] += sign * value_imaginary[lane];
+        }
+    }
+
+    /**
+     * \brief Gaussian elimination without pivoting, the rows were already placed in the shared
+     *        pivot order while stamping. The solution is left in the rhs planes.
+     */
+    void eliminate(Lane_System& system)
+    {
+        const auto size = system.size;
+        auto* a_real = system.matrix_real.data();
+        auto* a_imaginary = system.matrix_imaginary.data();
+        auto* b_real = system.rhs_real.data();
+        auto* b_imaginary = system.rhs_imaginary.data();
+
+        Lane_Values inverse_real;
+        Lane_Values inverse_imaginary;
+        Lane_Values multiplier_real;
+        Lane_Values multiplier_imaginary;
+
+        for(std::size_t pivot = 0U; pivot < size; ++pivot)
+        {
+            const auto pivot_entry = system.entry(pivot, pivot);
+            auto all_usable = true;
+            for(std::size_t lane = 0U; lane < LANES; ++lane)
+            {
+                const auto real = a_real[pivot_entry + lane];
+                const auto imaginary = a_imaginary[pivot_entry + lane];
+                const auto magnitude = (real * real) + (imaginary * imaginary);
+
+                all_usable = all_usable && (magnitude > 0.0);
+                inverse_real[lane] = real / magnitude;
+                inverse_imaginary[lane] = -imaginary / magnitude;
+            }
+
+            if(!all_usable)
+            {
+                throw Singular_Matrix_Exception();
+            }
+
+            for(std::size_t row = pivot + 1U; row < size; ++row)
+            {
+                const auto row_entry = system.entry(row, pivot);
+                auto any_nonzero = false;
+                for(std::size_t lane = 0U; lane < LANES; ++lane)
+                {
+                    const auto real = a_real[row_entry + lane];
+                    const auto imaginary = a_imaginary[row_entry + lane];
+
+                    multiplier_real[lane] = (real * inverse_real[lane]) -
+                                            (imaginary * inverse_imaginary[lane]);
+                    multiplier_imaginary[lane] = (real * inverse_imaginary[lane]) +
+                                                 (imaginary * inverse_real[lane]);
+                    any_nonzero = any_nonzero || (real != 0.0) || (imaginary != 0.0);
+                }
+
+                // MNA matrices are sparse, most rows have nothing to eliminate
+                if(!any_nonzero)
+                {
+                    continue;
+                }
+
+                for(std::size_t column = pivot + 1U; column < size; ++column)
+                {
+                    const auto target = system.entry(row, column);
+                    const auto source = system.entry(pivot, column);
+                    for(std::size_t lane = 0U; lane < LANES; ++lane)
+                    {
+                        const auto real = a_real[source + lane];
+                        const auto imaginary = a_imaginary[source + lane];
+
+                        a_real[target + lane] -= (multiplier_real[lane] * real) -
+                                                 (multiplier_imaginary[lane] * imaginary);
+                        a_imaginary[target + lane] -= (multiplier_real[lane] * imaginary) +
+                                                      (multiplier_imaginary[lane] * real);
+                    }
+                }
+
+                const auto target = row * LANES;
+                const auto source = pivot * LANES;
+                for(std::size_t lane = 0U; lane < LANES; ++lane)
+                {
+                    const auto real = b_real[source + lane];
+                    const auto imaginary = b_imaginary[source + lane];
+
+                    b_real[target + lane] -= (multiplier_real[lane] * real) -
+                                             (multiplier_imaginary[lane] * imaginary);
+                    b_imaginary[target + lane] -= (multiplier_real[lane] * imaginary) +
+                                                  (multiplier_imaginary[lane] * real);
+                }
+            }
+        }
+
+        for(std::size_t row = size; row-- > 0U;)
+        {
+            Lane_Values accumulator_real;
+            Lane_Values accumulator_imaginary;
+            for(std::size_t lane = 0U; lane < LANES; ++lane)
+            {
+                accumulator_real[lane] = b_real[(row * LANES) + lane];
+                accumulator_imaginary[lane] = b_imaginary[(row * LANES) + lane];
+            }
+
+            for(std::size_t column = row + 1U; column < size; ++column)
+            {
+                const auto coefficient = system.entry(row, column);
+                const auto known = column * LANES;
+                for(std::size_t lane = 0U; lane < LANES; ++lane)
+                {
+                    const auto a_r = a_real[coefficient + lane];
+                    const auto a_i = a_imaginary[coefficient + lane];
+                    const auto x_r = b_real[known + lane];
+                    const auto x_i = b_imaginary[known + lane];
+
+                    accumulator_real[lane] -= (a_r * x_r) - (a_i * x_i);
+                    accumulator_imaginary[lane] -= (a_r * x_i) + (a_i * x_r);
+                }
+            }
+
+            const auto diagonal = system.entry(row, row);
+            for(std::size_t lane = 0U; lane < LANES; ++lane)
+            {
+                const auto d_r = a_real[diagonal + lane];
+                const auto d_i = a_imaginary[diagonal + lane];
+                const auto magnitude = (d_r * d_r) + (d_i * d_i);
+
+                b_real[(row * LANES) + lane] =
+                    ((accumulator_real[lane] * d_r) + (accumulator_imaginary[lane] * d_i)) / magnitude;
+                b_imaginary[(row * LANES) + lane] =
+                    ((accumulator_imaginary[lane] * d_r) - (accumulator_real[lane] * d_i)) / magnitude;
+            }
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param network
+ * \param ground_uid
+ *************************************************************************************************/
+Batch_Analysis::Batch_Analysis(const Compiled_Network& network, const uint32_t ground_uid) :
+    analysis(network, ground_uid)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param network
+ * \param ground_uid
+ *************************************************************************************************/
+Batch_Analysis::Batch_Analysis(const Network& network, const uint32_t ground_uid) :
+    analysis(network, ground_uid)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Solves every instance in the table at the provided frequency
+ * \param table
+ * \param frequency
+ *************************************************************************************************/
+Batch_Solution Batch_Analysis::solve(const Batch_Table& table, const double frequency) const
+{
+    const auto size = analysis.get_system_size();
+    const auto& elements = analysis.get_elements();
+    const auto& node_uids = analysis.get_node_uids();
+
+    // The nominal factorization decides the pivot order shared by every lane
+    const LU_Factorization<std::complex<double>> nominal(analysis.assemble_matrix(frequency));
+    const auto& permutation = nominal.get_permutation();
+
+    std::vector<std::size_t> position(size);
+    for(std::size_t index = 0U; index < size; ++index)
+    {
+        position[permutation[index]] = index;
+    }
+
+    const auto to_position = [&](const std::size_t index)
+    {
+        return (index == GROUND_INDEX) ? GROUND_INDEX : position[index];
+    };
+
+    // Resolve each element's value column once, instead of once per block
+    std::vector<const std::vector<std::complex<double>>*> columns(elements.size(), nullptr);
+    for(std::size_t index = 0U; index < elements.size(); ++index)
+    {
+        const auto column = table.columns.find(elements[index].uid);
+        if(column != table.columns.end())
+        {
+            if(column->second.size() != table.number_of_instances)
+            {
+                throw Invalid_Batch_Table_Exception();
+            }
+
+            columns[index] = &column->second;
+        }
+    }
+
+    Batch_Solution solution;
+    solution.number_of_instances = table.number_of_instances;
+    solution.node_voltages.insert({ analysis.get_ground_uid(),
+                                    std::vector<std::complex<double>>(table.number_of_instances) });
+    for(const auto uid : node_uids)
+    {
+        solution.node_voltages.insert({ uid,
+                                        std::vector<std::complex<double>>(table.number_of_instances) });
+    }
+
+    std::vector<std::vector<std::complex<double>>*> outputs;
+    for(const auto uid : node_uids)
+    {
+        outputs.emplace_back(&solution.node_voltages.at(uid));
+    }
+
+    Lane_System system(size);
+    Lane_Values value_real;
+    Lane_Values value_imaginary;
+    Lane_Values ones;
+    Lane_Values zeros;
+    ones.fill(1.0);
+    zeros.fill(0.0);
+
+    for(std::size_t first_instance = 0U; first_instance < table.number_of_instances;
+        first_instance += LANES)
+    {
+        system.clear();
+
+        for(std::size_t index = 0U; index < elements.size(); ++index)
+        {
+            const auto& element = elements[index];
+
+            // Gather this element's value into the lanes, padding past the end with the nominal
+            for(std::size_t lane = 0U; lane < LANES; ++lane)
+            {
+                const auto instance = first_instance + lane;
+                const auto value = ((columns[index] != nullptr) &&
+                                    (instance < table.number_of_instances)) ?
+                    (*columns[index])[instance] : element.value;
+
+                value_real[lane] = value.real();
+                value_imaginary[lane] = value.imag();
+            }
+
+            const auto a = to_position(element.first);
+            const auto b = to_position(element.second);
+
+            if(element.current_index == GROUND_INDEX)
+            {
+                // Convert the per lane value into an admittance
+                for(std::size_t lane = 0U; lane < LANES; ++lane)
+                {
+                    const auto real = value_real[lane];
+                    const auto imaginary = value_imaginary[lane];
+
+                    if(element.type == Component_Type::Resistor)
+                    {
+                        const auto magnitude = (real * real) + (imaginary * imaginary);
+                        value_real[lane] = real / magnitude;
+                        value_imaginary[lane] = -imaginary / magnitude;
+                    }
+                    else
+                    {
+                        value_real[lane] = -frequency * imaginary;
+                        value_imaginary[lane] = frequency * real;
+                    }
+                }
+
+                // Rows are permuted into pivot order, columns keep their original numbering
+                if(a != GROUND_INDEX)
+                {
+                    add(system.matrix_real, system.matrix_imaginary,
+                        system.entry(a, element.first), value_real, value_imaginary, 1.0);
+                }
+
+                if(b != GROUND_INDEX)
+                {
+                    add(system.matrix_real, system.matrix_imaginary,
+                        system.entry(b, element.second), value_real, value_imaginary, 1.0);
+                }
+
+                if((a != GROUND_INDEX) && (b != GROUND_INDEX))
+                {
+                    add(system.matrix_real, system.matrix_imaginary,
+                        system.entry(a, element.second), value_real, value_imaginary, -1.0);
+                    add(system.matrix_real, system.matrix_imaginary,
+                        system.entry(b, element.first), value_real, value_imaginary, -1.0);
+                }
+
+                continue;
+            }
+
+            const auto k = element.current_index;
+            const auto k_position = position[k];
+            if(a != GROUND_INDEX)
+            {
+                add(system.matrix_real, system.matrix_imaginary,
+                    system.entry(a, k), ones, zeros, 1.0);
+                add(system.matrix_real, system.matrix_imaginary,
+                    system.entry(k_position, element.first), ones, zeros, 1.0);
+            }
+
+            if(b != GROUND_INDEX)
+            {
+                add(system.matrix_real, system.matrix_imaginary,
+                    system.entry(b, k), ones, zeros, -1.0);
+                add(system.matrix_real, system.matrix_imaginary,
+                    system.entry(k_position, element.second), ones, zeros, -1.0);
+            }
+
+            if(element.type == Component_Type::Inductor)
+            {
+                // -j w L on the diagonal of the current row
+                for(std::size_t lane = 0U; lane < LANES; ++lane)
+                {
+                    const auto real = value_real[lane];
+                    value_real[lane] = frequency * value_imaginary[lane];
+                    value_imaginary[lane] = -frequency * real;
+                }
+
+                add(system.matrix_real, system.matrix_imaginary,
+                    system.entry(k_position, k), value_real, value_imaginary, 1.0);
+            }
+            else
+            {
+                add(system.rhs_real, system.rhs_imaginary, k_position * LANES,
+                    value_real, value_imaginary, 1.0);
+            }
+        }
+
+        eliminate(system);
+
+        const auto active_lanes = std::min(LANES, table.number_of_instances - first_instance);
+        for(std::size_t index = 0U; index < node_uids.size(); ++index)
+        {
+            auto& output = *outputs[index];
+            for(std::size_t lane = 0U; lane < active_lanes; ++lane)
+            {
+                output[first_instance + lane] = { system.rhs_real[(index * LANES) + lane],
+                                                  system.rhs_imaginary[(index * LANES) + lane] };
+            }
+        }
+    }
+
+    return solution;
+}
@@ -0,0 +1,204 @@
+#include "circlyzer/branch_quantities.h"
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * \brief Lays the branches out in the Compiled_Network's order and takes the unknown numbering
+ *        from the analysis
+ * \param network
+ * \param analysis
+ *************************************************************************************************/
+Branch_Quantities::Branch_Quantities(const Compiled_Network& network, const Nodal_Analysis& analysis) :
+    node_uids(network.get_node_uids()),
+    branch_uids(network.get_branch_uids()),
+    node_unknowns(network.get_number_of_nodes(), NO_UNKNOWN),
+    first(network.get_number_of_branches(), static_cast<uint32_t>(network.get_number_of_nodes())),
+    second(network.get_number_of_branches(), static_cast<uint32_t>(network.get_number_of_nodes())),
+    current_unknowns(network.get_number_of_branches(), NO_UNKNOWN),
+    conductances(network.get_number_of_branches(), 0.0),
+    capacitances(network.get_number_of_branches(), 0.0),
+    potentials(network.get_number_of_nodes() + 1U, 0.0),
+    voltages(network.get_number_of_branches(), 0.0),
+    currents(network.get_number_of_branches(), 0.0),
+    powers(network.get_number_of_branches(), 0.0)
+{
+    const auto& unknown_uids = analysis.get_node_uids();
+    for(std::size_t unknown = 0U; unknown < unknown_uids.size(); ++unknown)
+    {
+        node_unknowns[network.get_node_index(unknown_uids[unknown])] = static_cast<uint32_t>(unknown);
+    }
+
+    const auto types = network.get_types();
+    const auto values = network.get_values();
+    for(uint32_t branch = 0U; branch < network.get_number_of_branches(); ++branch)
+    {
+        if(!network.is_connected(branch))
+        {
+            continue;
+        }
+
+        const auto terminals = network.get_terminals(branch);
+        first[branch] = terminals[0];
+        second[branch] = terminals[1];
+
+        if(types[branch] == Component_Type::Resistor)
+        {
+            conductances[branch] = 1.0 / values[branch].real();
+        }
+        else if(types[branch] == Component_Type::Capacitor)
+        {
+            capacitances[branch] = values[branch].real();
+        }
+    }
+
+    for(const auto& element : analysis.get_elements())
+    {
+        if(element.current_index != Nodal_Analysis::GROUND_INDEX)
+        {
+            current_unknowns[network.get_branch_index(element.uid)] = static_cast<uint32_t>(element.current_index);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Evaluates from the unknowns of the analysis' system
+ * \param unknowns
+ * \param frequency
+ *************************************************************************************************/
+void Branch_Quantities::evaluate(const std::vector<std::complex<double>>& unknowns, const double frequency)
+{
+    for(std::size_t node = 0U; node < node_unknowns.size(); ++node)
+    {
+        potentials[node] = (node_unknowns[node] == NO_UNKNOWN) ? 0.0 : unknowns[node_unknowns[node]];
+    }
+
+    for(std::size_t branch = 0U; branch < current_unknowns.size(); ++branch)
+    {
+        currents[branch] = (current_unknowns[branch] == NO_UNKNOWN) ? 0.0 : unknowns[current_unknowns[branch]];
+    }
+
+    compute(frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief Evaluates from a solution. Its maps are walked alongside the UID ordered arrays, so no
+ *        UID is looked up.
+ * \param solution
+ * \param frequency
+ *************************************************************************************************/
+void Branch_Quantities::evaluate(const Nodal_Solution& solution, const double frequency)
+{
+    auto voltage = solution.node_voltages.begin();
+    for(std::size_t node = 0U; node < node_uids.size(); ++node)
+    {
+        while((voltage != solution.node_voltages.end()) && (voltage->first < node_uids[node]))
+        {
+            ++voltage;
+        }
+
+        const auto found = (voltage != solution.node_voltages.end()) && (voltage->first == node_uids[node]);
+        potentials[node] = found ? voltage->second : 0.0;
+    }
+
+    auto current = solution.branch_currents.begin();
+    for(std::size_t branch = 0U; branch < branch_uids.size(); ++branch)
+    {
+        currents[branch] = 0.0;
+        if(current_unknowns[branch] == NO_UNKNOWN)
+        {
+            continue;
+        }
+
+        while((current != solution.branch_currents.end()) && (current->first < branch_uids[branch]))
+        {
+            ++current;
+        }
+
+        if((current != solution.branch_currents.end()) && (current->first == branch_uids[branch]))
+        {
+            currents[branch] = current->second;
+        }
+    }
+
+    compute(frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief Gathers the terminal voltages, then adds the admittance currents to the current unknowns
+ *        already in place and forms the powers. The second loop works on the real and imaginary
+ *        parts directly, std::complex multiplication's NaN recovery would keep it from being
+ *        vectorized.
+ * \param frequency
+ *************************************************************************************************/
+void Branch_Quantities::compute(const double frequency)
+{
+    const auto size = voltages.size();
+    const auto* const potential = potentials.data();
+    for(std::size_t branch = 0U; branch < size; ++branch)
+    {
+        voltages[branch] = potential[first[branch]] - potential[second[branch]];
+    }
+
+    // std::complex<double> is laid out as an array of its real and imaginary parts
+    const auto* const voltage = reinterpret_cast<const double*>(voltages.data());
+    auto* const current = reinterpret_cast<double*>(currents.data());
+    auto* const power = reinterpret_cast<double*>(powers.data());
+    const auto* const conductance = conductances.data();
+    const auto* const capacitance = capacitances.data();
+
+    for(std::size_t branch = 0U; branch < size; ++branch)
+    {
+        const auto real = voltage[2U * branch];
+        const auto imaginary = voltage[(2U * branch) + 1U];
+        const auto susceptance = frequency * capacitance[branch];
+
+        const auto current_real = current[2U * branch] + (conductance[branch] * real) - (susceptance * imaginary);
+        const auto current_imaginary = current[(2U * branch) + 1U] + (conductance[branch] * imaginary) +
+                                       (susceptance * real);
+
+        current[2U * branch] = current_real;
+        current[(2U * branch) + 1U] = current_imaginary;
+        power[2U * branch] = (real * current_real) + (imaginary * current_imaginary);
+        power[(2U * branch) + 1U] = (imaginary * current_real) - (real * current_imaginary);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for voltages, the drop from each branch's first terminal to its second
+ *************************************************************************************************/
+std::span<const std::complex<double>> Branch_Quantities::get_voltages() const
+{
+    return voltages;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for currents, flowing from each branch's first terminal to its second
+ *************************************************************************************************/
+std::span<const std::complex<double>> Branch_Quantities::get_currents() const
+{
+    return currents;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for powers, the complex power absorbed by each branch
+ *************************************************************************************************/
+std::span<const std::complex<double>> Branch_Quantities::get_powers() const
+{
+    return powers;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for branch_uids, the UID behind each entry of the spans
+ *************************************************************************************************/
+std::span<const uint32_t> Branch_Quantities::get_branch_uids() const
+{
+    return branch_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of branches
+ *************************************************************************************************/
+std::size_t Branch_Quantities::get_number_of_branches() const
+{
+    return branch_uids.size();
+}
@@ -0,0 +1,300 @@
+#include "circlyzer/compiled_network.h"
+#include "circlyzer/network.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+
+using namespace Circlyzer;
+
+namespace
+{
+    /**
+     * \brief Position of uid within a sorted UID list, or the list size if it isn't present
+     */
+    std::size_t find_sorted(const std::vector<uint32_t>& uids, const uint32_t uid)
+    {
+        const auto it = std::lower_bound(uids.begin(), uids.end(), uid);
+        if((it == uids.end()) || (*it != uid))
+        {
+            return uids.size();
+        }
+
+        return static_cast<std::size_t>(it - uids.begin());
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param component
+ *************************************************************************************************/
+std::complex<double> Circlyzer::get_component_value(const Component& component)
+{
+    switch(component.type)
+    {
+        case Component_Type::Resistor:
+            return dynamic_cast<const Resistor&>(component).resistance;
+
+        case Component_Type::Capacitor:
+            return dynamic_cast<const Capacitor&>(component).capacitance;
+
+        case Component_Type::Inductor:
+            return dynamic_cast<const Inductor&>(component).inductance;
+
+        case Component_Type::Voltage_Source:
+            return dynamic_cast<const Voltage_Source&>(component).voltage;
+
+        case Component_Type::Diode:
+        {
+            // Everything the diode equation needs: the saturation current and n Vt
+            const auto& diode = dynamic_cast<const Diode&>(component);
+            return { diode.saturation_current, diode.emission_coefficient * diode.thermal_voltage };
+        }
+    }
+
+    return 0.0;
+}
+
+/**********************************************************************************************//**
+ * \brief Walks the network once to number every entity, then a second time over the branches to
+ *        fill the terminal slots and count node degrees for the CSR offsets.
+ * \param network
+ *************************************************************************************************/
+Compiled_Network::Compiled_Network(const Network& network) :
+    node_uids(network.get_node_uids()),
+    branch_uids(network.get_branch_uids()),
+    node_aliases(node_uids.size()),
+    branch_aliases(branch_uids.size()),
+    branch_terminals(branch_uids.size() * TERMINALS_PER_BRANCH, NO_NODE),
+    node_offsets(node_uids.size() + 1U, 0U),
+    node_branches(),
+    types(branch_uids.size()),
+    values(branch_uids.size()),
+    sequence{ network.get_journal().get_sequence() }
+{
+    for(std::size_t node_index = 0U; node_index < node_uids.size(); ++node_index)
+    {
+        node_aliases[node_index] = network.get_node(node_uids[node_index]).alias;
+    }
+
+    for(std::size_t branch_index = 0U; branch_index < branch_uids.size(); ++branch_index)
+    {
+        const auto& branch = network.get_branch(branch_uids[branch_index]);
+
+        branch_aliases[branch_index] = branch.alias;
+        types[branch_index] = branch.component->type;
+        values[branch_index] = get_component_value(*branch.component);
+
+        const auto terminals = std::min(branch.nodes.size(), TERMINALS_PER_BRANCH);
+        for(std::size_t terminal = 0U; terminal < terminals; ++terminal)
+        {
+            const auto node_index = find_sorted(node_uids, branch.nodes[terminal]);
+            if(node_index == node_uids.size())
+            {
+                // Left behind by a destroyed node
+                continue;
+            }
+
+            branch_terminals[(branch_index * TERMINALS_PER_BRANCH) + terminal] =
+                static_cast<uint32_t>(node_index);
+            ++node_offsets[node_index + 1U];
+        }
+    }
+
+    // Prefix sum of the degrees gives each node's slice of node_branches
+    for(std::size_t node_index = 0U; node_index < node_uids.size(); ++node_index)
+    {
+        node_offsets[node_index + 1U] += node_offsets[node_index];
+    }
+
+    node_branches.resize(node_offsets.back());
+    auto cursor = node_offsets;
+    for(std::size_t branch_index = 0U; branch_index < branch_uids.size(); ++branch_index)
+    {
+        for(std::size_t terminal = 0U; terminal < TERMINALS_PER_BRANCH; ++terminal)
+        {
+            const auto node_index = branch_terminals[(branch_index * TERMINALS_PER_BRANCH) + terminal];
+            if(node_index != NO_NODE)
+            {
+                node_branches[cursor[node_index]++] = static_cast<uint32_t>(branch_index);
+            }
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+std::size_t Compiled_Network::get_number_of_nodes() const
+{
+    return node_uids.size();
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+std::size_t Compiled_Network::get_number_of_branches() const
+{
+    return branch_uids.size();
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param node_index
+ *************************************************************************************************/
+uint32_t Compiled_Network::get_node_uid(const uint32_t node_index) const
+{
+    return node_uids.at(node_index);
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param branch_index
+ *************************************************************************************************/
+uint32_t Compiled_Network::get_branch_uid(const uint32_t branch_index) const
+{
+    return branch_uids.at(branch_index);
+}
+
+/**********************************************************************************************//**
+ * \brief Translates a node UID, throwing the same exceptions as the Network accessors
+ * \param uid
+ *************************************************************************************************/
+uint32_t Compiled_Network::get_node_index(const uint32_t uid) const
+{
+    const auto index = find_sorted(node_uids, uid);
+    if(index == node_uids.size())
+    {
+        if(find_sorted(branch_uids, uid) != branch_uids.size())
+        {
+            throw Wrong_Entity_Type_Exception();
+        }
+
+        throw Non_Existant_UID_Exception();
+    }
+
+    return static_cast<uint32_t>(index);
+}
+
+/**********************************************************************************************//**
+ * \brief Translates a branch UID, throwing the same exceptions as the Network accessors
+ * \param uid
+ *************************************************************************************************/
+uint32_t Compiled_Network::get_branch_index(const uint32_t uid) const
+{
+    const auto index = find_sorted(branch_uids, uid);
+    if(index == branch_uids.size())
+    {
+        if(find_sorted(node_uids, uid) != node_uids.size())
+        {
+            throw Wrong_Entity_Type_Exception();
+        }
+
+        throw Non_Existant_UID_Exception();
+    }
+
+    return static_cast<uint32_t>(index);
+}
+
+/**********************************************************************************************//**
+ * \brief Alias of a node, empty if it has none
+ * \param node_index
+ *************************************************************************************************/
+const std::string& Compiled_Network::get_node_alias(const uint32_t node_index) const
+{
+    return node_aliases.at(node_index);
+}
+
+/**********************************************************************************************//**
+ * \brief Alias of a branch, empty if it has none
+ * \param branch_index
+ *************************************************************************************************/
+const std::string& Compiled_Network::get_branch_alias(const uint32_t branch_index) const
+{
+    return branch_aliases.at(branch_index);
+}
+
+/**********************************************************************************************//**
+ * \brief Both terminal slots of a branch, NO_NODE where nothing is connected
+ * \param branch_index
+ *************************************************************************************************/
+std::span<const uint32_t> Compiled_Network::get_terminals(const uint32_t branch_index) const
+{
+    return { branch_terminals.data() + (branch_index * TERMINALS_PER_BRANCH),
+             TERMINALS_PER_BRANCH };
+}
+
+/**********************************************************************************************//**
+ * \brief Branch indices touching a node, in ascending order
+ * \param node_index
+ *************************************************************************************************/
+std::span<const uint32_t> Compiled_Network::get_incident_branches(const uint32_t node_index) const
+{
+    return { node_branches.data() + node_offsets[node_index],
+             node_offsets[node_index + 1U] - node_offsets[node_index] };
+}
+
+/**********************************************************************************************//**
+ * \brief Whether both terminals of a branch are connected, which is when it can carry current
+ * \param branch_index
+ *************************************************************************************************/
+bool Compiled_Network::is_connected(const uint32_t branch_index) const
+{
+    const auto terminals = get_terminals(branch_index);
+    return (terminals[0] != NO_NODE) && (terminals[1] != NO_NODE);
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+std::span<const Component_Type> Compiled_Network::get_types() const
+{
+    return types;
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+std::span<const std::complex<double>> Compiled_Network::get_values() const
+{
+    return values;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for node_uids, sorted ascending
+ *************************************************************************************************/
+const std::vector<uint32_t>& Compiled_Network::get_node_uids() const
+{
+    return node_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for branch_uids, sorted ascending
+ *************************************************************************************************/
+const std::vector<uint32_t>& Compiled_Network::get_branch_uids() const
+{
+    return branch_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for node_offsets, node i's branches are node_branches[offsets[i], offsets[i+1])
+ *************************************************************************************************/
+const std::vector<uint32_t>& Compiled_Network::get_node_offsets() const
+{
+    return node_offsets;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for node_branches
+ *************************************************************************************************/
+const std::vector<uint32_t>& Compiled_Network::get_node_branches() const
+{
+    return node_branches;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for sequence
+ *************************************************************************************************/
+uint64_t Compiled_Network::get_sequence() const
+{
+    return sequence;
+}
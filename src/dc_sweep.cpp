@@ -0,0 +1,235 @@
+#include "circlyzer/dc_sweep.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/nodal_analysis.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto GROUND_INDEX = Nodal_Analysis::GROUND_INDEX;
+}
+
+/**********************************************************************************************//**
+ * \brief Assembles and factorizes the DC system
+ * \param network
+ * \param ground_uid
+ * \param source_uids Voltage sources whose value is set by every point
+ * \param probe_uids Nodes whose voltage is handed to the sink
+ *************************************************************************************************/
+DC_Sweep::DC_Sweep(const Compiled_Network& network, const uint32_t ground_uid,
+                   const std::vector<uint32_t>& source_uids, const std::vector<uint32_t>& probe_uids) :
+    factorization(),
+    base_excitation(),
+    source_rows(),
+    probe_indices()
+{
+    const Nodal_Analysis analysis(network, ground_uid);
+    const auto size = analysis.get_system_size();
+
+    // At DC every stamp is real
+    Dense_Matrix<double> matrix(size, size);
+    analysis.for_each_stamp(0.0, [&](const std::size_t row, const std::size_t column,
+                                     const std::complex<double>& value)
+    {
+        matrix(row, column) += value.real();
+    });
+
+    for(const auto& value : analysis.assemble_excitation())
+    {
+        base_excitation.emplace_back(value.real());
+    }
+
+    std::unordered_map<uint32_t, std::size_t> source_indices;
+    for(const auto& element : analysis.get_elements())
+    {
+        if(element.type == Component_Type::Voltage_Source)
+        {
+            source_indices.insert({ element.uid, element.current_index });
+        }
+    }
+
+    for(const auto uid : source_uids)
+    {
+        const auto found = source_indices.find(uid);
+        if(found == source_indices.end())
+        {
+            throw Invalid_Sweep_Exception();
+        }
+
+        source_rows.emplace_back(found->second);
+    }
+
+    const auto& node_uids = analysis.get_node_uids();
+    for(const auto uid : probe_uids)
+    {
+        if(uid == ground_uid)
+        {
+            probe_indices.emplace_back(GROUND_INDEX);
+            continue;
+        }
+
+        const auto found = std::find(node_uids.begin(), node_uids.end(), uid);
+        if(found == node_uids.end())
+        {
+            throw Non_Existant_UID_Exception();
+        }
+
+        probe_indices.emplace_back(static_cast<std::size_t>(found - node_uids.begin()));
+    }
+
+    factorization = LU_Factorization<double>(std::move(matrix));
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network before analysing it
+ * \param network
+ * \param ground_uid
+ * \param source_uids
+ * \param probe_uids
+ *************************************************************************************************/
+DC_Sweep::DC_Sweep(const Network& network, const uint32_t ground_uid,
+                   const std::vector<uint32_t>& source_uids, const std::vector<uint32_t>& probe_uids) :
+    DC_Sweep(*network.compile(), ground_uid, source_uids, probe_uids)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Solves every point, streaming the probe voltages to the sink
+ * \param points Pulled a wave at a time until it returns false
+ * \param sink
+ * \param block_size Points solved together in one substitution
+ * \param executor
+ *************************************************************************************************/
+void DC_Sweep::run(const Point_Source& points, const Sweep_Sink& sink,
+                   const std::size_t block_size, Executor& executor) const
+{
+    const auto size = base_excitation.size();
+    const auto width = std::max<std::size_t>(block_size, 1U);
+    const auto number_of_sources = source_rows.size();
+    const auto number_of_probes = probe_indices.size();
+    const auto wave = width * std::max<std::size_t>(executor.get_number_of_workers(), 1U);
+
+    std::vector<double> inputs(wave * number_of_sources);
+    std::vector<double> voltages(wave * number_of_probes);
+    bool exhausted = false;
+    for(std::size_t start = 0U; !exhausted; start += wave)
+    {
+        std::size_t count = 0U;
+        while(count < wave)
+        {
+            if(!points(std::span<double>(inputs.data() + (count * number_of_sources), number_of_sources)))
+            {
+                exhausted = true;
+                break;
+            }
+
+            ++count;
+        }
+
+        if(count == 0U)
+        {
+            break;
+        }
+
+        const auto number_of_blocks = (count + width - 1U) / width;
+        executor.parallel_for(0U, number_of_blocks, [&](const std::size_t first, const std::size_t last)
+        {
+            for(auto block = first; block < last; ++block)
+            {
+                const auto offset = block * width;
+                const auto columns = std::min(width, count - offset);
+
+                // Point per column, rows interleaved so each substitution step is contiguous
+                Dense_Matrix<double> rhs(size, columns);
+                for(std::size_t row = 0U; row < size; ++row)
+                {
+                    std::fill_n(rhs.data() + (row * columns), columns, base_excitation[row]);
+                }
+
+                for(std::size_t column = 0U; column < columns; ++column)
+                {
+                    const auto* point = inputs.data() + ((offset + column) * number_of_sources);
+                    for(std::size_t source = 0U; source < number_of_sources; ++source)
+                    {
+                        rhs(source_rows[source], column) = point[source];
+                    }
+                }
+
+                const auto unknowns = factorization.solve(rhs);
+                for(std::size_t column = 0U; column < columns; ++column)
+                {
+                    auto* output = voltages.data() + ((offset + column) * number_of_probes);
+                    for(std::size_t probe = 0U; probe < number_of_probes; ++probe)
+                    {
+                        const auto index = probe_indices[probe];
+                        output[probe] = (index == GROUND_INDEX) ? 0.0 : unknowns(index, column);
+                    }
+                }
+            }
+        });
+
+        for(std::size_t point = 0U; point < count; ++point)
+        {
+            sink(start + point, std::span<const double>(voltages.data() + (point * number_of_probes),
+                                                        number_of_probes));
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Solves points laid out one after the other, one value per swept source each
+ * \param points
+ * \param sink
+ * \param block_size Points solved together in one substitution
+ * \param executor
+ *************************************************************************************************/
+void DC_Sweep::run(const std::span<const double> points, const Sweep_Sink& sink,
+                   const std::size_t block_size, Executor& executor) const
+{
+    const auto number_of_sources = source_rows.size();
+    if((number_of_sources == 0U) ? !points.empty() : (points.size() % number_of_sources != 0U))
+    {
+        throw Invalid_Sweep_Exception();
+    }
+
+    std::size_t next = 0U;
+    run([&](const std::span<double> point)
+    {
+        if(next == points.size())
+        {
+            return false;
+        }
+
+        std::copy_n(points.data() + next, number_of_sources, point.data());
+        next += number_of_sources;
+        return true;
+    }, sink, block_size, executor);
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of swept sources
+ *************************************************************************************************/
+std::size_t DC_Sweep::get_number_of_sources() const
+{
+    return source_rows.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of probes
+ *************************************************************************************************/
+std::size_t DC_Sweep::get_number_of_probes() const
+{
+    return probe_indices.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of unknowns
+ *************************************************************************************************/
+std::size_t DC_Sweep::get_system_size() const
+{
+    return base_excitation.size();
+}
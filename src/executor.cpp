@@ -0,0 +1,245 @@
+#include "circlyzer/executor.h"
+
+using namespace Circlyzer;
+
+namespace
+{
+    // Lets enqueue() recognise submissions made from one of the pool's own workers
+    thread_local const Executor* current_executor = nullptr;
+    thread_local std::size_t current_worker = 0U;
+
+    std::mutex shared_mutex;
+    std::unique_ptr<Executor> shared_executor;
+    std::size_t shared_number_of_workers = 0U;
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param number_of_workers Zero selects one worker per hardware thread
+ *************************************************************************************************/
+Executor::Executor(const std::size_t number_of_workers) :
+    queues(),
+    workers(),
+    sleep_mutex(),
+    sleep_condition(),
+    pending{ 0U },
+    stopping{ false },
+    next_queue{ 0U }
+{
+    auto count = number_of_workers;
+    if(count == 0U)
+    {
+        count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1U);
+    }
+
+    for(std::size_t index = 0U; index < count; ++index)
+    {
+        queues.emplace_back(std::make_unique<Worker_Queue>());
+    }
+
+    for(std::size_t index = 0U; index < count; ++index)
+    {
+        workers.emplace_back([this, index]() { run(index); });
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Finishes every queued task, then joins the workers
+ *************************************************************************************************/
+Executor::~Executor()
+{
+    {
+        const std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+
+    sleep_condition.notify_all();
+
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief The library-wide executor, created on first use
+ *************************************************************************************************/
+Executor& Executor::get_shared()
+{
+    const std::lock_guard<std::mutex> lock(shared_mutex);
+    if(shared_executor == nullptr)
+    {
+        shared_executor = std::make_unique<Executor>(shared_number_of_workers);
+    }
+
+    return *shared_executor;
+}
+
+/**********************************************************************************************//**
+ * \brief Sets the worker count of the shared executor. Must happen before its first use.
+ * \param number_of_workers Zero selects one worker per hardware thread
+ *************************************************************************************************/
+void Executor::configure_shared(const std::size_t number_of_workers)
+{
+    const std::lock_guard<std::mutex> lock(shared_mutex);
+    if(shared_executor != nullptr)
+    {
+        throw Executor_Already_Running_Exception();
+    }
+
+    shared_number_of_workers = number_of_workers;
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+std::size_t Executor::get_number_of_workers() const
+{
+    return workers.size();
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param task
+ *************************************************************************************************/
+void Executor::enqueue(Task task)
+{
+    const auto target = (current_executor == this) ?
+        current_worker : (next_queue.fetch_add(1U) % queues.size());
+
+    // Count the task before publishing it, so a thief can never take it before it is counted
+    {
+        const std::lock_guard<std::mutex> lock(sleep_mutex);
+        ++pending;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.emplace_back(std::move(task));
+    }
+
+    sleep_condition.notify_one();
+}
+
+/**********************************************************************************************//**
+ * \brief Takes the newest task from a worker's own deque
+ * \param index
+ * \param task
+ *************************************************************************************************/
+bool Executor::try_pop(const std::size_t index, Task& task)
+{
+    auto& queue = *queues[index];
+    const std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+/**********************************************************************************************//**
+ * \brief Takes the oldest task from any other deque, starting with the thief's neighbour
+ * \param thief
+ * \param task
+ *************************************************************************************************/
+bool Executor::try_steal(const std::size_t thief, Task& task)
+{
+    for(std::size_t offset = 1U; offset <= queues.size(); ++offset)
+    {
+        auto& queue = *queues[(thief + offset) % queues.size()];
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        if(!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**********************************************************************************************//**
+ * \brief Runs a single queued task on the calling thread if one can be found
+ *************************************************************************************************/
+bool Executor::try_run_one()
+{
+    Task task;
+    const auto is_worker = (current_executor == this);
+    const auto index = is_worker ? current_worker : 0U;
+
+    if((is_worker && try_pop(index, task)) || try_steal(index, task))
+    {
+        {
+            const std::lock_guard<std::mutex> lock(sleep_mutex);
+            --pending;
+        }
+
+        task();
+        return true;
+    }
+
+    return false;
+}
+
+/**********************************************************************************************//**
+ * \brief Keeps the calling thread busy with queued work until the predicate clears. With nothing
+ *        left to steal it sleeps alongside the idle workers, so waiting doesn't hold on to a
+ *        core. Whatever clears the predicate must call wake_waiters() afterwards.
+ * \param predicate
+ *************************************************************************************************/
+void Executor::help_while(const std::function<bool()>& predicate)
+{
+    while(predicate())
+    {
+        if(try_run_one())
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_condition.wait(lock, [&]() { return (pending > 0U) || !predicate(); });
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Wakes every sleeping thread to re-check what it waits on. Taking the lock first orders
+ *        the wake after any waiter's last look at its predicate, so none can miss it.
+ *************************************************************************************************/
+void Executor::wake_waiters()
+{
+    {
+        const std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+
+    sleep_condition.notify_all();
+}
+
+/**********************************************************************************************//**
+ * \brief Worker loop
+ * \param index
+ *************************************************************************************************/
+void Executor::run(const std::size_t index)
+{
+    current_executor = this;
+    current_worker = index;
+
+    while(true)
+    {
+        if(try_run_one())
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_condition.wait(lock, [this]() { return (pending > 0U) || stopping; });
+
+        if(stopping && (pending == 0U))
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,299 @@
+#include "circlyzer/generators.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto MINIMUM_RESISTANCE = 100.0;
+    constexpr auto MAXIMUM_RESISTANCE = 10.0e3;
+    constexpr auto MINIMUM_CAPACITANCE = 1.0e-9;
+    constexpr auto MAXIMUM_CAPACITANCE = 1.0e-6;
+    constexpr auto MINIMUM_INDUCTANCE = 1.0e-6;
+    constexpr auto MAXIMUM_INDUCTANCE = 10.0e-3;
+    constexpr auto SOURCE_VOLTAGE = 1.0;
+
+    /**
+     * \brief Platform independent random values on top of the raw engine output
+     */
+    class Random_Values
+    {
+    public:
+        explicit Random_Values(const uint64_t seed) :
+            engine{ seed }
+        {
+
+        }
+
+        double between(const double minimum, const double maximum)
+        {
+            const auto unit = static_cast<double>(engine() >> 11U) * 0x1.0p-53;
+            return minimum + ((maximum - minimum) * unit);
+        }
+
+        std::size_t below(const std::size_t limit)
+        {
+            return static_cast<std::size_t>(engine() % limit);
+        }
+
+        bool coin()
+        {
+            return (engine() >> 63U) != 0U;
+        }
+
+    private:
+        std::mt19937_64 engine;
+    };
+
+    /**
+     * \brief Keeps the bookkeeping shared by all generators
+     */
+    class Builder
+    {
+    public:
+        Builder(Network& network, const std::size_t number_of_nodes, const uint64_t seed) :
+            network(network),
+            random{ seed },
+            nodes(),
+            circuit{ 0U, 0U, 0U, 0U }
+        {
+            if(number_of_nodes == 0U)
+            {
+                throw Invalid_Generator_Size_Exception();
+            }
+
+            circuit.ground_uid = network.create_node();
+            nodes.reserve(number_of_nodes);
+            for(std::size_t index = 0U; index < number_of_nodes; ++index)
+            {
+                nodes.emplace_back(network.create_node());
+            }
+
+            circuit.number_of_nodes = number_of_nodes + 1U;
+            circuit.source_uid = connect(std::make_unique<Voltage_Source>(SOURCE_VOLTAGE),
+                                         nodes.front(), circuit.ground_uid);
+        }
+
+        uint32_t connect(std::unique_ptr<Component> component, const uint32_t first,
+                         const uint32_t second)
+        {
+            const auto uid = network.create_branch(std::move(component));
+            network.create_connection_between(first, uid);
+            network.create_connection_between(second, uid);
+            ++circuit.number_of_branches;
+            return uid;
+        }
+
+        void resistor(const uint32_t first, const uint32_t second)
+        {
+            connect(std::make_unique<Resistor>(random.between(MINIMUM_RESISTANCE, MAXIMUM_RESISTANCE)),
+                    first, second);
+        }
+
+        void inductor(const uint32_t first, const uint32_t second)
+        {
+            connect(std::make_unique<Inductor>(random.between(MINIMUM_INDUCTANCE, MAXIMUM_INDUCTANCE)),
+                    first, second);
+        }
+
+        void capacitor(const uint32_t first, const uint32_t second)
+        {
+            connect(std::make_unique<Capacitor>(random.between(MINIMUM_CAPACITANCE, MAXIMUM_CAPACITANCE)),
+                    first, second);
+        }
+
+        uint32_t ground() const
+        {
+            return circuit.ground_uid;
+        }
+
+        uint32_t node(const std::size_t index) const
+        {
+            return nodes[index];
+        }
+
+        Random_Values& get_random()
+        {
+            return random;
+        }
+
+        const Generated_Circuit& get_circuit() const
+        {
+            return circuit;
+        }
+
+    private:
+        Network& network;
+        Random_Values random;
+        std::vector<uint32_t> nodes;
+        Generated_Circuit circuit;
+    };
+}
+
+/**********************************************************************************************//**
+ * \brief Builds a resistor ladder
+ * \param network
+ * \param number_of_sections
+ * \param seed
+ *************************************************************************************************/
+Generated_Circuit Circlyzer::generate_ladder(Network& network, const std::size_t number_of_sections,
+                                             const uint64_t seed)
+{
+    if(number_of_sections == 0U)
+    {
+        throw Invalid_Generator_Size_Exception();
+    }
+
+    Builder builder(network, number_of_sections + 1U, seed);
+
+    for(std::size_t section = 0U; section < number_of_sections; ++section)
+    {
+        builder.resistor(builder.node(section), builder.node(section + 1U));
+        builder.resistor(builder.node(section + 1U), builder.ground());
+    }
+
+    return builder.get_circuit();
+}
+
+/**********************************************************************************************//**
+ * \brief Builds a 2D or 3D resistor mesh
+ * \param network
+ * \param width
+ * \param height
+ * \param depth
+ * \param seed
+ *************************************************************************************************/
+Generated_Circuit Circlyzer::generate_grid(Network& network, const std::size_t width,
+                                           const std::size_t height, const std::size_t depth,
+                                           const uint64_t seed)
+{
+    Builder builder(network, width * height * depth, seed);
+
+    const auto index_of = [&](const std::size_t x, const std::size_t y, const std::size_t z)
+    {
+        return x + (width * (y + (height * z)));
+    };
+
+    for(std::size_t z = 0U; z < depth; ++z)
+    {
+        for(std::size_t y = 0U; y < height; ++y)
+        {
+            for(std::size_t x = 0U; x < width; ++x)
+            {
+                const auto here = builder.node(index_of(x, y, z));
+
+                if((x + 1U) < width)
+                {
+                    builder.resistor(here, builder.node(index_of(x + 1U, y, z)));
+                }
+
+                if((y + 1U) < height)
+                {
+                    builder.resistor(here, builder.node(index_of(x, y + 1U, z)));
+                }
+
+                if((z + 1U) < depth)
+                {
+                    builder.resistor(here, builder.node(index_of(x, y, z + 1U)));
+                }
+            }
+        }
+    }
+
+    builder.resistor(builder.node((width * height * depth) - 1U), builder.ground());
+
+    return builder.get_circuit();
+}
+
+/**********************************************************************************************//**
+ * \brief Builds a connected random resistor graph
+ * \param network
+ * \param number_of_nodes
+ * \param average_degree
+ * \param seed
+ *************************************************************************************************/
+Generated_Circuit Circlyzer::generate_random_sparse(Network& network, const std::size_t number_of_nodes,
+                                                    const double average_degree, const uint64_t seed)
+{
+    Builder builder(network, number_of_nodes, seed);
+    auto& random = builder.get_random();
+
+    for(std::size_t index = 1U; index < number_of_nodes; ++index)
+    {
+        builder.resistor(builder.node(index), builder.node(random.below(index)));
+    }
+
+    const auto target = static_cast<std::size_t>(average_degree * static_cast<double>(number_of_nodes) / 2.0);
+    for(auto edges = number_of_nodes - 1U; (edges < target) && (number_of_nodes > 1U); ++edges)
+    {
+        const auto first = random.below(number_of_nodes);
+        auto second = random.below(number_of_nodes - 1U);
+        if(second >= first)
+        {
+            ++second;
+        }
+
+        builder.resistor(builder.node(first), builder.node(second));
+    }
+
+    builder.resistor(builder.node(random.below(number_of_nodes)), builder.ground());
+
+    return builder.get_circuit();
+}
+
+/**********************************************************************************************//**
+ * \brief Builds a random RLC tree
+ * \param network
+ * \param number_of_nodes
+ * \param maximum_children
+ * \param seed
+ *************************************************************************************************/
+Generated_Circuit Circlyzer::generate_rlc_tree(Network& network, const std::size_t number_of_nodes,
+                                               const std::size_t maximum_children, const uint64_t seed)
+{
+    if(maximum_children == 0U)
+    {
+        throw Invalid_Generator_Size_Exception();
+    }
+
+    Builder builder(network, number_of_nodes, seed);
+    auto& random = builder.get_random();
+
+    // Nodes that can still take a child, with how many they have so far
+    std::vector<std::size_t> open_nodes = { 0U };
+    std::vector<std::size_t> children(number_of_nodes, 0U);
+
+    for(std::size_t index = 1U; index < number_of_nodes; ++index)
+    {
+        const auto slot = random.below(open_nodes.size());
+        const auto parent = open_nodes[slot];
+
+        if(random.coin())
+        {
+            builder.resistor(builder.node(parent), builder.node(index));
+        }
+        else
+        {
+            builder.inductor(builder.node(parent), builder.node(index));
+        }
+
+        if(++children[parent] == maximum_children)
+        {
+            open_nodes[slot] = open_nodes.back();
+            open_nodes.pop_back();
+        }
+
+        open_nodes.emplace_back(index);
+    }
+
+    for(std::size_t index = 0U; index < number_of_nodes; ++index)
+    {
+        builder.capacitor(builder.node(index), builder.ground());
+    }
+
+    return builder.get_circuit();
+}
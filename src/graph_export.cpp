@@ -0,0 +1,751 @@
+#include "circlyzer/graph_export.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/impedance_table.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <tuple>
+#include <unistd.h>
+
+using namespace Circlyzer;
+
+namespace
+{
+
+constexpr std::size_t NUMBER_BUFFER_SIZE = 64U;
+
+/**********************************************************************************************//**
+ * \brief Two or more passive branches drawn as one edge
+ *************************************************************************************************/
+struct Group
+{
+    uint32_t first;
+    uint32_t second;
+    std::complex<double> impedance;
+    std::size_t number_of_branches;
+    uint32_t representative;
+};
+
+struct Collapsed
+{
+    std::vector<bool> hidden_nodes;
+    std::vector<bool> grouped_branches;
+    std::vector<Group> groups;
+};
+
+/**********************************************************************************************//**
+ * \brief Admittance of an impedance. Anything infinite, such as a capacitor at DC, is an open
+ *        circuit and drops out of parallel combinations.
+ *************************************************************************************************/
+std::complex<double> to_admittance(const std::complex<double>& impedance)
+{
+    if(std::isinf(impedance.real()) || std::isinf(impedance.imag()))
+    {
+        return 0.0;
+    }
+
+    if(impedance == 0.0)
+    {
+        return { std::numeric_limits<double>::infinity(), 0.0 };
+    }
+
+    return 1.0 / impedance;
+}
+
+/**********************************************************************************************//**
+ * \brief Whether a branch has a linear impedance that can be folded into a series or parallel
+ *        group. Sources and diodes are always drawn on their own.
+ *************************************************************************************************/
+bool is_passive(const Component_Type type)
+{
+    return (type != Component_Type::Voltage_Source) && (type != Component_Type::Diode);
+}
+
+/**********************************************************************************************//**
+ * \brief Finds series chains through interior nodes, then merges chains that share both end
+ *        nodes. A node is interior when it has no alias and exactly two incident branches, both
+ *        connected and passive. The working memory is proportional to the network, not to the
+ *        output.
+ *************************************************************************************************/
+Collapsed collapse(const Compiled_Network& network, const double frequency)
+{
+    const auto number_of_nodes = network.get_number_of_nodes();
+    const auto number_of_branches = network.get_number_of_branches();
+    const auto types = network.get_types();
+
+    Impedance_Table table(network, 1U);
+    const auto& impedances = table.get_impedances(frequency);
+
+    Collapsed result;
+    result.hidden_nodes.assign(number_of_nodes, false);
+    result.grouped_branches.assign(number_of_branches, false);
+
+    const auto is_groupable = [&](const uint32_t branch)
+    {
+        return network.is_connected(branch) && is_passive(types[branch]);
+    };
+
+    for(uint32_t node = 0U; node < number_of_nodes; ++node)
+    {
+        const auto incident = network.get_incident_branches(node);
+        result.hidden_nodes[node] = network.get_node_alias(node).empty() &&
+                                    (incident.size() == 2U) &&
+                                    (incident[0] != incident[1]) &&
+                                    is_groupable(incident[0]) &&
+                                    is_groupable(incident[1]);
+    }
+
+    const auto other_terminal = [&](const uint32_t branch, const uint32_t node)
+    {
+        const auto terminals = network.get_terminals(branch);
+        return (terminals[0] == node) ? terminals[1] : terminals[0];
+    };
+
+    std::vector<Group> chains;
+    for(uint32_t branch = 0U; branch < number_of_branches; ++branch)
+    {
+        if(!is_groupable(branch) || result.grouped_branches[branch])
+        {
+            continue;
+        }
+
+        Group chain{ 0U, 0U, impedances[branch], 1U, branch };
+        result.grouped_branches[branch] = true;
+
+        // Walks outwards from each terminal until a visible node, or back onto the chain itself
+        const auto walk = [&](uint32_t node)
+        {
+            auto previous = branch;
+            while(result.hidden_nodes[node])
+            {
+                const auto incident = network.get_incident_branches(node);
+                const auto next = (incident[0] == previous) ? incident[1] : incident[0];
+                if(result.grouped_branches[next])
+                {
+                    break;
+                }
+
+                result.grouped_branches[next] = true;
+                chain.impedance += impedances[next];
+                ++chain.number_of_branches;
+
+                node = other_terminal(next, node);
+                previous = next;
+            }
+
+            return node;
+        };
+
+        const auto terminals = network.get_terminals(branch);
+        chain.first = walk(terminals[0]);
+        chain.second = walk(terminals[1]);
+
+        // One open branch, whatever the sign of its reactance, opens the whole chain
+        if(to_admittance(chain.impedance) == 0.0)
+        {
+            chain.impedance = { std::numeric_limits<double>::infinity(), 0.0 };
+        }
+
+        chains.emplace_back(chain);
+    }
+
+    // A ring made only of interior nodes has to keep its end point visible
+    for(auto& chain : chains)
+    {
+        result.hidden_nodes[chain.first] = false;
+        result.hidden_nodes[chain.second] = false;
+
+        if(chain.first > chain.second)
+        {
+            std::swap(chain.first, chain.second);
+        }
+    }
+
+    std::sort(chains.begin(), chains.end(), [](const Group& left, const Group& right)
+    {
+        return std::tie(left.first, left.second, left.representative) <
+               std::tie(right.first, right.second, right.representative);
+    });
+
+    for(std::size_t begin = 0U; begin < chains.size();)
+    {
+        auto end = begin + 1U;
+        auto admittance = to_admittance(chains[begin].impedance);
+        auto group = chains[begin];
+
+        while((end < chains.size()) &&
+              (chains[end].first == group.first) && (chains[end].second == group.second))
+        {
+            admittance += to_admittance(chains[end].impedance);
+            group.number_of_branches += chains[end].number_of_branches;
+            ++end;
+        }
+
+        if((end - begin) > 1U)
+        {
+            group.impedance = to_admittance(admittance);
+        }
+
+        result.groups.emplace_back(group);
+        begin = end;
+    }
+
+    return result;
+}
+
+const char* type_name(const Component_Type type)
+{
+    switch(type)
+    {
+        case Component_Type::Resistor:       return "Resistor";
+        case Component_Type::Capacitor:      return "Capacitor";
+        case Component_Type::Inductor:       return "Inductor";
+        case Component_Type::Voltage_Source: return "Voltage_Source";
+        case Component_Type::Diode:          return "Diode";
+    }
+
+    return "Unknown";
+}
+
+/**********************************************************************************************//**
+ * \brief Emits the document piece by piece. Every value is formatted into a stack buffer and
+ *        escaped while it is copied into the sink, so no strings are built for the output.
+ *************************************************************************************************/
+class Graph_Writer
+{
+public:
+    Graph_Writer(Output_Sink& sink, const Graph_Format format) :
+        sink(sink),
+        format{ format }
+    {
+
+    }
+
+    void begin()
+    {
+        if(format == Graph_Format::Dot)
+        {
+            sink.write("graph circlyzer {\n");
+            sink.write("  node [shape=circle];\n");
+            return;
+        }
+
+        sink.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        sink.write("<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n");
+        sink.write("  <key id=\"kind\" for=\"node\" attr.name=\"kind\" attr.type=\"string\"/>\n");
+        sink.write("  <key id=\"alias\" for=\"all\" attr.name=\"alias\" attr.type=\"string\"/>\n");
+        sink.write("  <key id=\"type\" for=\"all\" attr.name=\"type\" attr.type=\"string\"/>\n");
+        sink.write("  <key id=\"value\" for=\"all\" attr.name=\"value\" attr.type=\"string\"/>\n");
+        sink.write("  <key id=\"branches\" for=\"edge\" attr.name=\"branches\" attr.type=\"int\"/>\n");
+        sink.write("  <graph id=\"circlyzer\" edgedefault=\"undirected\">\n");
+    }
+
+    void end()
+    {
+        if(format == Graph_Format::Dot)
+        {
+            sink.write("}\n");
+            return;
+        }
+
+        sink.write("  </graph>\n");
+        sink.write("</graphml>\n");
+    }
+
+    void node(const uint32_t uid, const std::string& alias)
+    {
+        if(format == Graph_Format::Dot)
+        {
+            sink.write("  ");
+            write_id('n', uid);
+            sink.write(" [label=\"");
+            write_name(alias, uid);
+            sink.write("\"];\n");
+            return;
+        }
+
+        sink.write("    <node id=\"");
+        write_id('n', uid);
+        sink.write("\"><data key=\"kind\">node</data>");
+        write_alias_data(alias);
+        sink.write("</node>\n");
+    }
+
+    /**
+     * \brief A branch with both terminals connected, drawn as an edge
+     */
+    void branch(const uint32_t uid, const std::string& alias, const Component_Type type,
+                const std::complex<double>& value, const uint32_t first, const uint32_t second)
+    {
+        if(format == Graph_Format::Dot)
+        {
+            sink.write("  ");
+            write_id('n', first);
+            sink.write(" -- ");
+            write_id('n', second);
+            sink.write(" [id=\"");
+            write_id('b', uid);
+            sink.write("\", label=\"");
+            write_name(alias, uid);
+            sink.write("\\n");
+            write_value(type, value);
+            sink.write("\"];\n");
+            return;
+        }
+
+        sink.write("    <edge id=\"");
+        write_id('b', uid);
+        sink.write("\" source=\"");
+        write_id('n', first);
+        sink.write("\" target=\"");
+        write_id('n', second);
+        sink.write("\">");
+        write_alias_data(alias);
+        write_type_data(type, value);
+        sink.write("</edge>\n");
+    }
+
+    /**
+     * \brief A branch missing a terminal, drawn as a vertex tied to the nodes it does reach
+     */
+    void dangling_branch(const uint32_t uid, const std::string& alias, const Component_Type type,
+                         const std::complex<double>& value, const std::span<const uint32_t> nodes)
+    {
+        if(format == Graph_Format::Dot)
+        {
+            sink.write("  ");
+            write_id('b', uid);
+            sink.write(" [shape=box, label=\"");
+            write_name(alias, uid);
+            sink.write("\\n");
+            write_value(type, value);
+            sink.write("\"];\n");
+
+            for(const auto node : nodes)
+            {
+                sink.write("  ");
+                write_id('n', node);
+                sink.write(" -- ");
+                write_id('b', uid);
+                sink.write(" [style=dashed];\n");
+            }
+            return;
+        }
+
+        sink.write("    <node id=\"");
+        write_id('b', uid);
+        sink.write("\"><data key=\"kind\">branch</data>");
+        write_alias_data(alias);
+        write_type_data(type, value);
+        sink.write("</node>\n");
+
+        for(std::size_t terminal = 0U; terminal < nodes.size(); ++terminal)
+        {
+            sink.write("    <edge id=\"");
+            write_id('b', uid);
+            write_number(".%zu", terminal);
+            sink.write("\" source=\"");
+            write_id('n', nodes[terminal]);
+            sink.write("\" target=\"");
+            write_id('b', uid);
+            sink.write("\"/>\n");
+        }
+    }
+
+    /**
+     * \brief Several passive branches replaced by their equivalent impedance. The group is named
+     *        after its lowest numbered branch.
+     */
+    void group(const uint32_t representative, const uint32_t first, const uint32_t second,
+               const std::complex<double>& impedance, const std::size_t number_of_branches)
+    {
+        if(format == Graph_Format::Dot)
+        {
+            sink.write("  ");
+            write_id('n', first);
+            sink.write(" -- ");
+            write_id('n', second);
+            sink.write(" [id=\"");
+            write_id('g', representative);
+            sink.write("\", style=bold, label=\"");
+            write_number("%zu branches\\n", number_of_branches);
+            sink.write("Z=");
+            write_complex(impedance);
+            sink.write("\"];\n");
+            return;
+        }
+
+        sink.write("    <edge id=\"");
+        write_id('g', representative);
+        sink.write("\" source=\"");
+        write_id('n', first);
+        sink.write("\" target=\"");
+        write_id('n', second);
+        sink.write("\"><data key=\"type\">Group</data><data key=\"value\">");
+        write_complex(impedance);
+        sink.write("</data><data key=\"branches\">");
+        write_number("%zu", number_of_branches);
+        sink.write("</data></edge>\n");
+    }
+
+private:
+    template<typename Value>
+    void write_number(const char* format_string, const Value value)
+    {
+        char buffer[NUMBER_BUFFER_SIZE];
+        const auto length = std::snprintf(buffer, sizeof(buffer), format_string, value);
+        sink.write(std::string_view(buffer, std::min<std::size_t>(length, sizeof(buffer) - 1U)));
+    }
+
+    void write_complex(const std::complex<double>& value)
+    {
+        char buffer[NUMBER_BUFFER_SIZE];
+        const auto length = std::snprintf(buffer, sizeof(buffer), "%g%+gj", value.real(), value.imag());
+        sink.write(std::string_view(buffer, std::min<std::size_t>(length, sizeof(buffer) - 1U)));
+    }
+
+    void write_id(const char prefix, const uint32_t uid)
+    {
+        sink.write(prefix);
+        write_number("%u", static_cast<unsigned int>(uid));
+    }
+
+    void write_name(const std::string& alias, const uint32_t uid)
+    {
+        if(alias.empty())
+        {
+            write_number("%u", static_cast<unsigned int>(uid));
+        }
+        else
+        {
+            write_escaped(alias);
+        }
+    }
+
+    void write_value(const Component_Type type, const std::complex<double>& value)
+    {
+        switch(type)
+        {
+            case Component_Type::Resistor:  sink.write("R="); write_number("%g", value.real()); break;
+            case Component_Type::Capacitor: sink.write("C="); write_number("%g", value.real()); break;
+            case Component_Type::Inductor:  sink.write("L="); write_number("%g", value.real()); break;
+            case Component_Type::Diode:     sink.write("Is="); write_number("%g", value.real()); break;
+            default:                        sink.write("V="); write_complex(value); break;
+        }
+    }
+
+    void write_alias_data(const std::string& alias)
+    {
+        if(!alias.empty())
+        {
+            sink.write("<data key=\"alias\">");
+            write_escaped(alias);
+            sink.write("</data>");
+        }
+    }
+
+    void write_type_data(const Component_Type type, const std::complex<double>& value)
+    {
+        sink.write("<data key=\"type\">");
+        sink.write(type_name(type));
+        sink.write("</data><data key=\"value\">");
+        if(type == Component_Type::Voltage_Source)
+        {
+            write_complex(value);
+        }
+        else
+        {
+            write_number("%g", value.real());
+        }
+        sink.write("</data>");
+    }
+
+    void write_escaped(const std::string& text)
+    {
+        for(const auto character : text)
+        {
+            if(format == Graph_Format::Dot)
+            {
+                switch(character)
+                {
+                    case '"':  sink.write("\\\""); break;
+                    case '\\': sink.write("\\\\"); break;
+                    case '\n': sink.write("\\n"); break;
+                    default:   sink.write(character); break;
+                }
+                continue;
+            }
+
+            switch(character)
+            {
+                case '&':  sink.write("&amp;"); break;
+                case '<':  sink.write("&lt;"); break;
+                case '>':  sink.write("&gt;"); break;
+                case '"':  sink.write("&quot;"); break;
+                case '\'': sink.write("&apos;"); break;
+                default:   sink.write(character); break;
+            }
+        }
+    }
+
+    Output_Sink& sink;
+    Graph_Format format;
+};
+
+} // namespace
+
+/**********************************************************************************************//**
+ * \brief Constructor. The buffer is allocated once and never grows.
+ *************************************************************************************************/
+Output_Sink::Output_Sink() :
+    buffer(BUFFER_SIZE),
+    used{ 0U }
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Appends text, passing it through whenever the buffer fills
+ * \param text
+ *************************************************************************************************/
+void Output_Sink::write(std::string_view text)
+{
+    while(!text.empty())
+    {
+        const auto count = std::min(text.size(), buffer.size() - used);
+        std::copy_n(text.data(), count, buffer.data() + used);
+        used += count;
+        text.remove_prefix(count);
+
+        if(used == buffer.size())
+        {
+            flush();
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Appends a single character
+ * \param character
+ *************************************************************************************************/
+void Output_Sink::write(const char character)
+{
+    buffer[used++] = character;
+
+    if(used == buffer.size())
+    {
+        flush();
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Hands everything buffered to the destination
+ *************************************************************************************************/
+void Output_Sink::flush()
+{
+    if(used > 0U)
+    {
+        const auto count = used;
+        used = 0U;
+        write_through(buffer.data(), count);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Constructor
+ * \param file_descriptor
+ *************************************************************************************************/
+File_Descriptor_Sink::File_Descriptor_Sink(const int file_descriptor) :
+    Output_Sink(),
+    file_descriptor{ file_descriptor }
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Destructor. Writes whatever is still buffered; errors can't be reported from here, so
+ *        call flush() first when they matter.
+ *************************************************************************************************/
+File_Descriptor_Sink::~File_Descriptor_Sink()
+{
+    try
+    {
+        flush();
+    }
+    catch(const Export_Failed_Exception&)
+    {
+
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Retries short writes and interrupted calls until everything is written
+ * \param data
+ * \param size
+ *************************************************************************************************/
+void File_Descriptor_Sink::write_through(const char* data, std::size_t size)
+{
+    while(size > 0U)
+    {
+        const auto written = ::write(file_descriptor, data, size);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            throw Export_Failed_Exception();
+        }
+
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Constructor
+ * \param stream
+ *************************************************************************************************/
+Stream_Sink::Stream_Sink(std::ostream& stream) :
+    Output_Sink(),
+    stream(stream)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Destructor. Writes whatever is still buffered.
+ *************************************************************************************************/
+Stream_Sink::~Stream_Sink()
+{
+    try
+    {
+        flush();
+    }
+    catch(const Export_Failed_Exception&)
+    {
+
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Forwards to the stream
+ * \param data
+ * \param size
+ *************************************************************************************************/
+void Stream_Sink::write_through(const char* data, const std::size_t size)
+{
+    stream.write(data, static_cast<std::streamsize>(size));
+    if(!stream)
+    {
+        throw Export_Failed_Exception();
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Writes the compiled network to the sink and flushes it
+ * \param network
+ * \param sink
+ * \param options
+ *************************************************************************************************/
+void Circlyzer::export_network(const Compiled_Network& network, Output_Sink& sink,
+                               const Export_Options& options)
+{
+    Collapsed collapsed;
+    if(options.collapse_series_parallel)
+    {
+        collapsed = collapse(network, options.frequency);
+    }
+
+    const auto is_hidden = [&](const uint32_t node)
+    {
+        return options.collapse_series_parallel && collapsed.hidden_nodes[node];
+    };
+
+    const auto is_grouped = [&](const uint32_t branch)
+    {
+        return options.collapse_series_parallel && collapsed.grouped_branches[branch];
+    };
+
+    const auto types = network.get_types();
+    const auto values = network.get_values();
+
+    Graph_Writer writer(sink, options.format);
+    writer.begin();
+
+    for(uint32_t node = 0U; node < network.get_number_of_nodes(); ++node)
+    {
+        if(!is_hidden(node))
+        {
+            writer.node(network.get_node_uid(node), network.get_node_alias(node));
+        }
+    }
+
+    const auto write_branch = [&](const uint32_t branch)
+    {
+        const auto uid = network.get_branch_uid(branch);
+        const auto terminals = network.get_terminals(branch);
+
+        if(network.is_connected(branch))
+        {
+            writer.branch(uid, network.get_branch_alias(branch), types[branch], values[branch],
+                          network.get_node_uid(terminals[0]), network.get_node_uid(terminals[1]));
+            return;
+        }
+
+        std::array<uint32_t, Compiled_Network::TERMINALS_PER_BRANCH> nodes{};
+        std::size_t number_of_nodes = 0U;
+        for(const auto terminal : terminals)
+        {
+            if(terminal != Compiled_Network::NO_NODE)
+            {
+                nodes[number_of_nodes++] = network.get_node_uid(terminal);
+            }
+        }
+
+        writer.dangling_branch(uid, network.get_branch_alias(branch), types[branch], values[branch],
+                               std::span<const uint32_t>(nodes.data(), number_of_nodes));
+    };
+
+    for(uint32_t branch = 0U; branch < network.get_number_of_branches(); ++branch)
+    {
+        if(!is_grouped(branch))
+        {
+            write_branch(branch);
+        }
+    }
+
+    for(const auto& group : collapsed.groups)
+    {
+        // A lone branch keeps its own identity
+        if(group.number_of_branches == 1U)
+        {
+            write_branch(group.representative);
+            continue;
+        }
+
+        writer.group(network.get_branch_uid(group.representative),
+                     network.get_node_uid(group.first), network.get_node_uid(group.second),
+                     group.impedance, group.number_of_branches);
+    }
+
+    writer.end();
+    sink.flush();
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and writes the result to the sink
+ * \param network
+ * \param sink
+ * \param options
+ *************************************************************************************************/
+void Circlyzer::export_network(const Network& network, Output_Sink& sink,
+                               const Export_Options& options)
+{
+    export_network(*network.compile(), sink, options);
+}
@@ -0,0 +1,433 @@
+#include "circlyzer/impedance_table.h"
+#include "circlyzer/compiled_network.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param network
+ * \param capacity Number of frequencies kept before the least recently used is evicted
+ *************************************************************************************************/
+Impedance_Table::Impedance_Table(const Network& network, const std::size_t capacity) :
+    Impedance_Table(*network.compile(), capacity)
+{
+    this->network = network.get_reference();
+}
+
+/**********************************************************************************************//**
+ * \brief Builds a table over a compiled view. The values are copied, so the view need not outlive
+ *        the table.
+ * \param network
+ * \param capacity Number of frequencies kept before the least recently used is evicted
+ *************************************************************************************************/
+Impedance_Table::Impedance_Table(const Compiled_Network& network, const std::size_t capacity) :
+    network(),
+    capacity{ std::max<std::size_t>(capacity, 1U) },
+    branch_uids(),
+    branch_indices(),
+    types(),
+    values(),
+    reciprocals(),
+    resistors(),
+    capacitors(),
+    inductors(),
+    sources(),
+    diodes(),
+    cache(),
+    synchronized_sequence{ 0U },
+    clock{ 0U },
+    number_of_evaluations{ 0U }
+{
+    snapshot(network);
+}
+
+/**********************************************************************************************//**
+ * \brief Returns every branch impedance at the provided frequency, computing only what the cache
+ *        can't provide
+ * \param frequency
+ *************************************************************************************************/
+const std::vector<std::complex<double>>& Impedance_Table::get_impedances(const double frequency)
+{
+    return look_up(frequency).values->impedances;
+}
+
+/**********************************************************************************************//**
+ * \brief Returns every branch admittance at the provided frequency, from the same cache entry as
+ *        the impedances
+ * \param frequency
+ *************************************************************************************************/
+const std::vector<std::complex<double>>& Impedance_Table::get_admittances(const double frequency)
+{
+    return look_up(frequency).values->admittances;
+}
+
+/**********************************************************************************************//**
+ * \brief Shares the frequency's entry, which the table will not change or reuse while it is held
+ * \param frequency
+ *************************************************************************************************/
+std::shared_ptr<const Branch_Impedances> Impedance_Table::get_values(const double frequency)
+{
+    return look_up(frequency).values;
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param branch_uid
+ * \param frequency
+ *************************************************************************************************/
+std::complex<double> Impedance_Table::get_impedance(const uint32_t branch_uid,
+                                                    const double frequency)
+{
+    const auto index = branch_indices.find(branch_uid);
+    if(index == branch_indices.end())
+    {
+        throw Non_Existant_UID_Exception();
+    }
+
+    return get_impedances(frequency)[index->second];
+}
+
+/**********************************************************************************************//**
+ * \brief Applies the journal entries recorded since the table was last synchronized. Only branch
+ *        creation, destruction and component updates matter here, connections don't change an
+ *        impedance.
+ *************************************************************************************************/
+void Impedance_Table::synchronize()
+{
+    const auto* followed = get_network();
+    if(followed == nullptr)
+    {
+        return;
+    }
+
+    const auto& journal = followed->get_journal();
+    if(journal.get_sequence() == synchronized_sequence)
+    {
+        return;
+    }
+
+    if(!journal.is_available(synchronized_sequence))
+    {
+        invalidate_all();
+        return;
+    }
+
+    for(const auto& change : journal.get_changes_since(synchronized_sequence))
+    {
+        if((change.type == Change_Type::Branch_Created) ||
+           (change.type == Change_Type::Branch_Destroyed))
+        {
+            invalidate_all();
+            return;
+        }
+
+        if(change.type == Change_Type::Component_Updated)
+        {
+            invalidate(change.uid);
+        }
+    }
+
+    synchronized_sequence = journal.get_sequence();
+}
+
+/**********************************************************************************************//**
+ * \brief Re-reads a single branch from the network. If the branch has been created or destroyed
+ *        since the table was built, the whole table is rebuilt instead. A table over a compiled
+ *        view has nothing to re-read and is left as it is.
+ * \param branch_uid
+ *************************************************************************************************/
+void Impedance_Table::invalidate(const uint32_t branch_uid)
+{
+    const auto* followed = get_network();
+    if(followed == nullptr)
+    {
+        return;
+    }
+
+    const auto index = branch_indices.find(branch_uid);
+    const auto number_of_branches = followed->get_number_of_branches();
+
+    if((index == branch_indices.end()) || (number_of_branches != branch_uids.size()))
+    {
+        invalidate_all();
+        return;
+    }
+
+    const auto& component = followed->get_component(branch_uid);
+    if(component.type != types[index->second])
+    {
+        // Moving between type groups is rare enough to just start over
+        invalidate_all();
+        return;
+    }
+
+    values[index->second] = get_component_value(component).real();
+    reciprocals[index->second] = 1.0 / values[index->second];
+    for(auto& [frequency, entry] : cache)
+    {
+        if(std::find(entry.dirty.begin(), entry.dirty.end(), index->second) == entry.dirty.end())
+        {
+            entry.dirty.emplace_back(index->second);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Drops every cached frequency and re-reads the network, if there is one to follow
+ *************************************************************************************************/
+void Impedance_Table::invalidate_all()
+{
+    cache.clear();
+
+    const auto* followed = get_network();
+    if(followed != nullptr)
+    {
+        snapshot(*followed->compile());
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for branch_uids
+ *************************************************************************************************/
+const std::vector<uint32_t>& Impedance_Table::get_branch_uids() const
+{
+    return branch_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of frequencies currently held
+ *************************************************************************************************/
+std::size_t Impedance_Table::get_number_of_cached_frequencies() const
+{
+    return cache.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_evaluations, the count of individual impedances computed so far
+ *************************************************************************************************/
+std::size_t Impedance_Table::get_number_of_evaluations() const
+{
+    return number_of_evaluations;
+}
+
+/**********************************************************************************************//**
+ * \brief The network the table follows, null if there is none or it has been destroyed
+ *************************************************************************************************/
+const Network* Impedance_Table::get_network() const
+{
+    return (network != nullptr) ? *network : nullptr;
+}
+
+/**********************************************************************************************//**
+ * \brief Finds or evaluates the cache entry for a frequency, evicting the least recently used
+ *        entry to make room
+ * \param frequency
+ *************************************************************************************************/
+Impedance_Table::Cached_Frequency& Impedance_Table::look_up(const double frequency)
+{
+    synchronize();
+    ++clock;
+
+    auto cached = cache.find(frequency);
+    if(cached != cache.end())
+    {
+        auto& entry = cached->second;
+        if(!entry.dirty.empty() && (entry.values.use_count() > 1))
+        {
+            // Someone still holds the old values, they keep them as they are
+            entry.values = std::make_shared<Branch_Impedances>(*entry.values);
+        }
+
+        for(const auto index : entry.dirty)
+        {
+            evaluate_entry(index, frequency, *entry.values);
+        }
+
+        entry.dirty.clear();
+        entry.last_used = clock;
+        return entry;
+    }
+
+    decltype(cache)::node_type node;
+    if(cache.size() >= capacity)
+    {
+        const auto oldest = std::min_element(cache.begin(), cache.end(),
+                                             [](const auto& left, const auto& right)
+                                             {
+                                                 return left.second.last_used <
+                                                        right.second.last_used;
+                                             });
+
+        // Reusing the evicted entry keeps a sweep from allocating at every frequency, unless its
+        // values are still held elsewhere
+        node = cache.extract(oldest);
+        node.key() = frequency;
+        node.mapped().dirty.clear();
+    }
+
+    auto& entry = node.empty() ? cache[frequency] : cache.insert(std::move(node)).position->second;
+    if(!entry.values || (entry.values.use_count() > 1))
+    {
+        entry.values = std::make_shared<Branch_Impedances>();
+    }
+
+    entry.last_used = clock;
+    evaluate(frequency, *entry.values);
+    return entry;
+}
+
+/**********************************************************************************************//**
+ * \brief Copies the compiled branches into the flat arrays
+ * \param compiled
+ *************************************************************************************************/
+void Impedance_Table::snapshot(const Compiled_Network& compiled)
+{
+    const auto compiled_types = compiled.get_types();
+    const auto compiled_values = compiled.get_values();
+
+    synchronized_sequence = compiled.get_sequence();
+    branch_uids = compiled.get_branch_uids();
+    branch_indices.clear();
+    types.assign(compiled_types.begin(), compiled_types.end());
+    values.resize(branch_uids.size());
+    reciprocals.resize(branch_uids.size());
+    resistors.clear();
+    capacitors.clear();
+    inductors.clear();
+    sources.clear();
+    diodes.clear();
+
+    for(std::size_t index = 0U; index < branch_uids.size(); ++index)
+    {
+        branch_indices.insert({ branch_uids[index], index });
+        values[index] = compiled_values[index].real();
+        reciprocals[index] = 1.0 / values[index];
+
+        switch(types[index])
+        {
+            case Component_Type::Resistor:
+                resistors.emplace_back(index);
+                break;
+
+            case Component_Type::Capacitor:
+                capacitors.emplace_back(index);
+                break;
+
+            case Component_Type::Inductor:
+                inductors.emplace_back(index);
+                break;
+
+            case Component_Type::Voltage_Source:
+                sources.emplace_back(index);
+                break;
+
+            case Component_Type::Diode:
+                diodes.emplace_back(index);
+                break;
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Evaluates every entry, one tight loop per component type. The closed forms multiply by
+ *        the reciprocals kept with the values, avoiding both the complex division done by
+ *        Capacitor::get_impedence and any division per entry.
+ * \param frequency
+ * \param entry
+ *************************************************************************************************/
+void Impedance_Table::evaluate(const double frequency, Branch_Impedances& entry)
+{
+    constexpr auto INFINITE = std::numeric_limits<double>::infinity();
+
+    // Every entry belongs to exactly one type group, so each is written once below
+    entry.impedances.resize(branch_uids.size());
+    entry.admittances.resize(branch_uids.size());
+
+    const auto period = 1.0 / frequency;
+    const auto* value = values.data();
+    const auto* reciprocal = reciprocals.data();
+    auto* impedance = entry.impedances.data();
+    auto* admittance = entry.admittances.data();
+
+    for(const auto index : resistors)
+    {
+        impedance[index] = { value[index], 0.0 };
+        admittance[index] = { reciprocal[index], 0.0 };
+    }
+
+    for(const auto index : capacitors)
+    {
+        impedance[index] = { 0.0, -period * reciprocal[index] };
+        admittance[index] = { 0.0, frequency * value[index] };
+    }
+
+    for(const auto index : inductors)
+    {
+        impedance[index] = { 0.0, frequency * value[index] };
+        admittance[index] = { 0.0, -period * reciprocal[index] };
+    }
+
+    for(const auto index : sources)
+    {
+        impedance[index] = 0.0;
+        admittance[index] = INFINITE;
+    }
+
+    for(const auto index : diodes)
+    {
+        impedance[index] = { INFINITE, 0.0 };
+        admittance[index] = 0.0;
+    }
+
+    number_of_evaluations += resistors.size() + capacitors.size() + inductors.size();
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param index
+ * \param frequency
+ * \param entry
+ *************************************************************************************************/
+void Impedance_Table::evaluate_entry(const std::size_t index, const double frequency,
+                                     Branch_Impedances& entry)
+{
+    constexpr auto INFINITE = std::numeric_limits<double>::infinity();
+
+    ++number_of_evaluations;
+
+    auto& impedance = entry.impedances[index];
+    auto& admittance = entry.admittances[index];
+    const auto period = 1.0 / frequency;
+
+    switch(types[index])
+    {
+        case Component_Type::Resistor:
+            impedance = { values[index], 0.0 };
+            admittance = { reciprocals[index], 0.0 };
+            break;
+
+        case Component_Type::Capacitor:
+            impedance = { 0.0, -period * reciprocals[index] };
+            admittance = { 0.0, frequency * values[index] };
+            break;
+
+        case Component_Type::Inductor:
+            impedance = { 0.0, frequency * values[index] };
+            admittance = { 0.0, -period * reciprocals[index] };
+            break;
+
+        case Component_Type::Voltage_Source:
+            impedance = 0.0;
+            admittance = INFINITE;
+            break;
+
+        case Component_Type::Diode:
+            impedance = { INFINITE, 0.0 };
+            admittance = 0.0;
+            break;
+    }
+}
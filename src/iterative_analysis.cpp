@@ -0,0 +1,605 @@
+#include "circlyzer/iterative_analysis.h"
+#include "circlyzer/exceptions.h"
+
+#include <limits>
+#include <memory>
+
+using namespace Circlyzer;
+using namespace std::complex_literals;
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    constexpr auto ELIMINATED = Nodal_Analysis::GROUND_INDEX;
+
+    /**
+     * \brief Whether the element ties its terminal voltages together at this frequency
+     */
+    bool is_tie(const Nodal_Element& element, const double frequency)
+    {
+        return (element.type == Component_Type::Voltage_Source) ||
+               ((element.type == Component_Type::Inductor) && (frequency == 0.0));
+    }
+
+    /**
+     * \brief Admittance of an element that is not a tie, zero for an open capacitor at DC
+     */
+    Complex admittance_of(const Nodal_Element& element, const double frequency)
+    {
+        switch(element.type)
+        {
+            case Component_Type::Resistor:  return 1.0 / element.value;
+            case Component_Type::Capacitor: return 1.0i * frequency * element.value;
+            default:                        return 1.0 / (1.0i * frequency * element.value);
+        }
+    }
+
+    /**********************************************************************************************
+     * \brief Groups of nodes tied together by voltage sources, found with a union-find that tracks
+     *        each node's voltage relative to its parent. The ground is given the index after the
+     *        last node and is always kept as the root of its own group.
+     **********************************************************************************************/
+    class Supernodes
+    {
+    public:
+        Supernodes(const Nodal_Analysis& analysis, const double frequency) :
+            ground{ analysis.get_node_uids().size() },
+            parents(ground + 1U),
+            offsets(ground + 1U, 0.0),
+            reduced_index(ground + 1U, ELIMINATED),
+            path(),
+            size{ 0U }
+        {
+            for(std::size_t node = 0U; node <= ground; ++node)
+            {
+                parents[node] = node;
+            }
+
+            for(const auto& element : analysis.get_elements())
+            {
+                if(is_tie(element, frequency))
+                {
+                    const auto value = (element.type == Component_Type::Voltage_Source) ?
+                        element.value : Complex{ 0.0 };
+                    tie(index_of(element.first), index_of(element.second), value);
+                }
+            }
+
+            // Flatten so every node refers straight to its root
+            for(std::size_t node = 0U; node <= ground; ++node)
+            {
+                find(node);
+            }
+
+            number_groups(analysis, frequency);
+
+            for(std::size_t node = 0U; node < ground; ++node)
+            {
+                reduced_index[node] = reduced_index[parents[node]];
+            }
+        }
+
+        std::size_t index_of(const std::size_t analysis_index) const
+        {
+            return (analysis_index == ELIMINATED) ? ground : analysis_index;
+        }
+
+        /**
+         * \brief Unknown of the node's group, or ELIMINATED when it is tied to the ground
+         */
+        std::size_t get_reduced_index(const std::size_t node) const
+        {
+            return reduced_index[node];
+        }
+
+        /**
+         * \brief Node voltage less its group's unknown, which is the whole voltage when the group
+         *        is tied to the ground
+         */
+        const Complex& get_offset(const std::size_t node) const
+        {
+            return offsets[node];
+        }
+
+        std::size_t get_size() const
+        {
+            return size;
+        }
+
+    private:
+        /**
+         * \brief Root of the node's group. Compresses the path on the way, adding up the offsets
+         *        so every node on it ends up relative to the root. Iterative, as the chains of a
+         *        long source ladder would overflow the stack.
+         */
+        std::size_t find(const std::size_t node)
+        {
+            path.clear();
+            auto root = node;
+            while(parents[root] != root)
+            {
+                path.push_back(root);
+                root = parents[root];
+            }
+
+            for(auto position = path.size(); position-- > 0U;)
+            {
+                const auto current = path[position];
+                const auto parent = parents[current];
+                if(parent != root)
+                {
+                    offsets[current] += offsets[parent];
+                }
+
+                parents[current] = root;
+            }
+
+            return root;
+        }
+
+        /**
+         * \brief Numbers the groups in reverse breadth first order from the ground, so the
+         *        furthest groups come first. Eliminating in that order leaves each group with at
+         *        most its nearer neighbours, which keeps the fill the incomplete factorization
+         *        drops small, and there is none at all when the admittances form a tree.
+         */
+        void number_groups(const Nodal_Analysis& analysis, const double frequency)
+        {
+            const auto& elements = analysis.get_elements();
+            const auto is_edge = [&](const Nodal_Element& element)
+            {
+                return !is_tie(element, frequency) && (admittance_of(element, frequency) != 0.0) &&
+                       (parents[index_of(element.first)] != parents[index_of(element.second)]);
+            };
+
+            std::vector<std::size_t> edge_offsets(ground + 2U, 0U);
+            for(const auto& element : elements)
+            {
+                if(is_edge(element))
+                {
+                    ++edge_offsets[parents[index_of(element.first)] + 1U];
+                    ++edge_offsets[parents[index_of(element.second)] + 1U];
+                }
+            }
+
+            for(std::size_t node = 0U; node <= ground; ++node)
+            {
+                edge_offsets[node + 1U] += edge_offsets[node];
+            }
+
+            std::vector<std::size_t> edges(edge_offsets.back());
+            std::vector<std::size_t> cursor(edge_offsets.begin(), edge_offsets.end() - 1);
+            for(const auto& element : elements)
+            {
+                if(is_edge(element))
+                {
+                    const auto a = parents[index_of(element.first)];
+                    const auto b = parents[index_of(element.second)];
+                    edges[cursor[a]++] = b;
+                    edges[cursor[b]++] = a;
+                }
+            }
+
+            std::vector<std::size_t> order;
+            std::vector<bool> visited(ground + 1U, false);
+            order.reserve(ground + 1U);
+
+            for(std::size_t offset = 0U; offset <= ground; ++offset)
+            {
+                const auto start = (ground + offset) % (ground + 1U);
+                if(visited[start] || (parents[start] != start))
+                {
+                    continue;
+                }
+
+                visited[start] = true;
+                order.push_back(start);
+
+                for(auto position = order.size() - 1U; position < order.size(); ++position)
+                {
+                    const auto group = order[position];
+                    for(auto index = edge_offsets[group]; index < edge_offsets[group + 1U]; ++index)
+                    {
+                        if(!visited[edges[index]])
+                        {
+                            visited[edges[index]] = true;
+                            order.push_back(edges[index]);
+                        }
+                    }
+                }
+            }
+
+            size = order.size() - 1U;
+            for(std::size_t position = 1U; position < order.size(); ++position)
+            {
+                reduced_index[order[position]] = order.size() - 1U - position;
+            }
+        }
+
+        /**
+         * \brief Records v(first) - v(second) = value
+         */
+        void tie(const std::size_t first, const std::size_t second, const Complex& value)
+        {
+            const auto first_root = find(first);
+            const auto second_root = find(second);
+
+            if(first_root == second_root)
+            {
+                throw Singular_Matrix_Exception();
+            }
+
+            // v(first_root) - v(second_root) follows from the two paths to the roots
+            const auto difference = value - offsets[first] + offsets[second];
+            if(first_root == ground)
+            {
+                parents[second_root] = first_root;
+                offsets[second_root] = -difference;
+            }
+            else
+            {
+                parents[first_root] = second_root;
+                offsets[first_root] = difference;
+            }
+        }
+
+        std::size_t ground;
+        std::vector<std::size_t> parents;
+        std::vector<Complex> offsets;
+        std::vector<std::size_t> reduced_index;
+        std::vector<std::size_t> path;
+        std::size_t size;
+    };
+
+    /**
+     * \brief Calls stamp(row, column, value) for the admittance matrix and excite(row, value) for
+     *        the current the known offsets drive into each summed KCL equation
+     */
+    template<typename Stamp, typename Excite>
+    void assemble(const Nodal_Analysis& analysis, const Supernodes& supernodes,
+                  const double frequency, Stamp&& stamp, Excite&& excite)
+    {
+        for(const auto& element : analysis.get_elements())
+        {
+            if(is_tie(element, frequency))
+            {
+                continue;
+            }
+
+            const auto admittance = admittance_of(element, frequency);
+            const auto a = supernodes.index_of(element.first);
+            const auto b = supernodes.index_of(element.second);
+            const auto row_a = supernodes.get_reduced_index(a);
+            const auto row_b = supernodes.get_reduced_index(b);
+
+            if((row_a == row_b) || (admittance == 0.0))
+            {
+                // Inside one group the branch current leaves one node and enters another
+                continue;
+            }
+
+            const auto known = admittance * (supernodes.get_offset(a) - supernodes.get_offset(b));
+            if(row_a != ELIMINATED)
+            {
+                stamp(row_a, row_a, admittance);
+                excite(row_a, -known);
+            }
+
+            if(row_b != ELIMINATED)
+            {
+                stamp(row_b, row_b, admittance);
+                excite(row_b, known);
+            }
+
+            if((row_a != ELIMINATED) && (row_b != ELIMINATED))
+            {
+                stamp(row_a, row_b, -admittance);
+                stamp(row_b, row_a, -admittance);
+            }
+        }
+    }
+
+    Sparse_Matrix<Complex> assemble_matrix(const Nodal_Analysis& analysis, const Supernodes& supernodes,
+                                           const double frequency)
+    {
+        std::vector<Sparse_Matrix<Complex>::Entry> entries;
+        entries.reserve(supernodes.get_size() + (4U * analysis.get_elements().size()));
+
+        for(std::size_t index = 0U; index < supernodes.get_size(); ++index)
+        {
+            entries.push_back({ index, index, 0.0 });
+        }
+
+        assemble(analysis, supernodes, frequency,
+                 [&](const std::size_t row, const std::size_t column, const Complex& value)
+                 {
+                     entries.push_back({ row, column, value });
+                 },
+                 [](const std::size_t, const Complex&) {});
+
+        return Sparse_Matrix<Complex>(supernodes.get_size(), supernodes.get_size(), std::move(entries));
+    }
+
+    std::vector<Complex> assemble_excitation(const Nodal_Analysis& analysis, const Supernodes& supernodes,
+                                             const double frequency)
+    {
+        std::vector<Complex> excitation(supernodes.get_size(), 0.0);
+
+        assemble(analysis, supernodes, frequency,
+                 [](const std::size_t, const std::size_t, const Complex&) {},
+                 [&](const std::size_t row, const Complex& value)
+                 {
+                     excitation[row] += value;
+                 });
+
+        return excitation;
+    }
+
+    /**
+     * \brief Rebuilds the full unknown vector in Nodal_Analysis order. Admittance currents follow
+     *        from the voltages. The ties form a forest, so walking each tree from its leaves the
+     *        tie into a node carries whatever current the node and everything beyond it would
+     *        otherwise leave unbalanced.
+     */
+    std::vector<Complex> expand(const Nodal_Analysis& analysis, const Supernodes& supernodes,
+                                const std::vector<Complex>& reduced, const double frequency)
+    {
+        const auto& elements = analysis.get_elements();
+        const auto number_of_nodes = analysis.get_node_uids().size();
+        const auto ground = number_of_nodes;
+
+        std::vector<Complex> unknowns(analysis.get_system_size(), 0.0);
+        std::vector<Complex> voltages(number_of_nodes + 1U, 0.0);
+        for(std::size_t node = 0U; node < number_of_nodes; ++node)
+        {
+            const auto row = supernodes.get_reduced_index(node);
+            voltages[node] = supernodes.get_offset(node) + ((row == ELIMINATED) ? 0.0 : reduced[row]);
+            unknowns[node] = voltages[node];
+        }
+
+        // Current each node pushes out through admittances, then the tie adjacency as flat lists
+        std::vector<Complex> imbalance(number_of_nodes + 1U, 0.0);
+        std::vector<std::size_t> tie_offsets(number_of_nodes + 2U, 0U);
+        for(const auto& element : elements)
+        {
+            const auto a = supernodes.index_of(element.first);
+            const auto b = supernodes.index_of(element.second);
+
+            if(is_tie(element, frequency))
+            {
+                ++tie_offsets[a + 1U];
+                ++tie_offsets[b + 1U];
+                continue;
+            }
+
+            const auto current = admittance_of(element, frequency) * (voltages[a] - voltages[b]);
+            imbalance[a] += current;
+            imbalance[b] -= current;
+
+            if(element.current_index != ELIMINATED)
+            {
+                unknowns[element.current_index] = current;
+            }
+        }
+
+        for(std::size_t node = 0U; node <= number_of_nodes; ++node)
+        {
+            tie_offsets[node + 1U] += tie_offsets[node];
+        }
+
+        std::vector<std::size_t> ties(tie_offsets.back());
+        std::vector<std::size_t> cursor(tie_offsets.begin(), tie_offsets.end() - 1);
+        for(std::size_t index = 0U; index < elements.size(); ++index)
+        {
+            if(is_tie(elements[index], frequency))
+            {
+                ties[cursor[supernodes.index_of(elements[index].first)]++] = index;
+                ties[cursor[supernodes.index_of(elements[index].second)]++] = index;
+            }
+        }
+
+        // Breadth first from the ground and then from every other untouched node
+        constexpr auto NO_TIE = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> order;
+        std::vector<std::size_t> via(number_of_nodes + 1U, NO_TIE);
+        std::vector<bool> visited(number_of_nodes + 1U, false);
+        order.reserve(number_of_nodes + 1U);
+
+        for(std::size_t offset = 0U; offset <= number_of_nodes; ++offset)
+        {
+            const auto start = (ground + offset) % (number_of_nodes + 1U);
+            if(visited[start])
+            {
+                continue;
+            }
+
+            visited[start] = true;
+            order.push_back(start);
+
+            for(auto position = order.size() - 1U; position < order.size(); ++position)
+            {
+                const auto node = order[position];
+                for(auto index = tie_offsets[node]; index < tie_offsets[node + 1U]; ++index)
+                {
+                    const auto& element = elements[ties[index]];
+                    const auto a = supernodes.index_of(element.first);
+                    const auto other = (a == node) ? supernodes.index_of(element.second) : a;
+
+                    if(!visited[other])
+                    {
+                        visited[other] = true;
+                        via[other] = ties[index];
+                        order.push_back(other);
+                    }
+                }
+            }
+        }
+
+        for(auto position = order.size(); position-- > 0U;)
+        {
+            const auto node = order[position];
+            if(via[node] == NO_TIE)
+            {
+                continue;
+            }
+
+            // The branch current flows from first to second, so it leaves first and enters second
+            const auto& element = elements[via[node]];
+            const auto is_first = (supernodes.index_of(element.first) == node);
+            const auto parent = is_first ? supernodes.index_of(element.second) :
+                                           supernodes.index_of(element.first);
+
+            unknowns[element.current_index] = is_first ? -imbalance[node] : imbalance[node];
+            imbalance[parent] += imbalance[node];
+        }
+
+        return unknowns;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Captures the network, the supernodes are found per solve as inductors only tie nodes at
+ *        DC
+ * \param network
+ * \param ground_uid
+ * \param options
+ *************************************************************************************************/
+Iterative_Analysis::Iterative_Analysis(const Compiled_Network& network, const uint32_t ground_uid,
+                                       const Iterative_Options& options) :
+    analysis(network, ground_uid),
+    options(options)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and analyses the result
+ * \param network
+ * \param ground_uid
+ * \param options
+ *************************************************************************************************/
+Iterative_Analysis::Iterative_Analysis(const Network& network, const uint32_t ground_uid,
+                                       const Iterative_Options& options) :
+    Iterative_Analysis(*network.compile(), ground_uid, options)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Assembles the reduced system, picks the solver and preconditioner and maps the answer
+ *        back onto the full set of unknowns
+ * \param frequency
+ *************************************************************************************************/
+Iterative_Result Iterative_Analysis::solve(const double frequency) const
+{
+    const Supernodes supernodes(analysis, frequency);
+    const auto matrix = assemble_matrix(analysis, supernodes, frequency);
+    const auto excitation = assemble_excitation(analysis, supernodes, frequency);
+
+    auto method = options.method;
+    if(method == Iterative_Method::Automatic)
+    {
+        method = (frequency == 0.0) ? Iterative_Method::Conjugate_Gradient : Iterative_Method::BiCGSTAB;
+    }
+
+    std::unique_ptr<Preconditioner<Complex>> preconditioner;
+    switch(options.preconditioner)
+    {
+        case Preconditioner_Type::Jacobi:
+            preconditioner = std::make_unique<Jacobi_Preconditioner<Complex>>(matrix);
+            break;
+
+        case Preconditioner_Type::Incomplete_Factorization:
+            preconditioner = std::make_unique<Incomplete_LU_Preconditioner<Complex>>(matrix);
+            break;
+
+        default:
+            preconditioner = std::make_unique<Identity_Preconditioner<Complex>>();
+            break;
+    }
+
+    auto& executor = (options.executor != nullptr) ? *options.executor : Executor::get_shared();
+    const auto parallel = (supernodes.get_size() >= options.parallel_threshold);
+    const auto multiply = [&](const std::vector<Complex>& vector, std::vector<Complex>& result)
+    {
+        if(parallel)
+        {
+            matrix.multiply(vector, result, executor);
+        }
+        else
+        {
+            matrix.multiply(vector, result);
+        }
+    };
+
+    std::vector<Complex> unknowns(supernodes.get_size(), 0.0);
+    Krylov_Result outcome;
+    switch(method)
+    {
+        case Iterative_Method::Conjugate_Gradient:
+            outcome = conjugate_gradient(multiply, excitation, unknowns, *preconditioner,
+                                         options.krylov);
+            break;
+
+        case Iterative_Method::GMRES:
+            outcome = gmres(multiply, excitation, unknowns, *preconditioner, options.krylov);
+            break;
+
+        default:
+            outcome = bicgstab(multiply, excitation, unknowns, *preconditioner, options.krylov);
+            break;
+    }
+
+    return { analysis.interpret(expand(analysis, supernodes, unknowns, frequency), frequency),
+             method,
+             outcome.iterations,
+             outcome.relative_residual,
+             outcome.converged };
+}
+
+/**********************************************************************************************//**
+ * \brief The nodal admittance matrix over the supernodes. Every diagonal entry is kept in the
+ *        pattern for the preconditioners.
+ * \param frequency
+ *************************************************************************************************/
+Sparse_Matrix<std::complex<double>>
+Iterative_Analysis::assemble_reduced_matrix(const double frequency) const
+{
+    return assemble_matrix(analysis, Supernodes(analysis, frequency), frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief The current the sources drive into each supernode through the admittances around it
+ * \param frequency
+ *************************************************************************************************/
+std::vector<std::complex<double>>
+Iterative_Analysis::assemble_reduced_excitation(const double frequency) const
+{
+    return assemble_excitation(analysis, Supernodes(analysis, frequency), frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief Number of supernodes not tied to the ground, the unknowns of the reduced system
+ * \param frequency
+ *************************************************************************************************/
+std::size_t Iterative_Analysis::get_reduced_size(const double frequency) const
+{
+    return Supernodes(analysis, frequency).get_size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the underlying nodal analysis
+ *************************************************************************************************/
+const Nodal_Analysis& Iterative_Analysis::get_nodal_analysis() const
+{
+    return analysis;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for options
+ *************************************************************************************************/
+const Iterative_Options& Iterative_Analysis::get_options() const
+{
+    return options;
+}
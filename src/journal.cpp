@@ -0,0 +1,158 @@
+#include "circlyzer/journal.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+Journal::Journal() :
+    changes(),
+    oldest_sequence{ 0U }
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Appends a change. Called by the Network mutators once a mutation has succeeded.
+ * \param type
+ * \param uid
+ * \param other_uid
+ *************************************************************************************************/
+void Journal::record(const Change_Type type, const uint32_t uid, const uint32_t other_uid)
+{
+    changes.push_back({ type, uid, other_uid });
+}
+
+/**********************************************************************************************//**
+ * \brief Sequence number the next change will receive. Consumers store this after rebuilding.
+ *************************************************************************************************/
+uint64_t Journal::get_sequence() const
+{
+    return oldest_sequence + changes.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for oldest_sequence, the oldest change still retained
+ *************************************************************************************************/
+uint64_t Journal::get_oldest_sequence() const
+{
+    return oldest_sequence;
+}
+
+/**********************************************************************************************//**
+ * \brief Number of changes held in memory
+ *************************************************************************************************/
+std::size_t Journal::get_number_of_retained_changes() const
+{
+    return changes.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Whether every change from since onwards is still retained
+ * \param since
+ *************************************************************************************************/
+bool Journal::is_available(const uint64_t since) const
+{
+    return (since >= oldest_sequence) && (since <= get_sequence());
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param since
+ *************************************************************************************************/
+std::vector<Change> Journal::get_changes_since(const uint64_t since) const
+{
+    if(!is_available(since))
+    {
+        throw Compacted_Journal_Exception();
+    }
+
+    return std::vector<Change>(changes.begin() + (since - oldest_sequence), changes.end());
+}
+
+/**********************************************************************************************//**
+ * \brief Folds the changes since a sequence number into the set of entities they touched
+ * \param since
+ *************************************************************************************************/
+Dirty_Region Journal::get_dirty_region(const uint64_t since) const
+{
+    if(!is_available(since))
+    {
+        throw Compacted_Journal_Exception();
+    }
+
+    Dirty_Region region;
+    for(auto it = changes.begin() + (since - oldest_sequence); it != changes.end(); ++it)
+    {
+        switch(it->type)
+        {
+            case Change_Type::Node_Created:
+            case Change_Type::Node_Destroyed:
+                region.nodes.insert(it->uid);
+                region.topology_changed = true;
+                break;
+
+            case Change_Type::Branch_Created:
+            case Change_Type::Branch_Destroyed:
+                region.branches.insert(it->uid);
+                region.topology_changed = true;
+                break;
+
+            case Change_Type::Connection_Created:
+            case Change_Type::Connection_Deleted:
+                region.nodes.insert(it->uid);
+                region.branches.insert(it->other_uid);
+                region.topology_changed = true;
+                break;
+
+            case Change_Type::Alias_Updated:
+                region.aliases_changed = true;
+                break;
+
+            case Change_Type::Component_Updated:
+                region.branches.insert(it->uid);
+                region.values_changed = true;
+                break;
+        }
+    }
+
+    return region;
+}
+
+/**********************************************************************************************//**
+ * \brief Drops every change older than up_to. Pass the smallest sequence any consumer still
+ *        needs; passing get_sequence() empties the journal.
+ * \param up_to
+ *************************************************************************************************/
+void Journal::compact(const uint64_t up_to)
+{
+    const auto limit = std::min(up_to, get_sequence());
+    if(limit <= oldest_sequence)
+    {
+        return;
+    }
+
+    changes.erase(changes.begin(), changes.begin() + (limit - oldest_sequence));
+    oldest_sequence = limit;
+
+    // Long sessions would otherwise keep the high water mark allocated forever
+    if(changes.capacity() > (4U * (changes.size() + 1U)))
+    {
+        changes.shrink_to_fit();
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Drops every change and moves the sequence past them, so no sequence handed out so far is
+ *        available any more. Used when the UIDs themselves change, which the changes can't
+ *        describe: every consumer has to rebuild.
+ *************************************************************************************************/
+void Journal::restart()
+{
+    oldest_sequence = get_sequence() + 1U;
+    changes.clear();
+    changes.shrink_to_fit();
+}
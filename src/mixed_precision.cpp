@@ -0,0 +1,143 @@
+#include "circlyzer/mixed_precision.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Circlyzer;
+
+namespace
+{
+    using Double_Vector = std::vector<std::complex<double>>;
+    using Float_Vector = std::vector<std::complex<float>>;
+
+    Float_Vector to_float(const Double_Vector& vector)
+    {
+        Float_Vector result(vector.size());
+        std::transform(vector.begin(), vector.end(), result.begin(),
+                       [](const std::complex<double>& value)
+                       {
+                           return static_cast<std::complex<float>>(value);
+                       });
+
+        return result;
+    }
+
+    double infinity_norm(const Double_Vector& vector)
+    {
+        auto norm = 0.0;
+        for(const auto& value : vector)
+        {
+            norm = std::max(norm, std::abs(value));
+        }
+
+        return norm;
+    }
+
+    double infinity_norm(const Dense_Matrix<std::complex<double>>& matrix)
+    {
+        auto norm = 0.0;
+        for(std::size_t row = 0U; row < matrix.get_number_of_rows(); ++row)
+        {
+            auto row_sum = 0.0;
+            for(std::size_t column = 0U; column < matrix.get_number_of_columns(); ++column)
+            {
+                row_sum += std::abs(matrix(row, column));
+            }
+
+            norm = std::max(norm, row_sum);
+        }
+
+        return norm;
+    }
+
+    /**
+     * \brief Normwise backward error ||b - Ax|| / (||A|| ||x|| + ||b||), leaving the residual behind
+     */
+    double backward_error(const Dense_Matrix<std::complex<double>>& matrix, const Double_Vector& rhs,
+                          const Double_Vector& solution, Double_Vector& residual)
+    {
+        residual = matrix.multiply(solution);
+        for(std::size_t index = 0U; index < residual.size(); ++index)
+        {
+            residual[index] = rhs[index] - residual[index];
+        }
+
+        const auto scale = (infinity_norm(matrix) * infinity_norm(solution)) + infinity_norm(rhs);
+        return (scale > 0.0) ? (infinity_norm(residual) / scale) : 0.0;
+    }
+
+    Refinement_Result solve_in_double(const Dense_Matrix<std::complex<double>>& matrix,
+                                      const Double_Vector& rhs, const uint32_t iterations)
+    {
+        Refinement_Result result;
+        result.solution = LU_Factorization<std::complex<double>>(matrix).solve(rhs);
+        result.iterations = iterations;
+        result.used_fallback = true;
+
+        Double_Vector residual;
+        result.backward_error = backward_error(matrix, rhs, result.solution, residual);
+        return result;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param matrix
+ * \param rhs
+ * \param options
+ *************************************************************************************************/
+Refinement_Result Circlyzer::solve_mixed_precision(const Dense_Matrix<std::complex<double>>& matrix,
+                                                   const std::vector<std::complex<double>>& rhs,
+                                                   const Refinement_Options& options)
+{
+    LU_Factorization<std::complex<float>> factorization;
+    try
+    {
+        factorization = LU_Factorization<std::complex<float>>(matrix.cast<std::complex<float>>());
+    }
+    catch(const Singular_Matrix_Exception&)
+    {
+        // Entries may have underflowed in float, so the double system still deserves a chance
+        return solve_in_double(matrix, rhs, 0U);
+    }
+
+    Refinement_Result result;
+    const auto initial = factorization.solve(to_float(rhs));
+    result.solution.assign(initial.begin(), initial.end());
+
+    Double_Vector residual;
+    auto previous_error = std::numeric_limits<double>::infinity();
+    for(uint32_t iteration = 0U; ; ++iteration)
+    {
+        // Residual in double precision, this is what lets the float factors reach double accuracy
+        const auto error = backward_error(matrix, rhs, result.solution, residual);
+        if(!std::isfinite(error))
+        {
+            return solve_in_double(matrix, rhs, iteration);
+        }
+
+        result.backward_error = error;
+        result.iterations = iteration;
+        if(error <= options.tolerance)
+        {
+            return result;
+        }
+
+        // Ill-conditioned systems stop improving long before the tolerance is reached
+        const auto stalled = (error > (options.stall_ratio * previous_error));
+        if(stalled || (iteration == options.maximum_iterations))
+        {
+            return solve_in_double(matrix, rhs, iteration);
+        }
+
+        const auto correction = factorization.solve(to_float(residual));
+        for(std::size_t index = 0U; index < correction.size(); ++index)
+        {
+            result.solution[index] += static_cast<std::complex<double>>(correction[index]);
+        }
+
+        previous_error = error;
+    }
+}
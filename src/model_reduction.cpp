@@ -0,0 +1,473 @@
+#include "circlyzer/model_reduction.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace Circlyzer;
+
+namespace
+{
+    // A new direction is dropped when orthogonalization leaves less than this share of it
+    constexpr auto DEFLATION_TOLERANCE = 1e-10;
+
+    using Column = std::vector<double>;
+
+    double dot(const Column& first, const Column& second)
+    {
+        return std::inner_product(first.begin(), first.end(), second.begin(), 0.0);
+    }
+
+    double frobenius_norm(const Dense_Matrix<std::complex<double>>& matrix)
+    {
+        double sum = 0.0;
+        const auto count = matrix.get_number_of_rows() * matrix.get_number_of_columns();
+        for(std::size_t index = 0U; index < count; ++index)
+        {
+            sum += std::norm(matrix.data()[index]);
+        }
+
+        return std::sqrt(sum);
+    }
+
+    /**
+     * \brief The network in PRIMA form. Inductor and voltage source current rows are negated
+     *        relative to Nodal_Analysis, so G + G^T and C are positive semi-definite.
+     */
+    struct Descriptor_System
+    {
+        Sparse_Matrix<double> conductance;
+        Sparse_Matrix<double> capacitance;
+        std::vector<std::size_t> port_indices;
+    };
+
+    Descriptor_System assemble(const Nodal_Analysis& analysis, const std::vector<uint32_t>& port_uids)
+    {
+        using Entry = Sparse_Matrix<double>::Entry;
+
+        const auto size = analysis.get_system_size();
+        std::vector<Entry> g;
+        std::vector<Entry> c;
+
+        const auto stamp = [](std::vector<Entry>& entries, const std::size_t a, const std::size_t b,
+                              const double value)
+        {
+            constexpr auto GROUND = Nodal_Analysis::GROUND_INDEX;
+            if(a != GROUND) { entries.push_back({ a, a, value }); }
+            if(b != GROUND) { entries.push_back({ b, b, value }); }
+            if((a != GROUND) && (b != GROUND))
+            {
+                entries.push_back({ a, b, -value });
+                entries.push_back({ b, a, -value });
+            }
+        };
+
+        for(const auto& element : analysis.get_elements())
+        {
+            const auto a = element.first;
+            const auto b = element.second;
+            const auto value = element.value.real();
+
+            switch(element.type)
+            {
+                case Component_Type::Resistor:
+                    stamp(g, a, b, 1.0 / value);
+                    break;
+
+                case Component_Type::Capacitor:
+                    stamp(c, a, b, value);
+                    break;
+
+                default:
+                {
+                    // Voltage sources are zeroed, leaving an inductor of zero inductance
+                    const auto k = element.current_index;
+                    if(a != Nodal_Analysis::GROUND_INDEX)
+                    {
+                        g.push_back({ a, k, 1.0 });
+                        g.push_back({ k, a, -1.0 });
+                    }
+
+                    if(b != Nodal_Analysis::GROUND_INDEX)
+                    {
+                        g.push_back({ b, k, -1.0 });
+                        g.push_back({ k, b, 1.0 });
+                    }
+
+                    if(element.type == Component_Type::Inductor)
+                    {
+                        c.push_back({ k, k, value });
+                    }
+                    break;
+                }
+            }
+        }
+
+        Descriptor_System system{ Sparse_Matrix<double>(size, size, std::move(g)),
+                                  Sparse_Matrix<double>(size, size, std::move(c)), {} };
+
+        const auto& node_uids = analysis.get_node_uids();
+        for(const auto uid : port_uids)
+        {
+            if(uid == analysis.get_ground_uid())
+            {
+                throw Invalid_Port_Exception();
+            }
+
+            const auto found = std::lower_bound(node_uids.begin(), node_uids.end(), uid);
+            if((found == node_uids.end()) || (*found != uid))
+            {
+                throw Non_Existant_UID_Exception();
+            }
+
+            const auto index = static_cast<std::size_t>(found - node_uids.begin());
+            if(std::find(system.port_indices.begin(), system.port_indices.end(), index) !=
+               system.port_indices.end())
+            {
+                throw Invalid_Port_Exception();
+            }
+
+            system.port_indices.emplace_back(index);
+        }
+
+        if(system.port_indices.empty())
+        {
+            throw Invalid_Port_Exception();
+        }
+
+        return system;
+    }
+
+    /**
+     * \brief Orthogonalizes a candidate against the basis twice (modified Gram-Schmidt with
+     *        reorthogonalization) and appends it unless it has deflated
+     */
+    bool append_orthonormal(std::vector<Column>& basis, Column candidate)
+    {
+        const auto original_norm = std::sqrt(dot(candidate, candidate));
+        if(!(original_norm > 0.0))
+        {
+            return false;
+        }
+
+        for(auto pass = 0U; pass < 2U; ++pass)
+        {
+            for(const auto& column : basis)
+            {
+                const auto projection = dot(column, candidate);
+                for(std::size_t row = 0U; row < candidate.size(); ++row)
+                {
+                    candidate[row] -= projection * column[row];
+                }
+            }
+        }
+
+        const auto norm = std::sqrt(dot(candidate, candidate));
+        if(norm <= (DEFLATION_TOLERANCE * original_norm))
+        {
+            return false;
+        }
+
+        for(auto& value : candidate)
+        {
+            value /= norm;
+        }
+
+        basis.emplace_back(std::move(candidate));
+        return true;
+    }
+
+    Dense_Matrix<double> project(const std::vector<Column>& basis, const Sparse_Matrix<double>& matrix)
+    {
+        Dense_Matrix<double> projected(basis.size(), basis.size());
+        for(std::size_t column = 0U; column < basis.size(); ++column)
+        {
+            const auto product = matrix.multiply(basis[column]);
+            for(std::size_t row = 0U; row < basis.size(); ++row)
+            {
+                projected(row, column) = dot(basis[row], product);
+            }
+        }
+
+        return projected;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Builds the reduced model with block Arnoldi
+ * \param network
+ * \param ground_uid
+ * \param port_uids
+ * \param options
+ *************************************************************************************************/
+Reduced_Model::Reduced_Model(const Compiled_Network& network, const uint32_t ground_uid,
+                             const std::vector<uint32_t>& port_uids,
+                             const Model_Reduction_Options& options) :
+    port_uids(port_uids),
+    original_size{ 0U },
+    block_ends(),
+    conductance(),
+    capacitance(),
+    input()
+{
+    const Nodal_Analysis analysis(network, ground_uid);
+    const auto system = assemble(analysis, port_uids);
+    original_size = analysis.get_system_size();
+
+    // (G + s0 C) is factorized once, sparsely, and reused for every block
+    std::vector<Sparse_Matrix<double>::Entry> shifted;
+    shifted.reserve(system.conductance.get_number_of_nonzeros() + system.capacitance.get_number_of_nonzeros());
+    for(const auto* matrix : { &system.conductance, &system.capacitance })
+    {
+        const auto scale = (matrix == &system.conductance) ? 1.0 : options.expansion_point;
+        const auto& offsets = matrix->get_row_offsets();
+        for(std::size_t row = 0U; row < original_size; ++row)
+        {
+            for(auto index = offsets[row]; index < offsets[row + 1U]; ++index)
+            {
+                shifted.push_back({ row, matrix->get_column_indices()[index], scale * matrix->get_values()[index] });
+            }
+        }
+    }
+    const Sparse_LU_Factorization<double> factorization(
+        Sparse_Matrix<double>(original_size, original_size, std::move(shifted)));
+
+    std::vector<Column> basis;
+    std::size_t block_begin = 0U;
+
+    for(const auto index : system.port_indices)
+    {
+        Column port(original_size, 0.0);
+        port[index] = 1.0;
+        append_orthonormal(basis, factorization.solve(port));
+    }
+    block_ends.emplace_back(basis.size());
+
+    const auto project_model = [&]()
+    {
+        conductance = project(basis, system.conductance);
+        capacitance = project(basis, system.capacitance);
+
+        input = Dense_Matrix<double>(basis.size(), system.port_indices.size());
+        for(std::size_t row = 0U; row < basis.size(); ++row)
+        {
+            for(std::size_t port = 0U; port < system.port_indices.size(); ++port)
+            {
+                input(row, port) = basis[row][system.port_indices[port]];
+            }
+        }
+    };
+
+    const auto converged = [&]()
+    {
+        if((options.tolerance <= 0.0) || options.check_frequencies.empty() || (block_ends.size() < 2U))
+        {
+            return false;
+        }
+
+        project_model();
+        return std::all_of(options.check_frequencies.begin(), options.check_frequencies.end(),
+                           [&](const double frequency)
+                           {
+                               return get_error_estimate(frequency) < options.tolerance;
+                           });
+    };
+
+    while((block_ends.size() < options.maximum_blocks) && !converged())
+    {
+        const auto block_end = basis.size();
+        for(auto column = block_begin; column < block_end; ++column)
+        {
+            append_orthonormal(basis, factorization.solve(system.capacitance.multiply(basis[column])));
+        }
+
+        // The Krylov space is exhausted and the model is already exact
+        if(basis.size() == block_end)
+        {
+            break;
+        }
+
+        block_begin = block_end;
+        block_ends.emplace_back(basis.size());
+    }
+
+    project_model();
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and reduces the result
+ * \param network
+ * \param ground_uid
+ * \param port_uids
+ * \param options
+ *************************************************************************************************/
+Reduced_Model::Reduced_Model(const Network& network, const uint32_t ground_uid,
+                             const std::vector<uint32_t>& port_uids,
+                             const Model_Reduction_Options& options) :
+    Reduced_Model(*network.compile(), ground_uid, port_uids, options)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Port impedance matrix of the full reduced model
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Reduced_Model::get_impedance(const double frequency) const
+{
+    return evaluate(get_order(), frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief Port impedance matrices at each frequency
+ * \param frequencies
+ *************************************************************************************************/
+std::vector<Dense_Matrix<std::complex<double>>> Reduced_Model::sweep(const std::vector<double>& frequencies) const
+{
+    std::vector<Dense_Matrix<std::complex<double>>> results;
+    results.reserve(frequencies.size());
+
+    for(const auto frequency : frequencies)
+    {
+        results.emplace_back(get_impedance(frequency));
+    }
+
+    return results;
+}
+
+/**********************************************************************************************//**
+ * \brief Diagonal entry of the impedance matrix for one port
+ * \param port_uid
+ * \param frequency
+ *************************************************************************************************/
+std::complex<double> Reduced_Model::get_thevenin_impedance(const uint32_t port_uid, const double frequency) const
+{
+    const auto found = std::find(port_uids.begin(), port_uids.end(), port_uid);
+    if(found == port_uids.end())
+    {
+        throw Invalid_Port_Exception();
+    }
+
+    const auto port = static_cast<std::size_t>(found - port_uids.begin());
+    return get_impedance(frequency)(port, port);
+}
+
+/**********************************************************************************************//**
+ * \brief Compares the model with the nested model one block smaller
+ * \param frequency
+ *************************************************************************************************/
+double Reduced_Model::get_error_estimate(const double frequency) const
+{
+    if(block_ends.size() < 2U)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const auto full = evaluate(block_ends.back(), frequency);
+    auto difference = evaluate(block_ends[block_ends.size() - 2U], frequency);
+
+    const auto count = full.get_number_of_rows() * full.get_number_of_columns();
+    for(std::size_t index = 0U; index < count; ++index)
+    {
+        difference.data()[index] -= full.data()[index];
+    }
+
+    return frobenius_norm(difference) / frobenius_norm(full);
+}
+
+/**********************************************************************************************//**
+ * \brief Z = Br^T (Gr + jw Cr)^-1 Br using only the leading order basis vectors
+ * \param order
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Reduced_Model::evaluate(const std::size_t order, const double frequency) const
+{
+    const auto number_of_ports = port_uids.size();
+
+    Dense_Matrix<std::complex<double>> system(order, order);
+    for(std::size_t row = 0U; row < order; ++row)
+    {
+        for(std::size_t column = 0U; column < order; ++column)
+        {
+            system(row, column) = { conductance(row, column), frequency * capacitance(row, column) };
+        }
+    }
+
+    const LU_Factorization<std::complex<double>> factorization(std::move(system));
+
+    Dense_Matrix<std::complex<double>> impedance(number_of_ports, number_of_ports);
+    std::vector<std::complex<double>> excitation(order);
+    for(std::size_t column = 0U; column < number_of_ports; ++column)
+    {
+        for(std::size_t row = 0U; row < order; ++row)
+        {
+            excitation[row] = input(row, column);
+        }
+
+        const auto states = factorization.solve(excitation);
+        for(std::size_t row = 0U; row < number_of_ports; ++row)
+        {
+            std::complex<double> accumulator{ 0.0 };
+            for(std::size_t state = 0U; state < order; ++state)
+            {
+                accumulator += input(state, row) * states[state];
+            }
+
+            impedance(row, column) = accumulator;
+        }
+    }
+
+    return impedance;
+}
+
+/**********************************************************************************************//**
+ * \brief Number of states in the reduced model
+ *************************************************************************************************/
+std::size_t Reduced_Model::get_order() const
+{
+    return block_ends.empty() ? 0U : block_ends.back();
+}
+
+/**********************************************************************************************//**
+ * \brief Number of unknowns in the network the model was built from
+ *************************************************************************************************/
+std::size_t Reduced_Model::get_original_size() const
+{
+    return original_size;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for port_uids
+ *************************************************************************************************/
+const std::vector<uint32_t>& Reduced_Model::get_port_uids() const
+{
+    return port_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Reduced conductance matrix Gr
+ *************************************************************************************************/
+const Dense_Matrix<double>& Reduced_Model::get_conductance() const
+{
+    return conductance;
+}
+
+/**********************************************************************************************//**
+ * \brief Reduced capacitance matrix Cr
+ *************************************************************************************************/
+const Dense_Matrix<double>& Reduced_Model::get_capacitance() const
+{
+    return capacitance;
+}
+
+/**********************************************************************************************//**
+ * \brief Reduced input matrix Br
+ *************************************************************************************************/
+const Dense_Matrix<double>& Reduced_Model::get_input() const
+{
+    return input;
+}
@@ -1,17 +1,48 @@
 #include "circlyzer/network.h"
+#include "circlyzer/compiled_network.h"
 #include "circlyzer/exceptions.h"
+#include "circlyzer/network_shard.h"
+
+#include <algorithm>
+#include <utility>
 
 // uncomment to disable assert()
 // #define NDEBUG
 #include <cassert>
 
+using namespace Circlyzer;
+
 namespace
 {
     constexpr auto MAXIMUM_NUMBER_OF_NODES_FOR_ELEMENT = 2U;
-    constexpr auto DEFAULT_ALIAS_LENGTH_LIMIT = 25U;
-}
 
-using namespace Circlyzer;
+    /**
+     * \brief Copies a component, keeping its concrete type
+     */
+    std::unique_ptr<Component> clone(const Component& component)
+    {
+        switch(component.type)
+        {
+            case Component_Type::Resistor:
+                return std::make_unique<Resistor>(static_cast<const Resistor&>(component));
+
+            case Component_Type::Capacitor:
+                return std::make_unique<Capacitor>(static_cast<const Capacitor&>(component));
+
+            case Component_Type::Inductor:
+                return std::make_unique<Inductor>(static_cast<const Inductor&>(component));
+
+            case Component_Type::Voltage_Source:
+                return std::make_unique<Voltage_Source>(static_cast<const Voltage_Source&>(component));
+
+            case Component_Type::Diode:
+                return std::make_unique<Diode>(static_cast<const Diode&>(component));
+        }
+
+        assert((false) && "Invalid component type discovered on clone");
+        return nullptr;
+    }
+}
 
 /**********************************************************************************************//**
  * \brief 
@@ -19,90 +50,300 @@ using namespace Circlyzer;
 Network::Network() :
     entity_table(),
     alias_to_id_table(),
+    generations(),
+    released_uids(),
+    next_uid{ 0U },
     number_of_nodes{ 0U },
-    number_of_branches{ 0U }
+    number_of_branches{ 0U },
+    journal(),
+    self{ std::make_shared<const Network*>(this) }
 {
 
 }
 
 /**********************************************************************************************//**
- * \brief 
+ * \brief Takes over another network's contents, along with the reference that follows them. The
+ *        moved from network is left empty, with a reference of its own.
+ * \param other
  *************************************************************************************************/
-uint32_t Network::create_node(const std::string& alias)
+Network::Network(Network&& other) :
+    entity_table(std::move(other.entity_table)),
+    alias_to_id_table(std::move(other.alias_to_id_table)),
+    generations(std::move(other.generations)),
+    released_uids(std::move(other.released_uids)),
+    next_uid{ other.next_uid },
+    number_of_nodes{ other.number_of_nodes },
+    number_of_branches{ other.number_of_branches },
+    journal(std::move(other.journal)),
+    self{ std::exchange(other.self, std::make_shared<const Network*>(&other)) }
 {
-    // Size check
-    if(alias.size() >= DEFAULT_ALIAS_LENGTH_LIMIT)
-    {
-        throw Invalid_Alias_Exception();
-    }
+    *self = this;
+    other.next_uid = 0U;
+    other.number_of_nodes = 0U;
+    other.number_of_branches = 0U;
+}
 
-    // Duplicate check
-    if(alias_to_id_table.find(alias) != alias_to_id_table.end())
+/**********************************************************************************************//**
+ * \brief Replaces this network's contents with another's. Whatever followed the old contents
+ *        reads null from then on, and whatever followed the other's now follows this network.
+ * \param other
+ *************************************************************************************************/
+Network& Network::operator=(Network&& other)
+{
+    if(this == &other)
     {
-        throw Duplicate_Alias_Exception();
+        return *this;
     }
 
-    // Create the node
-    auto node = std::make_shared<Node>();
-    node->uid = find_valid_uid();
-    node->alias = alias;
-    node->type = Entity_Type::Node;
+    *self = nullptr;
 
-    // Insert all non-empty string aliases once they've been cleared for insertion
-    if(alias.size() > 0)
-    {
-        alias_to_id_table.insert({ alias, node->uid });
-    }
+    entity_table = std::move(other.entity_table);
+    alias_to_id_table = std::move(other.alias_to_id_table);
+    generations = std::move(other.generations);
+    released_uids = std::move(other.released_uids);
+    next_uid = std::exchange(other.next_uid, 0U);
+    number_of_nodes = std::exchange(other.number_of_nodes, 0U);
+    number_of_branches = std::exchange(other.number_of_branches, 0U);
+    journal = std::move(other.journal);
+    self = std::exchange(other.self, std::make_shared<const Network*>(&other));
+    *self = this;
 
-    // Insert the branch
-    entity_table.insert({ node->uid, node });
-    ++number_of_nodes;
+    return *this;
+}
 
-    return node->uid;
+/**********************************************************************************************//**
+ * \brief Tells whatever follows the contents that they are gone
+ *************************************************************************************************/
+Network::~Network()
+{
+    *self = nullptr;
 }
 
 /**********************************************************************************************//**
- * \brief 
- * \param component
- * \param alias
+ * \brief Merges shards into one network. Each shard's entities are created, and its aliases
+ *        sorted, as one task on the executor. The sorted aliases are then merged in parallel
+ *        rounds, which finds the duplicates across shards as neighbours.
+ *
+ *        Connections are then resolved, a task per shard, and applied in creation order, shard
+ *        after shard, as a serial build would. Each shard attaches its own branches, so a
+ *        connection by alias to a branch of another shard is handed to that shard's task, in
+ *        order. Only the node side of a connection that crosses shards is left for a last
+ *        serial pass, where order doesn't matter as a node's branches are a set.
+ *
+ *        The shards are consumed. The journal starts out empty, the merged network being the
+ *        starting point for anything derived from it. Throws Duplicate_Alias_Exception if two
+ *        shards use the same alias.
+ * \param shards
+ * \param executor
  *************************************************************************************************/
-uint32_t Network::create_branch(std::unique_ptr<Component> component, const std::string& alias)
+Network::Network(std::vector<Network_Shard> shards, Executor& executor) :
+    Network()
 {
-    if(component == nullptr)
+    std::vector<uint32_t> offsets(shards.size() + 1U, 0U);
+    std::vector<std::size_t> alias_offsets(shards.size() + 1U, 0U);
+    for(std::size_t index = 0U; index < shards.size(); ++index)
     {
-        throw Null_Component_Exception();
+        offsets[index + 1U] = offsets[index] + shards[index].get_number_of_entities();
+        alias_offsets[index + 1U] = alias_offsets[index] + shards[index].get_number_of_aliases();
+        number_of_nodes += shards[index].get_number_of_nodes();
+        number_of_branches += shards[index].get_number_of_branches();
     }
 
-    // Size check
-    if(alias.size() >= DEFAULT_ALIAS_LENGTH_LIMIT)
+    entity_table.resize(offsets.back());
+    generations.assign(offsets.back(), 0U);
+    next_uid = offsets.back();
+
+    std::vector<std::pair<std::string, uint32_t>> aliases(alias_offsets.back());
+    executor.parallel_for(0U, shards.size(), [&](const std::size_t first, const std::size_t last)
+    {
+        for(auto index = first; index < last; ++index)
+        {
+            auto& shard = shards[index];
+            const auto offset = offsets[index];
+            auto alias = aliases.begin() + alias_offsets[index];
+
+            for(uint32_t id = 0U; id < shard.types.size(); ++id)
+            {
+                std::shared_ptr<Unique_Entity> entity;
+                if(shard.types[id] == Entity_Type::Node)
+                {
+                    entity = std::make_shared<Node>();
+                }
+                else
+                {
+                    auto branch = std::make_shared<Branch>();
+                    branch->component = std::move(shard.components[id]);
+                    entity = std::move(branch);
+                }
+
+                entity->uid = offset + id;
+                entity->type = shard.types[id];
+                entity->alias = std::move(shard.aliases[id]);
+
+                if(entity->alias.size() > 0)
+                {
+                    *alias++ = { entity->alias, entity->uid };
+                }
+
+                entity_table[offset + id] = std::move(entity);
+            }
+
+            std::sort(aliases.begin() + alias_offsets[index], alias);
+        }
+    });
+
+    // Merge neighbouring runs, doubling the run length every round
+    for(std::size_t width = 1U; width < shards.size(); width *= 2U)
     {
-        throw Invalid_Alias_Exception();
+        const auto number_of_merges = (shards.size() + (2U * width) - 1U) / (2U * width);
+        executor.parallel_for(0U, number_of_merges, [&](const std::size_t first, const std::size_t last)
+        {
+            for(auto merge = first; merge < last; ++merge)
+            {
+                const auto begin = merge * 2U * width;
+                const auto middle = std::min(begin + width, shards.size());
+                const auto end = std::min(begin + (2U * width), shards.size());
+
+                std::inplace_merge(aliases.begin() + alias_offsets[begin],
+                                   aliases.begin() + alias_offsets[middle],
+                                   aliases.begin() + alias_offsets[end]);
+            }
+        });
     }
 
-    // Duplicate check
-    if(alias_to_id_table.find(alias) != alias_to_id_table.end())
+    const auto duplicate = std::adjacent_find(aliases.begin(), aliases.end(),
+                                              [](const auto& first, const auto& second)
+                                              {
+                                                  return first.first == second.first;
+                                              });
+    if(duplicate != aliases.end())
     {
         throw Duplicate_Alias_Exception();
     }
 
-    // Create the branch
-    auto branch = std::make_shared<Branch>();
-    branch->uid = find_valid_uid();
-    branch->alias = alias;
-    branch->type = Entity_Type::Branch;
-    branch->component = std::move(component);
+    for(auto& entry : aliases)
+    {
+        alias_to_id_table.emplace_hint(alias_to_id_table.end(), std::move(entry));
+    }
 
-    // Insert all non-empty string aliases once they've been cleared for insertion
-    if(alias.size() > 0)
+    const auto owner_of = [&](const uint32_t uid)
     {
-        alias_to_id_table.insert({ alias, branch->uid });
+        return static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), uid) - offsets.begin()) - 1U;
+    };
+
+    // Every shard's connections as UIDs, in creation order, dropping those that don't resolve
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> resolved(shards.size());
+    executor.parallel_for(0U, shards.size(), [&](const std::size_t first, const std::size_t last)
+    {
+        for(auto index = first; index < last; ++index)
+        {
+            const auto& shard = shards[index];
+            const auto offset = offsets[index];
+
+            auto& connections = resolved[index];
+            connections.reserve(shard.connections.size());
+            for(const auto& [node_id, branch_id] : shard.connections)
+            {
+                if(node_id != Network_Shard::NO_ID)
+                {
+                    connections.emplace_back(offset + node_id, offset + branch_id);
+                    continue;
+                }
+
+                const auto& connection = shard.deferred_connections[branch_id];
+                const auto node_uid = find_uid(connection.node_alias);
+                const auto branch_uid = (connection.branch_id == Network_Shard::NO_ID) ?
+                                        find_uid(connection.branch_alias) :
+                                        Result<uint32_t>(offset + connection.branch_id);
+                if(node_uid && branch_uid && (entity_table[*node_uid]->type == Entity_Type::Node) &&
+                   (entity_table[*branch_uid]->type == Entity_Type::Branch))
+                {
+                    connections.emplace_back(*node_uid, *branch_uid);
+                }
+            }
+        }
+    });
+
+    // Connections to a branch of another shard, in order, for that shard to apply
+    std::vector<std::vector<std::pair<std::size_t, std::pair<uint32_t, uint32_t>>>> inbound(shards.size());
+    for(std::size_t index = 0U; index < shards.size(); ++index)
+    {
+        for(const auto& connection : resolved[index])
+        {
+            const auto owner = owner_of(connection.second);
+            if(owner != index)
+            {
+                inbound[owner].emplace_back(index, connection);
+            }
+        }
     }
 
-    // Insert the branch
-    entity_table.insert({ branch->uid, branch });
-    ++number_of_branches;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> crossing(shards.size());
+    executor.parallel_for(0U, shards.size(), [&](const std::size_t first, const std::size_t last)
+    {
+        for(auto index = first; index < last; ++index)
+        {
+            const auto connect = [&](const uint32_t node_uid, const uint32_t branch_uid)
+            {
+                auto& branch = static_cast<Branch&>(*entity_table[branch_uid]);
+                if(owner_of(node_uid) == index)
+                {
+                    attach(static_cast<Node&>(*entity_table[node_uid]), branch);
+                }
+                else if(branch.nodes.size() < MAXIMUM_NUMBER_OF_NODES_FOR_ELEMENT)
+                {
+                    branch.nodes.emplace_back(node_uid);
+                    crossing[index].emplace_back(node_uid, branch_uid);
+                }
+            };
+
+            // Earlier shards' connections come before this shard's own, later shards' after
+            auto next = inbound[index].begin();
+            for(; (next != inbound[index].end()) && (next->first < index); ++next)
+            {
+                connect(next->second.first, next->second.second);
+            }
+
+            for(const auto& [node_uid, branch_uid] : resolved[index])
+            {
+                if(owner_of(branch_uid) == index)
+                {
+                    connect(node_uid, branch_uid);
+                }
+            }
+
+            for(; next != inbound[index].end(); ++next)
+            {
+                connect(next->second.first, next->second.second);
+            }
+        }
+    });
 
-    return branch->uid;
+    for(const auto& connections : crossing)
+    {
+        for(const auto& [node_uid, branch_uid] : connections)
+        {
+            static_cast<Node&>(*entity_table[node_uid]).branches.emplace(branch_uid);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ *************************************************************************************************/
+uint32_t Network::create_node(const std::string& alias)
+{
+    return try_create_node(alias).value();
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param component
+ * \param alias
+ *************************************************************************************************/
+uint32_t Network::create_branch(std::unique_ptr<Component> component, const std::string& alias)
+{
+    return try_create_branch(std::move(component), alias).value();
 }
 
 /**********************************************************************************************//**
@@ -111,34 +352,129 @@ uint32_t Network::create_branch(std::unique_ptr<Component> component, const std:
  *************************************************************************************************/
 const Component& Network::get_component(const uint32_t uid) const
 {
-    if(uid_does_not_exist(uid))
+    return *try_get_component(uid).value();
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param alias 
+ *************************************************************************************************/
+const Component& Network::get_component(const std::string& alias) const
+{
+    return *try_get_component(alias).value();
+}
+
+/**********************************************************************************************//**
+ * \brief Read only access to a node, used by the analysis passes to walk the topology
+ * \param uid 
+ *************************************************************************************************/
+const Node& Network::get_node(const uint32_t uid) const
+{
+    return *try_get_node(uid).value();
+}
+
+/**********************************************************************************************//**
+ * \brief Read only access to a branch, used by the analysis passes to walk the topology
+ * \param uid 
+ *************************************************************************************************/
+const Branch& Network::get_branch(const uint32_t uid) const
+{
+    return *try_get_branch(uid).value();
+}
+
+/**********************************************************************************************//**
+ * \brief Collects the UIDs of every node in ascending order
+ *************************************************************************************************/
+std::vector<uint32_t> Network::get_node_uids() const
+{
+    std::vector<uint32_t> uids;
+    uids.reserve(number_of_nodes);
+
+    for(uint32_t uid = 0U; uid < entity_table.size(); ++uid)
     {
-        throw Non_Existant_UID_Exception();
+        const auto& entity_ptr = entity_table[uid];
+        if((entity_ptr != nullptr) && (entity_ptr->type == Entity_Type::Node))
+        {
+            uids.emplace_back(uid);
+        }
     }
 
-    const auto entity_ptr = entity_table.at(uid);
-    if(entity_ptr->type != Entity_Type::Branch)
+    return uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Collects the UIDs of every branch in ascending order
+ *************************************************************************************************/
+std::vector<uint32_t> Network::get_branch_uids() const
+{
+    std::vector<uint32_t> uids;
+    uids.reserve(number_of_branches);
+
+    for(uint32_t uid = 0U; uid < entity_table.size(); ++uid)
     {
-        throw Wrong_Entity_Type_Exception();
+        const auto& entity_ptr = entity_table[uid];
+        if((entity_ptr != nullptr) && (entity_ptr->type == Entity_Type::Branch))
+        {
+            uids.emplace_back(uid);
+        }
     }
 
-    const auto& branch = dynamic_cast<const Branch&>(*entity_ptr);
+    return uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Handle to a node, valid until the node is destroyed or the network compacted
+ * \param uid
+ *************************************************************************************************/
+Node_Handle Network::get_node_handle(const uint32_t uid) const
+{
+    return try_get_node_handle(uid).value();
+}
 
-    return *(branch.component);
+/**********************************************************************************************//**
+ * \brief Handle to a branch, valid until the branch is destroyed or the network compacted
+ * \param uid
+ *************************************************************************************************/
+Branch_Handle Network::get_branch_handle(const uint32_t uid) const
+{
+    return try_get_branch_handle(uid).value();
 }
 
 /**********************************************************************************************//**
- * \brief 
- * \param alias 
+ * \brief Read only access to a node through a handle. Throws Stale_Handle_Exception once the
+ *        node is gone, even if its UID has been given to another entity since.
+ * \param handle
  *************************************************************************************************/
-const Component& Network::get_component(const std::string& alias) const
+const Node& Network::get_node(const Node_Handle handle) const
 {
-    if(alias_does_not_exist(alias))
-    {
-        throw Non_Existant_Alias_Exception();
-    }
+    return *try_get_node(handle).value();
+}
+
+/**********************************************************************************************//**
+ * \brief Read only access to a branch through a handle, see get_node
+ * \param handle
+ *************************************************************************************************/
+const Branch& Network::get_branch(const Branch_Handle handle) const
+{
+    return *try_get_branch(handle).value();
+}
+
+/**********************************************************************************************//**
+ * \brief Whether a handle still resolves
+ * \param handle
+ *************************************************************************************************/
+bool Network::is_valid(const Node_Handle handle) const
+{
+    return find_entity(handle.index, handle.generation, Entity_Type::Node).has_value();
+}
 
-    return get_component(alias_to_id_table.at(alias));
+/**********************************************************************************************//**
+ * \brief Whether a handle still resolves
+ * \param handle
+ *************************************************************************************************/
+bool Network::is_valid(const Branch_Handle handle) const
+{
+    return find_entity(handle.index, handle.generation, Entity_Type::Branch).has_value();
 }
 
 /**********************************************************************************************//**
@@ -170,9 +506,9 @@ void Network::create_connection_between(const uint32_t node_uid, const uint32_t
     }
 
     auto node_ptr = node_weak_ptr.lock();
-    auto branch_ptr = node_weak_ptr.lock();
+    auto branch_ptr = branch_weak_ptr.lock();
 
-    if((node_ptr->type != Entity_Type::Node) && (branch_ptr->type != Entity_Type::Branch))
+    if((node_ptr->type != Entity_Type::Node) || (branch_ptr->type != Entity_Type::Branch))
     {
         // Node and Branch weren't provided
         return;
@@ -181,22 +517,13 @@ void Network::create_connection_between(const uint32_t node_uid, const uint32_t
     auto& node = dynamic_cast<Node&>(*node_ptr);
     auto& branch = dynamic_cast<Branch&>(*branch_ptr);
 
-    // Assign the connection to the first open terminal
-    if(branch.nodes.size() < MAXIMUM_NUMBER_OF_NODES_FOR_ELEMENT)
-    {
-        branch.nodes.emplace_back(node_uid);
-    }
-    else if(branch.nodes.size() > MAXIMUM_NUMBER_OF_NODES_FOR_ELEMENT)
+    if(!attach(node, branch))
     {
         // No place for the new connection
         return;
     }
-    else
-    {
-        assert((false) && "An branch has been connected to too many nodes!");
-    }
 
-    node.branches.emplace(branch_uid);
+    journal.record(Change_Type::Connection_Created, node_uid, branch_uid);
 
     // Return success
     return;
@@ -231,9 +558,9 @@ void Network::delete_connection_between(const uint32_t node_uid, const uint32_t
     }
 
     auto node_ptr = node_weak_ptr.lock();
-    auto branch_ptr = node_weak_ptr.lock();
+    auto branch_ptr = branch_weak_ptr.lock();
 
-    if((node_ptr->type != Entity_Type::Node) && (branch_ptr->type != Entity_Type::Branch))
+    if((node_ptr->type != Entity_Type::Node) || (branch_ptr->type != Entity_Type::Branch))
     {
         // Node and Branch weren't provided
         return;
@@ -257,6 +584,7 @@ void Network::delete_connection_between(const uint32_t node_uid, const uint32_t
     }
 
     node.branches.erase(branch_uid);
+    journal.record(Change_Type::Connection_Deleted, node_uid, branch_uid);
 }
 
 /**********************************************************************************************//**
@@ -289,74 +617,65 @@ void Network::delete_connection_between(const std::string& node_alias,
         return;
     }
 
-    return create_connection_between(alias_to_id_table.at(node_alias),
+    return delete_connection_between(alias_to_id_table.at(node_alias),
                                      alias_to_id_table.at(branch_alias));
 }
 
 /**********************************************************************************************//**
- * \brief 
+ * \brief Renames an entity. Unknown UIDs are ignored.
  * \param uid
  * \param new_alias 
  *************************************************************************************************/
 void Network::update_alias(const uint32_t uid, const std::string& new_alias)
 {
-    if(uid_does_not_exist(uid))
+    const auto result = try_update_alias(uid, new_alias);
+    if(!result && (result.error() != Network_Error::Non_Existant_UID))
     {
-        return;
+        throw_network_error(result.error());
     }
-
-    // TODO: Update the alias
 }
 
 /**********************************************************************************************//**
- * \brief 
+ * \brief Renames an entity. Unknown aliases are ignored.
  * \param alias
  * \param new_alias 
  *************************************************************************************************/
 void Network::update_alias(const std::string& alias, const std::string& new_alias)
 {
-    if(alias_does_not_exist(alias))
+    const auto result = try_update_alias(alias, new_alias);
+    if(!result && (result.error() != Network_Error::Non_Existant_Alias))
     {
-        return;
+        throw_network_error(result.error());
     }
+}
 
-    update_alias(alias_to_id_table.at(alias), new_alias);
+/**********************************************************************************************//**
+ * \brief Swaps the component held by a branch, leaving its connections untouched
+ * \param uid
+ * \param component
+ *************************************************************************************************/
+void Network::update_component(const uint32_t uid, std::unique_ptr<Component> component)
+{
+    try_update_component(uid, std::move(component)).value();
 }
 
 /**********************************************************************************************//**
  * \brief 
+ * \param alias
+ * \param component
+ *************************************************************************************************/
+void Network::update_component(const std::string& alias, std::unique_ptr<Component> component)
+{
+    try_update_component(alias, std::move(component)).value();
+}
+
+/**********************************************************************************************//**
+ * \brief Destroys an entity along with its connections. Unknown UIDs are ignored.
  * \param uid 
  *************************************************************************************************/
 void Network::destroy_entity(const uint32_t uid)
 {
-    if(uid_does_not_exist(uid))
-    {
-        return;
-    }
-
-    auto entity_ptr = entity_table.at(uid);
-    const auto alias = entity_ptr->alias;
-    const auto type = entity_ptr->type;
-
-    if(type == Entity_Type::Node)
-    {
-        auto node_ptr = dynamic_pointer_cast<Node>(entity_ptr);
-        node_ptr.reset();
-        --number_of_nodes;
-    }
-    else if(type == Entity_Type::Branch)
-    {
-        auto branch_ptr = dynamic_pointer_cast<Branch>(entity_ptr);
-        branch_ptr.reset();
-        --number_of_branches;
-    }
-    else
-    {
-        assert((false) && "Invalid entity type discovered on destroy");
-    }
-
-    entity_table.erase(uid);
-    alias_to_id_table.erase(alias);
+    destroy_entities({ uid });
 }
 
 /**********************************************************************************************//**
@@ -374,69 +693,636 @@ void Network::destroy_entity(const std::string& alias)
 }
 
 /**********************************************************************************************//**
- * \brief Accessor for number_of_nodes
+ * \brief Destroys a set of entities in time proportional to them and their connections. Each
+ *        connection to a surviving neighbour is deleted from both ends, and journaled, before
+ *        its entity is destroyed. Connections between two destroyed entities simply go with
+ *        them. Unknown and repeated UIDs are ignored.
+ * \param uids
  *************************************************************************************************/
-uint32_t Network::get_number_of_entities() const
+void Network::destroy_entities(const std::vector<uint32_t>& uids)
 {
-    return entity_table.size();
-}
+    // Emptying the slots first leaves exactly the survivors in the table
+    std::vector<std::shared_ptr<Unique_Entity>> doomed;
+    doomed.reserve(uids.size());
+    for(const auto uid : uids)
+    {
+        if(!uid_does_not_exist(uid))
+        {
+            doomed.emplace_back(std::move(entity_table[uid]));
+        }
+    }
 
-/**********************************************************************************************//**
- * \brief Accessor for number_of_nodes
- *************************************************************************************************/
-uint32_t Network::get_number_of_aliases() const
-{
-   return alias_to_id_table.size();
-}
+    for(const auto& entity_ptr : doomed)
+    {
+        const auto uid = entity_ptr->uid;
+        if(entity_ptr->type == Entity_Type::Node)
+        {
+            for(const auto branch_uid : static_cast<Node&>(*entity_ptr).branches)
+            {
+                if(entity_table[branch_uid] != nullptr)
+                {
+                    std::erase(static_cast<Branch&>(*entity_table[branch_uid]).nodes, uid);
+                    journal.record(Change_Type::Connection_Deleted, uid, branch_uid);
+                }
+            }
+
+            --number_of_nodes;
+            journal.record(Change_Type::Node_Destroyed, uid);
+        }
+        else if(entity_ptr->type == Entity_Type::Branch)
+        {
+            for(const auto node_uid : static_cast<Branch&>(*entity_ptr).nodes)
+            {
+                // A branch with both terminals on one node holds it twice
+                if((entity_table[node_uid] != nullptr) &&
+                   (static_cast<Node&>(*entity_table[node_uid]).branches.erase(uid) > 0U))
+                {
+                    journal.record(Change_Type::Connection_Deleted, node_uid, uid);
+                }
+            }
+
+            --number_of_branches;
+            journal.record(Change_Type::Branch_Destroyed, uid);
+        }
+        else
+        {
+            assert((false) && "Invalid entity type discovered on destroy");
+        }
 
-/**********************************************************************************************//**
- * \brief Accessor for number_of_nodes
- *************************************************************************************************/
-uint32_t Network::get_number_of_nodes() const
-{
-    return number_of_nodes;
+        alias_to_id_table.erase(entity_ptr->alias);
+        ++generations[uid];
+        released_uids.insert(uid);
+    }
 }
 
 /**********************************************************************************************//**
- * \brief Accessor for number_of_branches
+ * \brief Copies out the subnetwork induced by a set of nodes: the nodes, and every branch whose
+ *        terminals are all among them. Only the region is visited, not the whole network. The
+ *        copy keeps the aliases and components, numbers its UIDs densely in the order of the
+ *        originals, and starts with an empty journal. Throws Non_Existant_UID_Exception or
+ *        Wrong_Entity_Type_Exception for a UID that isn't a node.
+ * \param node_uids
  *************************************************************************************************/
-uint32_t Network::get_number_of_branches() const
+Extracted_Network Network::extract_subnetwork(const std::vector<uint32_t>& node_uids) const
 {
-    return number_of_branches;
-}
+    std::vector<uint32_t> nodes(node_uids);
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
 
-/**********************************************************************************************//**
- * \brief Iterates over the entity table. Since the std::map is stored in sorted order, the
- *        iteration will happen in sorted order. If N uids have been reserved, and they were all
- *        allocated in perfect serial order, this function will return N + 1. If a gap exists in
- *        allocation, this function will find that gap before N+1 is reached.
- * 
- * \note  This may be a potential performance issue on larger networks. But for now, I'll ignore
- *        that as it is very unlikely.
- *************************************************************************************************/
-uint32_t Network::find_valid_uid() const
-{
-    uint32_t attempted_id = 0U;
-    for(auto it = entity_table.cbegin(); it != entity_table.cend(); ++it)
+    const auto inside = [&](const uint32_t uid)
     {
-        if(it->first < attempted_id)
+        return std::binary_search(nodes.begin(), nodes.end(), uid);
+    };
+
+    std::vector<uint32_t> members(nodes);
+    for(const auto uid : nodes)
+    {
+        for(const auto branch_uid : try_get_node(uid).value()->branches)
         {
-            break;
+            const auto& terminals = static_cast<const Branch&>(*entity_table[branch_uid]).nodes;
+            if(std::all_of(terminals.begin(), terminals.end(), inside))
+            {
+                members.emplace_back(branch_uid);
+            }
         }
-
-        ++attempted_id;
     }
 
-    return attempted_id;
-}
+    std::sort(members.begin(), members.end());
+    members.erase(std::unique(members.begin(), members.end()), members.end());
 
-/**********************************************************************************************//**
- * \brief 
- * \param alias 
- *************************************************************************************************/
+    const auto renumber = [&](const uint32_t uid)
+    {
+        return static_cast<uint32_t>(std::lower_bound(members.begin(), members.end(), uid) - members.begin());
+    };
+
+    Extracted_Network extracted;
+    auto& subnetwork = extracted.network;
+    for(const auto uid : members)
+    {
+        const auto& original = *entity_table[uid];
+        std::shared_ptr<Unique_Entity> entity;
+
+        if(original.type == Entity_Type::Node)
+        {
+            auto node = std::make_shared<Node>();
+            for(const auto branch_uid : static_cast<const Node&>(original).branches)
+            {
+                if(std::binary_search(members.begin(), members.end(), branch_uid))
+                {
+                    node->branches.emplace_hint(node->branches.end(), renumber(branch_uid));
+                }
+            }
+
+            entity = std::move(node);
+            ++subnetwork.number_of_nodes;
+        }
+        else
+        {
+            const auto& source = static_cast<const Branch&>(original);
+            auto branch = std::make_shared<Branch>();
+            branch->component = clone(*source.component);
+            for(const auto node_uid : source.nodes)
+            {
+                branch->nodes.emplace_back(renumber(node_uid));
+            }
+
+            entity = std::move(branch);
+            ++subnetwork.number_of_branches;
+        }
+
+        entity->uid = subnetwork.next_uid++;
+        entity->alias = original.alias;
+        entity->type = original.type;
+
+        if(entity->alias.size() > 0)
+        {
+            subnetwork.alias_to_id_table.insert({ entity->alias, entity->uid });
+        }
+
+        subnetwork.store_entity(std::move(entity));
+    }
+
+    extracted.original_uids = std::move(members);
+    return extracted;
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing create_node
+ * \param alias
+ *************************************************************************************************/
+Result<uint32_t> Network::try_create_node(const std::string& alias)
+{
+    if(const auto valid = validate_new_alias(alias); !valid)
+    {
+        return valid.error();
+    }
+
+    // Create the node
+    auto node = std::make_shared<Node>();
+    node->uid = find_valid_uid();
+    node->alias = alias;
+    node->type = Entity_Type::Node;
+
+    // Insert all non-empty string aliases once they've been cleared for insertion
+    if(alias.size() > 0)
+    {
+        alias_to_id_table.insert({ alias, node->uid });
+    }
+
+    // Insert the node
+    store_entity(node);
+    ++number_of_nodes;
+
+    journal.record(Change_Type::Node_Created, node->uid);
+
+    return node->uid;
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing create_branch. The component is discarded if the branch isn't created.
+ * \param component
+ * \param alias
+ *************************************************************************************************/
+Result<uint32_t> Network::try_create_branch(std::unique_ptr<Component> component,
+                                            const std::string& alias)
+{
+    if(component == nullptr)
+    {
+        return Network_Error::Null_Component;
+    }
+
+    if(const auto valid = validate_new_alias(alias); !valid)
+    {
+        return valid.error();
+    }
+
+    // Create the branch
+    auto branch = std::make_shared<Branch>();
+    branch->uid = find_valid_uid();
+    branch->alias = alias;
+    branch->type = Entity_Type::Branch;
+    branch->component = std::move(component);
+
+    // Insert all non-empty string aliases once they've been cleared for insertion
+    if(alias.size() > 0)
+    {
+        alias_to_id_table.insert({ alias, branch->uid });
+    }
+
+    // Insert the branch
+    store_entity(branch);
+    ++number_of_branches;
+
+    journal.record(Change_Type::Branch_Created, branch->uid);
+
+    return branch->uid;
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_component
+ * \param uid
+ *************************************************************************************************/
+Result<const Component*> Network::try_get_component(const uint32_t uid) const
+{
+    const auto branch = try_get_branch(uid);
+    if(!branch)
+    {
+        return branch.error();
+    }
+
+    return static_cast<const Component*>((*branch)->component.get());
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_component
+ * \param alias
+ *************************************************************************************************/
+Result<const Component*> Network::try_get_component(const std::string& alias) const
+{
+    const auto uid = find_uid(alias);
+    if(!uid)
+    {
+        return uid.error();
+    }
+
+    return try_get_component(*uid);
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_node
+ * \param uid
+ *************************************************************************************************/
+Result<const Node*> Network::try_get_node(const uint32_t uid) const
+{
+    const auto entity = find_entity(uid);
+    if(!entity)
+    {
+        return entity.error();
+    }
+
+    if((*entity)->type != Entity_Type::Node)
+    {
+        return Network_Error::Wrong_Entity_Type;
+    }
+
+    return static_cast<const Node*>(*entity);
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_branch
+ * \param uid
+ *************************************************************************************************/
+Result<const Branch*> Network::try_get_branch(const uint32_t uid) const
+{
+    const auto entity = find_entity(uid);
+    if(!entity)
+    {
+        return entity.error();
+    }
+
+    if((*entity)->type != Entity_Type::Branch)
+    {
+        return Network_Error::Wrong_Entity_Type;
+    }
+
+    return static_cast<const Branch*>(*entity);
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_node_handle
+ * \param uid
+ *************************************************************************************************/
+Result<Node_Handle> Network::try_get_node_handle(const uint32_t uid) const
+{
+    if(const auto node = try_get_node(uid); !node)
+    {
+        return node.error();
+    }
+
+    return Node_Handle{ uid, generations[uid] };
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_branch_handle
+ * \param uid
+ *************************************************************************************************/
+Result<Branch_Handle> Network::try_get_branch_handle(const uint32_t uid) const
+{
+    if(const auto branch = try_get_branch(uid); !branch)
+    {
+        return branch.error();
+    }
+
+    return Branch_Handle{ uid, generations[uid] };
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_node through a handle
+ * \param handle
+ *************************************************************************************************/
+Result<const Node*> Network::try_get_node(const Node_Handle handle) const
+{
+    const auto entity = find_entity(handle.index, handle.generation, Entity_Type::Node);
+    if(!entity)
+    {
+        return entity.error();
+    }
+
+    return static_cast<const Node*>(*entity);
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing get_branch through a handle
+ * \param handle
+ *************************************************************************************************/
+Result<const Branch*> Network::try_get_branch(const Branch_Handle handle) const
+{
+    const auto entity = find_entity(handle.index, handle.generation, Entity_Type::Branch);
+    if(!entity)
+    {
+        return entity.error();
+    }
+
+    return static_cast<const Branch*>(*entity);
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing update_alias. Unlike update_alias, an unknown UID is reported.
+ * \param uid
+ * \param new_alias
+ *************************************************************************************************/
+Result<void> Network::try_update_alias(const uint32_t uid, const std::string& new_alias)
+{
+    const auto found = find_entity(uid);
+    if(!found)
+    {
+        return found.error();
+    }
+
+    // Size check
+    if(new_alias.size() >= ALIAS_LENGTH_LIMIT)
+    {
+        return Network_Error::Invalid_Alias;
+    }
+
+    auto& entity = **found;
+    if(entity.alias == new_alias)
+    {
+        return {};
+    }
+
+    // Duplicate check
+    if(alias_to_id_table.find(new_alias) != alias_to_id_table.end())
+    {
+        return Network_Error::Duplicate_Alias;
+    }
+
+    alias_to_id_table.erase(entity.alias);
+
+    // An empty alias simply removes the existing one
+    if(new_alias.size() > 0)
+    {
+        alias_to_id_table.insert({ new_alias, uid });
+    }
+
+    entity.alias = new_alias;
+    journal.record(Change_Type::Alias_Updated, uid);
+
+    return {};
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing update_alias. Unlike update_alias, an unknown alias is reported.
+ * \param alias
+ * \param new_alias
+ *************************************************************************************************/
+Result<void> Network::try_update_alias(const std::string& alias, const std::string& new_alias)
+{
+    const auto uid = find_uid(alias);
+    if(!uid)
+    {
+        return uid.error();
+    }
+
+    return try_update_alias(*uid, new_alias);
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing update_component
+ * \param uid
+ * \param component
+ *************************************************************************************************/
+Result<void> Network::try_update_component(const uint32_t uid, std::unique_ptr<Component> component)
+{
+    if(component == nullptr)
+    {
+        return Network_Error::Null_Component;
+    }
+
+    const auto entity = find_entity(uid);
+    if(!entity)
+    {
+        return entity.error();
+    }
+
+    if((*entity)->type != Entity_Type::Branch)
+    {
+        return Network_Error::Wrong_Entity_Type;
+    }
+
+    static_cast<Branch*>(*entity)->component = std::move(component);
+    journal.record(Change_Type::Component_Updated, uid);
+
+    return {};
+}
+
+/**********************************************************************************************//**
+ * \brief Non-throwing update_component
+ * \param alias
+ * \param component
+ *************************************************************************************************/
+Result<void> Network::try_update_component(const std::string& alias,
+                                           std::unique_ptr<Component> component)
+{
+    const auto uid = find_uid(alias);
+    if(!uid)
+    {
+        return uid.error();
+    }
+
+    return try_update_component(*uid, std::move(component));
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_nodes
+ *************************************************************************************************/
+uint32_t Network::get_number_of_entities() const
+{
+    return number_of_nodes + number_of_branches;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_nodes
+ *************************************************************************************************/
+uint32_t Network::get_number_of_aliases() const
+{
+   return alias_to_id_table.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_nodes
+ *************************************************************************************************/
+uint32_t Network::get_number_of_nodes() const
+{
+    return number_of_nodes;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_branches
+ *************************************************************************************************/
+uint32_t Network::get_number_of_branches() const
+{
+    return number_of_branches;
+}
+
+/**********************************************************************************************//**
+ * \brief Read only access to the mutation journal, for derived structures to catch up with
+ *************************************************************************************************/
+const Journal& Network::get_journal() const
+{
+    return journal;
+}
+
+/**********************************************************************************************//**
+ * \brief Shares where this network's contents live. A move hands the reference on to the network
+ *        moved into, so something built from this network can keep following it, and a
+ *        destroyed network leaves it null.
+ *************************************************************************************************/
+std::shared_ptr<const Network* const> Network::get_reference() const
+{
+    return self;
+}
+
+/**********************************************************************************************//**
+ * \brief Drops journal entries older than up_to, see Journal::compact
+ * \param up_to
+ *************************************************************************************************/
+void Network::compact_journal(const uint64_t up_to)
+{
+    journal.compact(up_to);
+}
+
+/**********************************************************************************************//**
+ * \brief Renumbers the entities 0 to n - 1, keeping their order, after destroy_entity has left
+ *        gaps. Connections and aliases follow their entities and the entity table shrinks to fit.
+ *
+ *        The result maps every old UID to its new one, with Change::NO_UID for UIDs that were
+ *        free. Handles to entities that kept their UID stay valid and every other handle goes
+ *        stale. The journal can't express a renumbering, so it restarts and every structure
+ *        derived from it rebuilds. Nothing happens, and the journal is kept, if there are no gaps.
+ *************************************************************************************************/
+std::vector<uint32_t> Network::compact()
+{
+    std::vector<uint32_t> remap(entity_table.size(), Change::NO_UID);
+    std::vector<std::shared_ptr<Unique_Entity>> compacted;
+    compacted.reserve(get_number_of_entities());
+
+    for(uint32_t uid = 0U; uid < entity_table.size(); ++uid)
+    {
+        if(entity_table[uid] != nullptr)
+        {
+            remap[uid] = static_cast<uint32_t>(compacted.size());
+            compacted.emplace_back(entity_table[uid]);
+        }
+    }
+
+    if(compacted.size() == entity_table.size())
+    {
+        return remap;
+    }
+
+    // Any slot that ends up with a different occupant, or none, invalidates its handles
+    for(uint32_t index = 0U; index < entity_table.size(); ++index)
+    {
+        const auto* occupant = (index < compacted.size()) ? compacted[index].get() : nullptr;
+        if(entity_table[index].get() != occupant)
+        {
+            ++generations[index];
+        }
+    }
+
+    // The remap is increasing, so every set can be rebuilt in order
+    for(const auto& entity_ptr : compacted)
+    {
+        entity_ptr->uid = remap[entity_ptr->uid];
+
+        if(entity_ptr->type == Entity_Type::Node)
+        {
+            auto& node = static_cast<Node&>(*entity_ptr);
+            std::set<uint32_t> branches;
+            for(const auto branch_uid : node.branches)
+            {
+                branches.emplace_hint(branches.end(), remap[branch_uid]);
+            }
+
+            node.branches = std::move(branches);
+        }
+        else
+        {
+            for(auto& node_uid : static_cast<Branch&>(*entity_ptr).nodes)
+            {
+                node_uid = remap[node_uid];
+            }
+        }
+    }
+
+    for(auto& [alias, uid] : alias_to_id_table)
+    {
+        uid = remap[uid];
+    }
+
+    entity_table = std::move(compacted);
+    released_uids.clear();
+    next_uid = static_cast<uint32_t>(entity_table.size());
+
+    journal.restart();
+
+    return remap;
+}
+
+/**********************************************************************************************//**
+ * \brief Builds a Compiled_Network from the current state. The result is immutable and can be
+ *        handed to as many analyses and threads as needed.
+ *************************************************************************************************/
+std::shared_ptr<const Compiled_Network> Network::compile() const
+{
+    return std::make_shared<const Compiled_Network>(*this);
+}
+
+/**********************************************************************************************//**
+ * \brief Hands out the lowest UID that isn't in use. UIDs freed by destroy_entity are reused
+ *        first, lowest first, otherwise the next never used UID is taken. This gives the same
+ *        numbering as scanning the entity table for its first gap, in O(log n) instead of O(n).
+ *************************************************************************************************/
+uint32_t Network::find_valid_uid()
+{
+    if(!released_uids.empty())
+    {
+        const auto uid = *released_uids.begin();
+        released_uids.erase(released_uids.begin());
+        return uid;
+    }
+
+    return next_uid++;
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param alias 
+ *************************************************************************************************/
 bool Network::uid_does_not_exist(const uint32_t uid) const
 {
-    return (entity_table.find(uid) == entity_table.end());
+    return (uid >= entity_table.size()) || (entity_table[uid] == nullptr);
 }
 
 /**********************************************************************************************//**
@@ -447,3 +1333,124 @@ bool Network::alias_does_not_exist(const std::string& alias) const
 {
     return (alias_to_id_table.find(alias) == alias_to_id_table.end());
 }
+
+/**********************************************************************************************//**
+ * \brief Checks that an alias can be given to a new entity: short enough and not taken
+ * \param alias 
+ *************************************************************************************************/
+Result<void> Network::validate_new_alias(const std::string& alias) const
+{
+    // Size check
+    if(alias.size() >= ALIAS_LENGTH_LIMIT)
+    {
+        return Network_Error::Invalid_Alias;
+    }
+
+    // Duplicate check
+    if(alias_to_id_table.find(alias) != alias_to_id_table.end())
+    {
+        return Network_Error::Duplicate_Alias;
+    }
+
+    return {};
+}
+
+/**********************************************************************************************//**
+ * \brief Looks up the UID behind an alias in a single search
+ * \param alias 
+ *************************************************************************************************/
+Result<uint32_t> Network::find_uid(const std::string& alias) const
+{
+    const auto it = alias_to_id_table.find(alias);
+    if(it == alias_to_id_table.end())
+    {
+        return Network_Error::Non_Existant_Alias;
+    }
+
+    return it->second;
+}
+
+/**********************************************************************************************//**
+ * \brief Looks up an entity in a single search
+ * \param uid 
+ *************************************************************************************************/
+Result<Unique_Entity*> Network::find_entity(const uint32_t uid) const
+{
+    if(uid_does_not_exist(uid))
+    {
+        return Network_Error::Non_Existant_UID;
+    }
+
+    return entity_table[uid].get();
+}
+
+/**********************************************************************************************//**
+ * \brief Resolves a handle, checking its generation and type
+ * \param index
+ * \param generation
+ * \param type
+ *************************************************************************************************/
+Result<Unique_Entity*> Network::find_entity(const uint32_t index, const uint32_t generation,
+                                            const Entity_Type type) const
+{
+    if((index >= entity_table.size()) || (generations[index] != generation) ||
+       (entity_table[index] == nullptr))
+    {
+        return Network_Error::Stale_Handle;
+    }
+
+    if(entity_table[index]->type != type)
+    {
+        return Network_Error::Wrong_Entity_Type;
+    }
+
+    return entity_table[index].get();
+}
+
+/**********************************************************************************************//**
+ * \brief Assigns a connection to the branch's first open terminal, returning false if both are
+ *        taken
+ * \param node
+ * \param branch
+ *************************************************************************************************/
+bool Network::attach(Node& node, Branch& branch)
+{
+    if(branch.nodes.size() < MAXIMUM_NUMBER_OF_NODES_FOR_ELEMENT)
+    {
+        branch.nodes.emplace_back(node.uid);
+    }
+    else if(branch.nodes.size() == MAXIMUM_NUMBER_OF_NODES_FOR_ELEMENT)
+    {
+        return false;
+    }
+    else
+    {
+        assert((false) && "An branch has been connected to too many nodes!");
+    }
+
+    node.branches.emplace(branch.uid);
+    return true;
+}
+
+/**********************************************************************************************//**
+ * \brief Puts a new entity in the slot of its UID, which find_valid_uid either took from
+ *        released_uids or from the end of the table
+ * \param entity
+ *************************************************************************************************/
+void Network::store_entity(std::shared_ptr<Unique_Entity> entity)
+{
+    const auto uid = entity->uid;
+    if(uid == entity_table.size())
+    {
+        entity_table.emplace_back(std::move(entity));
+    }
+    else
+    {
+        entity_table[uid] = std::move(entity);
+    }
+
+    if(uid == generations.size())
+    {
+        generations.emplace_back(0U);
+    }
+}
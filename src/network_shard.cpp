@@ -0,0 +1,178 @@
+#include "circlyzer/network_shard.h"
+#include "circlyzer/exceptions.h"
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * \brief
+ *************************************************************************************************/
+Network_Shard::Network_Shard() :
+    types(),
+    aliases(),
+    components(),
+    alias_to_id_table(),
+    connections(),
+    deferred_connections(),
+    number_of_nodes{ 0U },
+    number_of_branches{ 0U }
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Adds a node, returning its local ID
+ * \param alias
+ *************************************************************************************************/
+uint32_t Network_Shard::create_node(const std::string& alias)
+{
+    validate_new_alias(alias);
+
+    const auto id = static_cast<uint32_t>(types.size());
+    if(alias.size() > 0)
+    {
+        alias_to_id_table.insert({ alias, id });
+    }
+
+    types.emplace_back(Entity_Type::Node);
+    aliases.emplace_back(alias);
+    components.emplace_back(nullptr);
+    ++number_of_nodes;
+
+    return id;
+}
+
+/**********************************************************************************************//**
+ * \brief Adds a branch, returning its local ID
+ * \param component
+ * \param alias
+ *************************************************************************************************/
+uint32_t Network_Shard::create_branch(std::unique_ptr<Component> component, const std::string& alias)
+{
+    if(component == nullptr)
+    {
+        throw Null_Component_Exception();
+    }
+
+    validate_new_alias(alias);
+
+    const auto id = static_cast<uint32_t>(types.size());
+    if(alias.size() > 0)
+    {
+        alias_to_id_table.insert({ alias, id });
+    }
+
+    types.emplace_back(Entity_Type::Branch);
+    aliases.emplace_back(alias);
+    components.emplace_back(std::move(component));
+    ++number_of_branches;
+
+    return id;
+}
+
+/**********************************************************************************************//**
+ * \brief Connects a node and a branch of this shard. Unknown IDs and IDs of the wrong type are
+ *        ignored.
+ * \param node_id
+ * \param branch_id
+ *************************************************************************************************/
+void Network_Shard::create_connection_between(const uint32_t node_id, const uint32_t branch_id)
+{
+    if((node_id >= types.size()) || (branch_id >= types.size()))
+    {
+        return;
+    }
+
+    if((types[node_id] != Entity_Type::Node) || (types[branch_id] != Entity_Type::Branch))
+    {
+        return;
+    }
+
+    connections.emplace_back(node_id, branch_id);
+}
+
+/**********************************************************************************************//**
+ * \brief Connects a node named by alias, in any shard, to a branch of this shard
+ * \param node_alias
+ * \param branch_id
+ *************************************************************************************************/
+void Network_Shard::create_connection_between(const std::string& node_alias, const uint32_t branch_id)
+{
+    if((branch_id >= types.size()) || (types[branch_id] != Entity_Type::Branch))
+    {
+        return;
+    }
+
+    if(const auto local = alias_to_id_table.find(node_alias); local != alias_to_id_table.end())
+    {
+        return create_connection_between(local->second, branch_id);
+    }
+
+    connections.emplace_back(NO_ID, static_cast<uint32_t>(deferred_connections.size()));
+    deferred_connections.push_back({ node_alias, std::string(), branch_id });
+}
+
+/**********************************************************************************************//**
+ * \brief Connects a node and a branch named by alias, in any shard
+ * \param node_alias
+ * \param branch_alias
+ *************************************************************************************************/
+void Network_Shard::create_connection_between(const std::string& node_alias,
+                                              const std::string& branch_alias)
+{
+    if(const auto local = alias_to_id_table.find(branch_alias); local != alias_to_id_table.end())
+    {
+        return create_connection_between(node_alias, local->second);
+    }
+
+    connections.emplace_back(NO_ID, static_cast<uint32_t>(deferred_connections.size()));
+    deferred_connections.push_back({ node_alias, branch_alias, NO_ID });
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of entities
+ *************************************************************************************************/
+uint32_t Network_Shard::get_number_of_entities() const
+{
+    return static_cast<uint32_t>(types.size());
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of aliases
+ *************************************************************************************************/
+uint32_t Network_Shard::get_number_of_aliases() const
+{
+    return static_cast<uint32_t>(alias_to_id_table.size());
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_nodes
+ *************************************************************************************************/
+uint32_t Network_Shard::get_number_of_nodes() const
+{
+    return number_of_nodes;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_branches
+ *************************************************************************************************/
+uint32_t Network_Shard::get_number_of_branches() const
+{
+    return number_of_branches;
+}
+
+/**********************************************************************************************//**
+ * \brief Applies Network's alias rules within the shard
+ * \param alias
+ *************************************************************************************************/
+void Network_Shard::validate_new_alias(const std::string& alias) const
+{
+    if(alias.size() >= Network::ALIAS_LENGTH_LIMIT)
+    {
+        throw Invalid_Alias_Exception();
+    }
+
+    if(alias_to_id_table.contains(alias))
+    {
+        throw Duplicate_Alias_Exception();
+    }
+}
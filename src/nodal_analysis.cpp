@@ -0,0 +1,369 @@
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/mixed_precision.h"
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * \brief Numbers the unknowns from the compiled view. Non-ground nodes keep their dense order,
+ *        followed by one branch current unknown per voltage source and inductor. Branches that are
+ *        not connected at both terminals carry no current and are left out of the system, and
+ *        diodes are set aside as nonlinear elements.
+ * \param network
+ * \param ground_uid
+ *************************************************************************************************/
+Nodal_Analysis::Nodal_Analysis(const Compiled_Network& network, const uint32_t ground_uid) :
+    ground_uid{ ground_uid },
+    node_uids(),
+    elements(),
+    nonlinear_elements(),
+    system_size{ 0U },
+    stamp_cache{ std::make_shared<Stamp_Cache>(network) }
+{
+    // Validates that the ground exists and is a node
+    const auto ground_index = network.get_node_index(ground_uid);
+
+    node_uids.reserve(network.get_number_of_nodes() - 1U);
+    for(const auto uid : network.get_node_uids())
+    {
+        if(uid != ground_uid)
+        {
+            node_uids.emplace_back(uid);
+        }
+    }
+
+    // Removing the ground shifts every later node down by one
+    const auto index_of = [&](const uint32_t node_index) -> std::size_t
+    {
+        if(node_index == ground_index)
+        {
+            return GROUND_INDEX;
+        }
+
+        return (node_index < ground_index) ? node_index : (node_index - 1U);
+    };
+
+    const auto types = network.get_types();
+    const auto values = network.get_values();
+
+    system_size = node_uids.size();
+    for(uint32_t branch_index = 0U; branch_index < network.get_number_of_branches(); ++branch_index)
+    {
+        if(!network.is_connected(branch_index))
+        {
+            continue;
+        }
+
+        const auto terminals = network.get_terminals(branch_index);
+
+        Nodal_Element element;
+        element.uid = network.get_branch_uid(branch_index);
+        element.branch_index = branch_index;
+        element.type = types[branch_index];
+        element.first = index_of(terminals[0]);
+        element.second = index_of(terminals[1]);
+        element.current_index = GROUND_INDEX;
+        element.value = values[branch_index];
+
+        if(element.type == Component_Type::Diode)
+        {
+            nonlinear_elements.emplace_back(element);
+            continue;
+        }
+
+        if((element.type == Component_Type::Voltage_Source) ||
+           (element.type == Component_Type::Inductor))
+        {
+            element.current_index = system_size++;
+        }
+
+        elements.emplace_back(element);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and analyses the result
+ * \param network
+ * \param ground_uid
+ *************************************************************************************************/
+Nodal_Analysis::Nodal_Analysis(const Network& network, const uint32_t ground_uid) :
+    Nodal_Analysis(*network.compile(), ground_uid)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief 
+ * \param network
+ *************************************************************************************************/
+Nodal_Analysis::Stamp_Cache::Stamp_Cache(const Compiled_Network& network) :
+    mutex(),
+    table(network, STAMP_CACHE_CAPACITY)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Assembles, factorizes and solves the system at the provided frequency
+ * \param frequency
+ * \param precision
+ *************************************************************************************************/
+Nodal_Solution Nodal_Analysis::solve(const double frequency, const Solve_Precision precision) const
+{
+    const auto values = get_branch_impedances(frequency);
+
+    Dense_Matrix<std::complex<double>> matrix(system_size, system_size);
+    stamp_elements(*values, [&](const std::size_t row, const std::size_t column,
+                                const std::complex<double>& value)
+    {
+        matrix(row, column) += value;
+    });
+
+    if(precision == Solve_Precision::Mixed)
+    {
+        const auto result = solve_mixed_precision(matrix, assemble_excitation());
+        return interpret(result.solution, *values);
+    }
+
+    const LU_Factorization<std::complex<double>> factorization(std::move(matrix));
+    return interpret(factorization.solve(assemble_excitation()), *values);
+}
+
+/**********************************************************************************************//**
+ * \brief Builds the MNA matrix
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Nodal_Analysis::assemble_matrix(const double frequency) const
+{
+    Dense_Matrix<std::complex<double>> matrix(system_size, system_size);
+
+    for_each_stamp(frequency, [&](const std::size_t row, const std::size_t column,
+                                  const std::complex<double>& value)
+    {
+        matrix(row, column) += value;
+    });
+
+    return matrix;
+}
+
+/**********************************************************************************************//**
+ * \brief Builds the MNA matrix in compressed sparse row form, with every diagonal entry present
+ *        even where it is zero
+ * \param frequency
+ *************************************************************************************************/
+Sparse_Matrix<std::complex<double>> Nodal_Analysis::assemble_sparse_matrix(const double frequency) const
+{
+    std::vector<Sparse_Matrix<std::complex<double>>::Entry> entries;
+    entries.reserve(system_size + (4U * elements.size()));
+
+    for(std::size_t index = 0U; index < system_size; ++index)
+    {
+        entries.push_back({ index, index, 0.0 });
+    }
+
+    for_each_stamp(frequency, [&](const std::size_t row, const std::size_t column,
+                                  const std::complex<double>& value)
+    {
+        entries.push_back({ row, column, value });
+    });
+
+    return Sparse_Matrix<std::complex<double>>(system_size, system_size, std::move(entries));
+}
+
+/**********************************************************************************************//**
+ * \brief Reports every matrix contribution. Admittances are stamped into the node block, while
+ *        voltage sources and inductors couple their current unknown to their terminal voltages.
+ *        Contributions to the same entry are reported separately and must be summed.
+ * \param frequency
+ * \param stamp
+ *************************************************************************************************/
+void Nodal_Analysis::for_each_stamp(const double frequency, const Stamp_Function& stamp) const
+{
+    stamp_elements(*get_branch_impedances(frequency), stamp);
+}
+
+/**********************************************************************************************//**
+ * \brief Shares the branch impedances at a frequency. The lock covers the table lookup alone.
+ * \param frequency
+ *************************************************************************************************/
+std::shared_ptr<const Branch_Impedances> Nodal_Analysis::get_branch_impedances(const double frequency) const
+{
+    const std::lock_guard<std::mutex> lock(stamp_cache->mutex);
+    return stamp_cache->table.get_values(frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief Reports every matrix contribution from the provided branch impedances
+ * \param values
+ * \param stamp
+ *************************************************************************************************/
+void Nodal_Analysis::stamp_elements(const Branch_Impedances& values, const Stamp_Function& stamp) const
+{
+    const auto& admittances = values.admittances;
+    const auto& impedances = values.impedances;
+
+    for(const auto& element : elements)
+    {
+        const auto a = element.first;
+        const auto b = element.second;
+
+        if(element.current_index == GROUND_INDEX)
+        {
+            const auto admittance = admittances[element.branch_index];
+
+            if(a != GROUND_INDEX)
+            {
+                stamp(a, a, admittance);
+            }
+
+            if(b != GROUND_INDEX)
+            {
+                stamp(b, b, admittance);
+            }
+
+            if((a != GROUND_INDEX) && (b != GROUND_INDEX))
+            {
+                stamp(a, b, -admittance);
+                stamp(b, a, -admittance);
+            }
+
+            continue;
+        }
+
+        const auto k = element.current_index;
+        if(a != GROUND_INDEX)
+        {
+            stamp(a, k, 1.0);
+            stamp(k, a, 1.0);
+        }
+
+        if(b != GROUND_INDEX)
+        {
+            stamp(b, k, -1.0);
+            stamp(k, b, -1.0);
+        }
+
+        if(element.type == Component_Type::Inductor)
+        {
+            stamp(k, k, -impedances[element.branch_index]);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Builds the right hand side. Only voltage sources contribute.
+ *************************************************************************************************/
+std::vector<std::complex<double>> Nodal_Analysis::assemble_excitation() const
+{
+    std::vector<std::complex<double>> excitation(system_size, 0.0);
+
+    for(const auto& element : elements)
+    {
+        if(element.type == Component_Type::Voltage_Source)
+        {
+            excitation[element.current_index] = element.value;
+        }
+    }
+
+    return excitation;
+}
+
+/**********************************************************************************************//**
+ * \brief Maps a vector of unknowns back onto node and branch UIDs
+ * \param unknowns
+ * \param frequency
+ *************************************************************************************************/
+Nodal_Solution Nodal_Analysis::interpret(const std::vector<std::complex<double>>& unknowns,
+                                         const double frequency) const
+{
+    return interpret(unknowns, *get_branch_impedances(frequency));
+}
+
+/**********************************************************************************************//**
+ * \brief Maps a vector of unknowns back onto node and branch UIDs, with the branch impedances
+ *        the system was stamped from
+ * \param unknowns
+ * \param values
+ *************************************************************************************************/
+Nodal_Solution Nodal_Analysis::interpret(const std::vector<std::complex<double>>& unknowns,
+                                         const Branch_Impedances& values) const
+{
+    Nodal_Solution solution;
+
+    solution.node_voltages.insert({ ground_uid, 0.0 });
+    for(std::size_t index = 0U; index < node_uids.size(); ++index)
+    {
+        solution.node_voltages.insert({ node_uids[index], unknowns[index] });
+    }
+
+    const auto voltage_at = [&](const std::size_t index)
+    {
+        return (index == GROUND_INDEX) ? std::complex<double>{ 0.0 } : unknowns[index];
+    };
+
+    const auto& admittances = values.admittances;
+
+    for(const auto& element : elements)
+    {
+        std::complex<double> current;
+        if(element.current_index != GROUND_INDEX)
+        {
+            current = unknowns[element.current_index];
+        }
+        else
+        {
+            current = admittances[element.branch_index] *
+                      (voltage_at(element.first) - voltage_at(element.second));
+        }
+
+        solution.branch_currents.insert({ element.uid, current });
+    }
+
+    // Open circuits as far as the linear system is concerned
+    for(const auto& element : nonlinear_elements)
+    {
+        solution.branch_currents.insert({ element.uid, 0.0 });
+    }
+
+    return solution;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for system_size
+ *************************************************************************************************/
+std::size_t Nodal_Analysis::get_system_size() const
+{
+    return system_size;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for ground_uid
+ *************************************************************************************************/
+uint32_t Nodal_Analysis::get_ground_uid() const
+{
+    return ground_uid;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for node_uids, the UID of the node behind each voltage unknown
+ *************************************************************************************************/
+const std::vector<uint32_t>& Nodal_Analysis::get_node_uids() const
+{
+    return node_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for elements
+ *************************************************************************************************/
+const std::vector<Nodal_Element>& Nodal_Analysis::get_elements() const
+{
+    return elements;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for nonlinear_elements, the diodes, which are not part of the linear system
+ *************************************************************************************************/
+const std::vector<Nodal_Element>& Nodal_Analysis::get_nonlinear_elements() const
+{
+    return nonlinear_elements;
+}
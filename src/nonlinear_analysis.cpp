@@ -0,0 +1,287 @@
+#include "circlyzer/nonlinear_analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto GROUND_INDEX = Nodal_Analysis::GROUND_INDEX;
+
+    double voltage_at(const std::vector<double>& unknowns, const std::size_t index)
+    {
+        return (index == GROUND_INDEX) ? 0.0 : unknowns[index];
+    }
+
+    double diode_current(const double saturation_current, const double scale, const double voltage)
+    {
+        return saturation_current * std::expm1(voltage / scale);
+    }
+
+    double diode_conductance(const double saturation_current, const double scale, const double voltage)
+    {
+        return (saturation_current / scale) * std::exp(voltage / scale);
+    }
+
+    /**
+     * \brief Adds a conductance across a junction through its precomputed matrix offsets, in the
+     *        order anode-anode, cathode-cathode, anode-cathode, cathode-anode
+     */
+    void stamp_conductance(double* matrix, const std::size_t (&slots)[4], const double conductance)
+    {
+        constexpr double SIGNS[4] = { 1.0, 1.0, -1.0, -1.0 };
+        for(std::size_t index = 0U; index < 4U; ++index)
+        {
+            if(slots[index] != GROUND_INDEX)
+            {
+                matrix[slots[index]] += SIGNS[index] * conductance;
+            }
+        }
+    }
+
+    /**
+     * \brief SPICE's pnjlim. Past the critical voltage a forward step is taken on the current,
+     *        through the logarithm of the exponential, rather than on the voltage.
+     */
+    double limit_junction(const double proposed, const double previous, const double scale,
+                          const double critical_voltage)
+    {
+        if((proposed <= critical_voltage) || (std::abs(proposed - previous) <= (2.0 * scale)))
+        {
+            return proposed;
+        }
+
+        if(previous > 0.0)
+        {
+            const auto argument = 1.0 + ((proposed - previous) / scale);
+            return (argument > 0.0) ? (previous + (scale * std::log(argument))) : critical_voltage;
+        }
+
+        return scale * std::log(proposed / scale);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Assembles the linear part of the DC system, with the minimum conductance across every
+ *        diode, and finds the matrix entries each diode stamps
+ * \param network
+ * \param ground_uid
+ * \param options
+ *************************************************************************************************/
+Nonlinear_Analysis::Nonlinear_Analysis(const Compiled_Network& network, const uint32_t ground_uid,
+                                       const Nonlinear_Options& options) :
+    analysis(network, ground_uid),
+    options{ options },
+    linear_matrix(analysis.get_system_size(), analysis.get_system_size()),
+    excitation(analysis.get_system_size(), 0.0),
+    junctions()
+{
+    analysis.for_each_stamp(0.0, [&](const std::size_t row, const std::size_t column,
+                                     const std::complex<double>& value)
+    {
+        linear_matrix(row, column) += value.real();
+    });
+
+    const auto sources = analysis.assemble_excitation();
+    for(std::size_t index = 0U; index < sources.size(); ++index)
+    {
+        excitation[index] = sources[index].real();
+    }
+
+    const auto size = analysis.get_system_size();
+    const auto slot = [size](const std::size_t row, const std::size_t column)
+    {
+        return ((row == GROUND_INDEX) || (column == GROUND_INDEX)) ? GROUND_INDEX : ((row * size) + column);
+    };
+
+    for(const auto& element : analysis.get_nonlinear_elements())
+    {
+        Junction junction;
+        junction.uid = element.uid;
+        junction.anode = element.first;
+        junction.cathode = element.second;
+        junction.saturation_current = element.value.real();
+        junction.scale = element.value.imag();
+        junction.critical_voltage = junction.scale *
+            std::log(junction.scale / (std::sqrt(2.0) * junction.saturation_current));
+        junction.slots[0] = slot(element.first, element.first);
+        junction.slots[1] = slot(element.second, element.second);
+        junction.slots[2] = slot(element.first, element.second);
+        junction.slots[3] = slot(element.second, element.first);
+
+        stamp_conductance(linear_matrix.data(), junction.slots, options.minimum_conductance);
+
+        junctions.emplace_back(junction);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and analyses the result
+ * \param network
+ * \param ground_uid
+ * \param options
+ *************************************************************************************************/
+Nonlinear_Analysis::Nonlinear_Analysis(const Network& network, const uint32_t ground_uid,
+                                       const Nonlinear_Options& options) :
+    Nonlinear_Analysis(*network.compile(), ground_uid, options)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Solves from every unknown at zero
+ *************************************************************************************************/
+Nonlinear_Result Nonlinear_Analysis::solve() const
+{
+    return solve(std::vector<double>(analysis.get_system_size(), 0.0));
+}
+
+/**********************************************************************************************//**
+ * \brief Newton-Raphson from the provided unknowns, for example the operating point of a nearby
+ *        circuit
+ * \param initial_unknowns
+ *************************************************************************************************/
+Nonlinear_Result Nonlinear_Analysis::solve(const std::vector<double>& initial_unknowns) const
+{
+    const auto size = analysis.get_system_size();
+    const auto number_of_nodes = analysis.get_node_uids().size();
+
+    Nonlinear_Result result{ {}, initial_unknowns, 0U, 0U, false };
+    result.unknowns.resize(size, 0.0);
+    auto& unknowns = result.unknowns;
+
+    // Junction voltages the diodes are evaluated at, and the conductances in the factorization
+    std::vector<double> voltages(junctions.size());
+    std::vector<double> conductances(junctions.size());
+    for(std::size_t index = 0U; index < junctions.size(); ++index)
+    {
+        voltages[index] = voltage_at(unknowns, junctions[index].anode) -
+                          voltage_at(unknowns, junctions[index].cathode);
+    }
+
+    LU_Factorization<double> factorization;
+    auto refactor = true;
+    auto previous_update = 0.0;
+    std::vector<double> rhs(size);
+
+    while(result.iterations < options.maximum_iterations)
+    {
+        ++result.iterations;
+
+        if(refactor || !options.reuse_jacobian)
+        {
+            auto jacobian = linear_matrix;
+            for(std::size_t index = 0U; index < junctions.size(); ++index)
+            {
+                const auto& junction = junctions[index];
+                conductances[index] = diode_conductance(junction.saturation_current, junction.scale,
+                                                        voltages[index]);
+                stamp_conductance(jacobian.data(), junction.slots, conductances[index]);
+            }
+
+            factorization = LU_Factorization<double>(std::move(jacobian));
+            ++result.factorizations;
+        }
+
+        // Companion current sources, flowing from anode to cathode
+        std::copy(excitation.begin(), excitation.end(), rhs.begin());
+        for(std::size_t index = 0U; index < junctions.size(); ++index)
+        {
+            const auto& junction = junctions[index];
+            const auto equivalent = diode_current(junction.saturation_current, junction.scale, voltages[index]) -
+                                    (conductances[index] * voltages[index]);
+
+            if(junction.anode != GROUND_INDEX)
+            {
+                rhs[junction.anode] -= equivalent;
+            }
+
+            if(junction.cathode != GROUND_INDEX)
+            {
+                rhs[junction.cathode] += equivalent;
+            }
+        }
+
+        const auto next = factorization.solve(rhs);
+
+        // Largest update relative to its tolerance, converged when at most one
+        auto update = 0.0;
+        for(std::size_t index = 0U; index < size; ++index)
+        {
+            const auto absolute = (index < number_of_nodes) ? options.voltage_tolerance : options.current_tolerance;
+            const auto tolerance = (options.relative_tolerance *
+                                    std::max(std::abs(next[index]), std::abs(unknowns[index]))) + absolute;
+            update = std::max(update, std::abs(next[index] - unknowns[index]) / tolerance);
+        }
+
+        auto limited = false;
+        auto consistent = true;
+        for(std::size_t index = 0U; index < junctions.size(); ++index)
+        {
+            const auto& junction = junctions[index];
+            const auto proposed = voltage_at(next, junction.anode) - voltage_at(next, junction.cathode);
+            const auto voltage = limit_junction(proposed, voltages[index], junction.scale,
+                                                junction.critical_voltage);
+
+            if(voltage != proposed)
+            {
+                limited = true;
+            }
+            else if(consistent)
+            {
+                const auto linearised = diode_current(junction.saturation_current, junction.scale, voltages[index]) +
+                                        (conductances[index] * (proposed - voltages[index]));
+                const auto actual = diode_current(junction.saturation_current, junction.scale, proposed);
+                const auto tolerance = (options.relative_tolerance *
+                                        std::max(std::abs(linearised), std::abs(actual))) + options.current_tolerance;
+                consistent = std::abs(linearised - actual) <= tolerance;
+            }
+
+            voltages[index] = voltage;
+        }
+
+        unknowns = next;
+
+        // Without diodes the first solve is already exact
+        if(!limited && consistent && ((update <= 1.0) || junctions.empty()))
+        {
+            result.converged = true;
+            break;
+        }
+
+        refactor = limited || (update > (options.contraction * previous_update));
+        previous_update = update;
+    }
+
+    // The diodes are open to interpret, so their currents are filled in from the junctions
+    std::vector<std::complex<double>> complex_unknowns(unknowns.begin(), unknowns.end());
+    result.solution = analysis.interpret(complex_unknowns, 0.0);
+
+    for(const auto& junction : junctions)
+    {
+        const auto voltage = voltage_at(unknowns, junction.anode) - voltage_at(unknowns, junction.cathode);
+        result.solution.branch_currents[junction.uid] =
+            diode_current(junction.saturation_current, junction.scale, voltage) +
+            (options.minimum_conductance * voltage);
+    }
+
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for analysis, the linear part of the system
+ *************************************************************************************************/
+const Nodal_Analysis& Nonlinear_Analysis::get_nodal_analysis() const
+{
+    return analysis;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for options
+ *************************************************************************************************/
+const Nonlinear_Options& Nonlinear_Analysis::get_options() const
+{
+    return options;
+}
@@ -1,7 +1,19 @@
 #include "circlyzer/phasors.h"
+#include "circlyzer/exceptions.h"
+
+#include <limits>
 
 using namespace std::complex_literals;
 
+namespace Circlyzer
+{
+
+namespace
+{
+    // A few rounding errors per term, enough for closed forms like wL - 1/(wC) at resonance
+    constexpr auto CANCELLATION_TOLERANCE = 64.0 * std::numeric_limits<double>::epsilon();
+}
+
 /**********************************************************************************************//**
  * \brief 
  * \param elements 
@@ -90,4 +102,56 @@ std::complex<float>
 simplify_parallel(const std::complex<float>& one, const std::complex<float>& two)
 {
     return (one * two) / (one + two);
-}
\ No newline at end of file
+}
+
+/**********************************************************************************************//**
+ * \brief Equivalent star of a triangle: each arm is the product of the two adjacent sides over
+ *        the sum of all three
+ * \param delta
+ *************************************************************************************************/
+Wye_Impedances
+delta_to_wye(const Delta_Impedances& delta)
+{
+    const auto sum = simplify_series({ delta.ab, delta.bc, delta.ca });
+    if(is_cancelled(sum, std::abs(delta.ab) + std::abs(delta.bc) + std::abs(delta.ca)))
+    {
+        throw Degenerate_Transform_Exception();
+    }
+
+    return { (delta.ab * delta.ca) / sum,
+             (delta.ab * delta.bc) / sum,
+             (delta.bc * delta.ca) / sum };
+}
+
+/**********************************************************************************************//**
+ * \brief Equivalent triangle of a star: each side is the sum of the pairwise arm products over
+ *        the opposite arm
+ * \param wye
+ *************************************************************************************************/
+Delta_Impedances
+wye_to_delta(const Wye_Impedances& wye)
+{
+    if((wye.a == 0.0) || (wye.b == 0.0) || (wye.c == 0.0))
+    {
+        throw Degenerate_Transform_Exception();
+    }
+
+    const auto products = simplify_series({ wye.a * wye.b, wye.b * wye.c, wye.c * wye.a });
+
+    return { products / wye.c,
+             products / wye.a,
+             products / wye.b };
+}
+
+/**********************************************************************************************//**
+ * \brief Whether a sum vanished next to its terms, as series reactances do at resonance
+ * \param sum
+ * \param magnitude Sum of the magnitudes of the terms
+ *************************************************************************************************/
+bool
+is_cancelled(const std::complex<double>& sum, const double magnitude)
+{
+    return std::abs(sum) <= (CANCELLATION_TOLERANCE * magnitude);
+}
+
+} // namespace Circlyzer
@@ -0,0 +1,531 @@
+#include "circlyzer/port_parameters.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <string_view>
+
+using namespace Circlyzer;
+
+namespace
+{
+
+using Complex = std::complex<double>;
+
+constexpr char BINARY_MAGIC[4] = { 'C', 'Z', 'N', 'P' };
+constexpr uint32_t BINARY_VERSION = 1U;
+constexpr uint32_t MAXIMUM_BINARY_PORTS = 4096U;
+constexpr std::size_t NUMBER_BUFFER_SIZE = 64U;
+constexpr std::size_t PAIRS_PER_LINE = 4U;
+
+/**********************************************************************************************//**
+ * \brief Plain row by row product, the matrices here are only port by port
+ *************************************************************************************************/
+Dense_Matrix<Complex> multiply(const Dense_Matrix<Complex>& one, const Dense_Matrix<Complex>& two)
+{
+    Dense_Matrix<Complex> result(one.get_number_of_rows(), two.get_number_of_columns());
+
+    for(std::size_t row = 0U; row < one.get_number_of_rows(); ++row)
+    {
+        for(std::size_t inner = 0U; inner < one.get_number_of_columns(); ++inner)
+        {
+            const auto factor = one(row, inner);
+            for(std::size_t column = 0U; column < two.get_number_of_columns(); ++column)
+            {
+                result(row, column) += factor * two(inner, column);
+            }
+        }
+    }
+
+    return result;
+}
+
+Dense_Matrix<Complex> identity(const std::size_t size)
+{
+    Dense_Matrix<Complex> result(size, size);
+    for(std::size_t index = 0U; index < size; ++index)
+    {
+        result(index, index) = 1.0;
+    }
+
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Writes one %.12g formatted number, separated from the one before it by a space
+ *************************************************************************************************/
+void write_number(Output_Sink& sink, const double value, const bool separate = true)
+{
+    char buffer[NUMBER_BUFFER_SIZE];
+    const auto length = std::snprintf(buffer, sizeof(buffer), separate ? " %.12g" : "%.12g", value);
+    sink.write(std::string_view(buffer, static_cast<std::size_t>(length)));
+}
+
+template<typename Value>
+void write_raw(Output_Sink& sink, const Value& value)
+{
+    char bytes[sizeof(Value)];
+    std::memcpy(bytes, &value, sizeof(Value));
+    sink.write(std::string_view(bytes, sizeof(Value)));
+}
+
+template<typename Value>
+Value read_raw(std::istream& stream)
+{
+    char bytes[sizeof(Value)];
+    if(!stream.read(bytes, sizeof(Value)))
+    {
+        throw Invalid_Parameter_Stream_Exception();
+    }
+
+    Value value;
+    std::memcpy(&value, bytes, sizeof(Value));
+    return value;
+}
+
+/**********************************************************************************************//**
+ * \brief Bytes left in a seekable stream, or the largest value when the stream can't tell
+ *************************************************************************************************/
+uint64_t remaining_bytes(std::istream& stream)
+{
+    const auto position = stream.tellg();
+    if(position < 0)
+    {
+        stream.clear();
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    stream.seekg(0, std::ios::end);
+    const auto end = stream.tellg();
+    stream.seekg(position);
+
+    if((end < position) || !stream)
+    {
+        stream.clear();
+        stream.seekg(position);
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    return static_cast<uint64_t>(end - position);
+}
+
+const char* type_name(const Parameter_Type type)
+{
+    switch(type)
+    {
+        case Parameter_Type::Y: return "Y";
+        case Parameter_Type::S: return "S";
+        default:                return "Z";
+    }
+}
+
+} // namespace
+
+/**********************************************************************************************//**
+ * \brief Captures the network and locates each port's terminals among the unknowns
+ * \param network
+ * \param ground_uid
+ * \param ports
+ *************************************************************************************************/
+Port_Analysis::Port_Analysis(const Compiled_Network& network, const uint32_t ground_uid,
+                             const std::vector<Port>& ports) :
+    analysis(network, ground_uid),
+    ports(ports),
+    positive_indices(),
+    negative_indices()
+{
+    if(ports.empty())
+    {
+        throw Invalid_Port_Pair_Exception();
+    }
+
+    // Validates the terminals, and matches Nodal_Analysis in shifting nodes after the ground down
+    const auto ground_index = network.get_node_index(ground_uid);
+    const auto index_of = [&](const uint32_t uid) -> std::size_t
+    {
+        const auto node_index = network.get_node_index(uid);
+        if(node_index == ground_index)
+        {
+            return Nodal_Analysis::GROUND_INDEX;
+        }
+
+        return (node_index < ground_index) ? node_index : (node_index - 1U);
+    };
+
+    for(const auto& port : ports)
+    {
+        if((port.positive_uid == port.negative_uid) || !(port.reference_impedance > 0.0))
+        {
+            throw Invalid_Port_Pair_Exception();
+        }
+
+        positive_indices.emplace_back(index_of(port.positive_uid));
+        negative_indices.emplace_back(index_of(port.negative_uid));
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and analyses the result
+ * \param network
+ * \param ground_uid
+ * \param ports
+ *************************************************************************************************/
+Port_Analysis::Port_Analysis(const Network& network, const uint32_t ground_uid,
+                             const std::vector<Port>& ports) :
+    Port_Analysis(*network.compile(), ground_uid, ports)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Open circuit impedance matrix. Column j holds the port voltages when only port j is
+ *        driven with one ampere, all ports are solved as a single block.
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Port_Analysis::get_impedance_matrix(const double frequency) const
+{
+    constexpr auto GROUND = Nodal_Analysis::GROUND_INDEX;
+
+    const auto number_of_ports = ports.size();
+    const LU_Factorization<Complex> factorization(analysis.assemble_matrix(frequency));
+
+    // The source rows are left at zero, which shorts every independent voltage source
+    Dense_Matrix<Complex> excitation(analysis.get_system_size(), number_of_ports);
+    for(std::size_t port = 0U; port < number_of_ports; ++port)
+    {
+        if(positive_indices[port] != GROUND)
+        {
+            excitation(positive_indices[port], port) += 1.0;
+        }
+
+        if(negative_indices[port] != GROUND)
+        {
+            excitation(negative_indices[port], port) -= 1.0;
+        }
+    }
+
+    const auto response = factorization.solve(excitation);
+
+    Dense_Matrix<Complex> impedance(number_of_ports, number_of_ports);
+    for(std::size_t row = 0U; row < number_of_ports; ++row)
+    {
+        for(std::size_t column = 0U; column < number_of_ports; ++column)
+        {
+            const auto positive = (positive_indices[row] == GROUND) ?
+                Complex{ 0.0 } : response(positive_indices[row], column);
+            const auto negative = (negative_indices[row] == GROUND) ?
+                Complex{ 0.0 } : response(negative_indices[row], column);
+
+            impedance(row, column) = positive - negative;
+        }
+    }
+
+    return impedance;
+}
+
+/**********************************************************************************************//**
+ * \brief Short circuit admittance matrix, the inverse of Z
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Port_Analysis::get_admittance_matrix(const double frequency) const
+{
+    const LU_Factorization<Complex> factorization(get_impedance_matrix(frequency));
+    return factorization.solve(identity(ports.size()));
+}
+
+/**********************************************************************************************//**
+ * \brief Power wave scattering matrix against each port's reference impedance
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Port_Analysis::get_scattering_matrix(const double frequency) const
+{
+    const auto number_of_ports = ports.size();
+    auto difference = get_impedance_matrix(frequency);
+    auto sum = difference;
+
+    for(std::size_t port = 0U; port < number_of_ports; ++port)
+    {
+        difference(port, port) -= ports[port].reference_impedance;
+        sum(port, port) += ports[port].reference_impedance;
+    }
+
+    const LU_Factorization<Complex> factorization(std::move(sum));
+    auto scattering = multiply(difference, factorization.solve(identity(number_of_ports)));
+
+    for(std::size_t row = 0U; row < number_of_ports; ++row)
+    {
+        for(std::size_t column = 0U; column < number_of_ports; ++column)
+        {
+            scattering(row, column) *= std::sqrt(ports[column].reference_impedance /
+                                                 ports[row].reference_impedance);
+        }
+    }
+
+    return scattering;
+}
+
+/**********************************************************************************************//**
+ * \brief Dispatches on the parameter type
+ * \param type
+ * \param frequency
+ *************************************************************************************************/
+Dense_Matrix<std::complex<double>> Port_Analysis::get_parameters(const Parameter_Type type,
+                                                                 const double frequency) const
+{
+    switch(type)
+    {
+        case Parameter_Type::Y: return get_admittance_matrix(frequency);
+        case Parameter_Type::S: return get_scattering_matrix(frequency);
+        default:                return get_impedance_matrix(frequency);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Parameters at every frequency, solved in parallel
+ * \param type
+ * \param frequencies
+ * \param executor
+ *************************************************************************************************/
+Port_Parameters Port_Analysis::extract(const Parameter_Type type, const std::vector<double>& frequencies,
+                                       Executor& executor) const
+{
+    Port_Parameters parameters;
+    parameters.type = type;
+    parameters.frequencies = frequencies;
+    parameters.matrices.resize(frequencies.size());
+
+    for(const auto& port : ports)
+    {
+        parameters.reference_impedances.emplace_back(port.reference_impedance);
+    }
+
+    executor.parallel_for(0U, frequencies.size(), [&](const std::size_t first, const std::size_t last)
+    {
+        for(auto index = first; index < last; ++index)
+        {
+            parameters.matrices[index] = get_parameters(type, frequencies[index]);
+        }
+    });
+
+    return parameters;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for ports
+ *************************************************************************************************/
+const std::vector<Port>& Port_Analysis::get_ports() const
+{
+    return ports;
+}
+
+/**********************************************************************************************//**
+ * \brief Touchstone writer, see the header for the version chosen
+ * \param parameters
+ * \param sink
+ *************************************************************************************************/
+void Circlyzer::write_touchstone(const Port_Parameters& parameters, Output_Sink& sink)
+{
+    const auto number_of_ports = parameters.reference_impedances.size();
+    const auto& references = parameters.reference_impedances;
+    const auto uniform = std::all_of(references.begin(), references.end(),
+                                     [&](const double value) { return value == references.front(); });
+
+    const auto reference = references.empty() ? 50.0 : references.front();
+
+    // Version 1 Z and Y data is normalised to the reference, version 2 data is not
+    auto scale = 1.0;
+    if(uniform && (parameters.type == Parameter_Type::Z))
+    {
+        scale = 1.0 / reference;
+    }
+    else if(uniform && (parameters.type == Parameter_Type::Y))
+    {
+        scale = reference;
+    }
+
+    sink.write("! Circlyzer ");
+    sink.write(std::to_string(number_of_ports));
+    sink.write("-port ");
+    sink.write(type_name(parameters.type));
+    sink.write(" parameters\n");
+
+    if(!uniform)
+    {
+        sink.write("[Version] 2.0\n");
+    }
+
+    sink.write("# Hz ");
+    sink.write(type_name(parameters.type));
+    sink.write(" RI R");
+    write_number(sink, reference);
+    sink.write('\n');
+
+    if(!uniform)
+    {
+        sink.write("[Number of Ports] ");
+        sink.write(std::to_string(number_of_ports));
+        sink.write('\n');
+
+        if(number_of_ports == 2U)
+        {
+            sink.write("[Two-Port Data Order] 21_12\n");
+        }
+
+        sink.write("[Number of Frequencies] ");
+        sink.write(std::to_string(parameters.frequencies.size()));
+        sink.write("\n[Reference]");
+        for(const auto value : references)
+        {
+            write_number(sink, value);
+        }
+
+        sink.write("\n[Network Data]\n");
+    }
+
+    for(std::size_t index = 0U; index < parameters.frequencies.size(); ++index)
+    {
+        const auto& matrix = parameters.matrices[index];
+        write_number(sink, parameters.frequencies[index] / (2.0 * std::numbers::pi), false);
+
+        const auto write_entry = [&](const std::size_t row, const std::size_t column)
+        {
+            write_number(sink, matrix(row, column).real() * scale);
+            write_number(sink, matrix(row, column).imag() * scale);
+        };
+
+        if(number_of_ports == 2U)
+        {
+            // Two-port data is the one exception to row major order
+            write_entry(0U, 0U);
+            write_entry(1U, 0U);
+            write_entry(0U, 1U);
+            write_entry(1U, 1U);
+            sink.write('\n');
+            continue;
+        }
+
+        // Larger networks give each row its own line, wrapped every four entries
+        for(std::size_t row = 0U; row < number_of_ports; ++row)
+        {
+            for(std::size_t column = 0U; column < number_of_ports; ++column)
+            {
+                if((column > 0U) && ((column % PAIRS_PER_LINE) == 0U))
+                {
+                    sink.write('\n');
+                }
+
+                write_entry(row, column);
+            }
+
+            sink.write('\n');
+        }
+    }
+
+    if(!uniform)
+    {
+        sink.write("[End]\n");
+    }
+
+    sink.flush();
+}
+
+/**********************************************************************************************//**
+ * \brief Binary writer, see the header for the layout
+ * \param parameters
+ * \param sink
+ *************************************************************************************************/
+void Circlyzer::write_binary_parameters(const Port_Parameters& parameters, Output_Sink& sink)
+{
+    const auto number_of_ports = static_cast<uint32_t>(parameters.reference_impedances.size());
+
+    sink.write(std::string_view(BINARY_MAGIC, sizeof(BINARY_MAGIC)));
+    write_raw(sink, BINARY_VERSION);
+    write_raw(sink, static_cast<uint8_t>(parameters.type));
+    write_raw(sink, number_of_ports);
+    write_raw(sink, static_cast<uint32_t>(parameters.frequencies.size()));
+
+    for(const auto value : parameters.reference_impedances)
+    {
+        write_raw(sink, value);
+    }
+
+    for(std::size_t index = 0U; index < parameters.frequencies.size(); ++index)
+    {
+        write_raw(sink, parameters.frequencies[index]);
+
+        const auto& matrix = parameters.matrices[index];
+        const auto count = static_cast<std::size_t>(number_of_ports) * number_of_ports;
+        sink.write(std::string_view(reinterpret_cast<const char*>(matrix.data()), count * sizeof(Complex)));
+    }
+
+    sink.flush();
+}
+
+/**********************************************************************************************//**
+ * \brief Binary reader
+ * \param stream
+ *************************************************************************************************/
+Port_Parameters Circlyzer::read_binary_parameters(std::istream& stream)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    if(!stream.read(magic, sizeof(magic)) || (std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0) ||
+       (read_raw<uint32_t>(stream) != BINARY_VERSION))
+    {
+        throw Invalid_Parameter_Stream_Exception();
+    }
+
+    const auto type = read_raw<uint8_t>(stream);
+    if(type > static_cast<uint8_t>(Parameter_Type::S))
+    {
+        throw Invalid_Parameter_Stream_Exception();
+    }
+
+    Port_Parameters parameters;
+    parameters.type = static_cast<Parameter_Type>(type);
+
+    const auto number_of_ports = read_raw<uint32_t>(stream);
+    const auto number_of_frequencies = read_raw<uint32_t>(stream);
+
+    // A corrupt header must not drive the allocations below. Ports are capped outright, which
+    // also keeps the sizes from overflowing, and a seekable stream must hold what it promises.
+    if(number_of_ports > MAXIMUM_BINARY_PORTS)
+    {
+        throw Invalid_Parameter_Stream_Exception();
+    }
+
+    const auto reference_bytes = static_cast<uint64_t>(number_of_ports) * sizeof(double);
+    const auto point_bytes = sizeof(double) +
+                             (static_cast<uint64_t>(number_of_ports) * number_of_ports * sizeof(Complex));
+    const auto remaining = remaining_bytes(stream);
+    if((reference_bytes > remaining) ||
+       (number_of_frequencies > ((remaining - reference_bytes) / point_bytes)))
+    {
+        throw Invalid_Parameter_Stream_Exception();
+    }
+
+    for(uint32_t port = 0U; port < number_of_ports; ++port)
+    {
+        parameters.reference_impedances.emplace_back(read_raw<double>(stream));
+    }
+
+    for(uint32_t index = 0U; index < number_of_frequencies; ++index)
+    {
+        parameters.frequencies.emplace_back(read_raw<double>(stream));
+
+        Dense_Matrix<Complex> matrix(number_of_ports, number_of_ports);
+        const auto bytes = static_cast<std::streamsize>(static_cast<std::size_t>(number_of_ports) *
+                                                        number_of_ports * sizeof(Complex));
+        if(!stream.read(reinterpret_cast<char*>(matrix.data()), bytes))
+        {
+            throw Invalid_Parameter_Stream_Exception();
+        }
+
+        parameters.matrices.emplace_back(std::move(matrix));
+    }
+
+    return parameters;
+}
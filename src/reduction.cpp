@@ -0,0 +1,920 @@
+#include "circlyzer/reduction.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/impedance_table.h"
+#include "circlyzer/phasors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr std::size_t TRIANGLE = 3U;
+
+    // A delta-wye step adds a node, so it is only taken when it frees at least two others
+    constexpr std::size_t MINIMUM_DELTA_TO_WYE_SCORE = 2U;
+
+    bool is_finite(const std::complex<double>& value)
+    {
+        return std::isfinite(value.real()) && std::isfinite(value.imag());
+    }
+
+    /**
+     * \brief Capacitances transform like admittances, so they are inverted on the way in and
+     *        back out. Resistances and inductances transform like impedances.
+     */
+    double to_transform_value(const Component_Type type, const double value)
+    {
+        return (type == Component_Type::Capacitor) ? (1.0 / value) : value;
+    }
+
+    std::unique_ptr<Component> make_component(const Component_Type type, const double value)
+    {
+        switch(type)
+        {
+            case Component_Type::Capacitor: return std::make_unique<Capacitor>(value);
+            case Component_Type::Inductor:  return std::make_unique<Inductor>(value);
+            default:                        return std::make_unique<Resistor>(value);
+        }
+    }
+
+    uint32_t add_branch(Network& network, const Component_Type type, const double transformed,
+                        const uint32_t first, const uint32_t second)
+    {
+        const auto uid = network.create_branch(make_component(type, to_transform_value(type, transformed)));
+        network.create_connection_between(first, uid);
+        network.create_connection_between(second, uid);
+        return uid;
+    }
+
+    /**
+     * \brief Checks a branch can take part in a transform, returning its component type
+     */
+    Component_Type transformable_type(const Branch& branch)
+    {
+        if((branch.nodes.size() != 2U) || (branch.nodes[0] == branch.nodes[1]) ||
+           (branch.component->type == Component_Type::Voltage_Source) ||
+           (branch.component->type == Component_Type::Diode))
+        {
+            throw Invalid_Transform_Exception();
+        }
+
+        return branch.component->type;
+    }
+
+    /**
+     * \brief Undirected impedance graph with at most one edge per node pair. An edge is never
+     *        zero: a short merges its two nodes instead, keeping a pinned node, such as a port,
+     *        when there is one. Every node whose neighbourhood changes is recorded as touched.
+     */
+    class Reduction_Graph
+    {
+    public:
+        using Neighbours = std::map<std::size_t, std::complex<double>>;
+
+        explicit Reduction_Graph(const std::size_t number_of_nodes) :
+            adjacency(number_of_nodes),
+            alive(number_of_nodes, true),
+            number_alive{ number_of_nodes },
+            pinned(number_of_nodes, false),
+            merged_into(number_of_nodes),
+            shorts(),
+            touched(),
+            shorting{ false },
+            pins_shorted{ false }
+        {
+            std::iota(merged_into.begin(), merged_into.end(), 0U);
+        }
+
+        std::size_t add_node()
+        {
+            adjacency.emplace_back();
+            alive.emplace_back(true);
+            ++number_alive;
+            pinned.emplace_back(false);
+            merged_into.emplace_back(adjacency.size() - 1U);
+            touched.emplace_back(adjacency.size() - 1U);
+            return adjacency.size() - 1U;
+        }
+
+        void pin(const std::size_t node)
+        {
+            pinned[node] = true;
+        }
+
+        /**
+         * \brief Adds an edge, combining it in parallel with any edge already there. Endpoints
+         *        that were merged away are followed to the node they were merged into.
+         */
+        void connect(std::size_t first, std::size_t second, const std::complex<double>& impedance,
+                     Reduction_Result& result)
+        {
+            first = find(first);
+            second = find(second);
+            if((first == second) || !is_finite(impedance))
+            {
+                return;
+            }
+
+            if(impedance == 0.0)
+            {
+                short_circuit(first, second, result);
+                return;
+            }
+
+            const auto existing = adjacency[first].find(second);
+            if(existing == adjacency[first].end())
+            {
+                adjacency[first].emplace(second, impedance);
+                adjacency[second].emplace(first, impedance);
+                touched.insert(touched.end(), { first, second });
+                return;
+            }
+
+            ++result.parallel;
+
+            // Parallel resonance leaves an open circuit
+            if(is_cancelled(existing->second + impedance, std::abs(existing->second) + std::abs(impedance)))
+            {
+                disconnect(first, second);
+                return;
+            }
+
+            const auto combined = simplify_parallel(existing->second, impedance);
+            existing->second = combined;
+            adjacency[second][first] = combined;
+        }
+
+        /**
+         * \brief Merges two nodes joined by a short, moving every edge of one onto the other.
+         *        Edges that meet in parallel are combined, which may short further nodes, so
+         *        shorts are queued and drained here rather than merged recursively.
+         */
+        void short_circuit(const std::size_t first, const std::size_t second, Reduction_Result& result)
+        {
+            shorts.emplace_back(first, second);
+            if(shorting)
+            {
+                return;
+            }
+
+            shorting = true;
+            while(!shorts.empty())
+            {
+                auto [kept, merged] = shorts.back();
+                shorts.pop_back();
+
+                kept = find(kept);
+                merged = find(merged);
+                if(kept == merged)
+                {
+                    continue;
+                }
+
+                if(pinned[merged])
+                {
+                    if(pinned[kept])
+                    {
+                        pins_shorted = true;
+                        continue;
+                    }
+
+                    std::swap(kept, merged);
+                }
+
+                const auto neighbours = adjacency[merged];
+                remove(merged);
+                merged_into[merged] = kept;
+                touched.emplace_back(kept);
+
+                for(const auto& [neighbour, impedance] : neighbours)
+                {
+                    connect(kept, neighbour, impedance, result);
+                }
+            }
+
+            shorting = false;
+        }
+
+        void disconnect(const std::size_t first, const std::size_t second)
+        {
+            adjacency[first].erase(second);
+            adjacency[second].erase(first);
+            touched.insert(touched.end(), { first, second });
+        }
+
+        void remove(const std::size_t node)
+        {
+            for(const auto& [neighbour, impedance] : adjacency[node])
+            {
+                adjacency[neighbour].erase(node);
+                touched.emplace_back(neighbour);
+            }
+
+            adjacency[node].clear();
+            touched.emplace_back(node);
+
+            if(alive[node])
+            {
+                alive[node] = false;
+                --number_alive;
+            }
+        }
+
+        const Neighbours& get_neighbours(const std::size_t node) const
+        {
+            return adjacency[node];
+        }
+
+        bool is_adjacent(const std::size_t first, const std::size_t second) const
+        {
+            return adjacency[first].count(second) != 0U;
+        }
+
+        std::size_t get_degree(const std::size_t node) const
+        {
+            return adjacency[node].size();
+        }
+
+        bool is_alive(const std::size_t node) const
+        {
+            return alive[node];
+        }
+
+        std::size_t get_number_alive() const
+        {
+            return number_alive;
+        }
+
+        // Whether a short joined two pinned nodes
+        bool are_pins_shorted() const
+        {
+            return pins_shorted;
+        }
+
+        std::size_t get_size() const
+        {
+            return adjacency.size();
+        }
+
+        /**
+         * \brief Hands over the nodes touched since the last call
+         */
+        std::vector<std::size_t> take_touched()
+        {
+            return std::exchange(touched, {});
+        }
+
+    private:
+        std::size_t find(std::size_t node)
+        {
+            while(merged_into[node] != node)
+            {
+                merged_into[node] = merged_into[merged_into[node]];
+                node = merged_into[node];
+            }
+
+            return node;
+        }
+
+        std::vector<Neighbours> adjacency;
+        std::vector<bool> alive;
+        std::size_t number_alive;
+        std::vector<bool> pinned;
+        std::vector<std::size_t> merged_into;
+        std::vector<std::pair<std::size_t, std::size_t>> shorts;
+        std::vector<std::size_t> touched;
+        bool shorting;
+        bool pins_shorted;
+    };
+
+    using Triangle = std::array<std::size_t, TRIANGLE>;
+
+    constexpr auto NO_CANDIDATE = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * \brief Transform candidate ordered by descending score, then by its nodes, so the first
+     *        candidate is the one a scan in node order would pick
+     */
+    template<typename Nodes>
+    struct Candidate
+    {
+        std::size_t score;
+        Nodes nodes;
+
+        bool operator<(const Candidate& other) const
+        {
+            return (score != other.score) ? (score > other.score) : (nodes < other.nodes);
+        }
+    };
+
+    /**
+     * \brief Reduces the graph step by step. Candidate stars, triangles and node degrees are kept
+     *        in ordered sets and rescored only around the nodes a step touched.
+     */
+    class Reducer
+    {
+    public:
+        Reducer(Reduction_Graph& graph, const std::size_t first_port, const std::size_t second_port,
+                const Reduction_Options& options, Reduction_Result& result) :
+            graph(graph),
+            first_port{ first_port },
+            second_port{ second_port },
+            options(options),
+            result(result),
+            pending(),
+            dirty(),
+            star_scores(),
+            stars(),
+            triangle_scores(),
+            triangles(),
+            recorded_degrees(),
+            degrees()
+        {
+
+        }
+
+        void run()
+        {
+            for(std::size_t node = 0U; node < graph.get_size(); ++node)
+            {
+                pending.emplace_back(node);
+                dirty.emplace_back(node);
+            }
+
+            simplify();
+            while(!graph.are_pins_shorted() && has_interior_nodes())
+            {
+                transform();
+                simplify();
+            }
+        }
+
+    private:
+        bool is_port(const std::size_t node) const
+        {
+            return (node == first_port) || (node == second_port);
+        }
+
+        bool is_interior(const std::size_t node) const
+        {
+            return graph.is_alive(node) && !is_port(node);
+        }
+
+        // The ports are pinned, so they are never merged away
+        bool has_interior_nodes() const
+        {
+            return graph.get_number_alive() > 2U;
+        }
+
+        /**
+         * \brief Removes dangling branches and merges series pairs until neither applies
+         */
+        void simplify()
+        {
+            while(collect_touched(), !pending.empty())
+            {
+                const auto node = pending.back();
+                pending.pop_back();
+
+                if(!is_interior(node))
+                {
+                    continue;
+                }
+
+                const auto& neighbours = graph.get_neighbours(node);
+                if(neighbours.size() > 2U)
+                {
+                    continue;
+                }
+
+                std::vector<std::pair<std::size_t, std::complex<double>>> ends(neighbours.begin(),
+                                                                                neighbours.end());
+                graph.remove(node);
+
+                if(ends.size() == 2U)
+                {
+                    ++result.series;
+
+                    // Series resonance leaves a short, which the graph merges
+                    auto impedance = simplify_series({ ends[0].second, ends[1].second });
+                    if(is_cancelled(impedance, std::abs(ends[0].second) + std::abs(ends[1].second)))
+                    {
+                        impedance = 0.0;
+                    }
+
+                    graph.connect(ends[0].first, ends[1].first, impedance, result);
+                }
+            }
+        }
+
+        void collect_touched()
+        {
+            const auto touched = graph.take_touched();
+            pending.insert(pending.end(), touched.begin(), touched.end());
+            dirty.insert(dirty.end(), touched.begin(), touched.end());
+        }
+
+        /**
+         * \brief Rescores the candidates that depend on a touched node: its own degree, the stars
+         *        it belongs to and the triangles through it. A triangle only scores when two of
+         *        its nodes would be freed, so triangles are found through a neighbour that would.
+         */
+        void refresh_candidates()
+        {
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+            star_scores.resize(graph.get_size(), NO_CANDIDATE);
+            recorded_degrees.resize(graph.get_size(), NO_CANDIDATE);
+
+            for(const auto node : dirty)
+            {
+                refresh_degree(node);
+                refresh_star(node);
+
+                for(const auto& [b, impedance] : graph.get_neighbours(node))
+                {
+                    refresh_star(b);
+
+                    if(freed(b, graph.get_degree(b) - 1U) == 0U)
+                    {
+                        continue;
+                    }
+
+                    for(const auto& [c, other] : graph.get_neighbours(b))
+                    {
+                        if((c != node) && graph.is_adjacent(node, c))
+                        {
+                            Triangle triangle = { node, b, c };
+                            std::sort(triangle.begin(), triangle.end());
+                            refresh_triangle(triangle);
+                        }
+                    }
+                }
+            }
+
+            dirty.clear();
+        }
+
+        void refresh_degree(const std::size_t node)
+        {
+            if(recorded_degrees[node] != NO_CANDIDATE)
+            {
+                degrees.erase({ recorded_degrees[node], node });
+                recorded_degrees[node] = NO_CANDIDATE;
+            }
+
+            if(is_interior(node))
+            {
+                recorded_degrees[node] = graph.get_degree(node);
+                degrees.emplace(recorded_degrees[node], node);
+            }
+        }
+
+        void refresh_star(const std::size_t node)
+        {
+            if(star_scores[node] != NO_CANDIDATE)
+            {
+                stars.erase({ star_scores[node], node });
+                star_scores[node] = NO_CANDIDATE;
+            }
+
+            if(is_interior(node) && (graph.get_degree(node) == TRIANGLE))
+            {
+                star_scores[node] = score_wye_to_delta(node);
+                stars.insert({ star_scores[node], node });
+            }
+        }
+
+        void refresh_triangle(const Triangle& triangle)
+        {
+            const auto score = score_delta_to_wye(triangle);
+            const auto existing = triangle_scores.find(triangle);
+            if(existing != triangle_scores.end())
+            {
+                if(existing->second == score)
+                {
+                    return;
+                }
+
+                triangles.erase({ existing->second, triangle });
+                triangle_scores.erase(existing);
+            }
+
+            if(score >= MINIMUM_DELTA_TO_WYE_SCORE)
+            {
+                triangle_scores.emplace(triangle, score);
+                triangles.insert({ score, triangle });
+            }
+        }
+
+        /**
+         * \brief Best triangle still in the graph. Triangles that lost an edge or most of their
+         *        score may no longer be found from a touched node, so they are rechecked here.
+         */
+        std::optional<Candidate<Triangle>> find_best_triangle()
+        {
+            while(!triangles.empty())
+            {
+                const auto best = *triangles.begin();
+                const auto& [a, b, c] = best.nodes;
+                if(!graph.is_adjacent(a, b) || !graph.is_adjacent(b, c) || !graph.is_adjacent(c, a))
+                {
+                    triangles.erase(triangles.begin());
+                    triangle_scores.erase(best.nodes);
+                }
+                else if(score_delta_to_wye(best.nodes) != best.score)
+                {
+                    refresh_triangle(best.nodes);
+                }
+                else
+                {
+                    return best;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        /**
+         * \brief Whether a node would be removed by simplify() at the given degree
+         */
+        std::size_t freed(const std::size_t node, const std::size_t new_degree) const
+        {
+            return (!is_port(node) && (new_degree <= 2U)) ? 1U : 0U;
+        }
+
+        std::size_t score_wye_to_delta(const std::size_t node) const
+        {
+            std::array<std::size_t, TRIANGLE> outer{};
+            std::size_t index = 0U;
+            for(const auto& entry : graph.get_neighbours(node))
+            {
+                outer[index++] = entry.first;
+            }
+
+            std::size_t score = 0U;
+            for(std::size_t side = 0U; side < TRIANGLE; ++side)
+            {
+                const auto here = outer[side];
+                const auto next = outer[(side + 1U) % TRIANGLE];
+                const auto previous = outer[(side + 2U) % TRIANGLE];
+
+                // Sides that already exist merge in parallel
+                score += graph.is_adjacent(here, next) ? 1U : 0U;
+
+                const auto existing = (graph.is_adjacent(here, next) ? 1U : 0U) +
+                                      (graph.is_adjacent(here, previous) ? 1U : 0U);
+                score += freed(here, graph.get_degree(here) + 1U - existing);
+            }
+
+            return score;
+        }
+
+        std::size_t score_delta_to_wye(const Triangle& triangle) const
+        {
+            std::size_t score = 0U;
+            for(const auto node : triangle)
+            {
+                score += freed(node, graph.get_degree(node) - 1U);
+            }
+
+            return score;
+        }
+
+        /**
+         * \brief Eliminates a node, connecting every pair of its neighbours. A node with three
+         *        neighbours is the wye-delta transform.
+         */
+        bool eliminate(const std::size_t node)
+        {
+            const auto neighbours = graph.get_neighbours(node);
+            std::vector<std::size_t> outer;
+            std::vector<std::complex<double>> mesh;
+
+            std::complex<double> total_admittance{ 0.0 };
+            double magnitude = 0.0;
+            for(const auto& entry : neighbours)
+            {
+                total_admittance += 1.0 / entry.second;
+                magnitude += 1.0 / std::abs(entry.second);
+            }
+
+            // When the node's admittances cancel, it shorts its neighbours together
+            const auto resonant = is_cancelled(total_admittance, magnitude);
+
+            if((neighbours.size() == TRIANGLE) && !resonant)
+            {
+                auto it = neighbours.begin();
+                const auto a = *it++;
+                const auto b = *it++;
+                const auto c = *it;
+
+                const auto delta = wye_to_delta({ a.second, b.second, c.second });
+                if(!is_finite(delta.ab) || !is_finite(delta.bc) || !is_finite(delta.ca))
+                {
+                    return false;
+                }
+
+                outer = { a.first, b.first, b.first, c.first, c.first, a.first };
+                mesh = { delta.ab, delta.bc, delta.ca };
+                ++result.wye_to_delta;
+            }
+            else
+            {
+                for(auto first = neighbours.begin(); first != neighbours.end(); ++first)
+                {
+                    for(auto second = std::next(first); second != neighbours.end(); ++second)
+                    {
+                        outer.insert(outer.end(), { first->first, second->first });
+                        mesh.emplace_back(resonant ? 0.0 : (first->second * second->second * total_admittance));
+                    }
+                }
+                ++result.star_mesh;
+            }
+
+            graph.remove(node);
+            for(std::size_t side = 0U; side < mesh.size(); ++side)
+            {
+                graph.connect(outer[2U * side], outer[(2U * side) + 1U], mesh[side], result);
+            }
+
+            return true;
+        }
+
+        bool replace_triangle(const Triangle& triangle)
+        {
+            const auto& [a, b, c] = triangle;
+            const Delta_Impedances delta{ graph.get_neighbours(a).at(b), graph.get_neighbours(b).at(c),
+                                          graph.get_neighbours(c).at(a) };
+
+            // A triangle that resonates around its loop has no equivalent star
+            if(is_cancelled(delta.ab + delta.bc + delta.ca,
+                            std::abs(delta.ab) + std::abs(delta.bc) + std::abs(delta.ca)))
+            {
+                return false;
+            }
+
+            const auto wye = delta_to_wye(delta);
+            if(!is_finite(wye.a) || !is_finite(wye.b) || !is_finite(wye.c))
+            {
+                return false;
+            }
+
+            graph.disconnect(a, b);
+            graph.disconnect(b, c);
+            graph.disconnect(c, a);
+
+            const auto star = graph.add_node();
+            graph.connect(a, star, wye.a, result);
+            graph.connect(b, star, wye.b, result);
+            graph.connect(c, star, wye.c, result);
+
+            ++result.delta_to_wye;
+            return true;
+        }
+
+        /**
+         * \brief Applies the transform that frees the most nodes for series/parallel reduction,
+         *        preferring wye-delta on ties as it never adds a node
+         */
+        void transform()
+        {
+            refresh_candidates();
+
+            const auto star = stars.empty() ? std::nullopt : std::optional(*stars.begin());
+            const auto triangle = find_best_triangle();
+
+            if(triangle && (!star || (triangle->score > star->score)) && replace_triangle(triangle->nodes))
+            {
+                return;
+            }
+
+            if(star && eliminate(star->nodes))
+            {
+                return;
+            }
+
+            if(!options.allow_star_mesh)
+            {
+                throw Irreducible_Network_Exception();
+            }
+
+            // Fall back to eliminating the interior node with the fewest neighbours
+            if(degrees.empty() || !eliminate(degrees.begin()->second))
+            {
+                throw Irreducible_Network_Exception();
+            }
+        }
+
+        Reduction_Graph& graph;
+        std::size_t first_port;
+        std::size_t second_port;
+        const Reduction_Options& options;
+        Reduction_Result& result;
+        std::vector<std::size_t> pending;
+        std::vector<std::size_t> dirty;
+        std::vector<std::size_t> star_scores;
+        std::set<Candidate<std::size_t>> stars;
+        std::map<Triangle, std::size_t> triangle_scores;
+        std::set<Candidate<Triangle>> triangles;
+        std::vector<std::size_t> recorded_degrees;
+        std::set<std::pair<std::size_t, std::size_t>> degrees;
+    };
+}
+
+/**********************************************************************************************//**
+ * \brief Replaces a triangle with a star
+ * \param network
+ * \param branch_uids
+ *************************************************************************************************/
+uint32_t Circlyzer::delta_to_wye(Network& network, const std::array<uint32_t, 3U>& branch_uids)
+{
+    std::array<const Branch*, TRIANGLE> branches{};
+    for(std::size_t index = 0U; index < TRIANGLE; ++index)
+    {
+        branches[index] = &network.get_branch(branch_uids[index]);
+    }
+
+    const auto type = transformable_type(*branches[0]);
+    if((transformable_type(*branches[1]) != type) || (transformable_type(*branches[2]) != type))
+    {
+        throw Invalid_Transform_Exception();
+    }
+
+    const auto a = branches[0]->nodes[0];
+    const auto b = branches[0]->nodes[1];
+    const auto connects = [](const Branch& branch, const uint32_t first, const uint32_t second)
+    {
+        return ((branch.nodes[0] == first) && (branch.nodes[1] == second)) ||
+               ((branch.nodes[0] == second) && (branch.nodes[1] == first));
+    };
+
+    // The node of the second branch that isn't on the first closes the triangle
+    const auto c = ((branches[1]->nodes[0] == a) || (branches[1]->nodes[0] == b)) ?
+                   branches[1]->nodes[1] : branches[1]->nodes[0];
+
+    std::size_t bc = TRIANGLE;
+    std::size_t ca = TRIANGLE;
+    for(std::size_t index = 1U; index < TRIANGLE; ++index)
+    {
+        if(connects(*branches[index], b, c))
+        {
+            bc = index;
+        }
+        else if(connects(*branches[index], c, a))
+        {
+            ca = index;
+        }
+    }
+
+    if((c == a) || (c == b) || (bc == TRIANGLE) || (ca == TRIANGLE))
+    {
+        throw Invalid_Transform_Exception();
+    }
+
+    const auto value_of = [&](const std::size_t index) -> std::complex<double>
+    {
+        return to_transform_value(type, get_component_value(*branches[index]->component).real());
+    };
+
+    const auto wye = Circlyzer::delta_to_wye({ value_of(0U), value_of(bc), value_of(ca) });
+
+    network.destroy_entities({ branch_uids.begin(), branch_uids.end() });
+
+    const auto star = network.create_node();
+    add_branch(network, type, wye.a.real(), a, star);
+    add_branch(network, type, wye.b.real(), b, star);
+    add_branch(network, type, wye.c.real(), c, star);
+
+    return star;
+}
+
+/**********************************************************************************************//**
+ * \brief Replaces a star with a triangle
+ * \param network
+ * \param star_node_uid
+ *************************************************************************************************/
+std::array<uint32_t, 3U> Circlyzer::wye_to_delta(Network& network, const uint32_t star_node_uid)
+{
+    const auto& star = network.get_node(star_node_uid);
+    if(star.branches.size() != TRIANGLE)
+    {
+        throw Invalid_Transform_Exception();
+    }
+
+    const std::vector<uint32_t> branch_uids(star.branches.begin(), star.branches.end());
+    std::array<uint32_t, TRIANGLE> outer{};
+    std::array<std::complex<double>, TRIANGLE> arms{};
+    auto type = Component_Type::Resistor;
+
+    for(std::size_t index = 0U; index < TRIANGLE; ++index)
+    {
+        const auto& branch = network.get_branch(branch_uids[index]);
+        const auto branch_type = transformable_type(branch);
+        if((index > 0U) && (branch_type != type))
+        {
+            throw Invalid_Transform_Exception();
+        }
+
+        type = branch_type;
+        outer[index] = (branch.nodes[0] == star_node_uid) ? branch.nodes[1] : branch.nodes[0];
+        arms[index] = to_transform_value(type, get_component_value(*branch.component).real());
+    }
+
+    if((outer[0] == outer[1]) || (outer[1] == outer[2]) || (outer[2] == outer[0]))
+    {
+        throw Invalid_Transform_Exception();
+    }
+
+    const auto delta = Circlyzer::wye_to_delta({ arms[0], arms[1], arms[2] });
+
+    network.destroy_entities({ branch_uids[0], branch_uids[1], branch_uids[2], star_node_uid });
+
+    return { add_branch(network, type, delta.ab.real(), outer[0], outer[1]),
+             add_branch(network, type, delta.bc.real(), outer[1], outer[2]),
+             add_branch(network, type, delta.ca.real(), outer[2], outer[0]) };
+}
+
+/**********************************************************************************************//**
+ * \brief Reduces the compiled network to the impedance between two of its nodes
+ * \param network
+ * \param first_port_uid
+ * \param second_port_uid
+ * \param frequency
+ * \param options
+ *************************************************************************************************/
+Reduction_Result Circlyzer::reduce_impedance(const Compiled_Network& network,
+                                             const uint32_t first_port_uid,
+                                             const uint32_t second_port_uid,
+                                             const double frequency,
+                                             const Reduction_Options& options)
+{
+    Reduction_Result result{ 0.0, 0U, 0U, 0U, 0U, 0U };
+
+    const auto number_of_nodes = network.get_number_of_nodes();
+
+    // Capacitors at DC and diodes are open, voltage sources are shorts
+    Impedance_Table table(network, 1U);
+    const auto& impedances = table.get_impedances(frequency);
+
+    // Shorts merge their nodes as they are connected, keeping the ports
+    const auto first_port = network.get_node_index(first_port_uid);
+    const auto second_port = network.get_node_index(second_port_uid);
+    if(first_port == second_port)
+    {
+        return result;
+    }
+
+    Reduction_Graph graph(number_of_nodes);
+    graph.pin(first_port);
+    graph.pin(second_port);
+
+    for(uint32_t branch = 0U; branch < network.get_number_of_branches(); ++branch)
+    {
+        if(network.is_connected(branch))
+        {
+            const auto terminals = network.get_terminals(branch);
+            graph.connect(terminals[0], terminals[1], impedances[branch], result);
+        }
+    }
+
+    Reducer(graph, first_port, second_port, options, result).run();
+    if(graph.are_pins_shorted())
+    {
+        result.impedance = 0.0;
+        return result;
+    }
+
+    const auto& neighbours = graph.get_neighbours(first_port);
+    const auto edge = neighbours.find(second_port);
+    result.impedance = (edge != neighbours.end()) ? edge->second :
+        std::complex<double>{ std::numeric_limits<double>::infinity(), 0.0 };
+
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network and reduces the result
+ * \param network
+ * \param first_port_uid
+ * \param second_port_uid
+ * \param frequency
+ * \param options
+ *************************************************************************************************/
+Reduction_Result Circlyzer::reduce_impedance(const Network& network, const uint32_t first_port_uid,
+                                             const uint32_t second_port_uid, const double frequency,
+                                             const Reduction_Options& options)
+{
+    return reduce_impedance(*network.compile(), first_port_uid, second_port_uid, frequency, options);
+}
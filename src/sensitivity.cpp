@@ -0,0 +1,110 @@
+#include "circlyzer/sensitivity.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+
+using namespace Circlyzer;
+using namespace std::complex_literals;
+
+/**********************************************************************************************//**
+ * \brief Factorizes and solves the forward system
+ * \param analysis
+ * \param frequency
+ *************************************************************************************************/
+Sensitivity_Analysis::Sensitivity_Analysis(const Nodal_Analysis& analysis, const double frequency) :
+    analysis(analysis),
+    frequency{ frequency },
+    factorization(analysis.assemble_sparse_matrix(frequency)),
+    unknowns(factorization.solve(analysis.assemble_excitation()))
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Sensitivities of one node voltage, from a single transposed solve
+ * \param output_node_uid
+ *************************************************************************************************/
+Sensitivity_Result Sensitivity_Analysis::get_sensitivities(const uint32_t output_node_uid) const
+{
+    Sensitivity_Result result;
+    result.output_node_uid = output_node_uid;
+    result.output_voltage = 0.0;
+
+    const auto& elements = analysis.get_elements();
+    result.branch_uids.reserve(elements.size());
+    result.sensitivities.reserve(elements.size());
+
+    std::vector<std::complex<double>> adjoint(unknowns.size(), 0.0);
+
+    // The ground is fixed at zero, so nothing moves it
+    if(output_node_uid != analysis.get_ground_uid())
+    {
+        const auto& node_uids = analysis.get_node_uids();
+        const auto found = std::lower_bound(node_uids.begin(), node_uids.end(), output_node_uid);
+        if((found == node_uids.end()) || (*found != output_node_uid))
+        {
+            throw Non_Existant_UID_Exception();
+        }
+
+        const auto output_index = static_cast<std::size_t>(found - node_uids.begin());
+        result.output_voltage = unknowns[output_index];
+
+        std::vector<std::complex<double>> selector(unknowns.size(), 0.0);
+        selector[output_index] = 1.0;
+        adjoint = factorization.solve_transposed(selector);
+    }
+
+    const auto at = [](const std::vector<std::complex<double>>& vector, const std::size_t index)
+    {
+        return (index == Nodal_Analysis::GROUND_INDEX) ? std::complex<double>{ 0.0 } : vector[index];
+    };
+
+    for(const auto& element : elements)
+    {
+        // Admittance stamps contribute (l_a - l_b)(x_a - x_b) dY/dp
+        const auto adjoint_across = at(adjoint, element.first) - at(adjoint, element.second);
+        const auto voltage_across = at(unknowns, element.first) - at(unknowns, element.second);
+
+        std::complex<double> sensitivity;
+        switch(element.type)
+        {
+            case Component_Type::Resistor:
+                sensitivity = adjoint_across * voltage_across / (element.value * element.value);
+                break;
+
+            case Component_Type::Capacitor:
+                sensitivity = -1.0i * frequency * adjoint_across * voltage_across;
+                break;
+
+            case Component_Type::Inductor:
+                // The inductor's -jwL sits on its own current row and column
+                sensitivity = 1.0i * frequency * adjoint[element.current_index] *
+                              unknowns[element.current_index];
+                break;
+
+            default:
+                continue;
+        }
+
+        result.branch_uids.emplace_back(element.uid);
+        result.sensitivities.emplace_back(sensitivity);
+    }
+
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for unknowns, the forward solution in Nodal_Analysis order
+ *************************************************************************************************/
+const std::vector<std::complex<double>>& Sensitivity_Analysis::get_unknowns() const
+{
+    return unknowns;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for frequency
+ *************************************************************************************************/
+double Sensitivity_Analysis::get_frequency() const
+{
+    return frequency;
+}
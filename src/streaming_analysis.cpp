@@ -0,0 +1,547 @@
+#include "circlyzer/streaming_analysis.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto GROUND_INDEX = Nodal_Analysis::GROUND_INDEX;
+
+    // Steps run() takes between checks of its stop token
+    constexpr std::size_t STEPS_PER_CHECK = 64U;
+
+    void stamp(Dense_Matrix<double>& matrix, const std::size_t row, const std::size_t column, const double value)
+    {
+        if((row != GROUND_INDEX) && (column != GROUND_INDEX))
+        {
+            matrix(row, column) += value;
+        }
+    }
+
+    void stamp_admittance(Dense_Matrix<double>& matrix, const std::size_t first, const std::size_t second,
+                          const double admittance)
+    {
+        stamp(matrix, first, first, admittance);
+        stamp(matrix, second, second, admittance);
+        stamp(matrix, first, second, -admittance);
+        stamp(matrix, second, first, -admittance);
+    }
+
+    void stamp_incidence(Dense_Matrix<double>& matrix, const Nodal_Element& element)
+    {
+        stamp(matrix, element.first, element.current_index, 1.0);
+        stamp(matrix, element.current_index, element.first, 1.0);
+        stamp(matrix, element.second, element.current_index, -1.0);
+        stamp(matrix, element.current_index, element.second, -1.0);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Starts empty
+ *************************************************************************************************/
+Latency_Histogram::Latency_Histogram() :
+    buckets(),
+    count{ 0U },
+    total{ 0U },
+    minimum{ std::numeric_limits<uint64_t>::max() },
+    maximum{ 0U }
+{
+    reset();
+}
+
+/**********************************************************************************************//**
+ * \brief Counts one latency
+ * \param nanoseconds
+ *************************************************************************************************/
+void Latency_Histogram::record(const uint64_t nanoseconds)
+{
+    buckets[get_bucket(nanoseconds)].fetch_add(1U, std::memory_order_relaxed);
+    count.fetch_add(1U, std::memory_order_relaxed);
+    total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    auto smallest = minimum.load(std::memory_order_relaxed);
+    while((nanoseconds < smallest) &&
+          !minimum.compare_exchange_weak(smallest, nanoseconds, std::memory_order_relaxed))
+    {
+
+    }
+
+    auto largest = maximum.load(std::memory_order_relaxed);
+    while((nanoseconds > largest) &&
+          !maximum.compare_exchange_weak(largest, nanoseconds, std::memory_order_relaxed))
+    {
+
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Forgets every recorded latency
+ *************************************************************************************************/
+void Latency_Histogram::reset()
+{
+    for(auto& bucket : buckets)
+    {
+        bucket.store(0U, std::memory_order_relaxed);
+    }
+
+    count.store(0U, std::memory_order_relaxed);
+    total.store(0U, std::memory_order_relaxed);
+    minimum.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    maximum.store(0U, std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for count, the number of latencies recorded
+ *************************************************************************************************/
+uint64_t Latency_Histogram::get_count() const
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for minimum, zero when nothing has been recorded
+ *************************************************************************************************/
+uint64_t Latency_Histogram::get_minimum() const
+{
+    return (get_count() == 0U) ? 0U : minimum.load(std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for maximum
+ *************************************************************************************************/
+uint64_t Latency_Histogram::get_maximum() const
+{
+    return maximum.load(std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief The exact mean of the recorded latencies, zero when nothing has been recorded
+ *************************************************************************************************/
+double Latency_Histogram::get_mean() const
+{
+    const auto recorded = get_count();
+    return (recorded == 0U) ? 0.0 :
+        (static_cast<double>(total.load(std::memory_order_relaxed)) / static_cast<double>(recorded));
+}
+
+/**********************************************************************************************//**
+ * \brief Walks the buckets until the requested share of the samples is covered, and reports the
+ *        upper bound of the last bucket, capped by the largest latency seen
+ * \param fraction
+ *************************************************************************************************/
+uint64_t Latency_Histogram::get_percentile(const double fraction) const
+{
+    const auto recorded = get_count();
+    if(recorded == 0U)
+    {
+        return 0U;
+    }
+
+    const auto wanted = std::clamp(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(recorded)),
+                                   1.0, static_cast<double>(recorded));
+    const auto target = static_cast<uint64_t>(wanted);
+
+    uint64_t covered = 0U;
+    for(std::size_t bucket = 0U; bucket < NUMBER_OF_BUCKETS; ++bucket)
+    {
+        covered += get_bucket_count(bucket);
+        if(covered >= target)
+        {
+            const auto upper = ((bucket + 1U) < NUMBER_OF_BUCKETS) ?
+                (get_bucket_lower_bound(bucket + 1U) - 1U) : std::numeric_limits<uint64_t>::max();
+            return std::min(upper, get_maximum());
+        }
+    }
+
+    return get_maximum();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for one bucket's count
+ * \param bucket
+ *************************************************************************************************/
+uint64_t Latency_Histogram::get_bucket_count(const std::size_t bucket) const
+{
+    return buckets.at(bucket).load(std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief The bucket a latency falls in. Below 2 * SUB_BUCKETS it is the latency itself, above
+ *        it the power of two picks the group and the next SUB_BUCKET_BITS bits the bucket.
+ * \param nanoseconds
+ *************************************************************************************************/
+std::size_t Latency_Histogram::get_bucket(const uint64_t nanoseconds)
+{
+    if(nanoseconds < SUB_BUCKETS)
+    {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+
+    const auto shift = static_cast<std::size_t>(std::bit_width(nanoseconds)) - 1U - SUB_BUCKET_BITS;
+    return ((shift + 1U) * SUB_BUCKETS) + static_cast<std::size_t>((nanoseconds >> shift) - SUB_BUCKETS);
+}
+
+/**********************************************************************************************//**
+ * \brief The smallest latency that falls in a bucket
+ * \param bucket
+ *************************************************************************************************/
+uint64_t Latency_Histogram::get_bucket_lower_bound(const std::size_t bucket)
+{
+    if(bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    const auto group = bucket / SUB_BUCKETS;
+    const auto sub_bucket = bucket % SUB_BUCKETS;
+    return static_cast<uint64_t>(SUB_BUCKETS + sub_bucket) << (group - 1U);
+}
+
+/**********************************************************************************************//**
+ * \brief Stamps the companion models into the real MNA matrix and factorizes it, and sizes every
+ *        buffer a step will use
+ * \param network
+ * \param ground_uid
+ * \param time_step Seconds
+ * \param source_uids Voltage sources taking one sample per step
+ * \param probe_uids Nodes whose voltage is output after each step
+ * \param method
+ *************************************************************************************************/
+Streaming_Analysis::Streaming_Analysis(const Compiled_Network& network, const uint32_t ground_uid,
+                                       const double time_step, const std::vector<uint32_t>& source_uids,
+                                       const std::vector<uint32_t>& probe_uids, const Integration_Method method) :
+    time_step{ time_step },
+    method{ method },
+    factorization(),
+    base_excitation(),
+    source_rows(),
+    probe_indices(),
+    capacitors(),
+    inductors(),
+    excitation(),
+    unknowns(),
+    input_frame(source_uids.size(), 0.0),
+    output_frame(probe_uids.size(), 0.0),
+    number_of_steps{ 0U },
+    number_of_dropped_outputs{ 0U },
+    latency()
+{
+    // Without a streamed source an input frame is empty, and every pop of one would succeed
+    if(!(time_step > 0.0) || !std::isfinite(time_step) || source_uids.empty())
+    {
+        throw Invalid_Streaming_Exception();
+    }
+
+    const Nodal_Analysis analysis(network, ground_uid);
+    const auto size = analysis.get_system_size();
+
+    // The trapezoidal rule's companion conductances are twice backward Euler's
+    const auto scale = ((method == Integration_Method::Trapezoidal) ? 2.0 : 1.0) / time_step;
+
+    Dense_Matrix<double> matrix(size, size);
+    base_excitation.assign(size, 0.0);
+
+    std::unordered_map<uint32_t, std::size_t> source_indices;
+    for(const auto& element : analysis.get_elements())
+    {
+        const auto value = element.value.real();
+        switch(element.type)
+        {
+            case Component_Type::Resistor:
+                stamp_admittance(matrix, element.first, element.second, 1.0 / value);
+                break;
+
+            case Component_Type::Capacitor:
+                stamp_admittance(matrix, element.first, element.second, scale * value);
+                capacitors.push_back({ element.first, element.second, GROUND_INDEX, scale * value, 0.0, 0.0 });
+                break;
+
+            case Component_Type::Inductor:
+                stamp_incidence(matrix, element);
+                stamp(matrix, element.current_index, element.current_index, -scale * value);
+                inductors.push_back({ element.first, element.second, element.current_index, scale * value, 0.0, 0.0 });
+                break;
+
+            case Component_Type::Voltage_Source:
+                stamp_incidence(matrix, element);
+                base_excitation[element.current_index] = value;
+                source_indices.insert({ element.uid, element.current_index });
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    for(const auto uid : source_uids)
+    {
+        const auto found = source_indices.find(uid);
+        if(found == source_indices.end())
+        {
+            throw Invalid_Streaming_Exception();
+        }
+
+        source_rows.emplace_back(found->second);
+    }
+
+    const auto& node_uids = analysis.get_node_uids();
+    for(const auto uid : probe_uids)
+    {
+        if(uid == ground_uid)
+        {
+            probe_indices.emplace_back(GROUND_INDEX);
+            continue;
+        }
+
+        const auto found = std::find(node_uids.begin(), node_uids.end(), uid);
+        if(found == node_uids.end())
+        {
+            throw Non_Existant_UID_Exception();
+        }
+
+        probe_indices.emplace_back(static_cast<std::size_t>(found - node_uids.begin()));
+    }
+
+    factorization = LU_Factorization<double>(std::move(matrix));
+    excitation.assign(size, 0.0);
+    unknowns.assign(size, 0.0);
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network before analysing it
+ * \param network
+ * \param ground_uid
+ * \param time_step
+ * \param source_uids
+ * \param probe_uids
+ * \param method
+ *************************************************************************************************/
+Streaming_Analysis::Streaming_Analysis(const Network& network, const uint32_t ground_uid,
+                                       const double time_step, const std::vector<uint32_t>& source_uids,
+                                       const std::vector<uint32_t>& probe_uids, const Integration_Method method) :
+    Streaming_Analysis(*network.compile(), ground_uid, time_step, source_uids, probe_uids, method)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Advances one time step
+ * \param samples One per streamed source
+ * \param outputs One per probe
+ *************************************************************************************************/
+void Streaming_Analysis::step(const std::span<const double> samples, const std::span<double> outputs)
+{
+    if((samples.size() != source_rows.size()) || (outputs.size() != probe_indices.size()))
+    {
+        throw Invalid_Streaming_Exception();
+    }
+
+    const auto trapezoidal = (method == Integration_Method::Trapezoidal);
+
+    std::copy(base_excitation.begin(), base_excitation.end(), excitation.begin());
+    for(std::size_t source = 0U; source < source_rows.size(); ++source)
+    {
+        excitation[source_rows[source]] = samples[source];
+    }
+
+    // A capacitor's history is a current source in parallel with its companion conductance
+    for(const auto& capacitor : capacitors)
+    {
+        const auto history = (capacitor.coefficient * capacitor.voltage) + (trapezoidal ? capacitor.current : 0.0);
+        if(capacitor.first != GROUND_INDEX)
+        {
+            excitation[capacitor.first] += history;
+        }
+
+        if(capacitor.second != GROUND_INDEX)
+        {
+            excitation[capacitor.second] -= history;
+        }
+    }
+
+    // An inductor's is a voltage source in series with its companion resistance
+    for(const auto& inductor : inductors)
+    {
+        excitation[inductor.current_index] = -(inductor.coefficient * inductor.current) -
+                                             (trapezoidal ? inductor.voltage : 0.0);
+    }
+
+    factorization.solve(excitation, unknowns);
+
+    for(auto& capacitor : capacitors)
+    {
+        const auto voltage = voltage_at(capacitor.first) - voltage_at(capacitor.second);
+        capacitor.current = (capacitor.coefficient * (voltage - capacitor.voltage)) -
+                            (trapezoidal ? capacitor.current : 0.0);
+        capacitor.voltage = voltage;
+    }
+
+    for(auto& inductor : inductors)
+    {
+        inductor.current = unknowns[inductor.current_index];
+        inductor.voltage = voltage_at(inductor.first) - voltage_at(inductor.second);
+    }
+
+    for(std::size_t probe = 0U; probe < probe_indices.size(); ++probe)
+    {
+        outputs[probe] = voltage_at(probe_indices[probe]);
+    }
+
+    number_of_steps.fetch_add(1U, std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief Steps through the input frames already available. An output frame that doesn't fit is
+ *        dropped and counted rather than waited for, so a stalled consumer can't hold up the
+ *        simulation.
+ * \param input
+ * \param output
+ * \param maximum_steps
+ *************************************************************************************************/
+std::size_t Streaming_Analysis::process(Ring_Buffer<double>& input, Ring_Buffer<double>& output,
+                                        const std::size_t maximum_steps)
+{
+    if((input.get_capacity() < input_frame.size()) || (output.get_capacity() < output_frame.size()))
+    {
+        throw Invalid_Streaming_Exception();
+    }
+
+    std::size_t steps = 0U;
+    while((steps < maximum_steps) && input.try_pop(input_frame))
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        step(input_frame, output_frame);
+        if(!output.try_push(output_frame))
+        {
+            number_of_dropped_outputs.fetch_add(1U, std::memory_order_relaxed);
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        ++steps;
+    }
+
+    return steps;
+}
+
+/**********************************************************************************************//**
+ * \brief Processes until stopped. Meant to own a thread, such as a std::jthread whose token it is
+ *        given.
+ * \param input
+ * \param output
+ * \param token
+ *************************************************************************************************/
+void Streaming_Analysis::run(Ring_Buffer<double>& input, Ring_Buffer<double>& output, const std::stop_token token)
+{
+    while(!token.stop_requested())
+    {
+        if(process(input, output, STEPS_PER_CHECK) == 0U)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Returns the circuit to rest at time zero. The latency histogram is kept.
+ *************************************************************************************************/
+void Streaming_Analysis::reset()
+{
+    for(auto& element : capacitors)
+    {
+        element.voltage = 0.0;
+        element.current = 0.0;
+    }
+
+    for(auto& element : inductors)
+    {
+        element.voltage = 0.0;
+        element.current = 0.0;
+    }
+
+    std::fill(unknowns.begin(), unknowns.end(), 0.0);
+    number_of_steps.store(0U, std::memory_order_relaxed);
+    number_of_dropped_outputs.store(0U, std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief The simulated time reached, in seconds
+ *************************************************************************************************/
+double Streaming_Analysis::get_time() const
+{
+    return static_cast<double>(get_number_of_steps()) * time_step;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for time_step
+ *************************************************************************************************/
+double Streaming_Analysis::get_time_step() const
+{
+    return time_step;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_steps
+ *************************************************************************************************/
+uint64_t Streaming_Analysis::get_number_of_steps() const
+{
+    return number_of_steps.load(std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_dropped_outputs, frames the output buffer had no room for
+ *************************************************************************************************/
+uint64_t Streaming_Analysis::get_number_of_dropped_outputs() const
+{
+    return number_of_dropped_outputs.load(std::memory_order_relaxed);
+}
+
+/**********************************************************************************************//**
+ * \brief The size of an input frame
+ *************************************************************************************************/
+std::size_t Streaming_Analysis::get_number_of_sources() const
+{
+    return source_rows.size();
+}
+
+/**********************************************************************************************//**
+ * \brief The size of an output frame
+ *************************************************************************************************/
+std::size_t Streaming_Analysis::get_number_of_probes() const
+{
+    return probe_indices.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for latency, safe to read while another thread runs the analysis
+ *************************************************************************************************/
+const Latency_Histogram& Streaming_Analysis::get_latency_histogram() const
+{
+    return latency;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for latency
+ *************************************************************************************************/
+Latency_Histogram& Streaming_Analysis::get_latency_histogram()
+{
+    return latency;
+}
+
+/**********************************************************************************************//**
+ * \brief The voltage behind an unknown index, zero for the ground
+ * \param index
+ *************************************************************************************************/
+double Streaming_Analysis::voltage_at(const std::size_t index) const
+{
+    return (index == GROUND_INDEX) ? 0.0 : unknowns[index];
+}
@@ -0,0 +1,701 @@
+#include "circlyzer/structural_hash.h"
+#include "circlyzer/compiled_network.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <bit>
+#include <complex>
+#include <limits>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr uint64_t INITIAL_COLOUR = 0x9e3779b97f4a7c15ULL;
+    constexpr uint64_t DANGLING = 0xc2b2ae3d27d4eb4fULL;
+    constexpr auto NO_UID = Change::NO_UID;
+    constexpr auto NO_COLOUR = std::numeric_limits<uint64_t>::max();
+
+    // Colourings for this many sets of roles are kept per journal sequence, then all are dropped
+    constexpr std::size_t MAXIMUM_STABLE_COLOURINGS = 16U;
+
+    uint64_t hash_value(const double value)
+    {
+        // -0.0 and 0.0 describe the same component
+        return std::bit_cast<uint64_t>((value == 0.0) ? 0.0 : value);
+    }
+
+    std::array<uint64_t, 3> describe_component(const Component& component)
+    {
+        const auto value = get_component_value(component);
+        return { static_cast<uint64_t>(component.type), hash_value(value.real()), hash_value(value.imag()) };
+    }
+
+    uint64_t hash_component(const std::array<uint64_t, 3>& value)
+    {
+        return combine_hash(combine_hash(value[0], value[1]), value[2]);
+    }
+
+    bool is_polarised(const Component_Type type)
+    {
+        return (type == Component_Type::Voltage_Source) || (type == Component_Type::Diode);
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Finalised with the splitmix64 mixer so that sums of hashes stay well distributed
+ * \param seed
+ * \param value
+ *************************************************************************************************/
+uint64_t Circlyzer::combine_hash(const uint64_t seed, const uint64_t value)
+{
+    auto hash = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6U) + (seed >> 2U));
+    hash = (hash ^ (hash >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27U)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31U);
+}
+
+/**********************************************************************************************//**
+ * \brief
+ * \param network
+ * \param rounds Rounds of colour refinement, each one lets a label see one hop further
+ *************************************************************************************************/
+Structural_Hash::Structural_Hash(const Network& network, const uint32_t rounds) :
+    network(network),
+    rounds{ std::max<uint32_t>(rounds, 1U) },
+    nodes(),
+    branches(),
+    node_sum{ 0U },
+    branch_sum{ 0U },
+    stable_colourings(),
+    synchronized_sequence{ 0U },
+    number_of_recoloured_nodes{ 0U }
+{
+    rebuild();
+}
+
+/**********************************************************************************************//**
+ * \brief The hash of the network as it is now
+ *************************************************************************************************/
+uint64_t Structural_Hash::get_hash()
+{
+    synchronize();
+
+    auto hash = combine_hash(nodes.size(), branches.size());
+    hash = combine_hash(hash, node_sum);
+    return combine_hash(hash, branch_sum);
+}
+
+/**********************************************************************************************//**
+ * \brief A node's final colour. Nodes in equivalent places, in this network or any network with
+ *        the same hash, share a label.
+ * \param node_uid
+ *************************************************************************************************/
+uint64_t Structural_Hash::get_node_label(const uint32_t node_uid)
+{
+    synchronize();
+
+    const auto node = nodes.find(node_uid);
+    if(node == nodes.end())
+    {
+        throw Non_Existant_UID_Exception();
+    }
+
+    return node->second.colours[rounds];
+}
+
+/**********************************************************************************************//**
+ * \brief A branch's label: its component and the final colours of its terminals
+ * \param branch_uid
+ *************************************************************************************************/
+uint64_t Structural_Hash::get_branch_label(const uint32_t branch_uid)
+{
+    synchronize();
+
+    const auto branch = branches.find(branch_uid);
+    if(branch == branches.end())
+    {
+        throw Non_Existant_UID_Exception();
+    }
+
+    return branch->second.label;
+}
+
+/**********************************************************************************************//**
+ * \brief The stable colouring with the given nodes in roles, refined once per journal sequence
+ * \param role_uids
+ *************************************************************************************************/
+const Structural_Hash::Stable_Colouring& Structural_Hash::get_stable_colouring(const std::vector<uint32_t>& role_uids)
+{
+    synchronize();
+
+    for(const auto uid : role_uids)
+    {
+        if(nodes.count(uid) == 0U)
+        {
+            throw Non_Existant_UID_Exception();
+        }
+    }
+
+    const auto found = stable_colourings.find(role_uids);
+    if(found != stable_colourings.end())
+    {
+        return found->second;
+    }
+
+    if(stable_colourings.size() >= MAXIMUM_STABLE_COLOURINGS)
+    {
+        stable_colourings.clear();
+    }
+
+    return stable_colourings.emplace(role_uids, refine(role_uids)).first->second;
+}
+
+/**********************************************************************************************//**
+ * \brief Catches up with the network's Journal, recolouring only around what changed
+ *************************************************************************************************/
+void Structural_Hash::synchronize()
+{
+    const auto& journal = network.get_journal();
+    if(journal.get_sequence() == synchronized_sequence)
+    {
+        return;
+    }
+
+    if(!journal.is_available(synchronized_sequence))
+    {
+        rebuild();
+        return;
+    }
+
+    std::set<uint32_t> touched_nodes;
+    std::set<uint32_t> touched_branches;
+    for(const auto& change : journal.get_changes_since(synchronized_sequence))
+    {
+        switch(change.type)
+        {
+            case Change_Type::Node_Created:
+            case Change_Type::Node_Destroyed:
+                touched_nodes.insert(change.uid);
+                break;
+
+            case Change_Type::Branch_Created:
+            case Change_Type::Branch_Destroyed:
+            case Change_Type::Component_Updated:
+                touched_branches.insert(change.uid);
+                break;
+
+            case Change_Type::Connection_Created:
+            case Change_Type::Connection_Deleted:
+                touched_nodes.insert(change.uid);
+                touched_branches.insert(change.other_uid);
+                break;
+
+            case Change_Type::Alias_Updated:
+                break;
+        }
+    }
+
+    update(std::move(touched_nodes), std::move(touched_branches));
+    stable_colourings.clear();
+    synchronized_sequence = journal.get_sequence();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for network
+ *************************************************************************************************/
+const Network& Structural_Hash::get_network() const
+{
+    return network;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_recoloured_nodes, the count of node colours computed so far
+ *        summed over every round
+ *************************************************************************************************/
+std::size_t Structural_Hash::get_number_of_recoloured_nodes() const
+{
+    return number_of_recoloured_nodes;
+}
+
+/**********************************************************************************************//**
+ * \brief Starts over with every entity touched
+ *************************************************************************************************/
+void Structural_Hash::rebuild()
+{
+    nodes.clear();
+    branches.clear();
+    node_sum = 0U;
+    branch_sum = 0U;
+    stable_colourings.clear();
+
+    const auto node_uids = network.get_node_uids();
+    const auto branch_uids = network.get_branch_uids();
+    update(std::set<uint32_t>(node_uids.begin(), node_uids.end()),
+           std::set<uint32_t>(branch_uids.begin(), branch_uids.end()));
+
+    synchronized_sequence = network.get_journal().get_sequence();
+}
+
+/**********************************************************************************************//**
+ * \brief Re-reads the touched entities, then recolours outwards from the touched nodes one hop
+ *        per round and relabels every branch around a node whose colour may have changed
+ * \param touched_nodes
+ * \param touched_branches
+ *************************************************************************************************/
+void Structural_Hash::update(std::set<uint32_t> touched_nodes, std::set<uint32_t> touched_branches)
+{
+    // A destroyed node leaves its branches with one terminal fewer
+    for(const auto uid : touched_nodes)
+    {
+        const auto node = nodes.find(uid);
+        if(node != nodes.end())
+        {
+            touched_branches.insert(node->second.branches.begin(), node->second.branches.end());
+        }
+    }
+
+    for(const auto uid : touched_branches)
+    {
+        auto existing = branches.find(uid);
+        if(existing != branches.end())
+        {
+            for(const auto terminal : existing->second.terminals)
+            {
+                if(terminal != NO_UID)
+                {
+                    touched_nodes.insert(terminal);
+                }
+            }
+
+            if(existing->second.counted)
+            {
+                branch_sum -= existing->second.label;
+            }
+        }
+
+        const auto branch = network.try_get_branch(uid);
+        if(!branch)
+        {
+            branches.erase(uid);
+            continue;
+        }
+
+        auto& state = branches[uid];
+        state.value = describe_component(*(*branch)->component);
+        state.component = hash_component(state.value);
+        state.polarised = is_polarised((*branch)->component->type);
+        state.terminals.clear();
+        state.label = 0U;
+        state.counted = false;
+
+        for(const auto terminal : (*branch)->nodes)
+        {
+            const auto exists = network.try_get_node(terminal).has_value();
+            state.terminals.emplace_back(exists ? terminal : NO_UID);
+            if(exists)
+            {
+                touched_nodes.insert(terminal);
+            }
+        }
+    }
+
+    std::set<uint32_t> frontier;
+    for(const auto uid : touched_nodes)
+    {
+        const auto node = network.try_get_node(uid);
+        auto existing = nodes.find(uid);
+
+        if(!node)
+        {
+            if(existing != nodes.end())
+            {
+                node_sum -= existing->second.colours[rounds];
+                nodes.erase(existing);
+            }
+            continue;
+        }
+
+        if(existing == nodes.end())
+        {
+            existing = nodes.insert({ uid, { std::vector<uint64_t>(rounds + 1U, INITIAL_COLOUR), {} } }).first;
+            node_sum += INITIAL_COLOUR;
+        }
+
+        // Only branches that list this node as a terminal are really connected to it
+        auto& incident = existing->second.branches;
+        incident.clear();
+        for(const auto branch_uid : (*node)->branches)
+        {
+            const auto branch = branches.find(branch_uid);
+            if((branch != branches.end()) &&
+               (std::find(branch->second.terminals.begin(), branch->second.terminals.end(), uid) !=
+                branch->second.terminals.end()))
+            {
+                incident.emplace_back(branch_uid);
+            }
+        }
+
+        frontier.insert(uid);
+    }
+
+    for(uint32_t round = 1U; round <= rounds; ++round)
+    {
+        // A colour that changed in the last round changes the neighbours' colours in this one
+        if(round > 1U)
+        {
+            std::vector<uint32_t> neighbours;
+            for(const auto uid : frontier)
+            {
+                for(const auto branch_uid : nodes.at(uid).branches)
+                {
+                    for(const auto terminal : branches.at(branch_uid).terminals)
+                    {
+                        if(terminal != NO_UID)
+                        {
+                            neighbours.emplace_back(terminal);
+                        }
+                    }
+                }
+            }
+
+            frontier.insert(neighbours.begin(), neighbours.end());
+        }
+
+        for(const auto uid : frontier)
+        {
+            const auto colour = recolour(uid, round);
+            auto& colours = nodes.at(uid).colours;
+            if(round == rounds)
+            {
+                node_sum += colour - colours[round];
+            }
+
+            colours[round] = colour;
+        }
+
+        number_of_recoloured_nodes += frontier.size();
+    }
+
+    for(const auto uid : frontier)
+    {
+        const auto& incident = nodes.at(uid).branches;
+        touched_branches.insert(incident.begin(), incident.end());
+    }
+
+    for(const auto uid : touched_branches)
+    {
+        const auto branch = branches.find(uid);
+        if(branch == branches.end())
+        {
+            continue;
+        }
+
+        auto& state = branch->second;
+        if(state.counted)
+        {
+            branch_sum -= state.label;
+        }
+
+        state.label = relabel(state);
+        state.counted = true;
+        branch_sum += state.label;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief A node's colour in a round from its own and its neighbours' colours in the last one. The
+ *        incident branches are summed so that their order doesn't matter.
+ * \param node_uid
+ * \param round
+ *************************************************************************************************/
+uint64_t Structural_Hash::recolour(const uint32_t node_uid, const uint32_t round) const
+{
+    const auto& node = nodes.at(node_uid);
+
+    uint64_t neighbourhood = 0U;
+    for(const auto branch_uid : node.branches)
+    {
+        const auto& branch = branches.at(branch_uid);
+        const auto& terminals = branch.terminals;
+
+        for(std::size_t slot = 0U; slot < terminals.size(); ++slot)
+        {
+            if(terminals[slot] != node_uid)
+            {
+                continue;
+            }
+
+            const auto other = ((terminals.size() == 2U) && (terminals[1U - slot] != NO_UID)) ?
+                nodes.at(terminals[1U - slot]).colours[round - 1U] : DANGLING;
+            const auto terminal = branch.polarised ? (slot + 1U) : 0U;
+
+            neighbourhood += combine_hash(combine_hash(branch.component, terminal), other);
+        }
+    }
+
+    return combine_hash(node.colours[round - 1U], neighbourhood);
+}
+
+/**********************************************************************************************//**
+ * \brief A branch's label from its component and its terminals' final colours, which are put in
+ *        order unless the branch is polarised
+ * \param branch
+ *************************************************************************************************/
+uint64_t Structural_Hash::relabel(const Branch_State& branch) const
+{
+    uint64_t colours[2] = { DANGLING, DANGLING };
+    for(std::size_t slot = 0U; slot < std::min<std::size_t>(branch.terminals.size(), 2U); ++slot)
+    {
+        if(branch.terminals[slot] != NO_UID)
+        {
+            colours[slot] = nodes.at(branch.terminals[slot]).colours[rounds];
+        }
+    }
+
+    if(!branch.polarised && (colours[1] < colours[0]))
+    {
+        std::swap(colours[0], colours[1]);
+    }
+
+    return combine_hash(combine_hash(branch.component, colours[0]), colours[1]);
+}
+
+/**********************************************************************************************//**
+ * \brief Colour refinement from the roles until no class splits. Only the classes of nodes whose
+ *        neighbours changed colour in the last round are looked at again, and of those only the
+ *        nodes that were touched: the others still share the signature the class had.
+ *
+ *        New colours are numbered in a way that depends only on the structure. Within a class the
+ *        untouched nodes keep its colour, or the lowest signature does when every node was
+ *        touched, and the remaining signatures get the next colours in ascending order. Classes
+ *        split in ascending colour order.
+ * \param role_uids
+ *************************************************************************************************/
+Structural_Hash::Stable_Colouring Structural_Hash::refine(const std::vector<uint32_t>& role_uids) const
+{
+    using Signature = std::vector<std::array<uint64_t, 5>>;
+
+    struct Incidence
+    {
+        const Branch_State* branch;
+        uint64_t terminal;
+        std::size_t other;
+    };
+
+    // Dense indices in whatever order the map holds, colours never depend on it
+    std::vector<uint32_t> uids;
+    std::unordered_map<uint32_t, std::size_t> indices;
+    for(const auto& entry : nodes)
+    {
+        indices.insert({ entry.first, uids.size() });
+        uids.emplace_back(entry.first);
+    }
+
+    const auto missing = uids.size();
+    std::vector<std::vector<Incidence>> incidences(uids.size());
+    for(std::size_t index = 0U; index < uids.size(); ++index)
+    {
+        for(const auto branch_uid : nodes.at(uids[index]).branches)
+        {
+            const auto& branch = branches.at(branch_uid);
+            const auto& terminals = branch.terminals;
+            for(std::size_t slot = 0U; slot < terminals.size(); ++slot)
+            {
+                if(terminals[slot] != uids[index])
+                {
+                    continue;
+                }
+
+                const auto other = ((terminals.size() == 2U) && (terminals[1U - slot] != NO_UID)) ?
+                    indices.at(terminals[1U - slot]) : missing;
+                incidences[index].push_back({ &branch, branch.polarised ? (slot + 1U) : 0U, other });
+            }
+        }
+    }
+
+    std::vector<uint64_t> colours(uids.size(), 0U);
+    for(std::size_t role = 0U; role < role_uids.size(); ++role)
+    {
+        auto& colour = colours[indices.at(role_uids[role])];
+        colour = (colour == 0U) ? (role + 1U) : colour;
+    }
+
+    // Members of each class, with every node's position in its class for constant time removal
+    std::vector<std::vector<std::size_t>> members(role_uids.size() + 1U);
+    std::vector<std::size_t> positions(uids.size());
+    for(std::size_t node = 0U; node < uids.size(); ++node)
+    {
+        positions[node] = members[colours[node]].size();
+        members[colours[node]].emplace_back(node);
+    }
+
+    const auto signature_of = [&](const std::size_t node)
+    {
+        Signature signature;
+        for(const auto& incidence : incidences[node])
+        {
+            const auto& value = incidence.branch->value;
+            signature.push_back({ value[0], value[1], value[2], incidence.terminal,
+                                  (incidence.other == missing) ? NO_COLOUR : colours[incidence.other] });
+        }
+
+        std::sort(signature.begin(), signature.end());
+        return signature;
+    };
+
+    std::vector<std::size_t> touched(uids.size());
+    for(std::size_t node = 0U; node < uids.size(); ++node)
+    {
+        touched[node] = node;
+    }
+
+    std::vector<char> is_touched(uids.size(), 0);
+    while(!touched.empty())
+    {
+        std::sort(touched.begin(), touched.end(), [&](const std::size_t one, const std::size_t two)
+        {
+            return (colours[one] != colours[two]) ? (colours[one] < colours[two]) : (one < two);
+        });
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+        // Every signature is taken from the colours the round started with
+        std::vector<std::pair<Signature, std::size_t>> signed_nodes;
+        std::vector<std::pair<std::size_t, std::size_t>> groups;
+        std::vector<Signature> untouched;
+        for(std::size_t first = 0U; first < touched.size();)
+        {
+            const auto colour = colours[touched[first]];
+            auto last = first;
+            while((last < touched.size()) && (colours[touched[last]] == colour))
+            {
+                ++last;
+            }
+
+            const auto& group = members[colour];
+            if(group.size() > 1U)
+            {
+                groups.emplace_back(signed_nodes.size(), signed_nodes.size() + (last - first));
+                for(auto index = first; index < last; ++index)
+                {
+                    signed_nodes.emplace_back(signature_of(touched[index]), touched[index]);
+                    is_touched[touched[index]] = 1;
+                }
+
+                const auto remaining = std::find_if(group.begin(), group.end(), [&](const std::size_t node)
+                {
+                    return is_touched[node] == 0;
+                });
+                untouched.emplace_back((remaining != group.end()) ? signature_of(*remaining) : Signature{});
+
+                for(auto index = first; index < last; ++index)
+                {
+                    is_touched[touched[index]] = 0;
+                }
+            }
+
+            first = last;
+        }
+
+        std::vector<std::size_t> changed;
+        for(std::size_t index = 0U; index < groups.size(); ++index)
+        {
+            const auto begin = signed_nodes.begin() + static_cast<std::ptrdiff_t>(groups[index].first);
+            const auto end = signed_nodes.begin() + static_cast<std::ptrdiff_t>(groups[index].second);
+            std::sort(begin, end);
+
+            const auto colour = colours[begin->second];
+            const auto all_touched = (static_cast<std::size_t>(end - begin) == members[colour].size());
+            const auto& kept = all_touched ? begin->first : untouched[index];
+
+            for(auto run = begin; run != end;)
+            {
+                auto next = run;
+                while((next != end) && (next->first == run->first))
+                {
+                    ++next;
+                }
+
+                if(run->first != kept)
+                {
+                    const auto split = members.size();
+                    members.emplace_back();
+
+                    for(auto entry = run; entry != next; ++entry)
+                    {
+                        const auto node = entry->second;
+                        auto& group = members[colour];
+                        positions[group.back()] = positions[node];
+                        group[positions[node]] = group.back();
+                        group.pop_back();
+
+                        colours[node] = split;
+                        positions[node] = members[split].size();
+                        members[split].emplace_back(node);
+                        changed.emplace_back(node);
+                    }
+                }
+
+                run = next;
+            }
+        }
+
+        touched.clear();
+        for(const auto node : changed)
+        {
+            for(const auto& incidence : incidences[node])
+            {
+                if(incidence.other != missing)
+                {
+                    touched.emplace_back(incidence.other);
+                }
+            }
+        }
+    }
+
+    Stable_Colouring colouring;
+    colouring.fingerprint = { uids.size(), branches.size(), members.size() };
+    for(const auto& group : members)
+    {
+        colouring.fingerprint.emplace_back(group.size());
+    }
+
+    std::vector<std::array<uint64_t, 5>> edges;
+    for(const auto& [uid, branch] : branches)
+    {
+        std::array<uint64_t, 2> ends = { NO_COLOUR, NO_COLOUR };
+        for(std::size_t slot = 0U; slot < std::min<std::size_t>(branch.terminals.size(), 2U); ++slot)
+        {
+            if(branch.terminals[slot] != NO_UID)
+            {
+                ends[slot] = colours[indices.at(branch.terminals[slot])];
+            }
+        }
+
+        if(!branch.polarised && (ends[1] < ends[0]))
+        {
+            std::swap(ends[0], ends[1]);
+        }
+
+        edges.push_back({ branch.value[0], branch.value[1], branch.value[2], ends[0], ends[1] });
+        colouring.branch_labels.insert({ uid, combine_hash(combine_hash(branch.component, ends[0]), ends[1]) });
+    }
+
+    std::sort(edges.begin(), edges.end());
+    for(const auto& edge : edges)
+    {
+        colouring.fingerprint.insert(colouring.fingerprint.end(), edge.begin(), edge.end());
+    }
+
+    for(const auto uid : role_uids)
+    {
+        colouring.fingerprint.emplace_back(colours[indices.at(uid)]);
+    }
+
+    for(std::size_t node = 0U; node < uids.size(); ++node)
+    {
+        colouring.node_colours.insert({ uids[node], colours[node] });
+    }
+
+    return colouring;
+}
@@ -0,0 +1,477 @@
+#include "circlyzer/subcircuit.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace Circlyzer;
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    constexpr auto GROUND_INDEX = Nodal_Analysis::GROUND_INDEX;
+
+    /**
+     * \brief The first port, which the body is solved against
+     */
+    uint32_t reference_of(const std::vector<uint32_t>& port_uids)
+    {
+        if(port_uids.size() < 2U)
+        {
+            throw Invalid_Subcircuit_Exception();
+        }
+
+        return port_uids.front();
+    }
+
+    /**
+     * \brief Finds the unknown index of every node each instance is wired to, checking that the
+     *        instance has one existing node per port
+     */
+    std::vector<std::vector<std::size_t>> resolve_instances(const Nodal_Analysis& analysis,
+                                                            const std::vector<Subcircuit_Instance>& instances)
+    {
+        std::unordered_map<uint32_t, std::size_t> indices;
+        indices.reserve(analysis.get_node_uids().size() + 1U);
+        indices.insert({ analysis.get_ground_uid(), GROUND_INDEX });
+        for(std::size_t index = 0U; index < analysis.get_node_uids().size(); ++index)
+        {
+            indices.insert({ analysis.get_node_uids()[index], index });
+        }
+
+        std::vector<std::vector<std::size_t>> resolved;
+        resolved.reserve(instances.size());
+        for(const auto& instance : instances)
+        {
+            if(!instance.definition || (instance.nodes.size() != instance.definition->get_number_of_ports()))
+            {
+                throw Invalid_Subcircuit_Exception();
+            }
+
+            std::vector<std::size_t> instance_indices;
+            instance_indices.reserve(instance.nodes.size());
+            for(const auto uid : instance.nodes)
+            {
+                const auto found = indices.find(uid);
+                if(found == indices.end())
+                {
+                    throw Invalid_Subcircuit_Exception();
+                }
+
+                instance_indices.emplace_back(found->second);
+            }
+
+            resolved.emplace_back(std::move(instance_indices));
+        }
+
+        return resolved;
+    }
+
+    /**
+     * \brief The MNA system of one level of the hierarchy: the level's own elements, plus the
+     *        macromodel of every instance stamped between the nodes it is wired to
+     */
+    Dense_Matrix<Complex> assemble_level(const Nodal_Analysis& analysis,
+                                         const std::vector<Subcircuit_Instance>& instances,
+                                         const std::vector<std::vector<std::size_t>>& instance_indices,
+                                         const double frequency, std::vector<Complex>& excitation)
+    {
+        auto matrix = analysis.assemble_matrix(frequency);
+        excitation = analysis.assemble_excitation();
+
+        for(std::size_t instance = 0U; instance < instances.size(); ++instance)
+        {
+            const auto macromodel = instances[instance].definition->get_macromodel(frequency);
+            const auto& indices = instance_indices[instance];
+
+            for(std::size_t row = 0U; row < indices.size(); ++row)
+            {
+                if(indices[row] == GROUND_INDEX)
+                {
+                    continue;
+                }
+
+                excitation[indices[row]] += macromodel->current[row];
+                for(std::size_t column = 0U; column < indices.size(); ++column)
+                {
+                    if(indices[column] != GROUND_INDEX)
+                    {
+                        matrix(indices[row], indices[column]) += macromodel->admittance(row, column);
+                    }
+                }
+            }
+        }
+
+        return matrix;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Captures the body with its first port as the reference, and splits the remaining unknowns
+ *        into the ports and the internal unknowns to eliminate
+ * \param body
+ * \param port_uids
+ * \param instances
+ * \param capacity Number of frequencies whose macromodels are kept
+ *************************************************************************************************/
+Subcircuit_Definition::Subcircuit_Definition(const Compiled_Network& body, const std::vector<uint32_t>& port_uids,
+                                             const std::vector<Subcircuit_Instance>& instances,
+                                             const std::size_t capacity) :
+    analysis(body, reference_of(port_uids)),
+    port_uids(port_uids),
+    instances(instances),
+    port_indices(),
+    internal_indices(),
+    instance_indices(resolve_instances(analysis, instances)),
+    capacity{ std::max<std::size_t>(capacity, 1U) },
+    macromodels(),
+    clock{ 0U },
+    number_of_eliminations{ 0U },
+    mutex()
+{
+    const auto& node_uids = analysis.get_node_uids();
+
+    std::vector<bool> is_port(analysis.get_system_size(), false);
+    for(std::size_t port = 1U; port < port_uids.size(); ++port)
+    {
+        const auto found = std::find(node_uids.begin(), node_uids.end(), port_uids[port]);
+        if(found == node_uids.end())
+        {
+            throw Invalid_Subcircuit_Exception();
+        }
+
+        const auto index = static_cast<std::size_t>(found - node_uids.begin());
+        if(is_port[index])
+        {
+            throw Invalid_Subcircuit_Exception();
+        }
+
+        is_port[index] = true;
+        port_indices.emplace_back(index);
+    }
+
+    for(std::size_t index = 0U; index < is_port.size(); ++index)
+    {
+        if(!is_port[index])
+        {
+            internal_indices.emplace_back(index);
+        }
+    }
+
+    // A source between two ports leaves its current out of every internal equation
+    const auto at_port = [&](const std::size_t index)
+    {
+        return (index == GROUND_INDEX) || is_port[index];
+    };
+
+    for(const auto& element : analysis.get_elements())
+    {
+        if((element.type == Component_Type::Voltage_Source) && at_port(element.first) && at_port(element.second))
+        {
+            throw Invalid_Subcircuit_Exception();
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the body before capturing it
+ * \param body
+ * \param port_uids
+ * \param instances
+ * \param capacity
+ *************************************************************************************************/
+Subcircuit_Definition::Subcircuit_Definition(const Network& body, const std::vector<uint32_t>& port_uids,
+                                             const std::vector<Subcircuit_Instance>& instances,
+                                             const std::size_t capacity) :
+    Subcircuit_Definition(*body.compile(), port_uids, instances, capacity)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief The macromodel at a frequency, eliminating the body the first time the frequency is seen
+ *        and evicting the least recently used frequency when full. Two threads asking for a new
+ *        frequency at once may both eliminate it, but only the first result is kept.
+ * \param frequency
+ *************************************************************************************************/
+std::shared_ptr<const Macromodel> Subcircuit_Definition::get_macromodel(const double frequency) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto found = macromodels.find(frequency);
+        if(found != macromodels.end())
+        {
+            found->second.last_used = ++clock;
+            return found->second.macromodel;
+        }
+    }
+
+    std::vector<Complex> excitation;
+    const auto matrix = assemble_level(analysis, instances, instance_indices, frequency, excitation);
+
+    const auto ports = port_indices.size();
+    const auto internals = internal_indices.size();
+
+    Dense_Matrix<Complex> internal_block(internals, internals);
+    Dense_Matrix<Complex> internal_to_port(internals, ports);
+    std::vector<Complex> internal_excitation(internals);
+    for(std::size_t row = 0U; row < internals; ++row)
+    {
+        for(std::size_t column = 0U; column < internals; ++column)
+        {
+            internal_block(row, column) = matrix(internal_indices[row], internal_indices[column]);
+        }
+
+        for(std::size_t column = 0U; column < ports; ++column)
+        {
+            internal_to_port(row, column) = matrix(internal_indices[row], port_indices[column]);
+        }
+
+        internal_excitation[row] = excitation[internal_indices[row]];
+    }
+
+    auto macromodel = std::make_shared<Macromodel>();
+    macromodel->internal_factorization = LU_Factorization<Complex>(std::move(internal_block));
+    macromodel->internal_response = macromodel->internal_factorization.solve(internal_to_port);
+    macromodel->internal_offset = macromodel->internal_factorization.solve(internal_excitation);
+
+    // Schur complement over the ports after the reference, then widened with the reference port
+    macromodel->admittance = Dense_Matrix<Complex>(ports + 1U, ports + 1U);
+    macromodel->current.assign(ports + 1U, Complex{});
+
+    auto& admittance = macromodel->admittance;
+    auto& current = macromodel->current;
+    for(std::size_t row = 0U; row < ports; ++row)
+    {
+        const auto port_row = port_indices[row];
+
+        auto injected = excitation[port_row];
+        for(std::size_t internal = 0U; internal < internals; ++internal)
+        {
+            injected -= matrix(port_row, internal_indices[internal]) * macromodel->internal_offset[internal];
+        }
+
+        current[row + 1U] = injected;
+        current[0U] -= injected;
+
+        for(std::size_t column = 0U; column < ports; ++column)
+        {
+            auto value = matrix(port_row, port_indices[column]);
+            for(std::size_t internal = 0U; internal < internals; ++internal)
+            {
+                value -= matrix(port_row, internal_indices[internal]) *
+                         macromodel->internal_response(internal, column);
+            }
+
+            admittance(row + 1U, column + 1U) = value;
+            admittance(row + 1U, 0U) -= value;
+            admittance(0U, column + 1U) -= value;
+            admittance(0U, 0U) += value;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto found = macromodels.find(frequency);
+    if(found != macromodels.end())
+    {
+        found->second.last_used = ++clock;
+        return found->second.macromodel;
+    }
+
+    if(macromodels.size() >= capacity)
+    {
+        macromodels.erase(std::min_element(macromodels.begin(), macromodels.end(),
+                                           [](const auto& left, const auto& right)
+                                           {
+                                               return left.second.last_used < right.second.last_used;
+                                           }));
+    }
+
+    ++number_of_eliminations;
+    return macromodels.insert({ frequency, { std::move(macromodel), ++clock } }).first->second.macromodel;
+}
+
+/**********************************************************************************************//**
+ * \brief Recovers the internal unknowns from the port voltages through the kept factorization,
+ *        and reports them in the body's UIDs. Voltages are absolute, the reference port sits at
+ *        port_voltages[0] rather than at zero.
+ * \param port_voltages
+ * \param frequency
+ *************************************************************************************************/
+Nodal_Solution Subcircuit_Definition::solve_internal(const std::vector<Complex>& port_voltages,
+                                                     const double frequency) const
+{
+    if(port_voltages.size() != port_uids.size())
+    {
+        throw Invalid_Subcircuit_Exception();
+    }
+
+    const auto macromodel = get_macromodel(frequency);
+    const auto reference = port_voltages.front();
+
+    std::vector<Complex> unknowns(analysis.get_system_size());
+    for(std::size_t port = 0U; port < port_indices.size(); ++port)
+    {
+        unknowns[port_indices[port]] = port_voltages[port + 1U] - reference;
+    }
+
+    const auto relative = macromodel->internal_response.get_number_of_columns();
+    for(std::size_t internal = 0U; internal < internal_indices.size(); ++internal)
+    {
+        auto value = macromodel->internal_offset[internal];
+        for(std::size_t port = 0U; port < relative; ++port)
+        {
+            value -= macromodel->internal_response(internal, port) * unknowns[port_indices[port]];
+        }
+
+        unknowns[internal_indices[internal]] = value;
+    }
+
+    auto solution = analysis.interpret(unknowns, frequency);
+    for(auto& [uid, voltage] : solution.node_voltages)
+    {
+        voltage += reference;
+    }
+
+    return solution;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of ports, the reference included
+ *************************************************************************************************/
+std::size_t Subcircuit_Definition::get_number_of_ports() const
+{
+    return port_uids.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for port_uids
+ *************************************************************************************************/
+const std::vector<uint32_t>& Subcircuit_Definition::get_port_uids() const
+{
+    return port_uids;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for instances, the definitions nested in the body
+ *************************************************************************************************/
+const std::vector<Subcircuit_Instance>& Subcircuit_Definition::get_instances() const
+{
+    return instances;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for analysis, the body referenced to its first port
+ *************************************************************************************************/
+const Nodal_Analysis& Subcircuit_Definition::get_nodal_analysis() const
+{
+    return analysis;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for number_of_eliminations, one per frequency macromodelled, counting again a
+ *        frequency that was evicted and asked for once more
+ *************************************************************************************************/
+std::size_t Subcircuit_Definition::get_number_of_eliminations() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return number_of_eliminations;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for the number of frequencies whose macromodels are kept
+ *************************************************************************************************/
+std::size_t Subcircuit_Definition::get_number_of_cached_frequencies() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return macromodels.size();
+}
+
+/**********************************************************************************************//**
+ * \brief Captures the top level network and resolves the nodes every instance is wired to
+ * \param network
+ * \param ground_uid
+ * \param instances
+ *************************************************************************************************/
+Hierarchical_Analysis::Hierarchical_Analysis(const Compiled_Network& network, const uint32_t ground_uid,
+                                             const std::vector<Subcircuit_Instance>& instances) :
+    analysis(network, ground_uid),
+    instances(instances),
+    instance_indices(resolve_instances(analysis, instances))
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network before capturing it
+ * \param network
+ * \param ground_uid
+ * \param instances
+ *************************************************************************************************/
+Hierarchical_Analysis::Hierarchical_Analysis(const Network& network, const uint32_t ground_uid,
+                                             const std::vector<Subcircuit_Instance>& instances) :
+    Hierarchical_Analysis(*network.compile(), ground_uid, instances)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Solves the interconnect, with every instance replaced by its macromodel
+ * \param frequency
+ *************************************************************************************************/
+Nodal_Solution Hierarchical_Analysis::solve(const double frequency) const
+{
+    std::vector<Complex> excitation;
+    const LU_Factorization<Complex> factorization(assemble_matrix(frequency, excitation));
+
+    return analysis.interpret(factorization.solve(excitation), frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief Expands one instance from the voltages a top level solution gives its nodes
+ * \param solution
+ * \param instance
+ * \param frequency
+ *************************************************************************************************/
+Nodal_Solution Hierarchical_Analysis::solve_instance(const Nodal_Solution& solution, const std::size_t instance,
+                                                     const double frequency) const
+{
+    const auto& used = instances.at(instance);
+
+    std::vector<Complex> port_voltages;
+    port_voltages.reserve(used.nodes.size());
+    for(const auto uid : used.nodes)
+    {
+        port_voltages.emplace_back(solution.node_voltages.at(uid));
+    }
+
+    return used.definition->solve_internal(port_voltages, frequency);
+}
+
+/**********************************************************************************************//**
+ * \brief The interconnect's MNA matrix, with the excitation written alongside it
+ * \param frequency
+ * \param excitation
+ *************************************************************************************************/
+Dense_Matrix<Complex> Hierarchical_Analysis::assemble_matrix(const double frequency,
+                                                             std::vector<Complex>& excitation) const
+{
+    return assemble_level(analysis, instances, instance_indices, frequency, excitation);
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for analysis, the top level network's own elements
+ *************************************************************************************************/
+const Nodal_Analysis& Hierarchical_Analysis::get_nodal_analysis() const
+{
+    return analysis;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for instances
+ *************************************************************************************************/
+const std::vector<Subcircuit_Instance>& Hierarchical_Analysis::get_instances() const
+{
+    return instances;
+}
@@ -0,0 +1,180 @@
+#include "circlyzer/superposition.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/matrix.h"
+
+#include <cmath>
+#include <map>
+
+using namespace Circlyzer;
+
+namespace
+{
+    /**
+     * \brief Sums the real parts of a quantity's phasors at a time
+     */
+    double evaluate(const std::vector<double>& frequencies,
+                    const std::vector<const std::map<uint32_t, std::complex<double>>*>& phasors,
+                    const uint32_t uid, const double time)
+    {
+        auto value = 0.0;
+        for(std::size_t index = 0U; index < frequencies.size(); ++index)
+        {
+            const auto found = phasors[index]->find(uid);
+            if(found == phasors[index]->end())
+            {
+                throw Non_Existant_UID_Exception();
+            }
+
+            value += (found->second * std::polar(1.0, frequencies[index] * time)).real();
+        }
+
+        return value;
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Finds the row each voltage source is excited through
+ * \param network
+ * \param ground_uid
+ *************************************************************************************************/
+Superposition_Analysis::Superposition_Analysis(const Compiled_Network& network, const uint32_t ground_uid) :
+    analysis(network, ground_uid),
+    source_rows()
+{
+    for(const auto& element : analysis.get_elements())
+    {
+        if(element.type == Component_Type::Voltage_Source)
+        {
+            source_rows.insert({ element.uid, element.current_index });
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * \brief Compiles the network before analysing it
+ * \param network
+ * \param ground_uid
+ *************************************************************************************************/
+Superposition_Analysis::Superposition_Analysis(const Network& network, const uint32_t ground_uid) :
+    Superposition_Analysis(*network.compile(), ground_uid)
+{
+
+}
+
+/**********************************************************************************************//**
+ * \brief Groups the excitations by frequency and solves every group as its own task
+ * \param excitations
+ * \param keep_contributions Whether each excitation's own solution is reported as well
+ * \param executor
+ *************************************************************************************************/
+Superposition_Solution Superposition_Analysis::solve(const std::vector<Source_Excitation>& excitations,
+                                                     const bool keep_contributions, Executor& executor) const
+{
+    std::map<double, std::vector<std::size_t>> groups;
+    for(std::size_t index = 0U; index < excitations.size(); ++index)
+    {
+        const auto& excitation = excitations[index];
+        if(!source_rows.contains(excitation.source_uid) || !std::isfinite(excitation.frequency))
+        {
+            throw Invalid_Excitation_Exception();
+        }
+
+        groups[excitation.frequency].emplace_back(index);
+    }
+
+    Superposition_Solution result;
+    std::vector<const std::vector<std::size_t>*> members;
+    for(const auto& [frequency, group] : groups)
+    {
+        result.frequencies.emplace_back(frequency);
+        members.emplace_back(&group);
+    }
+
+    result.solutions.resize(groups.size());
+    result.contributions.resize(keep_contributions ? excitations.size() : 0U);
+
+    const auto size = analysis.get_system_size();
+    executor.parallel_for(0U, members.size(), [&](const std::size_t first, const std::size_t last)
+    {
+        for(auto group = first; group < last; ++group)
+        {
+            const auto frequency = result.frequencies[group];
+            const auto& indices = *members[group];
+            const auto width = keep_contributions ? indices.size() : 1U;
+
+            Dense_Matrix<std::complex<double>> rhs(size, width);
+            for(std::size_t column = 0U; column < indices.size(); ++column)
+            {
+                const auto& excitation = excitations[indices[column]];
+                rhs(source_rows.at(excitation.source_uid), keep_contributions ? column : 0U) += excitation.voltage;
+            }
+
+            const LU_Factorization<std::complex<double>> factorization(analysis.assemble_matrix(frequency));
+            const auto unknowns = factorization.solve(rhs);
+
+            std::vector<std::complex<double>> total(size);
+            std::vector<std::complex<double>> column_unknowns(size);
+            for(std::size_t column = 0U; column < width; ++column)
+            {
+                for(std::size_t row = 0U; row < size; ++row)
+                {
+                    column_unknowns[row] = unknowns(row, column);
+                    total[row] += column_unknowns[row];
+                }
+
+                if(keep_contributions)
+                {
+                    result.contributions[indices[column]] = analysis.interpret(column_unknowns, frequency);
+                }
+            }
+
+            result.solutions[group] = analysis.interpret(total, frequency);
+        }
+    });
+
+    return result;
+}
+
+/**********************************************************************************************//**
+ * \brief Accessor for analysis
+ *************************************************************************************************/
+const Nodal_Analysis& Superposition_Analysis::get_nodal_analysis() const
+{
+    return analysis;
+}
+
+/**********************************************************************************************//**
+ * \brief Instantaneous node voltage
+ * \param solution
+ * \param node_uid
+ * \param time
+ *************************************************************************************************/
+double Circlyzer::evaluate_node_voltage(const Superposition_Solution& solution, const uint32_t node_uid,
+                                        const double time)
+{
+    std::vector<const std::map<uint32_t, std::complex<double>>*> phasors;
+    for(const auto& harmonic : solution.solutions)
+    {
+        phasors.emplace_back(&harmonic.node_voltages);
+    }
+
+    return evaluate(solution.frequencies, phasors, node_uid, time);
+}
+
+/**********************************************************************************************//**
+ * \brief Instantaneous branch current
+ * \param solution
+ * \param branch_uid
+ * \param time
+ *************************************************************************************************/
+double Circlyzer::evaluate_branch_current(const Superposition_Solution& solution, const uint32_t branch_uid,
+                                          const double time)
+{
+    std::vector<const std::map<uint32_t, std::complex<double>>*> phasors;
+    for(const auto& harmonic : solution.solutions)
+    {
+        phasors.emplace_back(&harmonic.branch_currents);
+    }
+
+    return evaluate(solution.frequencies, phasors, branch_uid, time);
+}
@@ -0,0 +1,353 @@
+#include "gtest/gtest.h"
+#include "circlyzer/analysis_cache.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/structural_hash.h"
+#include "circlyzer/units.h"
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto TOLERANCE = 1e-12;
+    constexpr auto SEED = 5U;
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    /**
+     * \brief A divider driving an RLC load, built in either of two orders. The second order has
+     *        other UIDs and swaps every passive branch's terminals.
+     */
+    uint32_t build_circuit(Network& network, const bool renumbered)
+    {
+        if(!renumbered)
+        {
+            const auto ground = network.create_node();
+            const auto a = network.create_node();
+            const auto b = network.create_node();
+            connect(network, a, ground, std::make_unique<Voltage_Source>(2.0));
+            connect(network, a, b, std::make_unique<Resistor>(1.0_kohm));
+            connect(network, b, ground, std::make_unique<Resistor>(2.0_kohm));
+            connect(network, b, ground, std::make_unique<Capacitor>(100.0_nF));
+            connect(network, b, ground, std::make_unique<Inductor>(10.0_mH));
+            return ground;
+        }
+
+        network.destroy_entity(network.create_node());
+        const auto b = network.create_node();
+        const auto ground = network.create_node();
+        const auto a = network.create_node();
+        connect(network, ground, b, std::make_unique<Inductor>(10.0_mH));
+        connect(network, ground, b, std::make_unique<Capacitor>(100.0_nF));
+        connect(network, ground, b, std::make_unique<Resistor>(2.0_kohm));
+        connect(network, b, a, std::make_unique<Resistor>(1.0_kohm));
+        connect(network, a, ground, std::make_unique<Voltage_Source>(2.0));
+        return ground;
+    }
+
+    void expect_same(const Nodal_Solution& actual, const Nodal_Solution& expected)
+    {
+        ASSERT_EQ(actual.node_voltages.size(), expected.node_voltages.size());
+        ASSERT_EQ(actual.branch_currents.size(), expected.branch_currents.size());
+
+        for(const auto& [uid, voltage] : expected.node_voltages)
+        {
+            EXPECT_NEAR(std::abs(actual.node_voltages.at(uid) - voltage), 0.0, TOLERANCE) << "node " << uid;
+        }
+
+        for(const auto& [uid, current] : expected.branch_currents)
+        {
+            EXPECT_NEAR(std::abs(actual.branch_currents.at(uid) - current), 0.0, TOLERANCE) << "branch " << uid;
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a repeated solve is answered from memory with the same result
+ *************************************************************************************************/
+TEST(AnalysisCache, RepeatedSolve)
+{
+    Network network;
+    const auto ground = build_circuit(network, false);
+    Structural_Hash structure(network);
+    Analysis_Cache cache;
+
+    const auto expected = Nodal_Analysis(network, ground).solve(ANGULAR_FREQUENCY);
+    expect_same(cache.solve(structure, ground, ANGULAR_FREQUENCY), expected);
+    expect_same(cache.solve(structure, ground, ANGULAR_FREQUENCY), expected);
+
+    EXPECT_EQ(cache.get_number_of_misses(), 1U);
+    EXPECT_EQ(cache.get_number_of_hits(), 1U);
+
+    // A different frequency or an edited network is a different request
+    cache.solve(structure, ground, 2.0 * ANGULAR_FREQUENCY);
+    EXPECT_EQ(cache.get_number_of_misses(), 2U);
+
+    network.update_component(network.get_branch_uids().back(), std::make_unique<Inductor>(20.0_mH));
+    expect_same(cache.solve(structure, ground, ANGULAR_FREQUENCY),
+                Nodal_Analysis(network, ground).solve(ANGULAR_FREQUENCY));
+    EXPECT_EQ(cache.get_number_of_misses(), 3U);
+}
+
+/**********************************************************************************************//**
+ * Assess that a resubmitted circuit with other UIDs is answered in its own numbering, with
+ * currents following its own branch orientation
+ *************************************************************************************************/
+TEST(AnalysisCache, RenumberedNetwork)
+{
+    Network one;
+    Network two;
+    const auto first_ground = build_circuit(one, false);
+    const auto second_ground = build_circuit(two, true);
+    Structural_Hash first(one);
+    Structural_Hash second(two);
+    Analysis_Cache cache;
+
+    cache.solve(first, first_ground, ANGULAR_FREQUENCY);
+    const auto solution = cache.solve(second, second_ground, ANGULAR_FREQUENCY);
+
+    EXPECT_EQ(cache.get_number_of_hits(), 1U);
+    expect_same(solution, Nodal_Analysis(two, second_ground).solve(ANGULAR_FREQUENCY));
+}
+
+/**********************************************************************************************//**
+ * Assess that the least recently used entry is the one evicted
+ *************************************************************************************************/
+TEST(AnalysisCache, LeastRecentlyUsed)
+{
+    Network network;
+    const auto ground = build_circuit(network, false);
+    Structural_Hash structure(network);
+    Analysis_Cache cache(2U);
+
+    cache.solve(structure, ground, 1.0);
+    cache.solve(structure, ground, 2.0);
+    cache.solve(structure, ground, 1.0);
+    cache.solve(structure, ground, 3.0);
+    EXPECT_EQ(cache.get_size(), 2U);
+    EXPECT_EQ(cache.get_number_of_misses(), 3U);
+
+    cache.solve(structure, ground, 1.0);
+    EXPECT_EQ(cache.get_number_of_misses(), 3U);
+
+    cache.solve(structure, ground, 2.0);
+    EXPECT_EQ(cache.get_number_of_misses(), 4U);
+}
+
+/**********************************************************************************************//**
+ * Assess that reductions and factorizations are cached, and a factorization solves the system
+ *************************************************************************************************/
+TEST(AnalysisCache, ReductionsAndFactorizations)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 50U, 3U, SEED);
+    Structural_Hash structure(network);
+    Analysis_Cache cache;
+
+    const auto port = network.get_node_uids().back();
+    const auto reduced = cache.reduce(structure, port, circuit.ground_uid, ANGULAR_FREQUENCY);
+    const auto again = cache.reduce(structure, port, circuit.ground_uid, ANGULAR_FREQUENCY);
+    EXPECT_EQ(reduced.impedance, again.impedance);
+    EXPECT_EQ(reduced.impedance, reduce_impedance(network, port, circuit.ground_uid, ANGULAR_FREQUENCY).impedance);
+
+    const Nodal_Analysis analysis(network, circuit.ground_uid);
+    const auto factorization = cache.factorize(structure, analysis, ANGULAR_FREQUENCY);
+    EXPECT_EQ(cache.factorize(structure, Nodal_Analysis(network, circuit.ground_uid), ANGULAR_FREQUENCY),
+              factorization);
+    EXPECT_EQ(cache.get_number_of_hits(), 2U);
+
+    expect_same(analysis.interpret(factorization->solve(analysis.assemble_excitation()), ANGULAR_FREQUENCY),
+                analysis.solve(ANGULAR_FREQUENCY));
+}
+
+/**********************************************************************************************//**
+ * Assess that a second cache over the same directory answers from disk
+ *************************************************************************************************/
+TEST(AnalysisCache, OnDisk)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "circlyzer-analysis-cache-test";
+    std::filesystem::remove_all(directory);
+
+    Network network;
+    const auto ground = build_circuit(network, false);
+    Structural_Hash structure(network);
+    const auto port = network.get_node_uids().back();
+
+    Nodal_Solution expected;
+    Reduction_Result reduced;
+    {
+        Analysis_Cache cache(Analysis_Cache::DEFAULT_CAPACITY, directory.string());
+        expected = cache.solve(structure, ground, ANGULAR_FREQUENCY);
+        reduced = cache.reduce(structure, port, ground, ANGULAR_FREQUENCY);
+    }
+
+    Network renumbered;
+    const auto renumbered_ground = build_circuit(renumbered, true);
+    Structural_Hash renumbered_structure(renumbered);
+
+    Analysis_Cache cache(Analysis_Cache::DEFAULT_CAPACITY, directory.string());
+    expect_same(cache.solve(renumbered_structure, renumbered_ground, ANGULAR_FREQUENCY),
+                Nodal_Analysis(renumbered, renumbered_ground).solve(ANGULAR_FREQUENCY));
+    EXPECT_EQ(cache.reduce(structure, port, ground, ANGULAR_FREQUENCY).impedance, reduced.impedance);
+    EXPECT_EQ(cache.get_number_of_disk_hits(), 2U);
+    EXPECT_EQ(cache.get_number_of_misses(), 0U);
+
+    // A damaged file is only a miss
+    for(const auto& file : std::filesystem::directory_iterator(directory))
+    {
+        std::filesystem::resize_file(file.path(), 10U);
+    }
+
+    Analysis_Cache damaged(Analysis_Cache::DEFAULT_CAPACITY, directory.string());
+    expect_same(damaged.solve(structure, ground, ANGULAR_FREQUENCY), expected);
+    EXPECT_EQ(damaged.get_number_of_misses(), 1U);
+
+    std::filesystem::remove_all(directory);
+}
+
+/**********************************************************************************************//**
+ * Assess that a network sharing another's hash, but not its structure, is not answered from the
+ * other's entry, in memory or on disk. Two chains of 1 ohm resistors in parallel, 10 and 20 long
+ * against 15 and 15, look the same within the hash's three rounds.
+ *************************************************************************************************/
+TEST(AnalysisCache, SharedHash)
+{
+    const auto build_chains = [](Network& network, const std::vector<std::size_t>& lengths)
+    {
+        const auto ground = network.create_node();
+        const auto port = network.create_node();
+        for(const auto length : lengths)
+        {
+            auto previous = port;
+            for(std::size_t link = 1U; link <= length; ++link)
+            {
+                const auto next = (link == length) ? ground : network.create_node();
+                connect(network, previous, next, std::make_unique<Resistor>(1.0_ohm));
+                previous = next;
+            }
+        }
+
+        return std::make_pair(port, ground);
+    };
+
+    Network uneven;
+    Network even;
+    const auto [uneven_port, uneven_ground] = build_chains(uneven, { 10U, 20U });
+    const auto [even_port, even_ground] = build_chains(even, { 15U, 15U });
+    Structural_Hash uneven_structure(uneven);
+    Structural_Hash even_structure(even);
+    ASSERT_EQ(uneven_structure.get_hash(), even_structure.get_hash());
+
+    const auto directory = std::filesystem::temp_directory_path() / "circlyzer-analysis-cache-shared-hash";
+    std::filesystem::remove_all(directory);
+    {
+        Analysis_Cache cache(Analysis_Cache::DEFAULT_CAPACITY, directory.string());
+        EXPECT_NEAR(cache.reduce(uneven_structure, uneven_port, uneven_ground).impedance.real(), 20.0 / 3.0,
+                    TOLERANCE);
+        EXPECT_NEAR(cache.reduce(even_structure, even_port, even_ground).impedance.real(), 7.5, TOLERANCE);
+        EXPECT_EQ(cache.get_number_of_hits(), 0U);
+        EXPECT_EQ(cache.get_number_of_misses(), 2U);
+    }
+
+    // The file now holds the even chains, which the uneven ones must not be answered from
+    Analysis_Cache cache(Analysis_Cache::DEFAULT_CAPACITY, directory.string());
+    EXPECT_NEAR(cache.reduce(uneven_structure, uneven_port, uneven_ground).impedance.real(), 20.0 / 3.0, TOLERANCE);
+    EXPECT_EQ(cache.get_number_of_disk_hits(), 0U);
+    EXPECT_NEAR(cache.reduce(even_structure, even_port, even_ground).impedance.real(), 7.5, TOLERANCE);
+    EXPECT_NEAR(cache.reduce(even_structure, even_port, even_ground).impedance.real(), 7.5, TOLERANCE);
+    EXPECT_EQ(cache.get_number_of_hits(), 1U);
+
+    std::filesystem::remove_all(directory);
+}
+
+/**********************************************************************************************//**
+ * Assess that a uniform chain, whose links all look alike within the hash's three rounds though
+ * their voltages differ, is kept and answered on resubmission, as is a uniform grid whose
+ * mirrored nodes share voltages
+ *************************************************************************************************/
+TEST(AnalysisCache, UniformStructures)
+{
+    constexpr auto NUMBER_OF_LINKS = 40U;
+    constexpr auto SIDE = 6U;
+
+    const auto build_chain = [](Network& network)
+    {
+        const auto ground = network.create_node();
+        auto previous = network.create_node();
+        connect(network, previous, ground, std::make_unique<Voltage_Source>(1.0));
+
+        for(auto link = 0U; link < NUMBER_OF_LINKS; ++link)
+        {
+            const auto next = (link + 1U == NUMBER_OF_LINKS) ? ground : network.create_node();
+            connect(network, previous, next, std::make_unique<Resistor>(1.0_kohm));
+            previous = next;
+        }
+
+        return ground;
+    };
+
+    const auto build_grid = [](Network& network)
+    {
+        const auto ground = network.create_node();
+        std::vector<uint32_t> nodes;
+        for(auto index = 0U; index < SIDE * SIDE; ++index)
+        {
+            nodes.emplace_back(network.create_node());
+        }
+
+        for(auto row = 0U; row < SIDE; ++row)
+        {
+            for(auto column = 0U; column < SIDE; ++column)
+            {
+                const auto node = nodes[(row * SIDE) + column];
+                if(column + 1U < SIDE)
+                {
+                    connect(network, node, nodes[(row * SIDE) + column + 1U],
+                            std::make_unique<Resistor>(1.0_kohm));
+                }
+                if(row + 1U < SIDE)
+                {
+                    connect(network, node, nodes[((row + 1U) * SIDE) + column],
+                            std::make_unique<Resistor>(1.0_kohm));
+                }
+            }
+        }
+
+        connect(network, nodes.front(), ground, std::make_unique<Voltage_Source>(1.0));
+        connect(network, nodes.back(), ground, std::make_unique<Resistor>(1.0_kohm));
+        return ground;
+    };
+
+    using Builder = std::function<uint32_t(Network&)>;
+
+    Analysis_Cache cache;
+    for(const auto& build : { Builder(build_chain), Builder(build_grid) })
+    {
+        Network original;
+        Network resubmitted;
+        const auto original_ground = build(original);
+        const auto resubmitted_ground = build(resubmitted);
+        Structural_Hash original_structure(original);
+        Structural_Hash resubmitted_structure(resubmitted);
+
+        const auto hits = cache.get_number_of_hits();
+        cache.solve(original_structure, original_ground);
+        expect_same(cache.solve(resubmitted_structure, resubmitted_ground),
+                    Nodal_Analysis(resubmitted, resubmitted_ground).solve(0.0));
+        EXPECT_EQ(cache.get_number_of_hits(), hits + 1U);
+    }
+}
@@ -0,0 +1,129 @@
+#include "gtest/gtest.h"
+#include "circlyzer/batch_analysis.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto TOLERANCE = 1e-9;
+    constexpr auto ANGULAR_FREQUENCY = 1000.0;
+
+    // Deliberately not a multiple of the lane count so the tail block is exercised
+    constexpr auto NUMBER_OF_INSTANCES = 19U;
+
+    struct Filter
+    {
+        Network network;
+        uint32_t ground;
+        uint32_t output;
+        uint32_t source;
+        uint32_t resistor;
+        uint32_t inductor;
+    };
+
+    /**
+     * \brief Source -> R -> L -> output, with a capacitor from output to ground
+     */
+    void build_filter(Filter& filter, const std::complex<double> voltage, const double resistance)
+    {
+        auto& network = filter.network;
+        filter.ground = network.create_node();
+        const auto input = network.create_node();
+        const auto middle = network.create_node();
+        filter.output = network.create_node();
+
+        const auto connect = [&](std::unique_ptr<Component> component, uint32_t a, uint32_t b)
+        {
+            const auto uid = network.create_branch(std::move(component));
+            network.create_connection_between(a, uid);
+            network.create_connection_between(b, uid);
+            return uid;
+        };
+
+        filter.source = connect(std::make_unique<Voltage_Source>(voltage), input, filter.ground);
+        filter.resistor = connect(std::make_unique<Resistor>(resistance), input, middle);
+        filter.inductor = connect(std::make_unique<Inductor>(100.0_mH), middle, filter.output);
+        connect(std::make_unique<Capacitor>(10.0_muF), filter.output, filter.ground);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that every instance of a batch matches an independent scalar solve
+ *************************************************************************************************/
+TEST(BatchAnalysis, MatchesScalarSolves)
+{
+    Filter nominal;
+    build_filter(nominal, 1.0, 100.0_ohm);
+
+    Batch_Table table;
+    table.number_of_instances = NUMBER_OF_INSTANCES;
+    auto& voltages = table.columns[nominal.source];
+    auto& resistances = table.columns[nominal.resistor];
+
+    for(auto instance = 0U; instance < NUMBER_OF_INSTANCES; ++instance)
+    {
+        voltages.emplace_back(1.0 + instance, 0.5 * instance);
+        resistances.emplace_back(10.0 + (25.0 * instance));
+    }
+
+    const auto batch = Batch_Analysis(nominal.network, nominal.ground).solve(table,
+                                                                             ANGULAR_FREQUENCY);
+    ASSERT_EQ(batch.number_of_instances, NUMBER_OF_INSTANCES);
+
+    for(auto instance = 0U; instance < NUMBER_OF_INSTANCES; ++instance)
+    {
+        Filter filter;
+        build_filter(filter, voltages[instance], resistances[instance].real());
+
+        const auto expected = Nodal_Analysis(filter.network, filter.ground).solve(ANGULAR_FREQUENCY);
+
+        // Both networks were built in the same order, so the UIDs line up
+        for(const auto& [uid, voltage] : expected.node_voltages)
+        {
+            EXPECT_NEAR(std::abs(batch.node_voltages.at(uid).at(instance) - voltage), 0.0,
+                        TOLERANCE);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that branches without a column are solved with their nominal value
+ *************************************************************************************************/
+TEST(BatchAnalysis, UnlistedBranchesKeepNominalValues)
+{
+    Filter filter;
+    build_filter(filter, 2.0, 50.0_ohm);
+
+    Batch_Table table;
+    table.number_of_instances = 3U;
+
+    const auto batch = Batch_Analysis(filter.network, filter.ground).solve(table, ANGULAR_FREQUENCY);
+    const auto expected = Nodal_Analysis(filter.network, filter.ground).solve(ANGULAR_FREQUENCY);
+
+    for(const auto& voltage : batch.node_voltages.at(filter.output))
+    {
+        EXPECT_NEAR(std::abs(voltage - expected.node_voltages.at(filter.output)), 0.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a column with the wrong number of values is rejected
+ *************************************************************************************************/
+TEST(BatchAnalysis, MismatchedColumnLength)
+{
+    Filter filter;
+    build_filter(filter, 1.0, 100.0_ohm);
+
+    Batch_Table table;
+    table.number_of_instances = 4U;
+    table.columns[filter.resistor] = { 1.0, 2.0 };
+
+    EXPECT_THROW(Batch_Analysis(filter.network, filter.ground).solve(table),
+                 Invalid_Batch_Table_Exception);
+}
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "circlyzer/branch_quantities.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto TOLERANCE = 1e-9;
+    constexpr auto SEED = 3U;
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    std::vector<std::complex<double>> solve_unknowns(const Nodal_Analysis& analysis, const double frequency)
+    {
+        const LU_Factorization<std::complex<double>> factorization(analysis.assemble_matrix(frequency));
+        return factorization.solve(analysis.assemble_excitation());
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the currents match the solution's, and the voltages its node voltages, from either
+ * the unknowns or the solution
+ *************************************************************************************************/
+TEST(BranchQuantities, MatchesSolution)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 60U, 3U, SEED);
+    const auto compiled = network.compile();
+    const Nodal_Analysis analysis(*compiled, circuit.ground_uid);
+
+    const auto unknowns = solve_unknowns(analysis, ANGULAR_FREQUENCY);
+    const auto solution = analysis.interpret(unknowns, ANGULAR_FREQUENCY);
+
+    Branch_Quantities from_unknowns(*compiled, analysis);
+    Branch_Quantities from_solution(*compiled, analysis);
+    from_unknowns.evaluate(unknowns, ANGULAR_FREQUENCY);
+    from_solution.evaluate(solution, ANGULAR_FREQUENCY);
+
+    ASSERT_EQ(from_unknowns.get_number_of_branches(), compiled->get_number_of_branches());
+    for(uint32_t branch = 0U; branch < compiled->get_number_of_branches(); ++branch)
+    {
+        const auto uid = from_unknowns.get_branch_uids()[branch];
+        ASSERT_EQ(uid, compiled->get_branch_uid(branch));
+
+        const auto& nodes = network.get_branch(uid).nodes;
+        const auto voltage = solution.node_voltages.at(nodes[0]) - solution.node_voltages.at(nodes[1]);
+        const auto current = solution.branch_currents.at(uid);
+
+        EXPECT_NEAR(std::abs(from_unknowns.get_voltages()[branch] - voltage), 0.0, TOLERANCE);
+        EXPECT_NEAR(std::abs(from_unknowns.get_currents()[branch] - current), 0.0, TOLERANCE);
+        EXPECT_NEAR(std::abs(from_unknowns.get_powers()[branch] - (voltage * std::conj(current))), 0.0, TOLERANCE);
+
+        EXPECT_NEAR(std::abs(from_solution.get_voltages()[branch] - voltage), 0.0, TOLERANCE);
+        EXPECT_NEAR(std::abs(from_solution.get_currents()[branch] - current), 0.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the absorbed powers balance, as Tellegen's theorem requires
+ *************************************************************************************************/
+TEST(BranchQuantities, PowerBalance)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 60U, 3U, SEED);
+    const auto compiled = network.compile();
+    const Nodal_Analysis analysis(*compiled, circuit.ground_uid);
+
+    Branch_Quantities quantities(*compiled, analysis);
+    for(const auto frequency : { ANGULAR_FREQUENCY, 10.0 * ANGULAR_FREQUENCY })
+    {
+        quantities.evaluate(solve_unknowns(analysis, frequency), frequency);
+
+        std::complex<double> total = 0.0;
+        double scale = 0.0;
+        for(const auto power : quantities.get_powers())
+        {
+            total += power;
+            scale += std::abs(power);
+        }
+
+        EXPECT_NEAR(std::abs(total), 0.0, TOLERANCE * scale);
+        EXPECT_GT(scale, 0.0);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that diodes and dangling branches carry no current
+ *************************************************************************************************/
+TEST(BranchQuantities, OpenBranches)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto top = network.create_node();
+    const auto source = connect(network, top, ground, std::make_unique<Voltage_Source>(2.0));
+    const auto load = connect(network, top, ground, std::make_unique<Resistor>(1.0_kohm));
+    const auto diode = connect(network, top, ground, std::make_unique<Diode>());
+    const auto dangling = network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    network.create_connection_between(top, dangling);
+
+    const auto compiled = network.compile();
+    const Nodal_Analysis analysis(*compiled, ground);
+    Branch_Quantities quantities(*compiled, analysis);
+    quantities.evaluate(analysis.solve(), 0.0);
+
+    const auto at = [&](const uint32_t uid) { return compiled->get_branch_index(uid); };
+    EXPECT_NEAR(std::abs(quantities.get_currents()[at(load)] - 2.0e-3), 0.0, TOLERANCE);
+    EXPECT_NEAR(std::abs(quantities.get_currents()[at(source)] + 2.0e-3), 0.0, TOLERANCE);
+    EXPECT_NEAR(std::abs(quantities.get_powers()[at(source)] + 4.0e-3), 0.0, TOLERANCE);
+
+    EXPECT_EQ(quantities.get_voltages()[at(diode)], std::complex<double>(2.0));
+    EXPECT_EQ(quantities.get_currents()[at(diode)], std::complex<double>(0.0));
+    EXPECT_EQ(quantities.get_voltages()[at(dangling)], std::complex<double>(0.0));
+    EXPECT_EQ(quantities.get_currents()[at(dangling)], std::complex<double>(0.0));
+}
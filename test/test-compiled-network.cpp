@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "circlyzer/compiled_network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    /**
+     * \brief ground -- source -- top -- R1 -- middle -- R2 -- ground, plus a dangling resistor
+     */
+    struct Divider
+    {
+        Divider()
+        {
+            ground = network.create_node();
+            top = network.create_node();
+            middle = network.create_node();
+
+            source = network.create_branch(std::make_unique<Voltage_Source>(12.0));
+            upper = network.create_branch(std::make_unique<Resistor>(2.0_kohm));
+            lower = network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+            dangling = network.create_branch(std::make_unique<Resistor>(5.0_ohm));
+
+            network.create_connection_between(top, source);
+            network.create_connection_between(ground, source);
+            network.create_connection_between(top, upper);
+            network.create_connection_between(middle, upper);
+            network.create_connection_between(middle, lower);
+            network.create_connection_between(ground, lower);
+            network.create_connection_between(middle, dangling);
+        }
+
+        Network network;
+        uint32_t ground, top, middle;
+        uint32_t source, upper, lower, dangling;
+    };
+}
+
+/**********************************************************************************************//**
+ * Assess that entities are renumbered densely and the incidence is captured in both directions
+ *************************************************************************************************/
+TEST(CompiledNetwork, Incidence)
+{
+    Divider divider;
+    const auto compiled = divider.network.compile();
+
+    ASSERT_EQ(compiled->get_number_of_nodes(), 3U);
+    ASSERT_EQ(compiled->get_number_of_branches(), 4U);
+
+    const auto middle = compiled->get_node_index(divider.middle);
+    const auto upper = compiled->get_branch_index(divider.upper);
+    const auto dangling = compiled->get_branch_index(divider.dangling);
+
+    EXPECT_EQ(compiled->get_node_uid(middle), divider.middle);
+    EXPECT_EQ(compiled->get_branch_uid(upper), divider.upper);
+
+    const auto terminals = compiled->get_terminals(upper);
+    EXPECT_EQ(compiled->get_node_uid(terminals[0]), divider.top);
+    EXPECT_EQ(compiled->get_node_uid(terminals[1]), divider.middle);
+
+    EXPECT_TRUE(compiled->is_connected(upper));
+    EXPECT_FALSE(compiled->is_connected(dangling));
+    EXPECT_EQ(compiled->get_terminals(dangling)[1], Compiled_Network::NO_NODE);
+
+    const auto incident = compiled->get_incident_branches(middle);
+    ASSERT_EQ(incident.size(), 3U);
+    for(const auto branch : incident)
+    {
+        const auto uid = compiled->get_branch_uid(branch);
+        EXPECT_TRUE((uid == divider.upper) || (uid == divider.lower) || (uid == divider.dangling));
+    }
+
+    EXPECT_EQ(compiled->get_node_offsets().back(), compiled->get_node_branches().size());
+}
+
+/**********************************************************************************************//**
+ * Assess that component data is flattened into arrays indexed by branch
+ *************************************************************************************************/
+TEST(CompiledNetwork, FlatComponentData)
+{
+    Divider divider;
+    const auto compiled = divider.network.compile();
+
+    const auto source = compiled->get_branch_index(divider.source);
+    const auto lower = compiled->get_branch_index(divider.lower);
+
+    EXPECT_EQ(compiled->get_types()[source], Component_Type::Voltage_Source);
+    EXPECT_EQ(compiled->get_values()[source], std::complex<double>(12.0));
+    EXPECT_EQ(compiled->get_types()[lower], Component_Type::Resistor);
+    EXPECT_EQ(compiled->get_values()[lower], std::complex<double>(1.0_kohm));
+}
+
+/**********************************************************************************************//**
+ * Assess that UID translation reports the same errors as the Network accessors
+ *************************************************************************************************/
+TEST(CompiledNetwork, IndexTranslationErrors)
+{
+    Divider divider;
+    const auto compiled = divider.network.compile();
+
+    EXPECT_THROW(compiled->get_node_index(0xDEADBEEFU), Non_Existant_UID_Exception);
+    EXPECT_THROW(compiled->get_node_index(divider.upper), Wrong_Entity_Type_Exception);
+    EXPECT_THROW(compiled->get_branch_index(divider.top), Wrong_Entity_Type_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that a compiled view is a snapshot that later edits don't reach
+ *************************************************************************************************/
+TEST(CompiledNetwork, SnapshotIsFrozen)
+{
+    Divider divider;
+    const auto compiled = divider.network.compile();
+    const auto sequence = compiled->get_sequence();
+
+    divider.network.update_component(divider.lower, std::make_unique<Resistor>(10.0_kohm));
+    divider.network.create_node();
+
+    EXPECT_EQ(compiled->get_number_of_nodes(), 3U);
+    EXPECT_EQ(compiled->get_values()[compiled->get_branch_index(divider.lower)],
+              std::complex<double>(1.0_kohm));
+    EXPECT_LT(sequence, divider.network.get_journal().get_sequence());
+}
+
+/**********************************************************************************************//**
+ * Assess that several threads can analyse the same compiled view concurrently
+ *************************************************************************************************/
+TEST(CompiledNetwork, SharedBetweenThreads)
+{
+    Divider divider;
+    const auto compiled = divider.network.compile();
+
+    std::vector<std::complex<double>> results(4U);
+    std::vector<std::thread> threads;
+    for(std::size_t index = 0U; index < results.size(); ++index)
+    {
+        threads.emplace_back([&, index]()
+        {
+            const auto solution = Nodal_Analysis(*compiled, divider.ground).solve();
+            results[index] = solution.node_voltages.at(divider.middle);
+        });
+    }
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for(const auto& result : results)
+    {
+        EXPECT_NEAR(result.real(), 4.0, 1e-9);
+    }
+}
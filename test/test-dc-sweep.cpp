@@ -0,0 +1,202 @@
+#include "gtest/gtest.h"
+#include "circlyzer/dc_sweep.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    /**
+     * \brief Two sources feeding a resistor bridge, with a capacitor and an inductor that DC
+     *        opens and shorts
+     */
+    struct Bridge
+    {
+        uint32_t ground;
+        uint32_t left;
+        uint32_t middle;
+        uint32_t right;
+        uint32_t first_source;
+        uint32_t second_source;
+    };
+
+    Bridge build_bridge(Network& network)
+    {
+        Bridge circuit;
+        circuit.ground = network.create_node();
+        circuit.left = network.create_node();
+        circuit.middle = network.create_node();
+        circuit.right = network.create_node();
+        const auto tap = network.create_node();
+
+        circuit.first_source = connect(network, circuit.left, circuit.ground, std::make_unique<Voltage_Source>(1.0));
+        circuit.second_source = connect(network, circuit.right, circuit.ground, std::make_unique<Voltage_Source>(2.0));
+        connect(network, circuit.left, circuit.middle, std::make_unique<Resistor>(1.0_kohm));
+        connect(network, circuit.middle, circuit.right, std::make_unique<Resistor>(2.0_kohm));
+        connect(network, circuit.middle, tap, std::make_unique<Inductor>(10.0_mH));
+        connect(network, tap, circuit.ground, std::make_unique<Resistor>(3.0_kohm));
+        connect(network, circuit.middle, circuit.ground, std::make_unique<Capacitor>(100.0_nF));
+        return circuit;
+    }
+
+    // Two values per point, point after point
+    std::vector<double> make_points(const std::size_t count)
+    {
+        std::vector<double> points;
+        for(std::size_t index = 0U; index < count; ++index)
+        {
+            points.push_back(-5.0 + (0.1 * index));
+            points.push_back(3.0 - (0.05 * index));
+        }
+
+        return points;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that every point matches a nodal solve with the sources set to its values, whatever the
+ * block size, and reaches the sink once, in order
+ *************************************************************************************************/
+TEST(DCSweep, MatchesNodalAnalysis)
+{
+    Network network;
+    const auto circuit = build_bridge(network);
+    const auto points = make_points(101U);
+
+    std::vector<std::vector<double>> expected;
+    for(std::size_t index = 0U; index < points.size(); index += 2U)
+    {
+        network.update_component(circuit.first_source, std::make_unique<Voltage_Source>(points[index]));
+        network.update_component(circuit.second_source, std::make_unique<Voltage_Source>(points[index + 1U]));
+        const auto solution = Nodal_Analysis(network, circuit.ground).solve();
+        expected.push_back({ solution.node_voltages.at(circuit.middle).real(),
+                             solution.node_voltages.at(circuit.left).real() });
+    }
+
+    const DC_Sweep sweep(network, circuit.ground, { circuit.first_source, circuit.second_source },
+                         { circuit.middle, circuit.left, circuit.ground });
+    EXPECT_EQ(sweep.get_number_of_sources(), 2U);
+    EXPECT_EQ(sweep.get_number_of_probes(), 3U);
+
+    Executor executor(3U);
+    for(const std::size_t block_size : { 1U, 7U, 32U, 500U })
+    {
+        std::size_t next = 0U;
+        sweep.run(points, [&](const std::size_t point, const std::span<const double> voltages)
+        {
+            ASSERT_EQ(point, next++);
+            ASSERT_EQ(voltages.size(), 3U);
+            EXPECT_NEAR(voltages[0], expected[point][0], 1e-12) << "point " << point;
+            EXPECT_NEAR(voltages[1], expected[point][1], 1e-12) << "point " << point;
+            EXPECT_EQ(voltages[2], 0.0);
+        }, block_size, executor);
+
+        EXPECT_EQ(next, expected.size()) << "block size " << block_size;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that sources that aren't swept hold their value
+ *************************************************************************************************/
+TEST(DCSweep, HeldSources)
+{
+    Network network;
+    const auto circuit = build_bridge(network);
+    const DC_Sweep sweep(network, circuit.ground, { circuit.first_source }, { circuit.right, circuit.left });
+
+    const std::vector<double> points = { 0.5, 1.5 };
+    std::vector<double> lefts;
+    sweep.run(points, [&](const std::size_t, const std::span<const double> voltages)
+    {
+        EXPECT_NEAR(voltages[0], 2.0, 1e-12);
+        lefts.emplace_back(voltages[1]);
+    });
+
+    EXPECT_NEAR(lefts.at(0), 0.5, 1e-12);
+    EXPECT_NEAR(lefts.at(1), 1.5, 1e-12);
+}
+
+/**********************************************************************************************//**
+ * Assess that invalid sources, probes and points are refused before the sink hears anything
+ *************************************************************************************************/
+TEST(DCSweep, Invalid)
+{
+    Network network;
+    const auto circuit = build_bridge(network);
+    const auto resistor = network.get_branch_uids()[2];
+
+    EXPECT_THROW(DC_Sweep(network, circuit.ground, { resistor }, {}), Invalid_Sweep_Exception);
+    EXPECT_THROW(DC_Sweep(network, circuit.ground, { circuit.first_source }, { resistor }),
+                 Non_Existant_UID_Exception);
+
+    const DC_Sweep pair(network, circuit.ground, { circuit.first_source, circuit.second_source }, { circuit.middle });
+    const std::vector<double> points = { 1.0, 2.0, 3.0 };
+    std::size_t calls = 0U;
+    EXPECT_THROW(pair.run(points, [&](std::size_t, std::span<const double>) { ++calls; }), Invalid_Sweep_Exception);
+    EXPECT_EQ(calls, 0U);
+
+    const DC_Sweep unswept(network, circuit.ground, {}, { circuit.middle });
+    EXPECT_THROW(unswept.run(points, [&](std::size_t, std::span<const double>) { ++calls; }), Invalid_Sweep_Exception);
+    EXPECT_EQ(calls, 0U);
+}
+
+/**********************************************************************************************//**
+ * Assess that a point source is pulled no further than a wave ahead of the sink, and that its
+ * points solve like the same points given flat
+ *************************************************************************************************/
+TEST(DCSweep, PointSource)
+{
+    Network network;
+    const auto circuit = build_bridge(network);
+    const DC_Sweep sweep(network, circuit.ground, { circuit.first_source, circuit.second_source }, { circuit.middle });
+
+    constexpr std::size_t NUMBER_OF_POINTS = 1000U;
+    constexpr std::size_t BLOCK_SIZE = 4U;
+    const auto points = make_points(NUMBER_OF_POINTS);
+
+    Executor executor(2U);
+    std::vector<double> expected;
+    sweep.run(points, [&](std::size_t, const std::span<const double> voltages)
+    {
+        expected.emplace_back(voltages[0]);
+    }, BLOCK_SIZE, executor);
+
+    const auto wave = BLOCK_SIZE * executor.get_number_of_workers();
+    std::size_t pulled = 0U;
+    std::size_t next = 0U;
+    sweep.run([&](const std::span<double> point)
+    {
+        if(pulled == NUMBER_OF_POINTS)
+        {
+            return false;
+        }
+
+        EXPECT_EQ(point.size(), 2U);
+        point[0] = points[2U * pulled];
+        point[1] = points[(2U * pulled) + 1U];
+        ++pulled;
+        return true;
+    }, [&](const std::size_t point, const std::span<const double> voltages)
+    {
+        ASSERT_EQ(point, next++);
+        EXPECT_LE(pulled - point, wave);
+        EXPECT_EQ(voltages[0], expected.at(point));
+    }, BLOCK_SIZE, executor);
+
+    EXPECT_EQ(next, NUMBER_OF_POINTS);
+}
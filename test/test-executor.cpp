@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+#include "circlyzer/async_analysis.h"
+#include "circlyzer/executor.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_WORKERS = 3U;
+
+    /**
+     * \brief RC low pass, returning the ground and output UIDs
+     */
+    std::pair<uint32_t, uint32_t> build_low_pass(Network& network)
+    {
+        const auto ground = network.create_node();
+        const auto input = network.create_node();
+        const auto output = network.create_node();
+
+        const auto connect = [&](std::unique_ptr<Component> component, uint32_t a, uint32_t b)
+        {
+            const auto uid = network.create_branch(std::move(component));
+            network.create_connection_between(a, uid);
+            network.create_connection_between(b, uid);
+        };
+
+        connect(std::make_unique<Voltage_Source>(1.0), input, ground);
+        connect(std::make_unique<Resistor>(1.0_kohm), input, output);
+        connect(std::make_unique<Capacitor>(1.0_muF), output, ground);
+
+        return { ground, output };
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the worker count is honoured and submitted work produces its result
+ *************************************************************************************************/
+TEST(Executor, SubmitReturnsFuture)
+{
+    Executor executor(NUMBER_OF_WORKERS);
+    EXPECT_EQ(executor.get_number_of_workers(), NUMBER_OF_WORKERS);
+
+    auto future = executor.submit([]() { return 42; });
+    EXPECT_EQ(future.get(), 42);
+}
+
+/**********************************************************************************************//**
+ * Assess that exceptions thrown by a task are delivered through its future
+ *************************************************************************************************/
+TEST(Executor, ExceptionsPropagate)
+{
+    Executor executor(NUMBER_OF_WORKERS);
+    auto future = executor.submit([]() -> int { throw Singular_Matrix_Exception(); });
+    EXPECT_THROW(future.get(), Singular_Matrix_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that work cancelled before it starts never runs
+ *************************************************************************************************/
+TEST(Executor, CancellationBeforeStart)
+{
+    Executor executor(1U);
+    std::stop_source source;
+    std::atomic<bool> release{ false };
+    std::atomic<bool> ran{ false };
+
+    // Occupy the only worker so the next task is still queued when it is cancelled
+    auto blocker = executor.submit([&]()
+    {
+        while(!release.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    auto cancelled = executor.submit(source.get_token(), [&]() { ran = true; });
+    source.request_stop();
+    release = true;
+
+    blocker.get();
+    EXPECT_THROW(cancelled.get(), Cancelled_Operation_Exception);
+    EXPECT_FALSE(ran.load());
+}
+
+/**********************************************************************************************//**
+ * Assess that parallel_for covers the range exactly once, including when nested inside a task
+ *************************************************************************************************/
+TEST(Executor, NestedParallelFor)
+{
+    Executor executor(NUMBER_OF_WORKERS);
+    std::vector<int> values(1000U, 0);
+
+    auto future = executor.submit([&]()
+    {
+        executor.parallel_for(0U, values.size(), [&](std::size_t first, std::size_t last)
+        {
+            for(auto index = first; index < last; ++index)
+            {
+                values[index] += 1;
+            }
+        });
+    });
+
+    future.get();
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 1000);
+}
+
+/**********************************************************************************************//**
+ * Assess that a caller with nothing left to run sleeps until parallel_for's last chunk is done,
+ * rather than spinning
+ *************************************************************************************************/
+TEST(Executor, ParallelForWaitsWithoutSpinning)
+{
+    Executor executor(NUMBER_OF_WORKERS);
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> started{ false };
+
+    const auto thread_time = []()
+    {
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+    };
+
+    const auto before = thread_time();
+    executor.parallel_for(0U, 2U, [&](std::size_t, std::size_t)
+    {
+        if(std::this_thread::get_id() == caller)
+        {
+            // Leaves the caller with nothing to do while a worker holds the other chunk
+            while(!started.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            return;
+        }
+
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    });
+
+    EXPECT_TRUE(started.load());
+    EXPECT_LT(thread_time() - before, std::chrono::milliseconds(50));
+}
+
+/**********************************************************************************************//**
+ * Assess that the shared executor can't be reconfigured once it's running
+ *************************************************************************************************/
+TEST(Executor, SharedExecutorConfiguration)
+{
+    Executor::get_shared();
+    EXPECT_THROW(Executor::configure_shared(2U), Executor_Already_Running_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that asynchronous solves, sweeps and reductions agree with the synchronous analyses
+ *************************************************************************************************/
+TEST(Executor, AsyncSolveSweepAndReduce)
+{
+    Executor executor(NUMBER_OF_WORKERS);
+    Network network;
+    const auto [ground, output] = build_low_pass(network);
+    const auto compiled = network.compile();
+
+    const std::vector<double> frequencies = { 10.0, 100.0, 1000.0, 10000.0 };
+    auto single = solve_async(compiled, ground, frequencies[2], {}, executor);
+    auto sweep = sweep_async(compiled, ground, frequencies, {}, executor);
+    auto reduction = reduce_async(compiled, ground, output, frequencies[1], {}, {}, executor);
+
+    const Nodal_Analysis analysis(*compiled, ground);
+    EXPECT_EQ(single.get().node_voltages.at(output),
+              analysis.solve(frequencies[2]).node_voltages.at(output));
+
+    const auto results = sweep.get();
+    ASSERT_EQ(results.size(), frequencies.size());
+    for(std::size_t index = 0U; index < frequencies.size(); ++index)
+    {
+        EXPECT_EQ(results[index].node_voltages.at(output),
+                  analysis.solve(frequencies[index]).node_voltages.at(output));
+    }
+
+    EXPECT_EQ(reduction.get().impedance, reduce_impedance(*compiled, ground, output, frequencies[1]).impedance);
+}
+
+/**********************************************************************************************//**
+ * Assess that a cancelled sweep or reduction reports the cancellation through its future
+ *************************************************************************************************/
+TEST(Executor, CancelledSweep)
+{
+    Executor executor(NUMBER_OF_WORKERS);
+    Network network;
+    const auto ground = build_low_pass(network).first;
+
+    std::stop_source source;
+    source.request_stop();
+
+    auto sweep = sweep_async(network.compile(), ground, { 1.0, 2.0 }, source.get_token(), executor);
+    EXPECT_THROW(sweep.get(), Cancelled_Operation_Exception);
+
+    auto reduction = reduce_async(network.compile(), ground, ground, 1.0, {}, source.get_token(), executor);
+    EXPECT_THROW(reduction.get(), Cancelled_Operation_Exception);
+}
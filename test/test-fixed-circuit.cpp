@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "circlyzer/fixed_circuit.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto TOLERANCE = 1e-9;
+    constexpr auto ANGULAR_FREQUENCY = 1000.0;
+
+    // Node 1 is driven by the source, node 2 is the divider tap
+    using Divider = Fixed_Circuit<3U,
+                                  Fixed_Voltage_Source<1U, 0U>,
+                                  Fixed_Resistor<1U, 2U>,
+                                  Fixed_Resistor<2U, 0U>>;
+
+    // Series RLC driven at node 1, measured across the capacitor at node 3
+    using Series_RLC = Fixed_Circuit<4U,
+                                     Fixed_Voltage_Source<1U, 0U>,
+                                     Fixed_Resistor<1U, 2U>,
+                                     Fixed_Inductor<2U, 3U>,
+                                     Fixed_Capacitor<3U, 0U>>;
+}
+
+/**********************************************************************************************//**
+ * Assess that the compile time system is sized from the element list
+ *************************************************************************************************/
+TEST(FixedCircuit, SystemSize)
+{
+    EXPECT_EQ(Divider::number_of_currents, 1U);
+    EXPECT_EQ(Divider::system_size, 3U);
+    EXPECT_EQ(Series_RLC::number_of_currents, 2U);
+    EXPECT_EQ(Series_RLC::system_size, 5U);
+}
+
+/**********************************************************************************************//**
+ * Assess that a resistive divider can be solved entirely at compile time
+ *************************************************************************************************/
+TEST(FixedCircuit, ConstexprVoltageDivider)
+{
+    constexpr auto voltages = Divider::solve({ 10.0, 3.0_kohm, 1.0_kohm });
+
+    static_assert(voltages[1].real() > 9.999 && voltages[1].real() < 10.001);
+    static_assert(voltages[2].real() > 2.499 && voltages[2].real() < 2.501);
+
+    EXPECT_NEAR(voltages[2].real(), 2.5, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that the specialised solver agrees with the dynamic Nodal_Analysis path
+ *************************************************************************************************/
+TEST(FixedCircuit, MatchesNodalAnalysis)
+{
+    const Series_RLC::Values values = { 1.0, 100.0_ohm, 10.0_mH, 1.0_muF };
+
+    Network network;
+    const auto ground = network.create_node();
+    const auto nodes = std::array{ ground, network.create_node(), network.create_node(),
+                                   network.create_node() };
+
+    const auto connect = [&](std::unique_ptr<Component> component, uint32_t a, uint32_t b)
+    {
+        const auto uid = network.create_branch(std::move(component));
+        network.create_connection_between(nodes[a], uid);
+        network.create_connection_between(nodes[b], uid);
+    };
+
+    connect(std::make_unique<Voltage_Source>(values[0]), 1U, 0U);
+    connect(std::make_unique<Resistor>(values[1].real()), 1U, 2U);
+    connect(std::make_unique<Inductor>(values[2].real()), 2U, 3U);
+    connect(std::make_unique<Capacitor>(values[3].real()), 3U, 0U);
+
+    const auto expected = Nodal_Analysis(network, ground).solve(ANGULAR_FREQUENCY);
+    const auto voltages = Series_RLC::solve(values, ANGULAR_FREQUENCY);
+
+    for(std::size_t node = 0U; node < nodes.size(); ++node)
+    {
+        EXPECT_NEAR(std::abs(voltages[node] - expected.node_voltages.at(nodes[node])), 0.0,
+                    TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that an unsolvable set of values is reported rather than producing garbage
+ *************************************************************************************************/
+TEST(FixedCircuit, SingularValues)
+{
+    using Floating = Fixed_Circuit<3U, Fixed_Resistor<1U, 0U>, Fixed_Capacitor<2U, 0U>>;
+
+    // At DC the capacitor is open, leaving node 2 floating
+    EXPECT_THROW(Floating::solve({ 1.0_kohm, 1.0_muF }), Singular_Matrix_Exception);
+}
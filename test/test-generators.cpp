@@ -0,0 +1,157 @@
+#include "gtest/gtest.h"
+#include "circlyzer/compiled_network.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/exceptions.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 1234U;
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+
+    // Large enough that a quadratic UID search would take minutes
+    constexpr auto SCALE_SECTIONS = 30000U;
+
+    // Set to an element count to also run the production sized check
+    constexpr auto SCALE_VARIABLE = "CIRCLYZER_SCALE_ELEMENTS";
+
+    std::vector<std::complex<double>> values_of(const Network& network)
+    {
+        const auto compiled = network.compile();
+        const auto values = compiled->get_values();
+        return std::vector<std::complex<double>>(values.begin(), values.end());
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the reported counts match what ended up in the network
+ *************************************************************************************************/
+TEST(Generators, Counts)
+{
+    Network ladder;
+    const auto ladder_circuit = generate_ladder(ladder, 10U, SEED);
+    ASSERT_EQ(ladder_circuit.number_of_nodes, 12U);
+    ASSERT_EQ(ladder_circuit.number_of_branches, 21U);
+    ASSERT_EQ(ladder.get_number_of_nodes(), 12U);
+    ASSERT_EQ(ladder.get_number_of_branches(), 21U);
+
+    Network grid;
+    const auto grid_circuit = generate_grid(grid, 4U, 3U, 2U, SEED);
+    ASSERT_EQ(grid_circuit.number_of_nodes, 25U);
+    // (3 * 3 + 4 * 2) * 2 in plane, 12 between planes, plus the source and the load
+    ASSERT_EQ(grid_circuit.number_of_branches, 34U + 12U + 2U);
+    ASSERT_EQ(grid.get_number_of_branches(), grid_circuit.number_of_branches);
+
+    Network sparse;
+    const auto sparse_circuit = generate_random_sparse(sparse, 100U, 6.0, SEED);
+    ASSERT_EQ(sparse_circuit.number_of_nodes, 101U);
+    ASSERT_EQ(sparse_circuit.number_of_branches, 300U + 2U);
+
+    Network tree;
+    const auto tree_circuit = generate_rlc_tree(tree, 50U, 3U, SEED);
+    ASSERT_EQ(tree_circuit.number_of_nodes, 51U);
+    ASSERT_EQ(tree_circuit.number_of_branches, 1U + 49U + 50U);
+}
+
+/**********************************************************************************************//**
+ * Assess that a seed always gives the same network and different seeds give different ones
+ *************************************************************************************************/
+TEST(Generators, Seeded)
+{
+    Network first, second, third;
+    generate_random_sparse(first, 200U, 4.0, SEED);
+    generate_random_sparse(second, 200U, 4.0, SEED);
+    generate_random_sparse(third, 200U, 4.0, SEED + 1U);
+
+    const auto first_compiled = first.compile();
+    const auto second_compiled = second.compile();
+    ASSERT_EQ(first_compiled->get_node_offsets(), second_compiled->get_node_offsets());
+    ASSERT_EQ(first_compiled->get_node_branches(), second_compiled->get_node_branches());
+    ASSERT_EQ(values_of(first), values_of(second));
+    ASSERT_NE(values_of(first), values_of(third));
+}
+
+/**********************************************************************************************//**
+ * Assess that every generated circuit solves, and the ladder attenuates along its length
+ *************************************************************************************************/
+TEST(Generators, Solvable)
+{
+    Network ladder;
+    const auto circuit = generate_ladder(ladder, 20U, SEED);
+    const auto solution = Nodal_Analysis(ladder, circuit.ground_uid).solve();
+
+    const auto nodes = ladder.get_node_uids();
+    for(std::size_t index = 2U; index < nodes.size(); ++index)
+    {
+        ASSERT_LT(solution.node_voltages.at(nodes[index]).real(),
+                  solution.node_voltages.at(nodes[index - 1U]).real());
+    }
+
+    Network grid;
+    const auto grid_circuit = generate_grid(grid, 5U, 5U, 1U, SEED);
+    ASSERT_NO_THROW(Nodal_Analysis(grid, grid_circuit.ground_uid).solve());
+
+    Network sparse;
+    const auto sparse_circuit = generate_random_sparse(sparse, 60U, 3.0, SEED);
+    ASSERT_NO_THROW(Nodal_Analysis(sparse, sparse_circuit.ground_uid).solve());
+
+    Network tree;
+    const auto tree_circuit = generate_rlc_tree(tree, 60U, 4U, SEED);
+    const Nodal_Analysis tree_analysis(tree, tree_circuit.ground_uid);
+    ASSERT_NO_THROW(tree_analysis.solve());
+    ASSERT_NO_THROW(tree_analysis.solve(ANGULAR_FREQUENCY));
+}
+
+/**********************************************************************************************//**
+ * Assess that empty sizes are refused
+ *************************************************************************************************/
+TEST(Generators, InvalidSizes)
+{
+    Network network;
+    ASSERT_THROW(generate_ladder(network, 0U), Invalid_Generator_Size_Exception);
+    ASSERT_THROW(generate_grid(network, 0U, 4U), Invalid_Generator_Size_Exception);
+    ASSERT_THROW(generate_random_sparse(network, 0U), Invalid_Generator_Size_Exception);
+    ASSERT_THROW(generate_rlc_tree(network, 10U, 0U), Invalid_Generator_Size_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that building a few hundred thousand entities stays fast, and compiles consistently
+ *************************************************************************************************/
+TEST(Generators, Scale)
+{
+    Network network;
+    const auto circuit = generate_ladder(network, SCALE_SECTIONS, SEED);
+    ASSERT_EQ(network.get_number_of_entities(), circuit.number_of_nodes + circuit.number_of_branches);
+
+    const auto compiled = network.compile();
+    ASSERT_EQ(compiled->get_number_of_branches(), circuit.number_of_branches);
+    ASSERT_EQ(compiled->get_incident_branches(compiled->get_node_index(circuit.ground_uid)).size(),
+              SCALE_SECTIONS + 1U);
+}
+
+/**********************************************************************************************//**
+ * Assess production sized networks when CIRCLYZER_SCALE_ELEMENTS is set, e.g. for releases
+ *************************************************************************************************/
+TEST(Generators, ProductionScale)
+{
+    const auto* requested = std::getenv(SCALE_VARIABLE);
+    if(requested == nullptr)
+    {
+        GTEST_SKIP() << "Set " << SCALE_VARIABLE << " to run";
+    }
+
+    const auto number_of_elements = std::stoull(requested);
+
+    Network network;
+    const auto circuit = generate_random_sparse(network, number_of_elements / 3U, 4.0, SEED);
+    const auto compiled = network.compile();
+    ASSERT_EQ(compiled->get_number_of_nodes(), circuit.number_of_nodes);
+    ASSERT_EQ(compiled->get_number_of_branches(), circuit.number_of_branches);
+}
@@ -0,0 +1,220 @@
+#include "gtest/gtest.h"
+#include "circlyzer/graph_export.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace Circlyzer;
+
+namespace
+{
+    /**
+     * \brief ground -- source -- top, then top -- R1 -- inner -- R2 -- bottom and a third
+     *        resistor straight from top to bottom, with bottom -- C -- ground
+     */
+    struct Ladder
+    {
+        Ladder()
+        {
+            ground = network.create_node();
+            top = network.create_node();
+            inner = network.create_node();
+            bottom = network.create_node();
+
+            source = network.create_branch(std::make_unique<Voltage_Source>(5.0));
+            first = network.create_branch(std::make_unique<Resistor>(100.0_ohm));
+            second = network.create_branch(std::make_unique<Resistor>(200.0_ohm));
+            bypass = network.create_branch(std::make_unique<Resistor>(300.0_ohm));
+            capacitor = network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+
+            network.create_connection_between(top, source);
+            network.create_connection_between(ground, source);
+            network.create_connection_between(top, first);
+            network.create_connection_between(inner, first);
+            network.create_connection_between(inner, second);
+            network.create_connection_between(bottom, second);
+            network.create_connection_between(top, bypass);
+            network.create_connection_between(bottom, bypass);
+            network.create_connection_between(bottom, capacitor);
+            network.create_connection_between(ground, capacitor);
+
+            network.update_alias(ground, "GND");
+            network.update_alias(top, "VCC");
+            network.update_alias(bottom, "OUT");
+        }
+
+        std::string export_to_string(const Export_Options& options = {})
+        {
+            std::ostringstream stream;
+            Stream_Sink sink(stream);
+            export_network(network, sink, options);
+            return stream.str();
+        }
+
+        Network network;
+        uint32_t ground, top, inner, bottom;
+        uint32_t source, first, second, bypass, capacitor;
+    };
+
+    std::size_t count(const std::string& text, const std::string& pattern)
+    {
+        std::size_t occurrences = 0U;
+        for(auto position = text.find(pattern); position != std::string::npos;
+            position = text.find(pattern, position + 1U))
+        {
+            ++occurrences;
+        }
+
+        return occurrences;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that every node becomes a vertex and every connected branch an edge
+ *************************************************************************************************/
+TEST(GraphExport, Dot)
+{
+    Ladder ladder;
+    const auto text = ladder.export_to_string();
+
+    ASSERT_EQ(text.rfind("graph circlyzer {\n", 0U), 0U);
+    ASSERT_EQ(text.substr(text.size() - 2U), "}\n");
+    ASSERT_EQ(count(text, " -- "), 5U);
+
+    const auto inner = "n" + std::to_string(ladder.inner);
+    ASSERT_NE(text.find(inner + " [label=\"" + std::to_string(ladder.inner) + "\"]"), std::string::npos);
+    ASSERT_NE(text.find("[label=\"VCC\"]"), std::string::npos);
+    ASSERT_NE(text.find("R=300"), std::string::npos);
+    ASSERT_NE(text.find("C=1e-06"), std::string::npos);
+    ASSERT_NE(text.find("V=5+0j"), std::string::npos);
+}
+
+/**********************************************************************************************//**
+ * Assess that the GraphML document is balanced and carries the component data
+ *************************************************************************************************/
+TEST(GraphExport, GraphML)
+{
+    Ladder ladder;
+    Export_Options options;
+    options.format = Graph_Format::GraphML;
+    const auto text = ladder.export_to_string(options);
+
+    ASSERT_EQ(text.rfind("<?xml", 0U), 0U);
+    ASSERT_EQ(count(text, "<node "), 4U);
+    ASSERT_EQ(count(text, "</node>"), 4U);
+    ASSERT_EQ(count(text, "<edge "), 5U);
+    ASSERT_EQ(count(text, "</edge>"), 5U);
+    ASSERT_NE(text.find("<data key=\"alias\">OUT</data>"), std::string::npos);
+    ASSERT_NE(text.find("<data key=\"type\">Capacitor</data>"), std::string::npos);
+    ASSERT_NE(text.find("</graphml>\n"), std::string::npos);
+}
+
+/**********************************************************************************************//**
+ * Assess that aliases can't break out of their quoting
+ *************************************************************************************************/
+TEST(GraphExport, Escaping)
+{
+    Ladder ladder;
+    ladder.network.update_alias(ladder.top, "a\"<b>&");
+
+    const auto dot = ladder.export_to_string();
+    ASSERT_NE(dot.find("label=\"a\\\"<b>&\""), std::string::npos);
+
+    Export_Options options;
+    options.format = Graph_Format::GraphML;
+    const auto graphml = ladder.export_to_string(options);
+    ASSERT_NE(graphml.find("a&quot;&lt;b&gt;&amp;"), std::string::npos);
+}
+
+/**********************************************************************************************//**
+ * Assess that branches missing a terminal are drawn as their own vertex
+ *************************************************************************************************/
+TEST(GraphExport, DanglingBranch)
+{
+    Ladder ladder;
+    const auto dangling = ladder.network.create_branch(std::make_unique<Inductor>(1.0_mH));
+    ladder.network.create_connection_between(ladder.inner, dangling);
+
+    const auto text = ladder.export_to_string();
+    const auto id = "b" + std::to_string(dangling);
+    ASSERT_NE(text.find(id + " [shape=box"), std::string::npos);
+    ASSERT_NE(text.find("n" + std::to_string(ladder.inner) + " -- " + id), std::string::npos);
+}
+
+/**********************************************************************************************//**
+ * Assess that R1 + R2 in series, in parallel with R3, collapse into one 150 ohm edge while the
+ * source and capacitor stay as they are
+ *************************************************************************************************/
+TEST(GraphExport, CollapseSeriesParallel)
+{
+    Ladder ladder;
+    Export_Options options;
+    options.collapse_series_parallel = true;
+    const auto text = ladder.export_to_string(options);
+
+    ASSERT_EQ(count(text, " -- "), 3U);
+    ASSERT_EQ(text.find("n" + std::to_string(ladder.inner) + " "), std::string::npos);
+    ASSERT_NE(text.find("3 branches\\nZ=150+0j"), std::string::npos);
+    ASSERT_NE(text.find("id=\"g" + std::to_string(ladder.first) + "\""), std::string::npos);
+    ASSERT_NE(text.find("V=5+0j"), std::string::npos);
+    ASSERT_NE(text.find("C=1e-06"), std::string::npos);
+}
+
+/**********************************************************************************************//**
+ * Assess that output larger than the sink's buffer arrives intact through a file descriptor
+ *************************************************************************************************/
+TEST(GraphExport, FileDescriptorSink)
+{
+    Network network;
+    auto previous = network.create_node();
+    for(auto index = 0U; index < 2000U; ++index)
+    {
+        const auto node = network.create_node();
+        const auto branch = network.create_branch(std::make_unique<Resistor>(1.0_ohm));
+        network.create_connection_between(previous, branch);
+        network.create_connection_between(node, branch);
+        previous = node;
+    }
+
+    std::ostringstream expected;
+    {
+        Stream_Sink sink(expected);
+        export_network(network, sink);
+    }
+    ASSERT_GT(expected.str().size(), Output_Sink::BUFFER_SIZE);
+
+    auto* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        File_Descriptor_Sink sink(::fileno(file));
+        export_network(network, sink);
+    }
+
+    std::rewind(file);
+    std::string written;
+    char buffer[4096];
+    for(auto read = std::fread(buffer, 1U, sizeof(buffer), file); read > 0U;
+        read = std::fread(buffer, 1U, sizeof(buffer), file))
+    {
+        written.append(buffer, read);
+    }
+    std::fclose(file);
+
+    ASSERT_EQ(written, expected.str());
+}
+
+/**********************************************************************************************//**
+ * Assess that write failures are reported
+ *************************************************************************************************/
+TEST(GraphExport, WriteFailure)
+{
+    Ladder ladder;
+    File_Descriptor_Sink sink(-1);
+    ASSERT_THROW(export_network(ladder.network, sink), Export_Failed_Exception);
+}
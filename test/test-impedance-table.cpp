@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+#include "circlyzer/impedance_table.h"
+#include "circlyzer/network.h"
+#include "circlyzer/component.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto TOLERANCE = 1e-12;
+    constexpr auto FIRST_FREQUENCY = 100.0;
+    constexpr auto SECOND_FREQUENCY = 1000.0;
+}
+
+/**********************************************************************************************//**
+ * Assess that the table agrees with the get_impedence functions on the components
+ *************************************************************************************************/
+TEST(ImpedanceTable, MatchesComponentImpedances)
+{
+    Network network;
+    const auto resistor = network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    const auto capacitor = network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+    const auto inductor = network.create_branch(std::make_unique<Inductor>(10.0_mH));
+    const auto source = network.create_branch(std::make_unique<Voltage_Source>(1.0));
+
+    Impedance_Table table(network);
+
+    EXPECT_NEAR(std::abs(table.get_impedance(resistor, FIRST_FREQUENCY) -
+                         Resistor(1.0_kohm).get_impedence()), 0.0, TOLERANCE);
+    EXPECT_NEAR(std::abs(table.get_impedance(capacitor, FIRST_FREQUENCY) -
+                         Capacitor(1.0_muF).get_impedence(FIRST_FREQUENCY)), 0.0, TOLERANCE);
+    EXPECT_NEAR(std::abs(table.get_impedance(inductor, FIRST_FREQUENCY) -
+                         Inductor(10.0_mH).get_impedence(FIRST_FREQUENCY)), 0.0, TOLERANCE);
+    EXPECT_EQ(table.get_impedance(source, FIRST_FREQUENCY), std::complex<double>(0.0));
+
+    EXPECT_THROW(table.get_impedance(0xDEADBEEFU, FIRST_FREQUENCY), Non_Existant_UID_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that repeated requests for a frequency are served without recomputation
+ *************************************************************************************************/
+TEST(ImpedanceTable, RepeatedFrequenciesAreCached)
+{
+    Network network;
+    network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+    network.create_branch(std::make_unique<Inductor>(10.0_mH));
+
+    Impedance_Table table(network);
+
+    table.get_impedances(FIRST_FREQUENCY);
+    table.get_impedances(SECOND_FREQUENCY);
+    EXPECT_EQ(table.get_number_of_evaluations(), 6U);
+    EXPECT_EQ(table.get_number_of_cached_frequencies(), 2U);
+
+    table.get_impedances(FIRST_FREQUENCY);
+    table.get_impedances(SECOND_FREQUENCY);
+    EXPECT_EQ(table.get_number_of_evaluations(), 6U);
+}
+
+/**********************************************************************************************//**
+ * Assess that invalidating a branch recomputes only that branch at each cached frequency
+ *************************************************************************************************/
+TEST(ImpedanceTable, InvalidateRecomputesOnlyChangedEntries)
+{
+    Network network;
+    network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    const auto capacitor = network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+    network.create_branch(std::make_unique<Inductor>(10.0_mH));
+
+    Impedance_Table table(network);
+    table.get_impedances(FIRST_FREQUENCY);
+    table.get_impedances(SECOND_FREQUENCY);
+
+    network.update_component(capacitor, std::make_unique<Capacitor>(2.0_muF));
+    table.invalidate(capacitor);
+
+    const auto expected = Capacitor(2.0_muF).get_impedence(FIRST_FREQUENCY);
+    EXPECT_NEAR(std::abs(table.get_impedance(capacitor, FIRST_FREQUENCY) - expected), 0.0,
+                TOLERANCE);
+    EXPECT_EQ(table.get_number_of_evaluations(), 7U);
+
+    table.get_impedances(SECOND_FREQUENCY);
+    EXPECT_EQ(table.get_number_of_evaluations(), 8U);
+}
+
+/**********************************************************************************************//**
+ * Assess that structural changes rebuild the table
+ *************************************************************************************************/
+TEST(ImpedanceTable, NewBranchRebuildsTable)
+{
+    Network network;
+    network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+
+    Impedance_Table table(network);
+    table.get_impedances(FIRST_FREQUENCY);
+
+    const auto inductor = network.create_branch(std::make_unique<Inductor>(1.0_H));
+    table.invalidate(inductor);
+
+    EXPECT_EQ(table.get_number_of_cached_frequencies(), 0U);
+    EXPECT_EQ(table.get_branch_uids().size(), 2U);
+    EXPECT_NEAR(table.get_impedance(inductor, FIRST_FREQUENCY).imag(), FIRST_FREQUENCY, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that the least recently used frequency is evicted once the capacity is reached
+ *************************************************************************************************/
+TEST(ImpedanceTable, EvictsLeastRecentlyUsed)
+{
+    Network network;
+    network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+
+    Impedance_Table table(network, 2U);
+    table.get_impedances(1.0);
+    table.get_impedances(2.0);
+    table.get_impedances(1.0);
+    table.get_impedances(3.0);
+
+    EXPECT_EQ(table.get_number_of_cached_frequencies(), 2U);
+
+    // 1.0 was used more recently than 2.0, so it should still be cached
+    const auto evaluations = table.get_number_of_evaluations();
+    table.get_impedances(1.0);
+    EXPECT_EQ(table.get_number_of_evaluations(), evaluations);
+}
+
+/**********************************************************************************************//**
+ * Assess that a table over a compiled view serves closed form admittances and stays fixed
+ *************************************************************************************************/
+TEST(ImpedanceTable, CompiledTableServesAdmittances)
+{
+    Network network;
+    network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+    network.create_branch(std::make_unique<Inductor>(10.0_mH));
+
+    Impedance_Table table(*network.compile());
+
+    const auto& admittances = table.get_admittances(FIRST_FREQUENCY);
+    ASSERT_EQ(admittances.size(), 3U);
+    EXPECT_NEAR(std::abs(admittances[0] - (1.0 / Resistor(1.0_kohm).get_impedence())), 0.0, TOLERANCE);
+    EXPECT_NEAR(std::abs(admittances[1] - (1.0 / Capacitor(1.0_muF).get_impedence(FIRST_FREQUENCY))),
+                0.0, TOLERANCE);
+    EXPECT_NEAR(std::abs(admittances[2] - (1.0 / Inductor(10.0_mH).get_impedence(FIRST_FREQUENCY))),
+                0.0, TOLERANCE);
+
+    // Impedances come from the same evaluation
+    table.get_impedances(FIRST_FREQUENCY);
+    EXPECT_EQ(table.get_number_of_evaluations(), 3U);
+
+    // Nothing in the source network reaches the snapshot
+    network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    EXPECT_EQ(table.get_impedances(FIRST_FREQUENCY).size(), 3U);
+    EXPECT_EQ(table.get_number_of_evaluations(), 3U);
+}
+
+/**********************************************************************************************//**
+ * Assess that shared values stay as they were while held, through updates and eviction
+ *************************************************************************************************/
+TEST(ImpedanceTable, HeldValuesStayFixed)
+{
+    Network network;
+    const auto capacitor = network.create_branch(std::make_unique<Capacitor>(1.0_muF));
+
+    Impedance_Table table(network, 1U);
+    const auto held = table.get_values(FIRST_FREQUENCY);
+    const auto impedance = held->impedances.at(0);
+
+    network.update_component(capacitor, std::make_unique<Capacitor>(2.0_muF));
+    const auto updated = table.get_values(FIRST_FREQUENCY);
+    EXPECT_NE(updated, held);
+    EXPECT_NEAR(std::abs(updated->impedances.at(0) - Capacitor(2.0_muF).get_impedence(FIRST_FREQUENCY)),
+                0.0, TOLERANCE);
+
+    table.get_values(SECOND_FREQUENCY);
+    EXPECT_EQ(table.get_number_of_cached_frequencies(), 1U);
+    EXPECT_EQ(held->impedances.at(0), impedance);
+    EXPECT_NEAR(std::abs(updated->impedances.at(0) - Capacitor(2.0_muF).get_impedence(FIRST_FREQUENCY)),
+                0.0, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that a table keeps following its network after the network is moved, and keeps its last
+ * values once the network is destroyed
+ *************************************************************************************************/
+TEST(ImpedanceTable, FollowsMovedNetwork)
+{
+    auto network = std::make_unique<Network>();
+    const auto capacitor = network->create_branch(std::make_unique<Capacitor>(1.0_muF));
+    Impedance_Table table(*network);
+
+    auto moved = std::make_unique<Network>(std::move(*network));
+    network.reset();
+
+    moved->update_component(capacitor, std::make_unique<Capacitor>(2.0_muF));
+    const auto expected = Capacitor(2.0_muF).get_impedence(FIRST_FREQUENCY);
+    EXPECT_NEAR(std::abs(table.get_impedance(capacitor, FIRST_FREQUENCY) - expected), 0.0, TOLERANCE);
+
+    moved.reset();
+    table.invalidate_all();
+    EXPECT_NEAR(std::abs(table.get_impedance(capacitor, SECOND_FREQUENCY) -
+                         Capacitor(2.0_muF).get_impedence(SECOND_FREQUENCY)), 0.0, TOLERANCE);
+}
@@ -0,0 +1,388 @@
+#include "gtest/gtest.h"
+#include "circlyzer/executor.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/iterative_analysis.h"
+#include "circlyzer/krylov.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/sparse_matrix.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace Circlyzer;
+using namespace std::complex_literals;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto TOLERANCE = 1e-7;
+    constexpr auto SEED = 7U;
+
+    /**
+     * \brief Checks an iterative solution against the dense LU solve of the same network
+     */
+    void expect_matches_direct(const Network& network, const uint32_t ground, const double frequency,
+                               const Iterative_Result& result)
+    {
+        const auto expected = Nodal_Analysis(network, ground).solve(frequency);
+
+        ASSERT_TRUE(result.converged);
+        ASSERT_EQ(result.solution.node_voltages.size(), expected.node_voltages.size());
+        ASSERT_EQ(result.solution.branch_currents.size(), expected.branch_currents.size());
+
+        for(const auto& [uid, voltage] : expected.node_voltages)
+        {
+            EXPECT_NEAR(std::abs(result.solution.node_voltages.at(uid) - voltage), 0.0, TOLERANCE)
+                << "node " << uid;
+        }
+
+        for(const auto& [uid, current] : expected.branch_currents)
+        {
+            EXPECT_NEAR(std::abs(result.solution.branch_currents.at(uid) - current), 0.0, TOLERANCE)
+                << "branch " << uid;
+        }
+    }
+
+    /**
+     * \brief Source between two non-ground nodes, so its current survives elimination
+     */
+    uint32_t build_floating_source(Network& network)
+    {
+        const auto ground = network.create_node();
+        const auto a = network.create_node();
+        const auto b = network.create_node();
+
+        const auto connect = [&](const uint32_t one, const uint32_t two, std::unique_ptr<Component> component)
+        {
+            const auto branch = network.create_branch(std::move(component));
+            network.create_connection_between(one, branch);
+            network.create_connection_between(two, branch);
+        };
+
+        connect(a, b, std::make_unique<Voltage_Source>(5.0));
+        connect(a, ground, std::make_unique<Resistor>(1.0_kohm));
+        connect(b, ground, std::make_unique<Resistor>(2.0_kohm));
+        connect(b, ground, std::make_unique<Capacitor>(100.0_nF));
+        connect(b, ground, std::make_unique<Inductor>(10.0_mH));
+
+        return ground;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that duplicate entries are summed and the product matches the dense matrix
+ *************************************************************************************************/
+TEST(IterativeAnalysis, SparseMatrix)
+{
+    std::vector<Sparse_Matrix<double>::Entry> entries = {
+        { 1U, 2U, 4.0 }, { 0U, 0U, 1.0 }, { 1U, 0U, 2.0 }, { 0U, 0U, 2.0 }, { 2U, 1U, -1.0 }
+    };
+
+    const Sparse_Matrix<double> matrix(3U, 3U, entries);
+    EXPECT_EQ(matrix.get_number_of_nonzeros(), 4U);
+    EXPECT_DOUBLE_EQ(matrix.get(0U, 0U), 3.0);
+    EXPECT_DOUBLE_EQ(matrix.get(1U, 2U), 4.0);
+    EXPECT_DOUBLE_EQ(matrix.get(2U, 2U), 0.0);
+
+    const auto positions = matrix.get_diagonal_positions();
+    EXPECT_EQ(positions[0], 0U);
+    EXPECT_EQ(positions[1], matrix.get_number_of_nonzeros());
+
+    const auto product = matrix.multiply({ 1.0, 2.0, 3.0 });
+    EXPECT_DOUBLE_EQ(product[0], 3.0);
+    EXPECT_DOUBLE_EQ(product[1], 14.0);
+    EXPECT_DOUBLE_EQ(product[2], -2.0);
+}
+
+/**********************************************************************************************//**
+ * Assess that the sparse MNA matrix holds the same values as the dense one
+ *************************************************************************************************/
+TEST(IterativeAnalysis, SparseAssembly)
+{
+    Network network;
+    const auto ground = build_floating_source(network);
+    const Nodal_Analysis analysis(network, ground);
+
+    const auto dense = analysis.assemble_matrix(ANGULAR_FREQUENCY);
+    const auto sparse = analysis.assemble_sparse_matrix(ANGULAR_FREQUENCY);
+
+    for(std::size_t row = 0U; row < analysis.get_system_size(); ++row)
+    {
+        for(std::size_t column = 0U; column < analysis.get_system_size(); ++column)
+        {
+            EXPECT_EQ(sparse.get(row, column), dense(row, column));
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the sparse LU agrees with the dense one, including at DC where inductor and source
+ * current rows have zero diagonals that must be pivoted around
+ *************************************************************************************************/
+TEST(IterativeAnalysis, SparseDirectSolve)
+{
+    Network network;
+    const auto tree = generate_rlc_tree(network, 300U, 4U, SEED);
+    const Nodal_Analysis analysis(network, tree.ground_uid);
+
+    for(const auto frequency : { 0.0, ANGULAR_FREQUENCY })
+    {
+        const Sparse_LU_Factorization<std::complex<double>> sparse(analysis.assemble_sparse_matrix(frequency));
+        const LU_Factorization<std::complex<double>> dense(analysis.assemble_matrix(frequency));
+
+        std::vector<std::complex<double>> rhs(analysis.get_system_size());
+        for(std::size_t row = 0U; row < rhs.size(); ++row)
+        {
+            rhs[row] = { std::sin(static_cast<double>(row)), std::cos(static_cast<double>(row)) };
+        }
+
+        const auto expected = dense.solve(rhs);
+        const auto solution = sparse.solve(rhs);
+        for(std::size_t row = 0U; row < rhs.size(); ++row)
+        {
+            EXPECT_NEAR(std::abs(solution[row] - expected[row]), 0.0, TOLERANCE * std::abs(expected[row]) + 1e-12)
+                << "row " << row;
+        }
+
+        // Eliminating a tree from its leaves adds little fill beyond the matrix itself
+        EXPECT_LE(sparse.get_number_of_nonzeros(),
+                  2U * analysis.assemble_sparse_matrix(frequency).get_number_of_nonzeros());
+    }
+
+    const Sparse_Matrix<double> singular(2U, 2U, { { 0U, 0U, 1.0 }, { 1U, 0U, 1.0 } });
+    EXPECT_THROW(Sparse_LU_Factorization<double>{ singular }, Singular_Matrix_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that a resistive grid at DC is solved by conjugate gradient with every preconditioner
+ *************************************************************************************************/
+TEST(IterativeAnalysis, ConjugateGradient)
+{
+    Network network;
+    const auto circuit = generate_grid(network, 12U, 12U, 1U, SEED);
+
+    for(const auto preconditioner : { Preconditioner_Type::None,
+                                      Preconditioner_Type::Jacobi,
+                                      Preconditioner_Type::Incomplete_Factorization })
+    {
+        Iterative_Options options;
+        options.preconditioner = preconditioner;
+        options.krylov.tolerance = 1e-12;
+
+        // The source ties the driven node to the ground, leaving one unknown per other node
+        const Iterative_Analysis analysis(network, circuit.ground_uid, options);
+        EXPECT_EQ(analysis.get_reduced_size(0.0), analysis.get_nodal_analysis().get_node_uids().size() - 1U);
+
+        const auto result = analysis.solve();
+        EXPECT_EQ(result.method, Iterative_Method::Conjugate_Gradient);
+        expect_matches_direct(network, circuit.ground_uid, 0.0, result);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the incomplete factorization cuts the iteration count on a large grid
+ *************************************************************************************************/
+TEST(IterativeAnalysis, PreconditioningHelps)
+{
+    Network network;
+    const auto circuit = generate_grid(network, 40U, 40U, 1U, SEED);
+
+    const auto iterations = [&](const Preconditioner_Type preconditioner)
+    {
+        Iterative_Options options;
+        options.preconditioner = preconditioner;
+
+        const auto result = Iterative_Analysis(network, circuit.ground_uid, options).solve();
+        EXPECT_TRUE(result.converged);
+        return result.iterations;
+    };
+
+    const auto none = iterations(Preconditioner_Type::None);
+    const auto jacobi = iterations(Preconditioner_Type::Jacobi);
+    const auto incomplete = iterations(Preconditioner_Type::Incomplete_Factorization);
+
+    EXPECT_LE(jacobi, none);
+    EXPECT_LT(incomplete, jacobi);
+}
+
+/**********************************************************************************************//**
+ * Assess that BiCGSTAB and GMRES solve a complex RLC network
+ *************************************************************************************************/
+TEST(IterativeAnalysis, ComplexSolvers)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 300U, 4U, SEED);
+
+    for(const auto method : { Iterative_Method::BiCGSTAB, Iterative_Method::GMRES })
+    {
+        Iterative_Options options;
+        options.method = method;
+        options.krylov.tolerance = 1e-12;
+        options.krylov.restart = 20U;
+
+        const auto result = Iterative_Analysis(network, circuit.ground_uid, options).solve(ANGULAR_FREQUENCY);
+        EXPECT_EQ(result.method, method);
+        expect_matches_direct(network, circuit.ground_uid, ANGULAR_FREQUENCY, result);
+    }
+
+    // Inductors short at DC, which leaves a conductance matrix for conjugate gradient
+    const auto result = Iterative_Analysis(network, circuit.ground_uid).solve();
+    EXPECT_EQ(result.method, Iterative_Method::Conjugate_Gradient);
+    expect_matches_direct(network, circuit.ground_uid, 0.0, result);
+}
+
+/**********************************************************************************************//**
+ * Assess that the complex solvers handle a meshed RLC network, where the incomplete
+ * factorization is no longer exact
+ *************************************************************************************************/
+TEST(IterativeAnalysis, ComplexMesh)
+{
+    constexpr auto SIDE = 12U;
+
+    Network network;
+    const auto ground = network.create_node();
+    std::vector<uint32_t> nodes;
+    for(std::size_t index = 0U; index < SIDE * SIDE; ++index)
+    {
+        nodes.push_back(network.create_node());
+    }
+
+    const auto connect = [&](const uint32_t one, const uint32_t two, std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(one, branch);
+        network.create_connection_between(two, branch);
+    };
+
+    connect(nodes.front(), ground, std::make_unique<Voltage_Source>(1.0));
+    for(std::size_t row = 0U; row < SIDE; ++row)
+    {
+        for(std::size_t column = 0U; column < SIDE; ++column)
+        {
+            const auto node = nodes[(row * SIDE) + column];
+            if(column + 1U < SIDE)
+            {
+                connect(node, nodes[(row * SIDE) + column + 1U],
+                        std::make_unique<Resistor>(100.0_ohm * static_cast<double>(1U + ((row + column) % 5U))));
+            }
+
+            if(row + 1U < SIDE)
+            {
+                connect(node, nodes[((row + 1U) * SIDE) + column], std::make_unique<Inductor>(1.0_mH));
+            }
+
+            connect(node, ground, std::make_unique<Capacitor>(100.0_nF));
+        }
+    }
+
+    for(const auto method : { Iterative_Method::BiCGSTAB, Iterative_Method::GMRES })
+    {
+        Iterative_Options options;
+        options.method = method;
+        options.krylov.tolerance = 1e-12;
+
+        const auto result = Iterative_Analysis(network, ground, options).solve(ANGULAR_FREQUENCY);
+        expect_matches_direct(network, ground, ANGULAR_FREQUENCY, result);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that voltage sources in a loop are reported like the direct solve reports them
+ *************************************************************************************************/
+TEST(IterativeAnalysis, SourceLoop)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto node = network.create_node();
+
+    for(const auto voltage : { 1.0, 2.0 })
+    {
+        const auto branch = network.create_branch(std::make_unique<Voltage_Source>(voltage));
+        network.create_connection_between(node, branch);
+        network.create_connection_between(ground, branch);
+    }
+
+    EXPECT_THROW(Iterative_Analysis(network, ground).solve(), Singular_Matrix_Exception);
+    EXPECT_THROW(Nodal_Analysis(network, ground).solve(), Singular_Matrix_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that a source without a grounded terminal still solves, with its current recovered
+ *************************************************************************************************/
+TEST(IterativeAnalysis, FloatingSource)
+{
+    Network network;
+    const auto ground = build_floating_source(network);
+
+    for(const auto method : { Iterative_Method::BiCGSTAB, Iterative_Method::GMRES })
+    {
+        Iterative_Options options;
+        options.method = method;
+        options.krylov.tolerance = 1e-13;
+
+        // Both ends of the source share one unknown
+        const Iterative_Analysis analysis(network, ground, options);
+        EXPECT_EQ(analysis.get_reduced_size(ANGULAR_FREQUENCY), 1U);
+
+        expect_matches_direct(network, ground, ANGULAR_FREQUENCY, analysis.solve(ANGULAR_FREQUENCY));
+        expect_matches_direct(network, ground, 0.0, analysis.solve(0.0));
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the multithreaded product gives the same answer as the serial one
+ *************************************************************************************************/
+TEST(IterativeAnalysis, ParallelProduct)
+{
+    Network network;
+    const auto circuit = generate_random_sparse(network, 2000U, 4.0, SEED);
+    Executor executor(4U);
+
+    Iterative_Options serial;
+    serial.parallel_threshold = std::numeric_limits<std::size_t>::max();
+
+    Iterative_Options parallel;
+    parallel.executor = &executor;
+    parallel.parallel_threshold = 0U;
+
+    const auto one = Iterative_Analysis(network, circuit.ground_uid, serial).solve();
+    const auto two = Iterative_Analysis(network, circuit.ground_uid, parallel).solve();
+
+    ASSERT_TRUE(one.converged);
+    EXPECT_EQ(one.iterations, two.iterations);
+    for(const auto& [uid, voltage] : one.solution.node_voltages)
+    {
+        EXPECT_EQ(two.solution.node_voltages.at(uid), voltage);
+    }
+
+    const auto matrix = Iterative_Analysis(network, circuit.ground_uid).assemble_reduced_matrix(0.0);
+    std::vector<std::complex<double>> vector(matrix.get_number_of_rows());
+    for(std::size_t index = 0U; index < vector.size(); ++index)
+    {
+        vector[index] = std::complex<double>(std::sin(index), std::cos(index));
+    }
+
+    std::vector<std::complex<double>> threaded;
+    matrix.multiply(vector, threaded, executor);
+    EXPECT_EQ(threaded, matrix.multiply(vector));
+}
+
+/**********************************************************************************************//**
+ * Assess that a system with no excitation converges immediately to zero
+ *************************************************************************************************/
+TEST(IterativeAnalysis, ZeroExcitation)
+{
+    const Sparse_Matrix<double> matrix(2U, 2U, { { 0U, 0U, 2.0 }, { 1U, 1U, 3.0 } });
+    const auto multiply = [&](const std::vector<double>& x, std::vector<double>& y) { matrix.multiply(x, y); };
+
+    std::vector<double> solution = { 1.0, 1.0 };
+    const auto result = conjugate_gradient(multiply, std::vector<double>{ 0.0, 0.0 }, solution,
+                                           Identity_Preconditioner<double>());
+
+    EXPECT_TRUE(result.converged);
+    EXPECT_EQ(result.iterations, 0U);
+    EXPECT_EQ(solution, std::vector<double>({ 0.0, 0.0 }));
+}
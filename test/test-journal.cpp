@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "circlyzer/journal.h"
+#include "circlyzer/network.h"
+#include "circlyzer/component.h"
+#include "circlyzer/impedance_table.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+/**********************************************************************************************//**
+ * Assess that every successful mutator appends exactly one change, in order
+ *************************************************************************************************/
+TEST(Journal, RecordsEveryMutation)
+{
+    Network network;
+    const auto node = network.create_node();
+    const auto branch = network.create_branch(std::make_unique<Resistor>(1.0_ohm));
+    network.create_connection_between(node, branch);
+    network.update_alias(node, "IN");
+    network.update_component(branch, std::make_unique<Resistor>(2.0_ohm));
+    network.delete_connection_between(node, branch);
+    network.destroy_entity(branch);
+    network.destroy_entity(node);
+
+    const auto changes = network.get_journal().get_changes_since(0U);
+    ASSERT_EQ(changes.size(), 8U);
+
+    EXPECT_EQ(changes[0].type, Change_Type::Node_Created);
+    EXPECT_EQ(changes[1].type, Change_Type::Branch_Created);
+    EXPECT_EQ(changes[2].type, Change_Type::Connection_Created);
+    EXPECT_EQ(changes[2].uid, node);
+    EXPECT_EQ(changes[2].other_uid, branch);
+    EXPECT_EQ(changes[3].type, Change_Type::Alias_Updated);
+    EXPECT_EQ(changes[4].type, Change_Type::Component_Updated);
+    EXPECT_EQ(changes[5].type, Change_Type::Connection_Deleted);
+    EXPECT_EQ(changes[6].type, Change_Type::Branch_Destroyed);
+    EXPECT_EQ(changes[7].type, Change_Type::Node_Destroyed);
+}
+
+/**********************************************************************************************//**
+ * Assess that rejected mutations leave no trace in the journal
+ *************************************************************************************************/
+TEST(Journal, IgnoresFailedMutations)
+{
+    Network network;
+    const auto node = network.create_node("ONE");
+    const auto sequence = network.get_journal().get_sequence();
+
+    EXPECT_THROW(network.create_node("ONE"), Duplicate_Alias_Exception);
+    network.create_connection_between(node, 0xDEADBEEFU);
+    network.destroy_entity(0xDEADBEEFU);
+
+    EXPECT_EQ(network.get_journal().get_sequence(), sequence);
+}
+
+/**********************************************************************************************//**
+ * Assess that the dirty region only covers changes after the requested sequence
+ *************************************************************************************************/
+TEST(Journal, DirtyRegionSinceSequence)
+{
+    Network network;
+    const auto node = network.create_node();
+    const auto first = network.create_branch(std::make_unique<Resistor>(1.0_ohm));
+    const auto second = network.create_branch(std::make_unique<Resistor>(1.0_ohm));
+    network.create_connection_between(node, first);
+
+    const auto built_at = network.get_journal().get_sequence();
+    EXPECT_TRUE(network.get_journal().get_dirty_region(built_at).is_clean());
+
+    network.update_component(second, std::make_unique<Resistor>(5.0_ohm));
+
+    const auto region = network.get_journal().get_dirty_region(built_at);
+    EXPECT_FALSE(region.topology_changed);
+    EXPECT_TRUE(region.values_changed);
+    EXPECT_TRUE(region.nodes.empty());
+    EXPECT_EQ(region.branches, std::set<uint32_t>{ second });
+}
+
+/**********************************************************************************************//**
+ * Assess that compaction frees consumed changes and reports consumers that fell behind
+ *************************************************************************************************/
+TEST(Journal, Compaction)
+{
+    Network network;
+    for(auto index = 0U; index < 100U; ++index)
+    {
+        network.create_node();
+    }
+
+    const auto& journal = network.get_journal();
+    EXPECT_EQ(journal.get_number_of_retained_changes(), 100U);
+
+    network.compact_journal(90U);
+    EXPECT_EQ(journal.get_number_of_retained_changes(), 10U);
+    EXPECT_EQ(journal.get_oldest_sequence(), 90U);
+    EXPECT_EQ(journal.get_sequence(), 100U);
+
+    EXPECT_TRUE(journal.is_available(95U));
+    EXPECT_FALSE(journal.is_available(10U));
+    EXPECT_THROW(journal.get_changes_since(10U), Compacted_Journal_Exception);
+    EXPECT_EQ(journal.get_changes_since(95U).size(), 5U);
+
+    network.compact_journal(journal.get_sequence());
+    EXPECT_EQ(journal.get_number_of_retained_changes(), 0U);
+}
+
+/**********************************************************************************************//**
+ * Assess that a derived structure picks up component changes from the journal on its own
+ *************************************************************************************************/
+TEST(Journal, ImpedanceTableFollowsJournal)
+{
+    Network network;
+    network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    const auto inductor = network.create_branch(std::make_unique<Inductor>(1.0_H));
+
+    Impedance_Table table(network);
+    table.get_impedances(10.0);
+    const auto evaluations = table.get_number_of_evaluations();
+
+    network.update_component(inductor, std::make_unique<Inductor>(2.0_H));
+    EXPECT_NEAR(table.get_impedance(inductor, 10.0).imag(), 20.0, 1e-12);
+    EXPECT_EQ(table.get_number_of_evaluations(), evaluations + 1U);
+
+    // Falling behind a compaction forces a rebuild rather than a stale answer
+    network.update_component(inductor, std::make_unique<Inductor>(3.0_H));
+    network.compact_journal(network.get_journal().get_sequence());
+    EXPECT_NEAR(table.get_impedance(inductor, 10.0).imag(), 30.0, 1e-12);
+}
@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include "circlyzer/mixed_precision.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SIZE = 12U;
+    constexpr auto TOLERANCE = 1e-12;
+
+    /**
+     * \brief Diagonally dominant complex system, comfortably conditioned for float factors
+     */
+    Dense_Matrix<std::complex<double>> well_conditioned_matrix()
+    {
+        Dense_Matrix<std::complex<double>> matrix(SIZE, SIZE);
+        for(std::size_t row = 0U; row < SIZE; ++row)
+        {
+            for(std::size_t column = 0U; column < SIZE; ++column)
+            {
+                matrix(row, column) = { 1.0 / (1.0 + row + column), 0.1 * (row == column) };
+            }
+
+            matrix(row, row) += 4.0;
+        }
+
+        return matrix;
+    }
+
+    /**
+     * \brief Hilbert matrix, whose condition number is far beyond what float refinement handles
+     */
+    Dense_Matrix<std::complex<double>> ill_conditioned_matrix()
+    {
+        Dense_Matrix<std::complex<double>> matrix(SIZE, SIZE);
+        for(std::size_t row = 0U; row < SIZE; ++row)
+        {
+            for(std::size_t column = 0U; column < SIZE; ++column)
+            {
+                matrix(row, column) = 1.0 / (1.0 + row + column);
+            }
+        }
+
+        return matrix;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that refinement recovers a double accurate solution without falling back
+ *************************************************************************************************/
+TEST(MixedPrecision, RefinesToDoubleAccuracy)
+{
+    const auto matrix = well_conditioned_matrix();
+    const std::vector<std::complex<double>> rhs(SIZE, { 1.0, -2.0 });
+
+    const auto expected = LU_Factorization<std::complex<double>>(matrix).solve(rhs);
+    const auto result = solve_mixed_precision(matrix, rhs);
+
+    EXPECT_FALSE(result.used_fallback);
+    EXPECT_GT(result.iterations, 0U);
+    EXPECT_LE(result.backward_error, Refinement_Options{}.tolerance);
+
+    for(std::size_t index = 0U; index < SIZE; ++index)
+    {
+        EXPECT_NEAR(std::abs(result.solution[index] - expected[index]), 0.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that an ill-conditioned system falls back to a double factorization
+ *************************************************************************************************/
+TEST(MixedPrecision, FallsBackWhenRefinementStalls)
+{
+    const auto matrix = ill_conditioned_matrix();
+    const std::vector<std::complex<double>> rhs(SIZE, 1.0);
+
+    const auto result = solve_mixed_precision(matrix, rhs);
+
+    EXPECT_TRUE(result.used_fallback);
+
+    const auto expected = LU_Factorization<std::complex<double>>(matrix).solve(rhs);
+    for(std::size_t index = 0U; index < SIZE; ++index)
+    {
+        EXPECT_EQ(result.solution[index], expected[index]);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the Mixed solve mode agrees with the Double mode on a real circuit
+ *************************************************************************************************/
+TEST(MixedPrecision, NodalAnalysisMixedMode)
+{
+    Network network;
+    auto previous = network.create_node();
+    const auto ground = previous;
+    const auto input = network.create_node();
+
+    const auto source = network.create_branch(std::make_unique<Voltage_Source>(5.0));
+    network.create_connection_between(input, source);
+    network.create_connection_between(ground, source);
+
+    // RC ladder hanging off the source
+    previous = input;
+    for(auto section = 0U; section < 8U; ++section)
+    {
+        const auto next = network.create_node();
+        const auto resistor = network.create_branch(std::make_unique<Resistor>(1.0_kohm));
+        const auto capacitor = network.create_branch(std::make_unique<Capacitor>(10.0_nF));
+
+        network.create_connection_between(previous, resistor);
+        network.create_connection_between(next, resistor);
+        network.create_connection_between(next, capacitor);
+        network.create_connection_between(ground, capacitor);
+        previous = next;
+    }
+
+    const Nodal_Analysis analysis(network, ground);
+    const auto expected = analysis.solve(1e5);
+    const auto mixed = analysis.solve(1e5, Solve_Precision::Mixed);
+
+    for(const auto& [uid, voltage] : expected.node_voltages)
+    {
+        EXPECT_NEAR(std::abs(mixed.node_voltages.at(uid) - voltage), 0.0, TOLERANCE);
+    }
+}
@@ -0,0 +1,209 @@
+#include "gtest/gtest.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/model_reduction.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_SECTIONS = 200U;
+    constexpr auto SECTION_RESISTANCE = 10.0;
+    constexpr auto SECTION_CAPACITANCE = 1.0e-12;
+
+    // The line's corner is near 1 / (R C N^2) with the totals, about 1.25e5 rad/s here
+    const std::vector<double> FREQUENCIES = { 0.0, 1.0e3, 1.0e4, 1.0e5, 3.0e5 };
+
+    /**
+     * \brief Distributed RC line from near to far, with a load resistor at the far end
+     */
+    struct Interconnect
+    {
+        Interconnect()
+        {
+            ground = network.create_node();
+            near = network.create_node();
+
+            auto previous = near;
+            for(auto section = 0U; section < NUMBER_OF_SECTIONS; ++section)
+            {
+                const auto next = network.create_node();
+                connect(std::make_unique<Resistor>(SECTION_RESISTANCE), previous, next);
+                connect(std::make_unique<Capacitor>(SECTION_CAPACITANCE), next, ground);
+                previous = next;
+            }
+
+            far = previous;
+            connect(std::make_unique<Resistor>(1.0_kohm), far, ground);
+        }
+
+        uint32_t connect(std::unique_ptr<Component> component, uint32_t first, uint32_t second)
+        {
+            const auto uid = network.create_branch(std::move(component));
+            network.create_connection_between(first, uid);
+            network.create_connection_between(second, uid);
+            return uid;
+        }
+
+        /**
+         * \brief Drives one port with 1 V and measures the input current and every voltage,
+         *        giving one column of the impedance matrix
+         */
+        std::vector<std::complex<double>> reference_column(uint32_t driven, const std::vector<uint32_t>& ports,
+                                                           double frequency)
+        {
+            const auto source = connect(std::make_unique<Voltage_Source>(1.0), driven, ground);
+            const auto solution = Nodal_Analysis(network, ground).solve(frequency);
+            network.delete_connection_between(driven, source);
+            network.delete_connection_between(ground, source);
+            network.destroy_entity(source);
+
+            const auto current = -solution.branch_currents.at(source);
+            std::vector<std::complex<double>> column;
+            for(const auto port : ports)
+            {
+                column.emplace_back(solution.node_voltages.at(port) / current);
+            }
+
+            return column;
+        }
+
+        Network network;
+        uint32_t ground, near, far;
+    };
+
+    double relative_error(const std::complex<double>& actual, const std::complex<double>& expected)
+    {
+        return std::abs(actual - expected) / std::abs(expected);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a small two port model of a 200 section line matches the full circuit
+ *************************************************************************************************/
+TEST(ModelReduction, TwoPortInterconnect)
+{
+    Interconnect line;
+    const std::vector<uint32_t> ports = { line.near, line.far };
+
+    Model_Reduction_Options options;
+    options.maximum_blocks = 6U;
+    const Reduced_Model model(line.network, line.ground, ports, options);
+
+    EXPECT_EQ(model.get_order(), 12U);
+    EXPECT_EQ(model.get_original_size(), NUMBER_OF_SECTIONS + 1U);
+
+    for(const auto frequency : FREQUENCIES)
+    {
+        const auto impedance = model.get_impedance(frequency);
+        for(std::size_t column = 0U; column < ports.size(); ++column)
+        {
+            const auto expected = line.reference_column(ports[column], ports, frequency);
+            for(std::size_t row = 0U; row < ports.size(); ++row)
+            {
+                EXPECT_LT(relative_error(impedance(row, column), expected[row]), 1e-4)
+                    << "Z" << row << column << " at " << frequency;
+            }
+        }
+
+        // Reciprocal and passive
+        EXPECT_NEAR(std::abs(impedance(0U, 1U) - impedance(1U, 0U)), 0.0, 1e-9 * std::abs(impedance(0U, 1U)));
+        EXPECT_GE(impedance(0U, 0U).real(), 0.0);
+        EXPECT_GE(impedance(1U, 1U).real(), 0.0);
+    }
+
+    // With the near end open no current flows along the line at DC, leaving the load alone
+    EXPECT_NEAR(model.get_thevenin_impedance(line.far, 0.0).real(), 1.0_kohm, 1e-6);
+}
+
+/**********************************************************************************************//**
+ * Assess that the error estimate shrinks with order and tracks the true error
+ *************************************************************************************************/
+TEST(ModelReduction, ErrorEstimate)
+{
+    Interconnect line;
+    const std::vector<uint32_t> ports = { line.near };
+    const auto frequency = FREQUENCIES.back();
+    const auto expected = line.reference_column(line.near, ports, frequency)[0];
+
+    double previous_estimate = std::numeric_limits<double>::infinity();
+    for(const auto blocks : { 2U, 4U, 8U })
+    {
+        Model_Reduction_Options options;
+        options.maximum_blocks = blocks;
+        const Reduced_Model model(line.network, line.ground, ports, options);
+
+        const auto estimate = model.get_error_estimate(frequency);
+        const auto error = relative_error(model.get_impedance(frequency)(0U, 0U), expected);
+
+        EXPECT_LT(estimate, previous_estimate);
+        EXPECT_LT(error, 10.0 * estimate + 1e-12);
+        previous_estimate = estimate;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a tolerance stops adding blocks as soon as the estimate allows
+ *************************************************************************************************/
+TEST(ModelReduction, Tolerance)
+{
+    Interconnect line;
+
+    Model_Reduction_Options options;
+    options.maximum_blocks = 50U;
+    options.tolerance = 1e-6;
+    options.check_frequencies = { 1.0e5 };
+    const Reduced_Model model(line.network, line.ground, { line.near, line.far }, options);
+
+    EXPECT_LT(model.get_order(), 50U * 2U);
+    EXPECT_LT(model.get_error_estimate(1.0e5), 1e-6);
+}
+
+/**********************************************************************************************//**
+ * Assess that RLC networks and a positive expansion point also reduce accurately
+ *************************************************************************************************/
+TEST(ModelReduction, RlcTree)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 80U, 3U, 5U);
+    network.delete_connection_between(network.get_node_uids()[1], circuit.source_uid);
+    network.delete_connection_between(circuit.ground_uid, circuit.source_uid);
+    network.destroy_entity(circuit.source_uid);
+
+    const auto port = network.get_node_uids()[1];
+
+    Model_Reduction_Options options;
+    options.expansion_point = 1.0e3;
+    options.maximum_blocks = 40U;
+    const Reduced_Model model(network, circuit.ground_uid, { port }, options);
+
+    const auto source = network.create_branch(std::make_unique<Voltage_Source>(1.0));
+    network.create_connection_between(port, source);
+    network.create_connection_between(circuit.ground_uid, source);
+
+    for(const auto frequency : { 1.0e2, 1.0e3, 3.0e3 })
+    {
+        const auto solution = Nodal_Analysis(network, circuit.ground_uid).solve(frequency);
+        const auto expected = -1.0 / solution.branch_currents.at(source);
+        EXPECT_LT(relative_error(model.get_impedance(frequency)(0U, 0U), expected), 1e-6);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that bad ports are refused
+ *************************************************************************************************/
+TEST(ModelReduction, InvalidPorts)
+{
+    Interconnect line;
+    EXPECT_THROW(Reduced_Model(line.network, line.ground, {}), Invalid_Port_Exception);
+    EXPECT_THROW(Reduced_Model(line.network, line.ground, { line.ground }), Invalid_Port_Exception);
+    EXPECT_THROW(Reduced_Model(line.network, line.ground, { line.near, line.near }), Invalid_Port_Exception);
+    EXPECT_THROW(Reduced_Model(line.network, line.ground, { 0xDEADU }), Non_Existant_UID_Exception);
+}
@@ -0,0 +1,241 @@
+#include "gtest/gtest.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/network.h"
+#include "circlyzer/network_shard.h"
+#include "circlyzer/units.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto NUMBER_OF_SECTIONS = 400U;
+    constexpr auto NUMBER_OF_SHARDS = 4U;
+
+    /**
+     * \brief Adds one section of an RC ladder: its node, the resistor from the previous node and
+     *        the capacitor to the first node. Works on a Network or a Network_Shard alike.
+     */
+    template<typename Builder>
+    void add_section(Builder& builder, const uint32_t index)
+    {
+        const auto node = "N" + std::to_string(index);
+        builder.create_node(node);
+
+        if(index > 0U)
+        {
+            const auto resistor = "R" + std::to_string(index);
+            builder.create_branch(std::make_unique<Resistor>(1.0_kohm * index), resistor);
+            builder.create_connection_between("N" + std::to_string(index - 1U), resistor);
+            builder.create_connection_between(node, resistor);
+
+            const auto capacitor = "C" + std::to_string(index);
+            builder.create_branch(std::make_unique<Capacitor>(100.0_nF), capacitor);
+            builder.create_connection_between(node, capacitor);
+            builder.create_connection_between(std::string("N0"), capacitor);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that shards filled on their own threads merge into the network built serially
+ *************************************************************************************************/
+TEST(NetworkShard, MatchesSerial)
+{
+    Network serial;
+    for(uint32_t index = 0U; index < NUMBER_OF_SECTIONS; ++index)
+    {
+        add_section(serial, index);
+    }
+
+    std::vector<Network_Shard> shards(NUMBER_OF_SHARDS);
+    std::vector<std::thread> builders;
+    for(uint32_t shard = 0U; shard < NUMBER_OF_SHARDS; ++shard)
+    {
+        builders.emplace_back([&shards, shard]()
+        {
+            const auto sections = NUMBER_OF_SECTIONS / NUMBER_OF_SHARDS;
+            for(auto index = shard * sections; index < (shard + 1U) * sections; ++index)
+            {
+                add_section(shards[shard], index);
+            }
+        });
+    }
+
+    for(auto& builder : builders)
+    {
+        builder.join();
+    }
+
+    const Network merged(std::move(shards));
+    ASSERT_EQ(merged.get_number_of_nodes(), serial.get_number_of_nodes());
+    ASSERT_EQ(merged.get_number_of_branches(), serial.get_number_of_branches());
+    EXPECT_EQ(merged.get_number_of_aliases(), serial.get_number_of_aliases());
+    EXPECT_EQ(merged.get_node_uids(), serial.get_node_uids());
+    EXPECT_EQ(merged.get_branch_uids(), serial.get_branch_uids());
+    EXPECT_EQ(merged.get_journal().get_number_of_retained_changes(), 0U);
+
+    for(const auto uid : serial.get_node_uids())
+    {
+        EXPECT_EQ(merged.get_node(uid).alias, serial.get_node(uid).alias);
+        EXPECT_EQ(merged.get_node(uid).branches, serial.get_node(uid).branches);
+    }
+
+    for(const auto uid : serial.get_branch_uids())
+    {
+        const auto& branch = merged.get_branch(uid);
+        EXPECT_EQ(branch.alias, serial.get_branch(uid).alias);
+        EXPECT_EQ(branch.nodes, serial.get_branch(uid).nodes);
+        EXPECT_EQ(branch.component->type, serial.get_branch(uid).component->type);
+    }
+
+    // The merged network carries on like any other
+    EXPECT_EQ(merged.get_node(merged.get_node_handle(0U)).alias, "N0");
+    EXPECT_EQ(merged.get_component("R7").type, Component_Type::Resistor);
+}
+
+/**********************************************************************************************//**
+ * Assess that aliases are checked within a shard as they are created, and across shards on merge
+ *************************************************************************************************/
+TEST(NetworkShard, Aliases)
+{
+    Network_Shard shard;
+    shard.create_node("A");
+    EXPECT_THROW(shard.create_node("A"), Duplicate_Alias_Exception);
+    EXPECT_THROW(shard.create_branch(std::make_unique<Resistor>(1.0_kohm), "A"), Duplicate_Alias_Exception);
+    EXPECT_THROW(shard.create_node(std::string(Network::ALIAS_LENGTH_LIMIT, 'x')), Invalid_Alias_Exception);
+    EXPECT_THROW(shard.create_branch(nullptr), Null_Component_Exception);
+    EXPECT_EQ(shard.get_number_of_entities(), 1U);
+
+    Network_Shard other;
+    other.create_node("B");
+    other.create_node("A");
+
+    std::vector<Network_Shard> shards;
+    shards.emplace_back(std::move(shard));
+    shards.emplace_back(std::move(other));
+    EXPECT_THROW(Network{ std::move(shards) }, Duplicate_Alias_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that connections follow create_connection_between, within and across shards
+ *************************************************************************************************/
+TEST(NetworkShard, Connections)
+{
+    Network_Shard first;
+    const auto ground = first.create_node("GND");
+    const auto node = first.create_node();
+    const auto resistor = first.create_branch(std::make_unique<Resistor>(1.0_kohm));
+    first.create_connection_between(node, resistor);
+    first.create_connection_between("OUT", resistor);
+    first.create_connection_between(ground, resistor);
+
+    // Wrong types and unknown IDs are ignored
+    first.create_connection_between(resistor, node);
+    first.create_connection_between(node, 42U);
+
+    Network_Shard second;
+    const auto output = second.create_node("OUT");
+    const auto capacitor = second.create_branch(std::make_unique<Capacitor>(1.0_muF), "C");
+    second.create_connection_between(output, capacitor);
+    second.create_connection_between("GND", "C");
+    second.create_connection_between("MISSING", "C");
+
+    std::vector<Network_Shard> shards;
+    shards.emplace_back(std::move(first));
+    shards.emplace_back(std::move(second));
+    const Network network(std::move(shards));
+
+    // Connections apply in creation order, which leaves no terminal for the ground
+    const auto output_uid = 3U + output;
+    const auto capacitor_uid = 3U + capacitor;
+    EXPECT_EQ(network.get_branch(resistor).nodes, (std::vector<uint32_t>{ node, output_uid }));
+    EXPECT_EQ(network.get_branch(capacitor_uid).nodes, (std::vector<uint32_t>{ output_uid, ground }));
+    EXPECT_EQ(network.get_node(ground).branches, (std::set<uint32_t>{ capacitor_uid }));
+    EXPECT_EQ(network.get_node(output_uid).branches, (std::set<uint32_t>{ resistor, capacitor_uid }));
+}
+
+/**********************************************************************************************//**
+ * Assess that terminals come out in the order a serial build gives them, whichever shard holds
+ * the node or the branch
+ *************************************************************************************************/
+TEST(NetworkShard, ConnectionOrder)
+{
+    // Entities and connections apart, so the serial build can connect in either shard order
+    const auto create_top = [](auto& builder)
+    {
+        builder.create_node("top");
+        builder.create_branch(std::make_unique<Resistor>(1.0_kohm), "load");
+    };
+
+    const auto connect_top = [](auto& builder)
+    {
+        builder.create_connection_between("top", "load");
+    };
+
+    const auto create_source = [](auto& builder)
+    {
+        builder.create_node("gnd");
+        builder.create_branch(std::make_unique<Voltage_Source>(5.0), "source");
+    };
+
+    // The source goes to another shard's node before its own, and the ground to another shard's branch
+    const auto connect_source = [](auto& builder)
+    {
+        builder.create_connection_between("top", "source");
+        builder.create_connection_between("gnd", "source");
+        builder.create_connection_between("gnd", "load");
+    };
+
+    const auto terminals_of = [](const Network& network, const std::string& alias)
+    {
+        std::vector<std::string> terminals;
+        for(const auto uid : network.get_branch_uids())
+        {
+            if(network.get_branch(uid).alias == alias)
+            {
+                for(const auto node : network.get_branch(uid).nodes)
+                {
+                    terminals.emplace_back(network.get_node(node).alias);
+                }
+            }
+        }
+
+        return terminals;
+    };
+
+    for(const auto source_first : { false, true })
+    {
+        Network serial;
+        create_top(serial);
+        create_source(serial);
+        if(source_first)
+        {
+            connect_source(serial);
+            connect_top(serial);
+        }
+        else
+        {
+            connect_top(serial);
+            connect_source(serial);
+        }
+
+        std::vector<Network_Shard> shards(2U);
+        auto& top_shard = shards[source_first ? 1U : 0U];
+        auto& source_shard = shards[source_first ? 0U : 1U];
+        create_top(top_shard);
+        connect_top(top_shard);
+        create_source(source_shard);
+        connect_source(source_shard);
+        const Network merged(std::move(shards));
+
+        EXPECT_EQ(terminals_of(merged, "source"), (std::vector<std::string>{ "top", "gnd" }));
+        EXPECT_EQ(terminals_of(merged, "source"), terminals_of(serial, "source"));
+        EXPECT_EQ(terminals_of(merged, "load"), terminals_of(serial, "load")) << "source first " << source_first;
+    }
+}
@@ -4,7 +4,11 @@
 #include "circlyzer/units.h"
 #include "circlyzer/exceptions.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 using namespace Circlyzer;
 
@@ -367,3 +371,400 @@ TEST(Network, DestroyEntityViaAliasToDestroyBranch)
     EXPECT_EQ(network.get_number_of_nodes(), 0);
     EXPECT_EQ(network.get_number_of_branches(), 0);
 }
+
+/**********************************************************************************************//**
+ * Assess that a branch's component can be swapped, and that invalid requests throw
+ *************************************************************************************************/
+TEST(Network, UpdateComponent)
+{
+    Network network;
+    auto resistor = std::make_unique<Resistor>(DEFAULT_RESISTANCE);
+    auto branch_uid = network.create_branch(std::move(resistor), VALID_ALIAS_ONE);
+    auto node_uid = network.create_node();
+
+    network.update_component(branch_uid, std::make_unique<Capacitor>(1.0_muF));
+    EXPECT_EQ(network.get_component(branch_uid).type, Component_Type::Capacitor);
+
+    network.update_component(VALID_ALIAS_ONE, std::make_unique<Resistor>(2.0_ohm));
+    const auto& updated = dynamic_cast<const Resistor&>(network.get_component(branch_uid));
+    EXPECT_EQ(updated.resistance, 2.0_ohm);
+
+    EXPECT_THROW(network.update_component(branch_uid, nullptr), Null_Component_Exception);
+    EXPECT_THROW(network.update_component(INVALID_UID_ONE, std::make_unique<Resistor>(1.0_ohm)),
+                 Non_Existant_UID_Exception);
+    EXPECT_THROW(network.update_component(node_uid, std::make_unique<Resistor>(1.0_ohm)),
+                 Wrong_Entity_Type_Exception);
+    EXPECT_THROW(network.update_component(VALID_ALIAS_TWO, std::make_unique<Resistor>(1.0_ohm)),
+                 Non_Existant_Alias_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that aliases can be renamed and removed, with the same rules as creation
+ *************************************************************************************************/
+TEST(Network, UpdateAlias)
+{
+    Network network;
+    auto first_uid = network.create_node(VALID_ALIAS_ONE);
+    auto resistor = std::make_unique<Resistor>(DEFAULT_RESISTANCE);
+    network.create_branch(std::move(resistor), VALID_ALIAS_TWO);
+
+    EXPECT_THROW(network.update_alias(first_uid, TOO_LONG_ALIAS), Invalid_Alias_Exception);
+    EXPECT_THROW(network.update_alias(first_uid, VALID_ALIAS_TWO), Duplicate_Alias_Exception);
+
+    network.update_alias(VALID_ALIAS_ONE, "THREE");
+    EXPECT_EQ(network.get_number_of_aliases(), 2);
+    EXPECT_EQ(network.get_node(first_uid).alias, "THREE");
+
+    // The old alias is free again
+    network.update_alias(VALID_ALIAS_TWO, VALID_ALIAS_ONE);
+    EXPECT_EQ(network.get_component(VALID_ALIAS_ONE).type, Component_Type::Resistor);
+
+    network.update_alias(first_uid, "");
+    EXPECT_EQ(network.get_number_of_aliases(), 1);
+}
+
+/**********************************************************************************************//**
+ * Assess that destroyed UIDs are handed out again, lowest first, before any new ones
+ *************************************************************************************************/
+TEST(Network, UidReuse)
+{
+    Network network;
+    const auto first_uid = network.create_node();
+    const auto second_uid = network.create_node();
+    const auto third_uid = network.create_node();
+    EXPECT_EQ(first_uid, 0U);
+    EXPECT_EQ(third_uid, 2U);
+
+    network.destroy_entity(third_uid);
+    network.destroy_entity(first_uid);
+
+    EXPECT_EQ(network.create_node(), first_uid);
+    EXPECT_EQ(network.create_node(), third_uid);
+    EXPECT_EQ(network.create_node(), 3U);
+    EXPECT_NE(second_uid, 3U);
+}
+
+/**********************************************************************************************//**
+ * Assess that the non-throwing creation functions apply the same alias and component rules
+ *************************************************************************************************/
+TEST(Network, TryCreate)
+{
+    Network network;
+
+    const auto node = network.try_create_node(VALID_ALIAS_ONE);
+    ASSERT_TRUE(node.has_value());
+    EXPECT_EQ(network.get_node(*node).alias, VALID_ALIAS_ONE);
+
+    const auto duplicate = network.try_create_node(VALID_ALIAS_ONE);
+    ASSERT_FALSE(duplicate);
+    EXPECT_EQ(duplicate.error(), Network_Error::Duplicate_Alias);
+
+    EXPECT_EQ(network.try_create_node(TOO_LONG_ALIAS).error(), Network_Error::Invalid_Alias);
+    EXPECT_EQ(network.try_create_branch(nullptr).error(), Network_Error::Null_Component);
+    EXPECT_EQ(network.try_create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE),
+                                        VALID_ALIAS_ONE).error(),
+              Network_Error::Duplicate_Alias);
+
+    // Failures leave the network untouched
+    EXPECT_EQ(network.get_number_of_entities(), 1);
+    EXPECT_EQ(network.get_journal().get_sequence(), 1U);
+
+    // Reading the error of a success breaks error()'s precondition
+    EXPECT_DEBUG_DEATH(static_cast<void>(node.error()), "error\\(\\) read from a Result holding a value");
+
+    const auto branch = network.try_create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE),
+                                                  VALID_ALIAS_TWO);
+    ASSERT_TRUE(branch);
+    EXPECT_EQ(network.get_number_of_branches(), 1);
+
+    // Unwrapping a failure raises the exception of the throwing API
+    EXPECT_THROW(network.try_create_node(VALID_ALIAS_TWO).value(), Duplicate_Alias_Exception);
+    EXPECT_EQ(network.try_create_node(TOO_LONG_ALIAS).value_or(INVALID_UID_ONE), INVALID_UID_ONE);
+}
+
+/**********************************************************************************************//**
+ * Assess that the non-throwing lookups and updates report the same errors as exceptions do
+ *************************************************************************************************/
+TEST(Network, TryLookupAndUpdate)
+{
+    Network network;
+    const auto node_uid = network.create_node(VALID_ALIAS_ONE);
+    const auto branch_uid = network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE),
+                                                  VALID_ALIAS_TWO);
+
+    EXPECT_EQ(network.try_get_component(branch_uid).value()->type, Component_Type::Resistor);
+    EXPECT_EQ(network.try_get_component(VALID_ALIAS_TWO).value(), &network.get_component(branch_uid));
+    EXPECT_EQ(network.try_get_component(node_uid).error(), Network_Error::Wrong_Entity_Type);
+    EXPECT_EQ(network.try_get_component(INVALID_UID_ONE).error(), Network_Error::Non_Existant_UID);
+    EXPECT_EQ(network.try_get_component(INVALID_ALIAS).error(), Network_Error::Non_Existant_Alias);
+    EXPECT_EQ(network.try_get_node(branch_uid).error(), Network_Error::Wrong_Entity_Type);
+    EXPECT_EQ(network.try_get_branch(node_uid).error(), Network_Error::Wrong_Entity_Type);
+    EXPECT_EQ(network.try_get_node(node_uid).value()->uid, node_uid);
+
+    EXPECT_EQ(network.try_update_alias(INVALID_UID_ONE, "THREE").error(), Network_Error::Non_Existant_UID);
+    EXPECT_EQ(network.try_update_alias(node_uid, VALID_ALIAS_TWO).error(), Network_Error::Duplicate_Alias);
+    EXPECT_EQ(network.try_update_alias(node_uid, TOO_LONG_ALIAS).error(), Network_Error::Invalid_Alias);
+    EXPECT_TRUE(network.try_update_alias(VALID_ALIAS_ONE, "THREE"));
+
+    EXPECT_EQ(network.try_update_component(node_uid, std::make_unique<Capacitor>(1.0_muF)).error(),
+              Network_Error::Wrong_Entity_Type);
+    EXPECT_EQ(network.try_update_component(branch_uid, nullptr).error(), Network_Error::Null_Component);
+    EXPECT_TRUE(network.try_update_component(VALID_ALIAS_TWO, std::make_unique<Capacitor>(1.0_muF)));
+    EXPECT_EQ(network.get_component(branch_uid).type, Component_Type::Capacitor);
+}
+
+/**********************************************************************************************//**
+ * Assess that a handle resolves until its entity is destroyed, even once the UID is reused
+ *************************************************************************************************/
+TEST(Network, Handles)
+{
+    Network network;
+    const auto node_uid = network.create_node(VALID_ALIAS_ONE);
+    const auto branch_uid = network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE));
+
+    const auto node = network.get_node_handle(node_uid);
+    const auto branch = network.get_branch_handle(branch_uid);
+    EXPECT_EQ(network.get_node(node).alias, VALID_ALIAS_ONE);
+    EXPECT_EQ(network.get_branch(branch).uid, branch_uid);
+    EXPECT_EQ(network.get_node_handle(node_uid), node);
+
+    EXPECT_THROW(network.get_node_handle(branch_uid), Wrong_Entity_Type_Exception);
+    EXPECT_THROW(network.get_branch_handle(INVALID_UID_ONE), Non_Existant_UID_Exception);
+    EXPECT_THROW(network.get_node(Node_Handle{ branch.index, branch.generation }), Wrong_Entity_Type_Exception);
+
+    network.destroy_entity(node_uid);
+    EXPECT_FALSE(network.is_valid(node));
+    EXPECT_TRUE(network.is_valid(branch));
+
+    // The new node takes the UID over, but not the old handle
+    EXPECT_EQ(network.create_node(VALID_ALIAS_TWO), node_uid);
+    EXPECT_FALSE(network.is_valid(node));
+    EXPECT_THROW(network.get_node(node), Stale_Handle_Exception);
+    EXPECT_EQ(network.try_get_node(node).error(), Network_Error::Stale_Handle);
+    EXPECT_EQ(network.get_node(network.get_node_handle(node_uid)).alias, VALID_ALIAS_TWO);
+}
+
+/**********************************************************************************************//**
+ * Assess that compaction closes the gaps, carries connections and aliases along, and only
+ * invalidates the handles of entities that moved
+ *************************************************************************************************/
+TEST(Network, Compaction)
+{
+    Network network;
+    std::vector<uint32_t> nodes;
+    std::vector<uint32_t> branches;
+    for(std::size_t index = 0U; index < 4U; ++index)
+    {
+        nodes.emplace_back(network.create_node("N" + std::to_string(index)));
+        branches.emplace_back(network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE * (index + 1U)),
+                                                    "R" + std::to_string(index)));
+    }
+
+    for(std::size_t index = 0U; index < 4U; ++index)
+    {
+        network.create_connection_between(nodes[index], branches[index]);
+        network.create_connection_between(nodes[(index + 1U) % 4U], branches[index]);
+    }
+
+    // Nothing to close yet
+    const auto sequence = network.get_journal().get_sequence();
+    const auto identity = network.compact();
+    for(uint32_t uid = 0U; uid < identity.size(); ++uid)
+    {
+        EXPECT_EQ(identity[uid], uid);
+    }
+    EXPECT_TRUE(network.get_journal().is_available(sequence));
+
+    const auto kept = network.get_node_handle(nodes[0]);
+    const auto moved = network.get_branch_handle(branches[3]);
+
+    network.delete_connection_between(nodes[1], branches[0]);
+    network.delete_connection_between(nodes[1], branches[1]);
+    network.destroy_entity(nodes[1]);
+    network.destroy_entity(branches[2]);
+    network.delete_connection_between(nodes[2], branches[1]);
+    network.destroy_entity(nodes[2]);
+
+    const auto remap = network.compact();
+    ASSERT_EQ(remap.size(), 8U);
+    EXPECT_EQ(remap[nodes[1]], Change::NO_UID);
+    EXPECT_EQ(remap[nodes[2]], Change::NO_UID);
+    EXPECT_EQ(remap[branches[2]], Change::NO_UID);
+
+    EXPECT_EQ(network.get_number_of_entities(), 5U);
+    EXPECT_EQ(network.get_node_uids(), (std::vector<uint32_t>{ 0U, 3U }));
+    EXPECT_EQ(network.get_branch_uids(), (std::vector<uint32_t>{ 1U, 2U, 4U }));
+
+    // Connections and aliases follow the renumbering
+    EXPECT_EQ(network.get_branch(remap[branches[0]]).nodes, (std::vector<uint32_t>{ remap[nodes[0]] }));
+    EXPECT_EQ(network.get_node(remap[nodes[3]]).branches, (std::set<uint32_t>{ remap[branches[3]] }));
+    EXPECT_EQ(dynamic_cast<const Resistor&>(network.get_component("R3")).resistance, DEFAULT_RESISTANCE * 4U);
+    EXPECT_EQ(network.get_branch(remap[branches[3]]).alias, "R3");
+
+    EXPECT_TRUE(network.is_valid(kept));
+    EXPECT_FALSE(network.is_valid(moved));
+    EXPECT_EQ(network.get_branch(network.get_branch_handle(remap[branches[3]])).alias, "R3");
+
+    // Consumers have to rebuild, and new UIDs carry on from the end
+    EXPECT_FALSE(network.get_journal().is_available(sequence));
+    EXPECT_EQ(network.create_node(), 5U);
+    EXPECT_EQ(network.compact(), (std::vector<uint32_t>{ 0U, 1U, 2U, 3U, 4U, 5U }));
+}
+
+/**********************************************************************************************//**
+ * Assess that destroying an entity removes its connections from the neighbours too
+ *************************************************************************************************/
+TEST(Network, DestroyEntityDisconnectsNeighbours)
+{
+    Network network;
+    const auto first = network.create_node();
+    const auto second = network.create_node();
+    const auto resistor = network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE));
+    const auto loop = network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE));
+    network.create_connection_between(first, resistor);
+    network.create_connection_between(second, resistor);
+    network.create_connection_between(second, loop);
+    network.create_connection_between(second, loop);
+
+    const auto sequence = network.get_journal().get_sequence();
+    network.destroy_entity(first);
+    EXPECT_EQ(network.get_branch(resistor).nodes, (std::vector<uint32_t>{ second }));
+
+    network.destroy_entity(loop);
+    network.destroy_entity(resistor);
+    EXPECT_TRUE(network.get_node(second).branches.empty());
+
+    // Every connection that went is journaled once, before its entity
+    const auto changes = network.get_journal().get_changes_since(sequence);
+    ASSERT_EQ(changes.size(), 6U);
+    EXPECT_EQ(changes[0].type, Change_Type::Connection_Deleted);
+    EXPECT_EQ(changes[1].type, Change_Type::Node_Destroyed);
+    EXPECT_EQ(changes[2].type, Change_Type::Connection_Deleted);
+    EXPECT_EQ(changes[2].other_uid, loop);
+    EXPECT_EQ(changes[3].type, Change_Type::Branch_Destroyed);
+    EXPECT_EQ(changes[4].type, Change_Type::Connection_Deleted);
+    EXPECT_EQ(changes[5].type, Change_Type::Branch_Destroyed);
+}
+
+/**********************************************************************************************//**
+ * Assess that a region destroyed at once leaves the rest of the network consistent
+ *************************************************************************************************/
+TEST(Network, DestroyEntities)
+{
+    Network network;
+    std::vector<uint32_t> nodes;
+    std::vector<uint32_t> branches;
+    for(std::size_t index = 0U; index < 6U; ++index)
+    {
+        nodes.emplace_back(network.create_node("N" + std::to_string(index)));
+    }
+
+    for(std::size_t index = 0U; index + 1U < nodes.size(); ++index)
+    {
+        branches.emplace_back(network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE)));
+        network.create_connection_between(nodes[index], branches.back());
+        network.create_connection_between(nodes[index + 1U], branches.back());
+    }
+
+    // The middle of the chain, its inner branch and a few UIDs to ignore
+    const auto sequence = network.get_journal().get_sequence();
+    network.destroy_entities({ nodes[2], branches[2], nodes[3], nodes[2], INVALID_UID_ONE });
+
+    EXPECT_EQ(network.get_number_of_nodes(), 4U);
+    EXPECT_EQ(network.get_number_of_branches(), 4U);
+    EXPECT_EQ(network.get_number_of_aliases(), 4U);
+    EXPECT_THROW(network.get_node(nodes[2]), Non_Existant_UID_Exception);
+    EXPECT_THROW(network.get_component("N3"), Non_Existant_Alias_Exception);
+    EXPECT_EQ(network.get_branch(branches[1]).nodes, (std::vector<uint32_t>{ nodes[1] }));
+    EXPECT_EQ(network.get_branch(branches[3]).nodes, (std::vector<uint32_t>{ nodes[4] }));
+
+    // Only the connections to survivors are journaled as deleted
+    const auto region = network.get_journal().get_dirty_region(sequence);
+    EXPECT_EQ(region.branches, (std::set<uint32_t>{ branches[1], branches[2], branches[3] }));
+    EXPECT_EQ(network.get_journal().get_changes_since(sequence).size(), 5U);
+
+    for(const auto uid : network.get_node_uids())
+    {
+        for(const auto branch_uid : network.get_node(uid).branches)
+        {
+            const auto& terminals = network.get_branch(branch_uid).nodes;
+            EXPECT_NE(std::find(terminals.begin(), terminals.end(), uid), terminals.end());
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the subnetwork induced by a node set holds exactly the branches within it
+ *************************************************************************************************/
+TEST(Network, ExtractSubnetwork)
+{
+    Network network;
+    const auto ground = network.create_node("GND");
+    const auto input = network.create_node("IN");
+    const auto output = network.create_node("OUT");
+    const auto source = network.create_branch(std::make_unique<Voltage_Source>(5.0), "V");
+    const auto resistor = network.create_branch(std::make_unique<Resistor>(DEFAULT_RESISTANCE), "R");
+    const auto capacitor = network.create_branch(std::make_unique<Capacitor>(1.0_muF), "C");
+    const auto floating = network.create_branch(std::make_unique<Inductor>(1.0_mH));
+    network.create_connection_between(input, source);
+    network.create_connection_between(ground, source);
+    network.create_connection_between(input, resistor);
+    network.create_connection_between(output, resistor);
+    network.create_connection_between(output, capacitor);
+    network.create_connection_between(ground, capacitor);
+    network.create_connection_between(output, floating);
+
+    const auto extracted = network.extract_subnetwork({ output, ground, output });
+    const auto& subnetwork = extracted.network;
+    EXPECT_EQ(extracted.original_uids, (std::vector<uint32_t>{ ground, output, capacitor, floating }));
+    EXPECT_EQ(subnetwork.get_number_of_nodes(), 2U);
+    EXPECT_EQ(subnetwork.get_number_of_branches(), 2U);
+    EXPECT_EQ(subnetwork.get_number_of_aliases(), 3U);
+
+    EXPECT_EQ(subnetwork.get_node(1U).alias, "OUT");
+    EXPECT_EQ(subnetwork.get_node(1U).branches, (std::set<uint32_t>{ 2U, 3U }));
+    EXPECT_EQ(subnetwork.get_node(0U).branches, (std::set<uint32_t>{ 2U }));
+    EXPECT_EQ(subnetwork.get_branch(2U).nodes, (std::vector<uint32_t>{ 1U, 0U }));
+    EXPECT_EQ(dynamic_cast<const Capacitor&>(subnetwork.get_component("C")).capacitance, 1.0_muF);
+
+    // The copy is independent of its source
+    network.update_component(capacitor, std::make_unique<Capacitor>(2.0_muF));
+    EXPECT_EQ(dynamic_cast<const Capacitor&>(subnetwork.get_component("C")).capacitance, 1.0_muF);
+
+    EXPECT_THROW(network.extract_subnetwork({ resistor }), Wrong_Entity_Type_Exception);
+    EXPECT_THROW(network.extract_subnetwork({ INVALID_UID_ONE }), Non_Existant_UID_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that a network's reference follows its contents through moves and is cleared when they
+ * are destroyed
+ *************************************************************************************************/
+TEST(Network, ReferenceFollowsMoves)
+{
+    auto original = std::make_unique<Network>();
+    original->create_node(VALID_ALIAS_ONE);
+    const auto reference = original->get_reference();
+    EXPECT_EQ(*reference, original.get());
+
+    Network moved(std::move(*original));
+    EXPECT_EQ(*reference, &moved);
+    EXPECT_NE(*original->get_reference(), &moved);
+    EXPECT_EQ(original->get_number_of_nodes(), 0U);
+
+    Network assigned;
+    const auto replaced = assigned.get_reference();
+    assigned = std::move(moved);
+    EXPECT_EQ(*reference, &assigned);
+    EXPECT_EQ(*replaced, nullptr);
+    EXPECT_EQ(assigned.get_node(0U).alias, VALID_ALIAS_ONE);
+
+    original.reset();
+    EXPECT_EQ(*reference, &assigned);
+
+    {
+        Network scoped(std::move(assigned));
+        EXPECT_EQ(*reference, &scoped);
+    }
+
+    EXPECT_EQ(*reference, nullptr);
+}
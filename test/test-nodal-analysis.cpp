@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/network.h"
+#include "circlyzer/component.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto TOLERANCE = 1e-9;
+    constexpr auto SOURCE_VOLTAGE = 10.0;
+    constexpr auto ANGULAR_FREQUENCY = 1000.0;
+
+    /**
+     * \brief Connects a new branch between two existing nodes
+     */
+    uint32_t connect(Network& network, std::unique_ptr<Component> component,
+                     const uint32_t first, const uint32_t second)
+    {
+        const auto uid = network.create_branch(std::move(component));
+        network.create_connection_between(first, uid);
+        network.create_connection_between(second, uid);
+        return uid;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a resistive divider splits the source voltage by the resistor ratio
+ *************************************************************************************************/
+TEST(NodalAnalysis, VoltageDivider)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto top = network.create_node();
+    const auto middle = network.create_node();
+
+    const auto source = connect(network, std::make_unique<Voltage_Source>(SOURCE_VOLTAGE),
+                                top, ground);
+    const auto upper = connect(network, std::make_unique<Resistor>(3.0_kohm), top, middle);
+    connect(network, std::make_unique<Resistor>(1.0_kohm), middle, ground);
+
+    const auto solution = Nodal_Analysis(network, ground).solve();
+
+    EXPECT_NEAR(std::abs(solution.node_voltages.at(ground)), 0.0, TOLERANCE);
+    EXPECT_NEAR(solution.node_voltages.at(top).real(), SOURCE_VOLTAGE, TOLERANCE);
+    EXPECT_NEAR(solution.node_voltages.at(middle).real(), 2.5, TOLERANCE);
+    EXPECT_NEAR(solution.branch_currents.at(upper).real(), 2.5e-3, TOLERANCE);
+
+    // The source delivers current out of its first terminal, so the current through it is negative
+    EXPECT_NEAR(solution.branch_currents.at(source).real(), -2.5e-3, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that an RC low pass filter sits at the -3dB point when wRC = 1
+ *************************************************************************************************/
+TEST(NodalAnalysis, RCLowPassAtCornerFrequency)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto input = network.create_node();
+    const auto output = network.create_node();
+
+    connect(network, std::make_unique<Voltage_Source>(1.0), input, ground);
+    connect(network, std::make_unique<Resistor>(1.0_kohm), input, output);
+    connect(network, std::make_unique<Capacitor>(1.0_muF), output, ground);
+
+    const auto solution = Nodal_Analysis(network, ground).solve(ANGULAR_FREQUENCY);
+    const auto expected = 1.0 / std::complex<double>(1.0, 1.0);
+
+    EXPECT_NEAR(std::abs(solution.node_voltages.at(output) - expected), 0.0, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that inductors behave as shorts and capacitors as opens at DC
+ *************************************************************************************************/
+TEST(NodalAnalysis, ReactiveComponentsAtDC)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto input = network.create_node();
+    const auto output = network.create_node();
+
+    connect(network, std::make_unique<Voltage_Source>(SOURCE_VOLTAGE), input, ground);
+    const auto inductor = connect(network, std::make_unique<Inductor>(1.0_mH), input, output);
+    connect(network, std::make_unique<Resistor>(1.0_kohm), output, ground);
+    connect(network, std::make_unique<Capacitor>(1.0_nF), output, ground);
+
+    const auto solution = Nodal_Analysis(network, ground).solve();
+
+    EXPECT_NEAR(solution.node_voltages.at(output).real(), SOURCE_VOLTAGE, TOLERANCE);
+    EXPECT_NEAR(solution.branch_currents.at(inductor).real(), 1e-2, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that the ground UID is validated like any other UID lookup
+ *************************************************************************************************/
+TEST(NodalAnalysis, InvalidGround)
+{
+    Network network;
+    const auto branch = network.create_branch(std::make_unique<Resistor>(1.0_ohm));
+
+    EXPECT_THROW(Nodal_Analysis(network, 0xDEADBEEFU), Non_Existant_UID_Exception);
+    EXPECT_THROW(Nodal_Analysis(network, branch), Wrong_Entity_Type_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that a node with no path to ground is reported as a singular system
+ *************************************************************************************************/
+TEST(NodalAnalysis, FloatingNodeIsSingular)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto top = network.create_node();
+    network.create_node();
+
+    connect(network, std::make_unique<Resistor>(1.0_ohm), top, ground);
+
+    EXPECT_THROW(Nodal_Analysis(network, ground).solve(), Singular_Matrix_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that the stamp function may call back into the analysis, even at more frequencies than
+ * the analysis keeps, and that the stamps it is handed stay those of its own frequency
+ *************************************************************************************************/
+TEST(NodalAnalysis, StampFunctionMayReenter)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto input = network.create_node();
+    const auto output = network.create_node();
+
+    connect(network, std::make_unique<Voltage_Source>(1.0), input, ground);
+    connect(network, std::make_unique<Resistor>(1.0_kohm), input, output);
+    connect(network, std::make_unique<Capacitor>(1.0_muF), output, ground);
+
+    const Nodal_Analysis analysis(network, ground);
+    const auto expected = analysis.assemble_matrix(ANGULAR_FREQUENCY);
+
+    Dense_Matrix<std::complex<double>> matrix(analysis.get_system_size(), analysis.get_system_size());
+    std::size_t calls = 0U;
+    analysis.for_each_stamp(ANGULAR_FREQUENCY, [&](const std::size_t row, const std::size_t column,
+                                                   const std::complex<double>& value)
+    {
+        if(calls++ == 0U)
+        {
+            for(std::size_t harmonic = 2U; harmonic < 10U; ++harmonic)
+            {
+                analysis.solve(static_cast<double>(harmonic) * ANGULAR_FREQUENCY);
+            }
+        }
+
+        matrix(row, column) += value;
+    });
+
+    for(std::size_t row = 0U; row < matrix.get_number_of_rows(); ++row)
+    {
+        for(std::size_t column = 0U; column < matrix.get_number_of_columns(); ++column)
+        {
+            EXPECT_EQ(matrix(row, column), expected(row, column));
+        }
+    }
+}
@@ -0,0 +1,225 @@
+#include "gtest/gtest.h"
+#include "circlyzer/component.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/nonlinear_analysis.h"
+#include "circlyzer/units.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SATURATION_CURRENT = 1e-14;
+    constexpr auto THERMAL_VOLTAGE = 25.852e-3;
+    constexpr auto TOLERANCE = 1e-9;
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    /**
+     * \brief Source, series resistor and a diode to the ground
+     */
+    struct Diode_Circuit
+    {
+        uint32_t ground;
+        uint32_t junction;
+        uint32_t resistor;
+        uint32_t diode;
+    };
+
+    Diode_Circuit build_diode_circuit(Network& network, const double voltage, const double resistance)
+    {
+        Diode_Circuit circuit;
+        circuit.ground = network.create_node();
+        const auto supply = network.create_node();
+        circuit.junction = network.create_node();
+
+        connect(network, supply, circuit.ground, std::make_unique<Voltage_Source>(voltage));
+        circuit.resistor = connect(network, supply, circuit.junction, std::make_unique<Resistor>(resistance));
+        circuit.diode = connect(network, circuit.junction, circuit.ground, std::make_unique<Diode>());
+
+        return circuit;
+    }
+
+    /**
+     * \brief A resistive ladder with a diode from every rung to the ground
+     */
+    uint32_t build_diode_ladder(Network& network, const std::size_t number_of_sections)
+    {
+        const auto ground = network.create_node();
+        auto previous = network.create_node();
+        connect(network, previous, ground, std::make_unique<Voltage_Source>(10.0));
+
+        for(std::size_t section = 0U; section < number_of_sections; ++section)
+        {
+            const auto rung = network.create_node();
+            connect(network, previous, rung, std::make_unique<Resistor>(100.0_ohm));
+            connect(network, rung, ground, std::make_unique<Diode>(SATURATION_CURRENT * (1.0 + section)));
+            connect(network, rung, ground, std::make_unique<Resistor>(10.0_kohm));
+            previous = rung;
+        }
+
+        return ground;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the diode equation helpers match the Shockley equation
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, DiodeEquation)
+{
+    const Diode diode;
+    const auto voltage = 0.6;
+    const auto expected = SATURATION_CURRENT * (std::exp(voltage / THERMAL_VOLTAGE) - 1.0);
+
+    EXPECT_NEAR(diode.get_current(voltage) / expected, 1.0, 1e-12);
+    EXPECT_NEAR(diode.get_conductance(voltage) * THERMAL_VOLTAGE / (expected + SATURATION_CURRENT), 1.0, 1e-12);
+    EXPECT_DOUBLE_EQ(diode.get_current(0.0), 0.0);
+}
+
+/**********************************************************************************************//**
+ * Assess that a forward biased diode settles where its current equals the resistor current
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, ForwardBias)
+{
+    Network network;
+    const auto circuit = build_diode_circuit(network, 5.0, 1.0_kohm);
+
+    const Nonlinear_Analysis analysis(network, circuit.ground);
+    const auto result = analysis.solve();
+    ASSERT_TRUE(result.converged);
+
+    const auto voltage = result.solution.node_voltages.at(circuit.junction).real();
+    const auto resistor_current = (5.0 - voltage) / 1.0_kohm;
+    const auto diode_current = SATURATION_CURRENT * std::expm1(voltage / THERMAL_VOLTAGE);
+
+    EXPECT_GT(voltage, 0.6);
+    EXPECT_LT(voltage, 0.8);
+    EXPECT_NEAR(resistor_current, diode_current, 1e-12);
+    EXPECT_NEAR(result.solution.branch_currents.at(circuit.resistor).real(), resistor_current, TOLERANCE);
+    EXPECT_NEAR(result.solution.branch_currents.at(circuit.diode).real(), resistor_current, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that a reverse biased diode only passes its saturation current
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, ReverseBias)
+{
+    Network network;
+    const auto circuit = build_diode_circuit(network, -5.0, 1.0_kohm);
+
+    const auto result = Nonlinear_Analysis(network, circuit.ground).solve();
+    ASSERT_TRUE(result.converged);
+
+    EXPECT_NEAR(result.solution.node_voltages.at(circuit.junction).real(), -5.0, 1e-6);
+    EXPECT_NEAR(result.solution.branch_currents.at(circuit.diode).real(), -SATURATION_CURRENT, 1e-11);
+}
+
+/**********************************************************************************************//**
+ * Assess that the linear analyses see a diode as an open circuit
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, OpenToLinearAnalyses)
+{
+    Network network;
+    const auto circuit = build_diode_circuit(network, 5.0, 1.0_kohm);
+
+    const Nodal_Analysis analysis(network, circuit.ground);
+    EXPECT_EQ(analysis.get_nonlinear_elements().size(), 1U);
+
+    const auto solution = analysis.solve();
+    EXPECT_NEAR(std::abs(solution.node_voltages.at(circuit.junction) - 5.0), 0.0, TOLERANCE);
+    EXPECT_EQ(solution.branch_currents.at(circuit.diode), 0.0);
+}
+
+/**********************************************************************************************//**
+ * Assess that a network without diodes is solved in one iteration, matching the linear solve
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, LinearNetwork)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto a = network.create_node();
+    const auto b = network.create_node();
+    connect(network, a, ground, std::make_unique<Voltage_Source>(3.0));
+    connect(network, a, b, std::make_unique<Inductor>(10.0_mH));
+    connect(network, b, ground, std::make_unique<Resistor>(1.0_kohm));
+
+    const auto result = Nonlinear_Analysis(network, ground).solve();
+    const auto expected = Nodal_Analysis(network, ground).solve();
+
+    ASSERT_TRUE(result.converged);
+    EXPECT_EQ(result.iterations, 1U);
+    for(const auto& [uid, current] : expected.branch_currents)
+    {
+        EXPECT_NEAR(std::abs(result.solution.branch_currents.at(uid) - current), 0.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that reusing the Jacobian saves factorizations without changing the answer
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, JacobianReuse)
+{
+    Network network;
+    const auto ground = build_diode_ladder(network, 40U);
+
+    Nonlinear_Options full;
+    full.reuse_jacobian = false;
+
+    const auto reused = Nonlinear_Analysis(network, ground).solve();
+    const auto newton = Nonlinear_Analysis(network, ground, full).solve();
+
+    ASSERT_TRUE(reused.converged);
+    ASSERT_TRUE(newton.converged);
+    EXPECT_EQ(newton.factorizations, newton.iterations);
+    EXPECT_LT(reused.factorizations, reused.iterations);
+    EXPECT_LE(reused.factorizations, newton.factorizations);
+
+    for(const auto& [uid, voltage] : newton.solution.node_voltages)
+    {
+        EXPECT_NEAR(std::abs(reused.solution.node_voltages.at(uid) - voltage), 0.0, 1e-8) << "node " << uid;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a converged operating point is accepted again straight away
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, WarmStart)
+{
+    Network network;
+    const auto ground = build_diode_ladder(network, 10U);
+    const Nonlinear_Analysis analysis(network, ground);
+
+    const auto cold = analysis.solve();
+    const auto warm = analysis.solve(cold.unknowns);
+
+    ASSERT_TRUE(warm.converged);
+    EXPECT_LE(warm.iterations, 2U);
+    EXPECT_LT(warm.iterations, cold.iterations);
+}
+
+/**********************************************************************************************//**
+ * Assess that running out of iterations is reported rather than hidden
+ *************************************************************************************************/
+TEST(NonlinearAnalysis, IterationLimit)
+{
+    Network network;
+    const auto circuit = build_diode_circuit(network, 5.0, 1.0_kohm);
+
+    Nonlinear_Options options;
+    options.maximum_iterations = 2U;
+
+    const auto result = Nonlinear_Analysis(network, circuit.ground, options).solve();
+    EXPECT_FALSE(result.converged);
+    EXPECT_EQ(result.iterations, 2U);
+}
@@ -4,4 +4,37 @@
 TEST(PhasorCheckout, CheckForTrue)
 {
     EXPECT_EQ(true, true);
-}
\ No newline at end of file
+}
+
+/**********************************************************************************************//**
+ * Assess that series impedances add and parallel impedances combine reciprocally
+ *************************************************************************************************/
+TEST(Phasors, Simplify)
+{
+    using namespace std::complex_literals;
+
+    const std::vector<std::complex<double>> elements = { 100.0, 300.0 };
+    EXPECT_DOUBLE_EQ(Circlyzer::simplify_series(elements).real(), 400.0);
+    EXPECT_DOUBLE_EQ(Circlyzer::simplify_parallel(elements).real(), 75.0);
+    EXPECT_NEAR(std::abs(Circlyzer::simplify_parallel(1.0i, -1.0i + 1.0) - (1.0 + 1.0i)), 0.0, 1e-12);
+}
+
+/**********************************************************************************************//**
+ * Assess that delta-wye and wye-delta invert each other for complex impedances
+ *************************************************************************************************/
+TEST(Phasors, DeltaWye)
+{
+    using namespace std::complex_literals;
+
+    const Circlyzer::Delta_Impedances delta = { 10.0 + 5.0i, 20.0 - 3.0i, 30.0 };
+    const auto wye = Circlyzer::delta_to_wye(delta);
+    const auto back = Circlyzer::wye_to_delta(wye);
+
+    EXPECT_NEAR(std::abs(back.ab - delta.ab), 0.0, 1e-12);
+    EXPECT_NEAR(std::abs(back.bc - delta.bc), 0.0, 1e-12);
+    EXPECT_NEAR(std::abs(back.ca - delta.ca), 0.0, 1e-12);
+
+    // Equal resistors: a star arm is a third of a side
+    const auto balanced = Circlyzer::delta_to_wye({ 30.0, 30.0, 30.0 });
+    EXPECT_NEAR(balanced.a.real(), 10.0, 1e-12);
+}
@@ -0,0 +1,348 @@
+#include "gtest/gtest.h"
+#include "circlyzer/executor.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/graph_export.h"
+#include "circlyzer/matrix.h"
+#include "circlyzer/network.h"
+#include "circlyzer/port_parameters.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <numbers>
+#include <sstream>
+#include <string>
+
+using namespace Circlyzer;
+using namespace std::complex_literals;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 2.0e4;
+    constexpr auto TOLERANCE = 1e-9;
+
+    constexpr auto R1 = 100.0;
+    constexpr auto R2 = 220.0;
+    constexpr auto R3 = 330.0;
+
+    struct Two_Port
+    {
+        uint32_t ground;
+        uint32_t input;
+        uint32_t output;
+        uint32_t source;
+    };
+
+    void connect(Network& network, const uint32_t one, const uint32_t two, std::unique_ptr<Component> component,
+                 uint32_t* uid = nullptr)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(one, branch);
+        network.create_connection_between(two, branch);
+
+        if(uid != nullptr)
+        {
+            *uid = branch;
+        }
+    }
+
+    /**
+     * \brief Resistive T: R1 from the input to the centre, R2 from the centre to the output and
+     *        R3 from the centre to ground, with a source in series with R3 that should be shorted
+     */
+    Two_Port build_tee(Network& network)
+    {
+        Two_Port tee;
+        tee.ground = network.create_node();
+        tee.input = network.create_node();
+        tee.output = network.create_node();
+
+        const auto centre = network.create_node();
+        const auto tap = network.create_node();
+
+        connect(network, tee.input, centre, std::make_unique<Resistor>(R1));
+        connect(network, centre, tee.output, std::make_unique<Resistor>(R2));
+        connect(network, centre, tap, std::make_unique<Resistor>(R3));
+        connect(network, tap, tee.ground, std::make_unique<Voltage_Source>(5.0), &tee.source);
+
+        return tee;
+    }
+
+    void expect_matrix_near(const Dense_Matrix<std::complex<double>>& actual,
+                            const Dense_Matrix<std::complex<double>>& expected)
+    {
+        ASSERT_EQ(actual.get_number_of_rows(), expected.get_number_of_rows());
+        ASSERT_EQ(actual.get_number_of_columns(), expected.get_number_of_columns());
+
+        for(std::size_t row = 0U; row < actual.get_number_of_rows(); ++row)
+        {
+            for(std::size_t column = 0U; column < actual.get_number_of_columns(); ++column)
+            {
+                EXPECT_NEAR(std::abs(actual(row, column) - expected(row, column)), 0.0, TOLERANCE)
+                    << "(" << row << ", " << column << ")";
+            }
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the block solve matches solving each column on its own
+ *************************************************************************************************/
+TEST(PortParameters, BlockSolve)
+{
+    Dense_Matrix<std::complex<double>> matrix(3U, 3U);
+    matrix(0U, 0U) = 0.0;  matrix(0U, 1U) = 2.0;      matrix(0U, 2U) = 1.0i;
+    matrix(1U, 0U) = 3.0;  matrix(1U, 1U) = 1.0 - 1i; matrix(1U, 2U) = 0.0;
+    matrix(2U, 0U) = 1.0;  matrix(2U, 1U) = 0.5;      matrix(2U, 2U) = 4.0;
+
+    Dense_Matrix<std::complex<double>> rhs(3U, 2U);
+    rhs(0U, 0U) = 1.0; rhs(1U, 0U) = 2.0i; rhs(2U, 0U) = -1.0;
+    rhs(0U, 1U) = 0.5; rhs(1U, 1U) = 0.0;  rhs(2U, 1U) = 3.0 + 1i;
+
+    const LU_Factorization<std::complex<double>> factorization(matrix);
+    const auto block = factorization.solve(rhs);
+
+    for(std::size_t column = 0U; column < 2U; ++column)
+    {
+        const auto single = factorization.solve(std::vector<std::complex<double>>{
+            rhs(0U, column), rhs(1U, column), rhs(2U, column) });
+
+        for(std::size_t row = 0U; row < 3U; ++row)
+        {
+            EXPECT_NEAR(std::abs(block(row, column) - single[row]), 0.0, TOLERANCE);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess Z, Y and S of a resistive T against the textbook values
+ *************************************************************************************************/
+TEST(PortParameters, Tee)
+{
+    Network network;
+    const auto tee = build_tee(network);
+    const Port_Analysis analysis(network, tee.ground, { { tee.input, tee.ground }, { tee.output, tee.ground } });
+
+    Dense_Matrix<std::complex<double>> impedance(2U, 2U);
+    impedance(0U, 0U) = R1 + R3; impedance(0U, 1U) = R3;
+    impedance(1U, 0U) = R3;      impedance(1U, 1U) = R2 + R3;
+    expect_matrix_near(analysis.get_impedance_matrix(0.0), impedance);
+
+    const auto determinant = ((R1 + R3) * (R2 + R3)) - (R3 * R3);
+    Dense_Matrix<std::complex<double>> admittance(2U, 2U);
+    admittance(0U, 0U) = (R2 + R3) / determinant; admittance(0U, 1U) = -R3 / determinant;
+    admittance(1U, 0U) = -R3 / determinant;       admittance(1U, 1U) = (R1 + R3) / determinant;
+    expect_matrix_near(analysis.get_admittance_matrix(0.0), admittance);
+
+    // With equal references S = (z - 1)(z + 1)^-1 for z = Z / 50
+    const auto a = (R1 + R3) / 50.0;
+    const auto b = R3 / 50.0;
+    const auto d = (R2 + R3) / 50.0;
+    const auto denominator = ((a + 1.0) * (d + 1.0)) - (b * b);
+    Dense_Matrix<std::complex<double>> scattering(2U, 2U);
+    scattering(0U, 0U) = (((a - 1.0) * (d + 1.0)) - (b * b)) / denominator;
+    scattering(0U, 1U) = (2.0 * b) / denominator;
+    scattering(1U, 0U) = (2.0 * b) / denominator;
+    scattering(1U, 1U) = (((a + 1.0) * (d - 1.0)) - (b * b)) / denominator;
+    expect_matrix_near(analysis.get_scattering_matrix(0.0), scattering);
+}
+
+/**********************************************************************************************//**
+ * Assess a floating port and a one-port against its reference impedance
+ *************************************************************************************************/
+TEST(PortParameters, FloatingAndMatchedPorts)
+{
+    Network network;
+    const auto tee = build_tee(network);
+
+    // Across the series arms the T looks like R1 + R2 with R3 not carrying current
+    const Port_Analysis across(network, tee.ground, { { tee.input, tee.output } });
+    EXPECT_NEAR(std::abs(across.get_impedance_matrix(0.0)(0U, 0U) - (R1 + R2)), 0.0, TOLERANCE);
+
+    for(const auto reference : { R1 + R3, 2.0 * (R1 + R3) })
+    {
+        const Port_Analysis one_port(network, tee.ground, { { tee.input, tee.ground, reference } });
+        const auto expected = ((R1 + R3) - reference) / ((R1 + R3) + reference);
+        EXPECT_NEAR(std::abs(one_port.get_scattering_matrix(0.0)(0U, 0U) - expected), 0.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that S is reciprocal and lossless for a reactive network, and that mixed references
+ *        follow the power wave definition
+ *************************************************************************************************/
+TEST(PortParameters, ReactiveNetwork)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto a = network.create_node();
+    const auto b = network.create_node();
+
+    connect(network, a, b, std::make_unique<Inductor>(10.0_mH));
+    connect(network, a, ground, std::make_unique<Capacitor>(1.0_muF));
+    connect(network, b, ground, std::make_unique<Capacitor>(2.0_muF));
+
+    const Port_Analysis analysis(network, ground, { { a, ground, 50.0 }, { b, ground, 75.0 } });
+    const auto scattering = analysis.get_scattering_matrix(ANGULAR_FREQUENCY);
+
+    EXPECT_NEAR(std::abs(scattering(0U, 1U) - scattering(1U, 0U)), 0.0, TOLERANCE);
+
+    // A lossless network has a unitary S, so each column carries unit power
+    for(std::size_t column = 0U; column < 2U; ++column)
+    {
+        EXPECT_NEAR(std::norm(scattering(0U, column)) + std::norm(scattering(1U, column)), 1.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the parallel sweep matches the per frequency results
+ *************************************************************************************************/
+TEST(PortParameters, Extract)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 60U, 3U, 11U);
+    const auto& nodes = network.get_node_uids();
+
+    std::vector<Port> ports;
+    for(std::size_t index = 1U; index < 5U; ++index)
+    {
+        ports.push_back({ nodes[index * 7U], circuit.ground_uid, 50.0 });
+    }
+
+    const Port_Analysis analysis(network, circuit.ground_uid, ports);
+    const std::vector<double> frequencies = { 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6 };
+
+    Executor executor(3U);
+    for(const auto type : { Parameter_Type::Z, Parameter_Type::Y, Parameter_Type::S })
+    {
+        const auto parameters = analysis.extract(type, frequencies, executor);
+        ASSERT_EQ(parameters.matrices.size(), frequencies.size());
+        EXPECT_EQ(parameters.type, type);
+        EXPECT_EQ(parameters.reference_impedances, std::vector<double>(4U, 50.0));
+
+        for(std::size_t index = 0U; index < frequencies.size(); ++index)
+        {
+            expect_matrix_near(parameters.matrices[index], analysis.get_parameters(type, frequencies[index]));
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess the Touchstone layout for both versions
+ *************************************************************************************************/
+TEST(PortParameters, Touchstone)
+{
+    Network network;
+    const auto tee = build_tee(network);
+
+    {
+        const Port_Analysis analysis(network, tee.ground, { { tee.input, tee.ground }, { tee.output, tee.ground } });
+
+        std::ostringstream stream;
+        Stream_Sink sink(stream);
+        write_touchstone(analysis.extract(Parameter_Type::Z, { 2.0 * std::numbers::pi * 1.0e3 }), sink);
+
+        // Version 1 normalises Z to the reference and orders two-port data 11 21 12 22
+        const auto expected = "! Circlyzer 2-port Z parameters\n"
+                              "# Hz Z RI R 50\n"
+                              "1000 8.6 0 6.6 0 6.6 0 11 0\n";
+        EXPECT_EQ(stream.str(), expected);
+    }
+
+    {
+        const Port_Analysis analysis(network, tee.ground, { { tee.input, tee.ground, 50.0 },
+                                                            { tee.output, tee.ground, 75.0 },
+                                                            { tee.input, tee.output, 100.0 } });
+
+        std::ostringstream stream;
+        Stream_Sink sink(stream);
+        write_touchstone(analysis.extract(Parameter_Type::S, { 1.0, 2.0 }), sink);
+
+        const auto text = stream.str();
+        EXPECT_NE(text.find("[Version] 2.0\n# Hz S RI R 50\n[Number of Ports] 3\n"), std::string::npos);
+        EXPECT_NE(text.find("[Number of Frequencies] 2\n[Reference] 50 75 100\n[Network Data]\n"),
+                  std::string::npos);
+        EXPECT_EQ(text.substr(text.size() - 6U), "[End]\n");
+
+        // One line per matrix row for three or more ports
+        const auto data = text.substr(text.find("[Network Data]\n") + 15U);
+        EXPECT_EQ(std::count(data.begin(), data.end(), '\n'), 7);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the binary stream reads back exactly and rejects other data
+ *************************************************************************************************/
+TEST(PortParameters, BinaryRoundTrip)
+{
+    Network network;
+    const auto tee = build_tee(network);
+    const Port_Analysis analysis(network, tee.ground, { { tee.input, tee.ground, 50.0 },
+                                                        { tee.output, tee.ground, 75.0 } });
+    const auto parameters = analysis.extract(Parameter_Type::S, { 1.0e3, 1.0e4, 1.0e5 });
+
+    std::ostringstream output;
+    {
+        Stream_Sink sink(output);
+        write_binary_parameters(parameters, sink);
+    }
+
+    // Header, two references, then a frequency and four complex values per point
+    EXPECT_EQ(output.str().size(), 17U + (2U * 8U) + (3U * (8U + (4U * 16U))));
+
+    std::istringstream input(output.str());
+    const auto read = read_binary_parameters(input);
+    EXPECT_EQ(read.type, parameters.type);
+    EXPECT_EQ(read.reference_impedances, parameters.reference_impedances);
+    EXPECT_EQ(read.frequencies, parameters.frequencies);
+    for(std::size_t index = 0U; index < read.matrices.size(); ++index)
+    {
+        for(std::size_t row = 0U; row < 2U; ++row)
+        {
+            for(std::size_t column = 0U; column < 2U; ++column)
+            {
+                EXPECT_EQ(read.matrices[index](row, column), parameters.matrices[index](row, column));
+            }
+        }
+    }
+
+    std::istringstream truncated(output.str().substr(0U, 40U));
+    EXPECT_THROW(read_binary_parameters(truncated), Invalid_Parameter_Stream_Exception);
+
+    std::istringstream text("# Hz S RI R 50\n");
+    EXPECT_THROW(read_binary_parameters(text), Invalid_Parameter_Stream_Exception);
+
+    // Corrupt port and frequency counts are refused before anything is allocated
+    const auto corrupt = [&](const std::size_t offset, const uint32_t value)
+    {
+        auto data = output.str();
+        std::memcpy(data.data() + offset, &value, sizeof(value));
+        return std::istringstream(data);
+    };
+
+    auto ports = corrupt(9U, 0xFFFFFFFFU);
+    EXPECT_THROW(read_binary_parameters(ports), Invalid_Parameter_Stream_Exception);
+
+    auto sized = corrupt(9U, 1000U);
+    EXPECT_THROW(read_binary_parameters(sized), Invalid_Parameter_Stream_Exception);
+
+    auto frequencies = corrupt(13U, 0xFFFFFFFFU);
+    EXPECT_THROW(read_binary_parameters(frequencies), Invalid_Parameter_Stream_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that invalid ports are rejected
+ *************************************************************************************************/
+TEST(PortParameters, InvalidPorts)
+{
+    Network network;
+    const auto tee = build_tee(network);
+
+    EXPECT_THROW(Port_Analysis(network, tee.ground, {}), Invalid_Port_Pair_Exception);
+    EXPECT_THROW(Port_Analysis(network, tee.ground, { { tee.input, tee.input } }), Invalid_Port_Pair_Exception);
+    EXPECT_THROW(Port_Analysis(network, tee.ground, { { tee.input, tee.ground, 0.0 } }),
+                 Invalid_Port_Pair_Exception);
+    EXPECT_THROW(Port_Analysis(network, tee.ground, { { tee.source, tee.ground } }), Wrong_Entity_Type_Exception);
+}
@@ -0,0 +1,271 @@
+#include "gtest/gtest.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/phasors.h"
+#include "circlyzer/reduction.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto TOLERANCE = 1e-9;
+
+    uint32_t connect(Network& network, std::unique_ptr<Component> component, uint32_t first, uint32_t second)
+    {
+        const auto uid = network.create_branch(std::move(component));
+        network.create_connection_between(first, uid);
+        network.create_connection_between(second, uid);
+        return uid;
+    }
+
+    /**
+     * \brief Reference impedance: drive the ports with 1 V and measure the current
+     */
+    std::complex<double> solve_impedance(const Network& original, uint32_t first, uint32_t second,
+                                         const double frequency)
+    {
+        Network network;
+        std::map<uint32_t, uint32_t> nodes;
+        for(const auto uid : original.get_node_uids())
+        {
+            nodes[uid] = network.create_node();
+        }
+
+        for(const auto uid : original.get_branch_uids())
+        {
+            const auto& branch = original.get_branch(uid);
+            const auto value = get_component_value(*branch.component);
+            std::unique_ptr<Component> copy;
+            switch(branch.component->type)
+            {
+                case Component_Type::Resistor:  copy = std::make_unique<Resistor>(value.real()); break;
+                case Component_Type::Capacitor: copy = std::make_unique<Capacitor>(value.real()); break;
+                case Component_Type::Inductor:  copy = std::make_unique<Inductor>(value.real()); break;
+                default:                        copy = std::make_unique<Voltage_Source>(0.0); break;
+            }
+            connect(network, std::move(copy), nodes.at(branch.nodes[0]), nodes.at(branch.nodes[1]));
+        }
+
+        const auto source = connect(network, std::make_unique<Voltage_Source>(1.0),
+                                    nodes.at(first), nodes.at(second));
+        const auto solution = Nodal_Analysis(network, nodes.at(second)).solve(frequency);
+        return -1.0 / solution.branch_currents.at(source);
+    }
+
+    /**
+     * \brief Wheatstone bridge between top and bottom with a detector resistor across the middle
+     */
+    struct Bridge
+    {
+        Bridge()
+        {
+            top = network.create_node();
+            left = network.create_node();
+            right = network.create_node();
+            bottom = network.create_node();
+
+            top_left = connect(network, std::make_unique<Resistor>(100.0_ohm), top, left);
+            top_right = connect(network, std::make_unique<Resistor>(220.0_ohm), top, right);
+            detector = connect(network, std::make_unique<Resistor>(47.0_ohm), left, right);
+            connect(network, std::make_unique<Resistor>(330.0_ohm), left, bottom);
+            connect(network, std::make_unique<Resistor>(150.0_ohm), right, bottom);
+        }
+
+        Network network;
+        uint32_t top, left, right, bottom;
+        uint32_t top_left, top_right, detector;
+    };
+}
+
+/**********************************************************************************************//**
+ * Assess that a bridge, which series/parallel steps alone can't reduce, matches a nodal solve
+ *************************************************************************************************/
+TEST(Reduction, Bridge)
+{
+    Bridge bridge;
+    const auto result = reduce_impedance(bridge.network, bridge.top, bridge.bottom);
+    const auto expected = solve_impedance(bridge.network, bridge.top, bridge.bottom, 0.0);
+
+    EXPECT_NEAR(std::abs(result.impedance - expected), 0.0, TOLERANCE);
+    EXPECT_EQ(result.wye_to_delta + result.delta_to_wye, 1U);
+    EXPECT_EQ(result.star_mesh, 0U);
+}
+
+/**********************************************************************************************//**
+ * Assess that complex impedances reduce correctly, with a mix of R, L and C
+ *************************************************************************************************/
+TEST(Reduction, ComplexBridge)
+{
+    Bridge bridge;
+    bridge.network.update_component(bridge.top_left, std::make_unique<Inductor>(10.0_mH));
+    bridge.network.update_component(bridge.detector, std::make_unique<Capacitor>(1.0_muF));
+    const auto extra = bridge.network.create_node();
+    connect(bridge.network, std::make_unique<Capacitor>(470.0_nF), bridge.right, extra);
+    connect(bridge.network, std::make_unique<Resistor>(1.0_kohm), extra, bridge.bottom);
+
+    const auto result = reduce_impedance(bridge.network, bridge.top, bridge.bottom, ANGULAR_FREQUENCY);
+    const auto expected = solve_impedance(bridge.network, bridge.top, bridge.bottom, ANGULAR_FREQUENCY);
+
+    EXPECT_NEAR(std::abs(result.impedance - expected) / std::abs(expected), 0.0, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that sources are shorted, open ports are infinite and joined ports are zero
+ *************************************************************************************************/
+TEST(Reduction, ShortsAndOpens)
+{
+    Network network;
+    const auto a = network.create_node();
+    const auto b = network.create_node();
+    const auto c = network.create_node();
+    const auto d = network.create_node();
+    connect(network, std::make_unique<Resistor>(10.0_ohm), a, b);
+    connect(network, std::make_unique<Voltage_Source>(5.0), b, c);
+    connect(network, std::make_unique<Resistor>(20.0_ohm), c, a);
+    connect(network, std::make_unique<Capacitor>(1.0_muF), c, d);
+
+    EXPECT_NEAR(reduce_impedance(network, a, c).impedance.real(), 20.0 / 3.0, TOLERANCE);
+    EXPECT_EQ(reduce_impedance(network, b, c).impedance, 0.0);
+    EXPECT_TRUE(std::isinf(reduce_impedance(network, a, d).impedance.real()));
+}
+
+/**********************************************************************************************//**
+ * Assess that meshes reduce to the nodal answer, with and without the star-mesh fallback
+ *************************************************************************************************/
+TEST(Reduction, Meshes)
+{
+    Network grid;
+    const auto circuit = generate_grid(grid, 4U, 4U, 1U, 7U);
+    const auto nodes = grid.get_node_uids();
+    const auto first = nodes[1];
+    const auto last = nodes.back();
+
+    grid.destroy_entity(circuit.source_uid);
+
+    const auto result = reduce_impedance(grid, first, last);
+    const auto expected = solve_impedance(grid, first, last, 0.0);
+    EXPECT_NEAR(std::abs(result.impedance - expected) / std::abs(expected), 0.0, TOLERANCE);
+
+    // Every node of a complete graph has four neighbours and no transform frees any of them
+    Network complete;
+    std::vector<uint32_t> vertices;
+    for(auto index = 0U; index < 5U; ++index)
+    {
+        vertices.emplace_back(complete.create_node());
+    }
+    for(auto i = 0U; i < 5U; ++i)
+    {
+        for(auto j = i + 1U; j < 5U; ++j)
+        {
+            connect(complete, std::make_unique<Resistor>(1.0_ohm + i + j), vertices[i], vertices[j]);
+        }
+    }
+
+    Reduction_Options options;
+    options.allow_star_mesh = false;
+    EXPECT_THROW(reduce_impedance(complete, vertices[0], vertices[1], 0.0, options),
+                 Irreducible_Network_Exception);
+
+    const auto fallback = reduce_impedance(complete, vertices[0], vertices[1]);
+    EXPECT_GT(fallback.star_mesh, 0U);
+    EXPECT_NEAR(std::abs(fallback.impedance - solve_impedance(complete, vertices[0], vertices[1], 0.0)),
+                0.0, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that transforming a triangle in the Network and back preserves the port impedance
+ *************************************************************************************************/
+TEST(Reduction, NetworkTransforms)
+{
+    Bridge bridge;
+    const auto expected = solve_impedance(bridge.network, bridge.top, bridge.bottom, 0.0);
+
+    const auto star = delta_to_wye(bridge.network, { bridge.top_left, bridge.top_right, bridge.detector });
+    EXPECT_EQ(bridge.network.get_node(star).branches.size(), 3U);
+    EXPECT_EQ(bridge.network.get_number_of_nodes(), 5U);
+    EXPECT_EQ(bridge.network.get_number_of_branches(), 5U);
+    EXPECT_NEAR(std::abs(solve_impedance(bridge.network, bridge.top, bridge.bottom, 0.0) - expected),
+                0.0, TOLERANCE);
+
+    // After delta-wye the bridge is plain series/parallel
+    const auto reduced = reduce_impedance(bridge.network, bridge.top, bridge.bottom);
+    EXPECT_EQ(reduced.wye_to_delta + reduced.delta_to_wye + reduced.star_mesh, 0U);
+
+    const auto sides = wye_to_delta(bridge.network, star);
+    EXPECT_EQ(bridge.network.get_number_of_nodes(), 4U);
+    EXPECT_EQ(bridge.network.get_branch(sides[0]).component->type, Component_Type::Resistor);
+    EXPECT_NEAR(std::abs(solve_impedance(bridge.network, bridge.top, bridge.bottom, 0.0) - expected),
+                0.0, TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that capacitor triangles transform into capacitor stars, and mixed kinds are refused
+ *************************************************************************************************/
+TEST(Reduction, CapacitorTransform)
+{
+    Network network;
+    const auto a = network.create_node();
+    const auto b = network.create_node();
+    const auto c = network.create_node();
+    const auto ab = connect(network, std::make_unique<Capacitor>(1.0_muF), a, b);
+    const auto bc = connect(network, std::make_unique<Capacitor>(2.0_muF), b, c);
+    const auto ca = connect(network, std::make_unique<Capacitor>(3.0_muF), c, a);
+    const auto expected = solve_impedance(network, a, b, ANGULAR_FREQUENCY);
+
+    const auto star = delta_to_wye(network, { ab, ca, bc });
+    for(const auto uid : network.get_node(star).branches)
+    {
+        EXPECT_EQ(network.get_component(uid).type, Component_Type::Capacitor);
+    }
+    EXPECT_NEAR(std::abs(solve_impedance(network, a, b, ANGULAR_FREQUENCY) - expected) / std::abs(expected),
+                0.0, TOLERANCE);
+
+    const auto branches = network.get_node(star).branches;
+    network.update_component(*branches.begin(), std::make_unique<Resistor>(1.0_ohm));
+    EXPECT_THROW(wye_to_delta(network, star), Invalid_Transform_Exception);
+    EXPECT_THROW(wye_to_delta(network, a), Invalid_Transform_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that series LC resonance shorts its ends and parallel LC resonance opens them, without
+ * an infinite or undefined impedance reaching a later step
+ *************************************************************************************************/
+TEST(Reduction, Resonance)
+{
+    // At 1 rad/s a 1 H inductor and a 1 F capacitor cancel exactly
+    constexpr auto RESONANCE = 1.0;
+
+    Bridge bridge;
+    bridge.network.destroy_entity(bridge.detector);
+    const auto middle = bridge.network.create_node();
+    connect(bridge.network, std::make_unique<Inductor>(1.0_H), bridge.left, middle);
+    connect(bridge.network, std::make_unique<Capacitor>(1.0_F), middle, bridge.right);
+
+    const auto shorted = reduce_impedance(bridge.network, bridge.top, bridge.bottom, RESONANCE);
+    const auto expected = ((100.0 * 220.0) / 320.0) + ((330.0 * 150.0) / 480.0);
+    EXPECT_NEAR(std::abs(shorted.impedance - expected), 0.0, TOLERANCE);
+
+    // The short reaches the port itself
+    EXPECT_EQ(reduce_impedance(bridge.network, bridge.left, bridge.right, RESONANCE).impedance, 0.0);
+
+    Network tank;
+    const auto first = tank.create_node();
+    const auto second = tank.create_node();
+    const auto inner = tank.create_node();
+    connect(tank, std::make_unique<Inductor>(1.0_H), first, inner);
+    connect(tank, std::make_unique<Capacitor>(1.0_F), first, inner);
+    connect(tank, std::make_unique<Resistor>(10.0_ohm), inner, second);
+    connect(tank, std::make_unique<Resistor>(40.0_ohm), first, second);
+    EXPECT_NEAR(std::abs(reduce_impedance(tank, first, second, RESONANCE).impedance - 40.0), 0.0, TOLERANCE);
+
+    EXPECT_THROW(Circlyzer::delta_to_wye({ { 0.0, 1.0 }, { 0.0, -2.0 }, { 0.0, 1.0 } }),
+                 Degenerate_Transform_Exception);
+    EXPECT_THROW(Circlyzer::wye_to_delta({ 10.0, 0.0, 20.0 }), Degenerate_Transform_Exception);
+}
@@ -0,0 +1,222 @@
+#include "gtest/gtest.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/matrix.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/sensitivity.h"
+#include "circlyzer/sparse_matrix.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace Circlyzer;
+using namespace std::complex_literals;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 2.0e3;
+    constexpr auto RELATIVE_STEP = 1e-6;
+    constexpr auto TOLERANCE = 1e-5;
+
+    /**
+     * \brief Copies a component with its value scaled
+     */
+    std::unique_ptr<Component> scaled(const Component& component, const double factor)
+    {
+        const auto value = get_component_value(component).real() * factor;
+        switch(component.type)
+        {
+            case Component_Type::Capacitor: return std::make_unique<Capacitor>(value);
+            case Component_Type::Inductor:  return std::make_unique<Inductor>(value);
+            default:                        return std::make_unique<Resistor>(value);
+        }
+    }
+
+    /**
+     * \brief Output voltage from a sparse forward solve, which also suits large networks
+     */
+    std::complex<double> solve_output(const Network& network, const uint32_t ground, const uint32_t output,
+                                      const double frequency)
+    {
+        const Nodal_Analysis analysis(network, ground);
+        const Sparse_LU_Factorization<std::complex<double>> factorization(
+            analysis.assemble_sparse_matrix(frequency));
+        const auto unknowns = factorization.solve(analysis.assemble_excitation());
+
+        const auto& node_uids = analysis.get_node_uids();
+        return unknowns[static_cast<std::size_t>(
+            std::lower_bound(node_uids.begin(), node_uids.end(), output) - node_uids.begin())];
+    }
+
+    /**
+     * \brief Central difference of the output voltage with respect to one component
+     */
+    std::complex<double> finite_difference(Network& network, const uint32_t ground, const uint32_t output,
+                                           const uint32_t branch, const double frequency)
+    {
+        const auto nominal = scaled(network.get_component(branch), 1.0);
+        const auto value = get_component_value(*nominal).real();
+
+        network.update_component(branch, scaled(*nominal, 1.0 + RELATIVE_STEP));
+        const auto above = solve_output(network, ground, output, frequency);
+
+        network.update_component(branch, scaled(*nominal, 1.0 - RELATIVE_STEP));
+        const auto below = solve_output(network, ground, output, frequency);
+
+        network.update_component(branch, scaled(*nominal, 1.0));
+        return (above - below) / (2.0 * RELATIVE_STEP * value);
+    }
+
+    /**
+     * \brief Compares every stride-th component, so large networks are only spot checked
+     */
+    void expect_matches_finite_differences(Network& network, const uint32_t ground,
+                                           const uint32_t output, const double frequency,
+                                           const std::size_t stride = 1U)
+    {
+        const Sensitivity_Analysis analysis(Nodal_Analysis(network, ground), frequency);
+        const auto result = analysis.get_sensitivities(output);
+
+        ASSERT_EQ(result.branch_uids.size(), network.get_number_of_branches() - 1U);
+        for(std::size_t index = 0U; index < result.branch_uids.size(); index += stride)
+        {
+            const auto expected = finite_difference(network, ground, output, result.branch_uids[index],
+                                                    frequency);
+            const auto scale = std::max(std::abs(expected), 1e-3 * std::abs(result.output_voltage) /
+                get_component_value(network.get_component(result.branch_uids[index])).real());
+
+            EXPECT_NEAR(std::abs(result.sensitivities[index] - expected) / scale, 0.0, TOLERANCE)
+                << "branch " << result.branch_uids[index];
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that the transposed solve agrees with solving against the explicit transpose
+ *************************************************************************************************/
+TEST(Sensitivity, TransposedSolve)
+{
+    Dense_Matrix<std::complex<double>> matrix(3U, 3U);
+    matrix(0U, 0U) = 0.5;   matrix(0U, 1U) = 2.0 + 1.0i; matrix(0U, 2U) = -1.0;
+    matrix(1U, 0U) = 4.0;   matrix(1U, 1U) = 1.0;        matrix(1U, 2U) = 3.0i;
+    matrix(2U, 0U) = -2.0i; matrix(2U, 1U) = 0.25;       matrix(2U, 2U) = 5.0;
+
+    Dense_Matrix<std::complex<double>> transposed(3U, 3U);
+    for(std::size_t row = 0U; row < 3U; ++row)
+    {
+        for(std::size_t column = 0U; column < 3U; ++column)
+        {
+            transposed(row, column) = matrix(column, row);
+        }
+    }
+
+    const std::vector<std::complex<double>> rhs = { 1.0, -2.0 + 1.0i, 0.5 };
+    const auto adjoint = LU_Factorization<std::complex<double>>(matrix).solve_transposed(rhs);
+    const auto expected = LU_Factorization<std::complex<double>>(transposed).solve(rhs);
+
+    std::vector<Sparse_Matrix<std::complex<double>>::Entry> entries;
+    for(std::size_t row = 0U; row < 3U; ++row)
+    {
+        for(std::size_t column = 0U; column < 3U; ++column)
+        {
+            entries.push_back({ row, column, matrix(row, column) });
+        }
+    }
+
+    const Sparse_LU_Factorization<std::complex<double>> sparse(
+        Sparse_Matrix<std::complex<double>>(3U, 3U, std::move(entries)));
+    const auto sparse_adjoint = sparse.solve_transposed(rhs);
+
+    for(std::size_t index = 0U; index < rhs.size(); ++index)
+    {
+        EXPECT_NEAR(std::abs(adjoint[index] - expected[index]), 0.0, 1e-12);
+        EXPECT_NEAR(std::abs(sparse_adjoint[index] - expected[index]), 0.0, 1e-12);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess a divider against the closed form dV/dR
+ *************************************************************************************************/
+TEST(Sensitivity, Divider)
+{
+    Network network;
+    const auto ground = network.create_node();
+    const auto top = network.create_node();
+    const auto middle = network.create_node();
+
+    const auto connect = [&](std::unique_ptr<Component> component, uint32_t a, uint32_t b)
+    {
+        const auto uid = network.create_branch(std::move(component));
+        network.create_connection_between(a, uid);
+        network.create_connection_between(b, uid);
+        return uid;
+    };
+
+    connect(std::make_unique<Voltage_Source>(10.0), top, ground);
+    const auto upper = connect(std::make_unique<Resistor>(3.0_kohm), top, middle);
+    const auto lower = connect(std::make_unique<Resistor>(1.0_kohm), middle, ground);
+
+    const Sensitivity_Analysis analysis(Nodal_Analysis(network, ground));
+    const auto result = analysis.get_sensitivities(middle);
+    EXPECT_NEAR(result.output_voltage.real(), 2.5, 1e-12);
+
+    // V = 10 R2 / (R1 + R2)
+    const auto total = 4.0e3;
+    for(std::size_t index = 0U; index < result.branch_uids.size(); ++index)
+    {
+        const auto expected = (result.branch_uids[index] == upper) ? (-10.0 * 1.0e3 / (total * total)) :
+                                                                     (10.0 * 3.0e3 / (total * total));
+        EXPECT_NEAR(result.sensitivities[index].real(), expected, 1e-15);
+        EXPECT_TRUE((result.branch_uids[index] == upper) || (result.branch_uids[index] == lower));
+    }
+
+    // The ground never moves
+    const auto grounded = analysis.get_sensitivities(ground);
+    EXPECT_EQ(grounded.sensitivities[0], 0.0);
+    EXPECT_THROW(analysis.get_sensitivities(upper), Non_Existant_UID_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess every component of an RLC tree against central differences, at DC and in AC
+ *************************************************************************************************/
+TEST(Sensitivity, MatchesFiniteDifferences)
+{
+    Network network;
+    const auto circuit = generate_rlc_tree(network, 12U, 3U, 99U);
+    const auto nodes = network.get_node_uids();
+    const auto output = nodes.back();
+
+    expect_matches_finite_differences(network, circuit.ground_uid, output, ANGULAR_FREQUENCY);
+
+    // At DC the capacitors are open and have no influence
+    const Sensitivity_Analysis dc(Nodal_Analysis(network, circuit.ground_uid), 0.0);
+    const auto result = dc.get_sensitivities(output);
+    for(std::size_t index = 0U; index < result.branch_uids.size(); ++index)
+    {
+        if(network.get_component(result.branch_uids[index]).type == Component_Type::Capacitor)
+        {
+            EXPECT_EQ(result.sensitivities[index], 0.0);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess sensitivities of a tree with around ten thousand unknowns, too many for a dense
+ * factorization, at DC where the inductor current rows must be pivoted around and in AC
+ *************************************************************************************************/
+TEST(Sensitivity, LargeNetwork)
+{
+    constexpr auto NUMBER_OF_NODES = 5000U;
+    constexpr auto NUMBER_OF_CHECKS = 4U;
+
+    Network network;
+    const auto circuit = generate_rlc_tree(network, NUMBER_OF_NODES, 4U, 99U);
+    const auto output = network.get_node_uids().back();
+    const auto stride = network.get_number_of_branches() / NUMBER_OF_CHECKS;
+
+    expect_matches_finite_differences(network, circuit.ground_uid, output, 0.0, stride);
+    expect_matches_finite_differences(network, circuit.ground_uid, output, ANGULAR_FREQUENCY, stride);
+}
@@ -0,0 +1,323 @@
+#include "gtest/gtest.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/network.h"
+#include "circlyzer/ring_buffer.h"
+#include "circlyzer/streaming_analysis.h"
+#include "circlyzer/units.h"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto TIME_STEP = 1.0e-6;
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    /**
+     * \brief UIDs of a source driving a series resistor into either a shunt capacitor or a shunt
+     *        inductor
+     */
+    struct First_Order
+    {
+        uint32_t ground;
+        uint32_t output;
+        uint32_t source;
+    };
+
+    First_Order build_first_order(Network& network, std::unique_ptr<Component> shunt)
+    {
+        First_Order circuit;
+        circuit.ground = network.create_node();
+        const auto input = network.create_node();
+        circuit.output = network.create_node();
+
+        circuit.source = connect(network, input, circuit.ground, std::make_unique<Voltage_Source>(0.0));
+        connect(network, input, circuit.output, std::make_unique<Resistor>(1.0_kohm));
+        connect(network, circuit.output, circuit.ground, std::move(shunt));
+        return circuit;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that frames are moved whole, in order, across the wrap around
+ *************************************************************************************************/
+TEST(RingBuffer, Frames)
+{
+    Ring_Buffer<double> buffer(6U);
+    EXPECT_EQ(buffer.get_capacity(), 8U);
+
+    const std::vector<double> frame = { 1.0, 2.0, 3.0 };
+    std::vector<double> popped(3U);
+
+    for(std::size_t round = 0U; round < 5U; ++round)
+    {
+        EXPECT_TRUE(buffer.try_push(frame));
+        EXPECT_TRUE(buffer.try_push(frame));
+        EXPECT_FALSE(buffer.try_push(frame));
+        EXPECT_EQ(buffer.get_size(), 6U);
+
+        EXPECT_TRUE(buffer.try_pop(popped));
+        EXPECT_EQ(popped, frame);
+        EXPECT_TRUE(buffer.try_pop(popped));
+        EXPECT_EQ(popped, frame);
+        EXPECT_FALSE(buffer.try_pop(popped));
+    }
+
+    double value = 0.0;
+    EXPECT_TRUE(buffer.try_push(4.0));
+    EXPECT_FALSE(buffer.try_pop(popped));
+    EXPECT_TRUE(buffer.try_pop(value));
+    EXPECT_EQ(value, 4.0);
+}
+
+/**********************************************************************************************//**
+ * Assess that a producer and a consumer on their own threads see every value once, in order
+ *************************************************************************************************/
+TEST(RingBuffer, Concurrent)
+{
+    constexpr uint64_t NUMBER_OF_VALUES = 200000U;
+    Ring_Buffer<uint64_t> buffer(64U);
+
+    std::thread producer([&]()
+    {
+        for(uint64_t value = 0U; value < NUMBER_OF_VALUES;)
+        {
+            if(buffer.try_push(value))
+            {
+                ++value;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0U;
+    while(expected < NUMBER_OF_VALUES)
+    {
+        uint64_t value = 0U;
+        if(!buffer.try_pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+
+    producer.join();
+    EXPECT_EQ(buffer.get_size(), 0U);
+}
+
+/**********************************************************************************************//**
+ * Assess that buckets cover every latency within 6.25%, and percentiles follow the samples
+ *************************************************************************************************/
+TEST(LatencyHistogram, Percentiles)
+{
+    for(const uint64_t value : { 0ULL, 17ULL, 1000ULL, 123456789ULL, 0xFFFFFFFFFFFFFFFFULL })
+    {
+        const auto bucket = Latency_Histogram::get_bucket(value);
+        ASSERT_LT(bucket, Latency_Histogram::NUMBER_OF_BUCKETS);
+
+        const auto lower = Latency_Histogram::get_bucket_lower_bound(bucket);
+        EXPECT_LE(lower, value);
+        EXPECT_LE(static_cast<double>(value - lower), 0.0625 * static_cast<double>(value));
+    }
+
+    Latency_Histogram histogram;
+    for(uint64_t value = 1U; value <= 1000U; ++value)
+    {
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(histogram.get_count(), 1000U);
+    EXPECT_EQ(histogram.get_minimum(), 1U);
+    EXPECT_EQ(histogram.get_maximum(), 1000U);
+    EXPECT_DOUBLE_EQ(histogram.get_mean(), 500.5);
+    EXPECT_NEAR(static_cast<double>(histogram.get_percentile(0.5)), 500.0, 500.0 * 0.0625);
+    EXPECT_NEAR(static_cast<double>(histogram.get_percentile(0.99)), 990.0, 990.0 * 0.0625);
+    EXPECT_EQ(histogram.get_percentile(1.0), 1000U);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.get_count(), 0U);
+    EXPECT_EQ(histogram.get_percentile(0.5), 0U);
+}
+
+/**********************************************************************************************//**
+ * Assess that an RC circuit charges and an RL circuit fluxes as the analytic step responses
+ *************************************************************************************************/
+TEST(StreamingAnalysis, StepResponse)
+{
+    Network rc;
+    const auto capacitive = build_first_order(rc, std::make_unique<Capacitor>(1.0_muF));
+    Network rl;
+    const auto inductive = build_first_order(rl, std::make_unique<Inductor>(1.0_mH));
+
+    Streaming_Analysis charging(rc, capacitive.ground, TIME_STEP, { capacitive.source }, { capacitive.output });
+    Streaming_Analysis fluxing(rl, inductive.ground, TIME_STEP, { inductive.source }, { inductive.output });
+
+    // Time constants of 1 ms and 1 us. Starting at rest, the trapezoidal rule sees the step
+    // half a step late, which bounds the error by half the step over the time constant.
+    const std::vector<double> sample = { 1.0 };
+    std::vector<double> output(1U);
+    for(std::size_t step = 1U; step <= 2000U; ++step)
+    {
+        charging.step(sample, output);
+        const auto time = charging.get_time();
+        EXPECT_NEAR(output[0], 1.0 - std::exp(-time / 1.0e-3), 1e-3) << "step " << step;
+    }
+
+    Streaming_Analysis slow(rl, inductive.ground, 1.0e-8, { inductive.source }, { inductive.output });
+    for(std::size_t step = 1U; step <= 300U; ++step)
+    {
+        slow.step(sample, output);
+        EXPECT_NEAR(output[0], std::exp(-slow.get_time() / 1.0e-6), 1e-2) << "step " << step;
+    }
+
+    // Once settled the inductor is a short, whichever step is used
+    for(std::size_t step = 0U; step < 100U; ++step)
+    {
+        fluxing.step(sample, output);
+    }
+    EXPECT_NEAR(output[0], 0.0, 1e-9);
+
+    // From rest the first step solves (1 - v) / R = 2 C v / h
+    charging.reset();
+    charging.step(sample, output);
+    EXPECT_NEAR(output[0], 1.0 / (1.0 + (2.0e-3 / TIME_STEP)), 1e-12);
+}
+
+/**********************************************************************************************//**
+ * Assess that backward Euler converges on the same response, only less accurately
+ *************************************************************************************************/
+TEST(StreamingAnalysis, BackwardEuler)
+{
+    Network network;
+    const auto circuit = build_first_order(network, std::make_unique<Capacitor>(1.0_muF));
+    Streaming_Analysis analysis(network, circuit.ground, TIME_STEP, { circuit.source }, { circuit.output },
+                                Integration_Method::Backward_Euler);
+
+    const std::vector<double> sample = { 1.0 };
+    std::vector<double> output(1U);
+    for(std::size_t step = 0U; step < 1000U; ++step)
+    {
+        analysis.step(sample, output);
+    }
+
+    EXPECT_NEAR(output[0], 1.0 - std::exp(-1.0), 1e-3);
+}
+
+/**********************************************************************************************//**
+ * Assess that streaming through ring buffers matches stepping directly, with every step timed
+ *************************************************************************************************/
+TEST(StreamingAnalysis, Streamed)
+{
+    Network network;
+    const auto circuit = build_first_order(network, std::make_unique<Capacitor>(1.0_muF));
+    Streaming_Analysis direct(network, circuit.ground, TIME_STEP, { circuit.source }, { circuit.output });
+    Streaming_Analysis streamed(network, circuit.ground, TIME_STEP, { circuit.source },
+                                { circuit.output, circuit.ground });
+
+    constexpr std::size_t NUMBER_OF_STEPS = 5000U;
+    Ring_Buffer<double> input(256U);
+    Ring_Buffer<double> output(1024U);
+
+    std::jthread simulation([&](std::stop_token token) { streamed.run(input, output, token); });
+
+    std::vector<double> expected(1U);
+    std::vector<double> frame(2U);
+    std::size_t received = 0U;
+    std::size_t sent = 0U;
+    while(received < NUMBER_OF_STEPS)
+    {
+        const auto sample = std::sin(static_cast<double>(sent) * 1.0e-2);
+        if((sent < NUMBER_OF_STEPS) && input.try_push(sample))
+        {
+            ++sent;
+        }
+
+        if(output.try_pop(frame))
+        {
+            direct.step(std::vector<double>{ std::sin(static_cast<double>(received) * 1.0e-2) }, expected);
+            ASSERT_EQ(frame[0], expected[0]) << "step " << received;
+            ASSERT_EQ(frame[1], 0.0);
+            ++received;
+        }
+    }
+
+    simulation.request_stop();
+    simulation.join();
+
+    EXPECT_EQ(streamed.get_number_of_steps(), NUMBER_OF_STEPS);
+    EXPECT_EQ(streamed.get_number_of_dropped_outputs(), 0U);
+    EXPECT_EQ(streamed.get_latency_histogram().get_count(), NUMBER_OF_STEPS);
+    EXPECT_LE(streamed.get_latency_histogram().get_percentile(0.5),
+              streamed.get_latency_histogram().get_maximum());
+}
+
+/**********************************************************************************************//**
+ * Assess that a full output buffer drops frames instead of stalling the simulation
+ *************************************************************************************************/
+TEST(StreamingAnalysis, DroppedOutputs)
+{
+    Network network;
+    const auto circuit = build_first_order(network, std::make_unique<Capacitor>(1.0_muF));
+    Streaming_Analysis analysis(network, circuit.ground, TIME_STEP, { circuit.source }, { circuit.output });
+
+    Ring_Buffer<double> input(16U);
+    Ring_Buffer<double> output(4U);
+    for(std::size_t step = 0U; step < 10U; ++step)
+    {
+        ASSERT_TRUE(input.try_push(1.0));
+    }
+
+    EXPECT_EQ(analysis.process(input, output), 10U);
+    EXPECT_EQ(analysis.get_number_of_dropped_outputs(), 6U);
+    EXPECT_EQ(output.get_size(), 4U);
+}
+
+/**********************************************************************************************//**
+ * Assess that invalid time steps, sources, probes and ring buffers are refused
+ *************************************************************************************************/
+TEST(StreamingAnalysis, Invalid)
+{
+    Network network;
+    const auto circuit = build_first_order(network, std::make_unique<Capacitor>(1.0_muF));
+    const auto resistor = network.get_branch_uids()[1];
+
+    EXPECT_THROW(Streaming_Analysis(network, circuit.ground, 0.0, { circuit.source }, {}),
+                 Invalid_Streaming_Exception);
+    EXPECT_THROW(Streaming_Analysis(network, circuit.ground, TIME_STEP, { resistor }, {}),
+                 Invalid_Streaming_Exception);
+    EXPECT_THROW(Streaming_Analysis(network, circuit.ground, TIME_STEP, {}, { circuit.output }),
+                 Invalid_Streaming_Exception);
+    EXPECT_THROW(Streaming_Analysis(network, circuit.ground, TIME_STEP, { circuit.source }, { resistor }),
+                 Non_Existant_UID_Exception);
+
+    Streaming_Analysis analysis(network, circuit.ground, TIME_STEP, { circuit.source }, { circuit.output });
+    std::vector<double> output(1U);
+    EXPECT_THROW(analysis.step(std::vector<double>{}, output), Invalid_Streaming_Exception);
+
+    // Frames that can never fit, in or out
+    Streaming_Analysis wide(network, circuit.ground, TIME_STEP, { circuit.source },
+                            { circuit.output, circuit.output, circuit.output });
+    Ring_Buffer<double> input(1U);
+    Ring_Buffer<double> narrow(2U);
+    Ring_Buffer<double> roomy(4U);
+    ASSERT_TRUE(input.try_push(1.0));
+    EXPECT_THROW(wide.process(input, narrow), Invalid_Streaming_Exception);
+    EXPECT_EQ(wide.process(input, roomy), 1U);
+    }
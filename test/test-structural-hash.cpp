@@ -0,0 +1,245 @@
+#include "gtest/gtest.h"
+#include "circlyzer/generators.h"
+#include "circlyzer/network.h"
+#include "circlyzer/structural_hash.h"
+#include "circlyzer/units.h"
+#include "circlyzer/exceptions.h"
+
+#include <memory>
+#include <random>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto SEED = 11U;
+
+    /**
+     * \brief UIDs of a bridge circuit: a source from a to the ground, and resistors a-b, a-c,
+     *        b-c, b-ground and c-ground
+     */
+    struct Bridge
+    {
+        uint32_t ground;
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+        uint32_t source;
+        uint32_t bridge;
+    };
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component, const std::string& alias = "")
+    {
+        const auto branch = network.create_branch(std::move(component), alias);
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    Bridge build_bridge(Network& network)
+    {
+        Bridge bridge;
+        bridge.ground = network.create_node();
+        bridge.a = network.create_node();
+        bridge.b = network.create_node();
+        bridge.c = network.create_node();
+
+        bridge.source = connect(network, bridge.a, bridge.ground, std::make_unique<Voltage_Source>(5.0));
+        connect(network, bridge.a, bridge.b, std::make_unique<Resistor>(1.0_kohm));
+        connect(network, bridge.a, bridge.c, std::make_unique<Resistor>(2.0_kohm));
+        bridge.bridge = connect(network, bridge.b, bridge.c, std::make_unique<Resistor>(3.0_kohm));
+        connect(network, bridge.b, bridge.ground, std::make_unique<Resistor>(4.0_kohm));
+        connect(network, bridge.c, bridge.ground, std::make_unique<Resistor>(5.0_kohm));
+
+        return bridge;
+    }
+
+    /**
+     * \brief The same bridge built in another order, with other UIDs, aliases and with every
+     *        resistor's terminals swapped
+     */
+    Bridge build_renumbered_bridge(Network& network)
+    {
+        const auto padding = network.create_node("padding");
+        network.create_node("unused");
+        network.destroy_entity(padding);
+
+        Bridge bridge;
+        network.destroy_entity("unused");
+        bridge.c = network.create_node("c");
+        bridge.b = network.create_node();
+        bridge.ground = network.create_node("ground");
+        bridge.a = network.create_node();
+
+        connect(network, bridge.ground, bridge.c, std::make_unique<Resistor>(5.0_kohm), "R5");
+        connect(network, bridge.ground, bridge.b, std::make_unique<Resistor>(4.0_kohm));
+        bridge.bridge = connect(network, bridge.c, bridge.b, std::make_unique<Resistor>(3.0_kohm));
+        connect(network, bridge.c, bridge.a, std::make_unique<Resistor>(2.0_kohm));
+        connect(network, bridge.b, bridge.a, std::make_unique<Resistor>(1.0_kohm));
+        bridge.source = connect(network, bridge.a, bridge.ground, std::make_unique<Voltage_Source>(5.0));
+
+        return bridge;
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that numbering, construction order, aliases and resistor orientation don't matter
+ *************************************************************************************************/
+TEST(StructuralHash, IgnoresNumbering)
+{
+    Network one;
+    Network two;
+    const auto first = build_bridge(one);
+    const auto second = build_renumbered_bridge(two);
+    ASSERT_NE(first.a, second.a);
+
+    Structural_Hash one_hash(one);
+    Structural_Hash two_hash(two);
+    EXPECT_EQ(one_hash.get_hash(), two_hash.get_hash());
+
+    EXPECT_EQ(one_hash.get_node_label(first.a), two_hash.get_node_label(second.a));
+    EXPECT_EQ(one_hash.get_node_label(first.ground), two_hash.get_node_label(second.ground));
+    EXPECT_EQ(one_hash.get_branch_label(first.bridge), two_hash.get_branch_label(second.bridge));
+    EXPECT_NE(one_hash.get_node_label(first.b), one_hash.get_node_label(first.c));
+
+    two.update_alias(second.a, "renamed");
+    EXPECT_EQ(one_hash.get_hash(), two_hash.get_hash());
+}
+
+/**********************************************************************************************//**
+ * Assess that component values, topology and source polarity all change the hash
+ *************************************************************************************************/
+TEST(StructuralHash, CoversStructure)
+{
+    Network network;
+    const auto bridge = build_bridge(network);
+    Structural_Hash hash(network);
+    const auto original = hash.get_hash();
+
+    network.update_component(bridge.bridge, std::make_unique<Resistor>(3.5_kohm));
+    const auto changed = hash.get_hash();
+    EXPECT_NE(changed, original);
+
+    network.update_component(bridge.bridge, std::make_unique<Resistor>(3.0_kohm));
+    EXPECT_EQ(hash.get_hash(), original);
+
+    // Reversing the source matters, where reversing a resistor does not
+    network.delete_connection_between(bridge.a, bridge.source);
+    network.create_connection_between(bridge.a, bridge.source);
+    EXPECT_NE(hash.get_hash(), original);
+
+    network.delete_connection_between(bridge.ground, bridge.source);
+    network.create_connection_between(bridge.ground, bridge.source);
+    EXPECT_EQ(hash.get_hash(), original);
+
+    network.delete_connection_between(bridge.b, bridge.bridge);
+    network.create_connection_between(bridge.b, bridge.bridge);
+    EXPECT_EQ(hash.get_hash(), original);
+
+    network.delete_connection_between(bridge.c, bridge.bridge);
+    EXPECT_NE(hash.get_hash(), original);
+
+    EXPECT_THROW(hash.get_node_label(bridge.bridge), Non_Existant_UID_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that the incrementally maintained hash always equals one built from scratch, while only
+ * recolouring around each edit
+ *************************************************************************************************/
+TEST(StructuralHash, Incremental)
+{
+    Network network;
+    const auto circuit = generate_grid(network, 40U, 40U, 1U, SEED);
+    Structural_Hash hash(network);
+    hash.get_hash();
+
+    std::mt19937_64 generator(SEED);
+    const auto branch_uids = network.get_branch_uids();
+    const auto node_uids = network.get_node_uids();
+
+    for(uint32_t edit = 0U; edit < 20U; ++edit)
+    {
+        const auto recoloured = hash.get_number_of_recoloured_nodes();
+
+        const auto branch = branch_uids[generator() % branch_uids.size()];
+        switch(edit % 3U)
+        {
+            case 0U:
+                network.update_component(branch, std::make_unique<Resistor>(1.0 + static_cast<double>(edit)));
+                break;
+
+            case 1U:
+            {
+                const auto node = network.create_node();
+                connect(network, node, node_uids[generator() % node_uids.size()],
+                        std::make_unique<Capacitor>(1.0_muF));
+                break;
+            }
+
+            default:
+            {
+                const auto nodes = network.get_branch(branch).nodes;
+                if(!nodes.empty())
+                {
+                    network.delete_connection_between(nodes[0], branch);
+                }
+                break;
+            }
+        }
+
+        EXPECT_EQ(hash.get_hash(), Structural_Hash(network).get_hash()) << "edit " << edit;
+        EXPECT_LT(hash.get_number_of_recoloured_nodes() - recoloured, circuit.number_of_nodes / 10U);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that destroying entities, and compacting the journal past the hash, are handled
+ *************************************************************************************************/
+TEST(StructuralHash, DestroyAndCompact)
+{
+    Network network;
+    const auto bridge = build_bridge(network);
+    Structural_Hash hash(network);
+    hash.get_hash();
+
+    network.destroy_entity(bridge.bridge);
+    network.destroy_entity(network.create_node());
+    EXPECT_EQ(hash.get_hash(), Structural_Hash(network).get_hash());
+
+    network.update_component(bridge.source, std::make_unique<Voltage_Source>(1.0));
+    network.compact_journal(network.get_journal().get_sequence());
+    EXPECT_EQ(hash.get_hash(), Structural_Hash(network).get_hash());
+}
+
+/**********************************************************************************************//**
+ * Assess that stable colourings match between renumbered networks, colour roles apart and are
+ * refined again only after an edit
+ *************************************************************************************************/
+TEST(StructuralHash, StableColouring)
+{
+    Network one;
+    Network two;
+    const auto first = build_bridge(one);
+    const auto second = build_renumbered_bridge(two);
+    Structural_Hash one_hash(one);
+    Structural_Hash two_hash(two);
+
+    const auto& one_colouring = one_hash.get_stable_colouring({ first.ground });
+    const auto& two_colouring = two_hash.get_stable_colouring({ second.ground });
+    EXPECT_EQ(one_colouring.fingerprint, two_colouring.fingerprint);
+    EXPECT_EQ(one_colouring.node_colours.at(first.b), two_colouring.node_colours.at(second.b));
+    EXPECT_NE(one_colouring.node_colours.at(first.b), one_colouring.node_colours.at(first.c));
+
+    // Held until the network changes
+    EXPECT_EQ(&one_hash.get_stable_colouring({ first.ground }), &one_colouring);
+
+    const auto ported = one_hash.get_stable_colouring({ first.b, first.c }).fingerprint;
+    EXPECT_NE(ported, one_hash.get_stable_colouring({ first.c, first.b }).fingerprint);
+
+    one.update_component(first.bridge, std::make_unique<Resistor>(6.0_kohm));
+    EXPECT_NE(one_hash.get_stable_colouring({ first.ground }).fingerprint,
+              two_hash.get_stable_colouring({ second.ground }).fingerprint);
+
+    EXPECT_THROW(one_hash.get_stable_colouring({ first.source }), Non_Existant_UID_Exception);
+}
@@ -0,0 +1,365 @@
+#include "gtest/gtest.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/subcircuit.h"
+#include "circlyzer/units.h"
+
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto TOLERANCE = 1e-9;
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    /**
+     * \brief The repeated block: two internal nodes between three ports, with a source inside so
+     *        the block injects current of its own. Returns the internal nodes.
+     */
+    std::vector<uint32_t> add_block(Network& network, const uint32_t reference, const uint32_t input,
+                                    const uint32_t output)
+    {
+        const auto middle = network.create_node();
+        const auto inner = network.create_node();
+
+        connect(network, input, middle, std::make_unique<Resistor>(1.0_kohm));
+        connect(network, middle, reference, std::make_unique<Capacitor>(100.0_nF));
+        connect(network, middle, inner, std::make_unique<Inductor>(10.0_mH));
+        connect(network, inner, output, std::make_unique<Resistor>(2.0_kohm));
+        connect(network, inner, reference, std::make_unique<Resistor>(3.0_kohm));
+        connect(network, inner, reference, std::make_unique<Voltage_Source>(1.0));
+
+        return { middle, inner };
+    }
+
+    /**
+     * \brief A definition of the block, with its ports in the order reference, input, output
+     */
+    std::shared_ptr<const Subcircuit_Definition> define_block(std::vector<uint32_t>& internal_nodes)
+    {
+        Network body;
+        const auto reference = body.create_node();
+        const auto input = body.create_node();
+        const auto output = body.create_node();
+        internal_nodes = add_block(body, reference, input, output);
+
+        return std::make_shared<const Subcircuit_Definition>(body, std::vector<uint32_t>{ reference, input, output });
+    }
+
+    /**
+     * \brief A source driving a chain of blocks, every block referenced to the ground. Blocks are
+     *        either instanced or flattened into the network; the chain nodes come back in order.
+     */
+    std::vector<uint32_t> build_chain(Network& network, const uint32_t ground, const std::size_t number_of_blocks,
+                                      const std::shared_ptr<const Subcircuit_Definition>& definition,
+                                      std::vector<Subcircuit_Instance>& instances)
+    {
+        std::vector<uint32_t> chain{ network.create_node() };
+        connect(network, chain.front(), ground, std::make_unique<Voltage_Source>(5.0));
+
+        for(std::size_t block = 0U; block < number_of_blocks; ++block)
+        {
+            chain.emplace_back(network.create_node());
+            if(definition)
+            {
+                instances.push_back({ definition, { ground, chain[block], chain[block + 1U] } });
+            }
+            else
+            {
+                add_block(network, ground, chain[block], chain[block + 1U]);
+            }
+        }
+
+        connect(network, chain.back(), ground, std::make_unique<Resistor>(1.0_kohm));
+        return chain;
+    }
+
+    void expect_voltages(const Nodal_Solution& actual, const Nodal_Solution& expected,
+                         const std::vector<uint32_t>& actual_uids, const std::vector<uint32_t>& expected_uids)
+    {
+        for(std::size_t index = 0U; index < actual_uids.size(); ++index)
+        {
+            EXPECT_NEAR(std::abs(actual.node_voltages.at(actual_uids[index]) -
+                                 expected.node_voltages.at(expected_uids[index])), 0.0, TOLERANCE);
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that a chain of instances solves like the same chain flattened, at DC and in AC
+ *************************************************************************************************/
+TEST(Subcircuit, MatchesFlattened)
+{
+    std::vector<uint32_t> internal_nodes;
+    const auto definition = define_block(internal_nodes);
+
+    Network hierarchical;
+    Network flattened;
+    const auto ground = hierarchical.create_node();
+    const auto flat_ground = flattened.create_node();
+
+    std::vector<Subcircuit_Instance> instances;
+    std::vector<Subcircuit_Instance> unused;
+    const auto chain = build_chain(hierarchical, ground, 4U, definition, instances);
+    const auto flat_chain = build_chain(flattened, flat_ground, 4U, nullptr, unused);
+
+    const Hierarchical_Analysis analysis(hierarchical, ground, instances);
+    const Nodal_Analysis flat_analysis(flattened, flat_ground);
+
+    for(const auto frequency : { 0.0, ANGULAR_FREQUENCY })
+    {
+        const auto solution = analysis.solve(frequency);
+        const auto expected = flat_analysis.solve(frequency);
+        expect_voltages(solution, expected, chain, flat_chain);
+        EXPECT_EQ(solution.node_voltages.size(), chain.size() + 1U);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that every instance shares one elimination per frequency
+ *************************************************************************************************/
+TEST(Subcircuit, SharedElimination)
+{
+    std::vector<uint32_t> internal_nodes;
+    const auto definition = define_block(internal_nodes);
+
+    Network network;
+    const auto ground = network.create_node();
+    std::vector<Subcircuit_Instance> instances;
+    build_chain(network, ground, 100U, definition, instances);
+
+    const Hierarchical_Analysis analysis(network, ground, instances);
+    analysis.solve(0.0);
+    EXPECT_EQ(definition->get_number_of_eliminations(), 1U);
+
+    analysis.solve(ANGULAR_FREQUENCY);
+    analysis.solve(0.0);
+    EXPECT_EQ(definition->get_number_of_eliminations(), 2U);
+
+    // Only the interconnect is in the system: the chain nodes and the source current
+    EXPECT_EQ(analysis.get_nodal_analysis().get_system_size(), 102U);
+
+    // The macromodel of a floating block is indefinite
+    const auto macromodel = definition->get_macromodel(ANGULAR_FREQUENCY);
+    for(std::size_t row = 0U; row < 3U; ++row)
+    {
+        std::complex<double> row_sum = 0.0;
+        std::complex<double> column_sum = 0.0;
+        for(std::size_t column = 0U; column < 3U; ++column)
+        {
+            row_sum += macromodel->admittance(row, column);
+            column_sum += macromodel->admittance(column, row);
+        }
+
+        EXPECT_NEAR(std::abs(row_sum), 0.0, TOLERANCE);
+        EXPECT_NEAR(std::abs(column_sum), 0.0, TOLERANCE);
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that expanding an instance recovers the internal voltages of the flattened circuit
+ *************************************************************************************************/
+TEST(Subcircuit, SolveInstance)
+{
+    std::vector<uint32_t> internal_nodes;
+    const auto definition = define_block(internal_nodes);
+
+    Network hierarchical;
+    Network flattened;
+    const auto ground = hierarchical.create_node();
+    const auto flat_ground = flattened.create_node();
+
+    std::vector<Subcircuit_Instance> instances;
+    build_chain(hierarchical, ground, 3U, definition, instances);
+
+    // The flattened chain is rebuilt by hand to keep hold of the second block's internal nodes
+    std::vector<uint32_t> flat_chain{ flattened.create_node() };
+    connect(flattened, flat_chain.front(), flat_ground, std::make_unique<Voltage_Source>(5.0));
+
+    std::vector<uint32_t> flat_internal_nodes;
+    for(std::size_t block = 0U; block < 3U; ++block)
+    {
+        flat_chain.emplace_back(flattened.create_node());
+        const auto nodes = add_block(flattened, flat_ground, flat_chain[block], flat_chain[block + 1U]);
+        if(block == 1U)
+        {
+            flat_internal_nodes = nodes;
+        }
+    }
+    connect(flattened, flat_chain.back(), flat_ground, std::make_unique<Resistor>(1.0_kohm));
+
+    const Hierarchical_Analysis analysis(hierarchical, ground, instances);
+    const auto solution = analysis.solve(ANGULAR_FREQUENCY);
+    const auto internal = analysis.solve_instance(solution, 1U, ANGULAR_FREQUENCY);
+    const auto expected = Nodal_Analysis(flattened, flat_ground).solve(ANGULAR_FREQUENCY);
+
+    expect_voltages(internal, expected, internal_nodes, flat_internal_nodes);
+
+    const auto& ports = definition->get_port_uids();
+    expect_voltages(internal, expected, { ports[1], ports[2] }, { flat_chain[1], flat_chain[2] });
+}
+
+/**********************************************************************************************//**
+ * Assess that a definition can instance another, and that a block can float off the ground
+ *************************************************************************************************/
+TEST(Subcircuit, Nested)
+{
+    std::vector<uint32_t> internal_nodes;
+    const auto block = define_block(internal_nodes);
+
+    // A pair of blocks in series, sharing the pair's reference rather than any ground
+    Network pair_body;
+    const auto reference = pair_body.create_node();
+    const auto input = pair_body.create_node();
+    const auto middle = pair_body.create_node();
+    const auto output = pair_body.create_node();
+    const auto pair = std::make_shared<const Subcircuit_Definition>(
+        pair_body, std::vector<uint32_t>{ reference, input, output },
+        std::vector<Subcircuit_Instance>{ { block, { reference, input, middle } },
+                                          { block, { reference, middle, output } } });
+
+    Network hierarchical;
+    const auto ground = hierarchical.create_node();
+    const auto common = hierarchical.create_node();
+    const auto top_input = hierarchical.create_node();
+    const auto top_output = hierarchical.create_node();
+    connect(hierarchical, common, ground, std::make_unique<Voltage_Source>(0.5));
+    connect(hierarchical, top_input, ground, std::make_unique<Voltage_Source>(5.0));
+    connect(hierarchical, top_output, ground, std::make_unique<Resistor>(1.0_kohm));
+
+    Network flattened;
+    const auto flat_ground = flattened.create_node();
+    const auto flat_common = flattened.create_node();
+    const auto flat_input = flattened.create_node();
+    const auto flat_middle = flattened.create_node();
+    const auto flat_output = flattened.create_node();
+    connect(flattened, flat_common, flat_ground, std::make_unique<Voltage_Source>(0.5));
+    connect(flattened, flat_input, flat_ground, std::make_unique<Voltage_Source>(5.0));
+    connect(flattened, flat_output, flat_ground, std::make_unique<Resistor>(1.0_kohm));
+    add_block(flattened, flat_common, flat_input, flat_middle);
+    add_block(flattened, flat_common, flat_middle, flat_output);
+
+    const Hierarchical_Analysis analysis(hierarchical, ground, { { pair, { common, top_input, top_output } } });
+    const auto solution = analysis.solve(ANGULAR_FREQUENCY);
+    const auto expected = Nodal_Analysis(flattened, flat_ground).solve(ANGULAR_FREQUENCY);
+
+    expect_voltages(solution, expected, { top_output }, { flat_output });
+    expect_voltages(analysis.solve_instance(solution, 0U, ANGULAR_FREQUENCY), expected, { middle }, { flat_middle });
+    EXPECT_EQ(block->get_number_of_eliminations(), 1U);
+}
+
+/**********************************************************************************************//**
+ * Assess that only the most recently used frequencies keep their macromodels
+ *************************************************************************************************/
+TEST(Subcircuit, MacromodelCapacity)
+{
+    Network body;
+    const auto first = body.create_node();
+    const auto second = body.create_node();
+    const auto middle = body.create_node();
+    connect(body, first, middle, std::make_unique<Resistor>(1.0_kohm));
+    connect(body, middle, second, std::make_unique<Capacitor>(100.0_nF));
+
+    const Subcircuit_Definition definition(body, { first, second }, {}, 2U);
+    definition.get_macromodel(1.0);
+    definition.get_macromodel(2.0);
+    definition.get_macromodel(1.0);
+    definition.get_macromodel(3.0);
+    EXPECT_EQ(definition.get_number_of_cached_frequencies(), 2U);
+    EXPECT_EQ(definition.get_number_of_eliminations(), 3U);
+
+    definition.get_macromodel(1.0);
+    EXPECT_EQ(definition.get_number_of_eliminations(), 3U);
+
+    definition.get_macromodel(2.0);
+    EXPECT_EQ(definition.get_number_of_eliminations(), 4U);
+}
+
+/**********************************************************************************************//**
+ * Assess that an inductor tying two ports is macromodelled away from DC, and that at DC, where
+ * the tie has no Norton form, elimination fails where the flat analysis does not
+ *************************************************************************************************/
+TEST(Subcircuit, PortTie)
+{
+    Network body;
+    const auto first = body.create_node();
+    const auto second = body.create_node();
+    connect(body, first, second, std::make_unique<Inductor>(10.0_mH));
+    connect(body, first, second, std::make_unique<Resistor>(1.0_kohm));
+    const auto definition = std::make_shared<const Subcircuit_Definition>(body, std::vector<uint32_t>{ first, second });
+
+    Network network;
+    const auto ground = network.create_node();
+    const auto input = network.create_node();
+    const auto output = network.create_node();
+    connect(network, input, ground, std::make_unique<Voltage_Source>(5.0));
+    connect(network, output, ground, std::make_unique<Resistor>(1.0_kohm));
+
+    Network flattened;
+    const auto flat_ground = flattened.create_node();
+    const auto flat_input = flattened.create_node();
+    const auto flat_output = flattened.create_node();
+    connect(flattened, flat_input, flat_ground, std::make_unique<Voltage_Source>(5.0));
+    connect(flattened, flat_output, flat_ground, std::make_unique<Resistor>(1.0_kohm));
+    connect(flattened, flat_input, flat_output, std::make_unique<Inductor>(10.0_mH));
+    connect(flattened, flat_input, flat_output, std::make_unique<Resistor>(1.0_kohm));
+
+    const Hierarchical_Analysis analysis(network, ground, { { definition, { input, output } } });
+    expect_voltages(analysis.solve(ANGULAR_FREQUENCY), Nodal_Analysis(flattened, flat_ground).solve(ANGULAR_FREQUENCY),
+                    { output }, { flat_output });
+
+    EXPECT_THROW(analysis.solve(0.0), Singular_Matrix_Exception);
+    EXPECT_NEAR(std::abs(Nodal_Analysis(flattened, flat_ground).solve(0.0).node_voltages.at(flat_output) - 5.0), 0.0,
+                TOLERANCE);
+}
+
+/**********************************************************************************************//**
+ * Assess that malformed definitions and instances are refused
+ *************************************************************************************************/
+TEST(Subcircuit, Invalid)
+{
+    Network body;
+    const auto first = body.create_node();
+    const auto second = body.create_node();
+    connect(body, first, second, std::make_unique<Resistor>(1.0_kohm));
+
+    EXPECT_THROW(Subcircuit_Definition(body, { first }), Invalid_Subcircuit_Exception);
+    EXPECT_THROW(Subcircuit_Definition(body, { first, first }), Invalid_Subcircuit_Exception);
+    EXPECT_THROW(Subcircuit_Definition(body, { first, second, second }), Invalid_Subcircuit_Exception);
+
+    const auto branch = body.get_branch_uids().front();
+    EXPECT_THROW(Subcircuit_Definition(body, { first, branch }), Invalid_Subcircuit_Exception);
+
+    // A source between two ports, but not one from a port to an internal node
+    Network tied;
+    const auto tied_first = tied.create_node();
+    const auto tied_second = tied.create_node();
+    const auto tied_internal = tied.create_node();
+    connect(tied, tied_second, tied_first, std::make_unique<Voltage_Source>(1.0));
+    connect(tied, tied_internal, tied_first, std::make_unique<Voltage_Source>(1.0));
+    connect(tied, tied_internal, tied_second, std::make_unique<Resistor>(1.0_kohm));
+    EXPECT_THROW(Subcircuit_Definition(tied, { tied_first, tied_second }), Invalid_Subcircuit_Exception);
+    EXPECT_NO_THROW(Subcircuit_Definition(tied, { tied_second, tied_internal }));
+
+    const auto definition = std::make_shared<const Subcircuit_Definition>(body, std::vector<uint32_t>{ first, second });
+
+    Network network;
+    const auto ground = network.create_node();
+    const auto node = network.create_node();
+    EXPECT_THROW(Hierarchical_Analysis(network, ground, { { definition, { ground } } }),
+                 Invalid_Subcircuit_Exception);
+    EXPECT_THROW(Hierarchical_Analysis(network, ground, { { definition, { ground, node + 100U } } }),
+                 Invalid_Subcircuit_Exception);
+    EXPECT_NO_THROW(Hierarchical_Analysis(network, ground, { { definition, { ground, node } } }));
+}
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+#include "circlyzer/exceptions.h"
+#include "circlyzer/executor.h"
+#include "circlyzer/network.h"
+#include "circlyzer/nodal_analysis.h"
+#include "circlyzer/superposition.h"
+#include "circlyzer/units.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace Circlyzer;
+
+namespace
+{
+    constexpr auto ANGULAR_FREQUENCY = 1.0e4;
+    constexpr auto TOLERANCE = 1e-12;
+
+    uint32_t connect(Network& network, const uint32_t first, const uint32_t second,
+                     std::unique_ptr<Component> component)
+    {
+        const auto branch = network.create_branch(std::move(component));
+        network.create_connection_between(first, branch);
+        network.create_connection_between(second, branch);
+        return branch;
+    }
+
+    /**
+     * \brief Two sources, each behind a resistor, feeding an RLC node
+     */
+    struct Two_Sources
+    {
+        uint32_t ground;
+        uint32_t middle;
+        uint32_t first_source;
+        uint32_t second_source;
+        uint32_t load;
+    };
+
+    Two_Sources build_two_sources(Network& network)
+    {
+        Two_Sources circuit;
+        circuit.ground = network.create_node();
+        const auto left = network.create_node();
+        const auto right = network.create_node();
+        circuit.middle = network.create_node();
+
+        circuit.first_source = connect(network, left, circuit.ground, std::make_unique<Voltage_Source>(0.0));
+        circuit.second_source = connect(network, right, circuit.ground, std::make_unique<Voltage_Source>(0.0));
+        connect(network, left, circuit.middle, std::make_unique<Resistor>(1.0_kohm));
+        connect(network, right, circuit.middle, std::make_unique<Resistor>(2.0_kohm));
+        circuit.load = connect(network, circuit.middle, circuit.ground, std::make_unique<Resistor>(3.0_kohm));
+        connect(network, circuit.middle, circuit.ground, std::make_unique<Capacitor>(100.0_nF));
+        connect(network, circuit.middle, circuit.ground, std::make_unique<Inductor>(10.0_mH));
+        return circuit;
+    }
+
+    /**
+     * \brief The reference: a plain solve with the sources set to the provided voltages
+     */
+    Nodal_Solution solve_directly(Network& network, const Two_Sources& circuit, const std::complex<double> first,
+                                  const std::complex<double> second, const double frequency)
+    {
+        network.update_component(circuit.first_source, std::make_unique<Voltage_Source>(first));
+        network.update_component(circuit.second_source, std::make_unique<Voltage_Source>(second));
+        return Nodal_Analysis(network, circuit.ground).solve(frequency);
+    }
+
+    void expect_same(const Nodal_Solution& actual, const Nodal_Solution& expected)
+    {
+        ASSERT_EQ(actual.node_voltages.size(), expected.node_voltages.size());
+        for(const auto& [uid, voltage] : expected.node_voltages)
+        {
+            EXPECT_NEAR(std::abs(actual.node_voltages.at(uid) - voltage), 0.0, TOLERANCE) << "node " << uid;
+        }
+
+        for(const auto& [uid, current] : expected.branch_currents)
+        {
+            EXPECT_NEAR(std::abs(actual.branch_currents.at(uid) - current), 0.0, TOLERANCE) << "branch " << uid;
+        }
+    }
+}
+
+/**********************************************************************************************//**
+ * Assess that each frequency's solution is that of its own sources alone, with the others shorted
+ *************************************************************************************************/
+TEST(Superposition, GroupsByFrequency)
+{
+    Network network;
+    const auto circuit = build_two_sources(network);
+    const Superposition_Analysis analysis(network, circuit.ground);
+
+    const std::complex<double> harmonic{ 0.5, -0.25 };
+    const auto solution = analysis.solve({ { circuit.first_source, 1.0, ANGULAR_FREQUENCY },
+                                           { circuit.second_source, 2.0, 0.0 },
+                                           { circuit.second_source, harmonic, ANGULAR_FREQUENCY },
+                                           { circuit.first_source, 0.1, 3.0 * ANGULAR_FREQUENCY } });
+
+    ASSERT_EQ(solution.frequencies, (std::vector<double>{ 0.0, ANGULAR_FREQUENCY, 3.0 * ANGULAR_FREQUENCY }));
+    ASSERT_EQ(solution.solutions.size(), 3U);
+    EXPECT_TRUE(solution.contributions.empty());
+
+    expect_same(solution.solutions[0], solve_directly(network, circuit, 0.0, 2.0, 0.0));
+    expect_same(solution.solutions[1], solve_directly(network, circuit, 1.0, harmonic, ANGULAR_FREQUENCY));
+    expect_same(solution.solutions[2], solve_directly(network, circuit, 0.1, 0.0, 3.0 * ANGULAR_FREQUENCY));
+}
+
+/**********************************************************************************************//**
+ * Assess that kept contributions are each source's own solution, and add up to the total
+ *************************************************************************************************/
+TEST(Superposition, Contributions)
+{
+    Network network;
+    const auto circuit = build_two_sources(network);
+    const Superposition_Analysis analysis(network, circuit.ground);
+
+    Executor executor(2U);
+    const auto solution = analysis.solve({ { circuit.first_source, 1.0, ANGULAR_FREQUENCY },
+                                           { circuit.second_source, 2.0, ANGULAR_FREQUENCY } },
+                                         true, executor);
+
+    ASSERT_EQ(solution.contributions.size(), 2U);
+    expect_same(solution.contributions[0], solve_directly(network, circuit, 1.0, 0.0, ANGULAR_FREQUENCY));
+    expect_same(solution.contributions[1], solve_directly(network, circuit, 0.0, 2.0, ANGULAR_FREQUENCY));
+    expect_same(solution.solutions[0], solve_directly(network, circuit, 1.0, 2.0, ANGULAR_FREQUENCY));
+}
+
+/**********************************************************************************************//**
+ * Assess that the instantaneous values add up the harmonics
+ *************************************************************************************************/
+TEST(Superposition, TimeDomain)
+{
+    Network network;
+    const auto circuit = build_two_sources(network);
+    const Superposition_Analysis analysis(network, circuit.ground);
+
+    const auto solution = analysis.solve({ { circuit.first_source, 1.0, 0.0 },
+                                           { circuit.second_source, { 0.0, -1.0 }, ANGULAR_FREQUENCY } });
+
+    const auto direct = solution.solutions[0].node_voltages.at(circuit.middle);
+    const auto harmonic = solution.solutions[1].node_voltages.at(circuit.middle);
+    for(const auto time : { 0.0, 1.0e-5, 3.3e-4 })
+    {
+        const auto expected = direct.real() + std::abs(harmonic) * std::cos((ANGULAR_FREQUENCY * time) + std::arg(harmonic));
+        EXPECT_NEAR(evaluate_node_voltage(solution, circuit.middle, time), expected, TOLERANCE);
+    }
+
+    // The inductor shorts the middle node at DC, and a -j source is a sine
+    EXPECT_NEAR(std::abs(direct), 0.0, TOLERANCE);
+    EXPECT_NEAR(evaluate_branch_current(solution, circuit.second_source, 0.0),
+                solution.solutions[1].branch_currents.at(circuit.second_source).real(), TOLERANCE);
+    EXPECT_THROW(evaluate_node_voltage(solution, circuit.load, 0.0), Non_Existant_UID_Exception);
+}
+
+/**********************************************************************************************//**
+ * Assess that only voltage sources can be excited
+ *************************************************************************************************/
+TEST(Superposition, Invalid)
+{
+    Network network;
+    const auto circuit = build_two_sources(network);
+    const Superposition_Analysis analysis(network, circuit.ground);
+
+    EXPECT_THROW(analysis.solve({ { circuit.load, 1.0, 0.0 } }), Invalid_Excitation_Exception);
+    EXPECT_THROW(analysis.solve({ { circuit.first_source, 1.0, std::nan("") } }), Invalid_Excitation_Exception);
+    EXPECT_TRUE(analysis.solve({}).solutions.empty());
+}